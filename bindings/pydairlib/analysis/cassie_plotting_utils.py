@@ -15,11 +15,33 @@ from pydairlib.cassie.cassie_utils import AddCassieMultibody
 from pydrake.multibody.plant import AddMultibodyPlantSceneGraph
 from pydrake.systems.framework import DiagramBuilder
 
+
+
+class RobotStateDecoder:
+    """ Decodes a state channel carrying either lcmt_robot_output or
+    lcmt_robot_output_compact messages (see RobotStateFormat) """
+    lcmtypes = (dairlib.lcmt_robot_output, dairlib.lcmt_robot_output_compact)
+
+    @classmethod
+    def decode(cls, data):
+        for lcmtype in cls.lcmtypes:
+            try:
+                return lcmtype.decode(data)
+            except ValueError:
+                # Fingerprint mismatch
+                pass
+        raise ValueError("Not an lcmt_robot_output or "
+                         "lcmt_robot_output_compact message")
+
+
 cassie_urdf = "examples/Cassie/urdf/cassie_v2.urdf"
 cassie_urdf_no_springs = "examples/Cassie/urdf/cassie_fixed_springs.urdf"
+# The _LAYOUT channels carry the names of compact state messages
 cassie_default_channels = \
-    {'CASSIE_STATE_SIMULATION': dairlib.lcmt_robot_output,
-     'CASSIE_STATE_DISPATCHER': dairlib.lcmt_robot_output,
+    {'CASSIE_STATE_SIMULATION': RobotStateDecoder,
+     'CASSIE_STATE_DISPATCHER': RobotStateDecoder,
+     'CASSIE_STATE_SIMULATION_LAYOUT': dairlib.lcmt_robot_state_layout,
+     'CASSIE_STATE_DISPATCHER_LAYOUT': dairlib.lcmt_robot_state_layout,
      'CASSIE_INPUT': dairlib.lcmt_robot_input,
      'OSC_WALKING': dairlib.lcmt_robot_input,
      'OSC_STANDING': dairlib.lcmt_robot_input,
@@ -39,18 +39,56 @@ def make_joint_order_permutation_matrix(names_in_old_order, names_in_new_order):
     return perm
 
 
-def make_joint_order_permutations(robot_output_message, plant):
+def robot_state_layout_id(position_names, velocity_names, effort_names):
+    """ Same hash as RobotStateLayoutId() in systems/robot_lcm_systems.h """
+    h = 14695981039346656037
+    for names in (position_names, velocity_names, effort_names):
+        data = b''.join(name.encode() + b'\0' for name in names) + b'\x1f'
+        for c in data:
+            h = ((h ^ c) * 1099511628211) & 0xFFFFFFFFFFFFFFFF
+    return h - (1 << 64) if h >= (1 << 63) else h
+
+
+def make_state_layouts(plant, layout_data=None):
+    """ Dict from layout id to the (position, velocity, effort) names of the
+    lcmt_robot_state_layout messages in `layout_data`, and of the plant """
     qnames, vnames, unames = make_mbp_name_vectors(plant)
-    qperm = make_joint_order_permutation_matrix(
-        robot_output_message.position_names, qnames)
-    vperm = make_joint_order_permutation_matrix(
-        robot_output_message.velocity_names, vnames)
-    uperm = make_joint_order_permutation_matrix(
-        robot_output_message.effort_names, unames)
+    layouts = {robot_state_layout_id(qnames, vnames, unames):
+               (qnames, vnames, unames)}
+    for layout in (layout_data or []):
+        layouts[layout.layout_id] = (layout.position_names,
+                                     layout.velocity_names,
+                                     layout.effort_names)
+    return layouts
+
+
+def get_state_names(msg, layouts):
+    """ Position, velocity and effort names of an lcmt_robot_output or
+    lcmt_robot_output_compact message. The names of compact messages are
+    looked up in `layouts` (see make_state_layouts) """
+    if hasattr(msg, 'position_names'):
+        return msg.position_names, msg.velocity_names, msg.effort_names
+    if msg.layout_id not in layouts:
+        raise ValueError(f"No lcmt_robot_state_layout for layout id "
+                         f"{msg.layout_id}, which differs from the plant")
+    return layouts[msg.layout_id]
+
+
+def make_joint_order_permutations(robot_output_message, plant,
+                                  layout_data=None):
+    qnames, vnames, unames = make_mbp_name_vectors(plant)
+    msg_qnames, msg_vnames, msg_unames = get_state_names(
+        robot_output_message, make_state_layouts(plant, layout_data))
+    qperm = make_joint_order_permutation_matrix(msg_qnames, qnames)
+    vperm = make_joint_order_permutation_matrix(msg_vnames, vnames)
+    uperm = make_joint_order_permutation_matrix(msg_unames, unames)
     return qperm, vperm, uperm
 
 
-def process_state_channel(state_data, plant):
+def process_state_channel(state_data, plant, layout_data=None):
+    """ Processes lcmt_robot_output or lcmt_robot_output_compact messages.
+    For compact messages whose layout differs from the plant, `layout_data`
+    are the lcmt_robot_state_layout messages of the layout channel """
     t_x = []
     q = []
     u = []
@@ -59,17 +97,20 @@ def process_state_channel(state_data, plant):
     pos_map = MakeNameToPositionsMap(plant)
     vel_map = MakeNameToVelocitiesMap(plant)
     act_map = MakeNameToActuatorsMap(plant)
+    layouts = make_state_layouts(plant, layout_data)
 
     for msg in state_data:
+        position_names, velocity_names, effort_names = \
+            get_state_names(msg, layouts)
         q_temp = [[] for i in range(len(msg.position))]
         v_temp = [[] for i in range(len(msg.velocity))]
         u_temp = [[] for i in range(len(msg.effort))]
         for i in range(len(q_temp)):
-            q_temp[pos_map[msg.position_names[i]]] = msg.position[i]
+            q_temp[pos_map[position_names[i]]] = msg.position[i]
         for i in range(len(v_temp)):
-            v_temp[vel_map[msg.velocity_names[i]]] = msg.velocity[i]
+            v_temp[vel_map[velocity_names[i]]] = msg.velocity[i]
         for i in range(len(u_temp)):
-            u_temp[act_map[msg.effort_names[i]]] = msg.effort[i]
+            u_temp[act_map[effort_names[i]]] = msg.effort[i]
         q.append(q_temp)
         v.append(v_temp)
         u.append(u_temp)
@@ -241,20 +282,28 @@ def process_contact_channel(data):
             'p_lambda_c': contact_info_locs}
 
 
-def permute_osc_joint_ordering(osc_data, robot_output_msg, plant):
-    _, vperm, uperm = make_joint_order_permutations(robot_output_msg, plant)
+def permute_osc_joint_ordering(osc_data, robot_output_msg, plant,
+                               layout_data=None):
+    _, vperm, uperm = make_joint_order_permutations(robot_output_msg, plant,
+                                                    layout_data)
     osc_data['u_sol'] = (osc_data['u_sol'] @ uperm.T)
     osc_data['dv_sol'] = (osc_data['dv_sol'] @ vperm.T)
     return osc_data
 
 
 def load_default_channels(data, plant, state_channel, input_channel,
-                          osc_debug_channel):
-    robot_output = process_state_channel(data[state_channel], plant)
+                          osc_debug_channel, layout_channel=None):
+    """ The layout channel defaults to state_channel + '_LAYOUT', and is only
+    needed for compact state messages whose layout differs from the plant """
+    if layout_channel is None:
+        layout_channel = state_channel + '_LAYOUT'
+    layout_data = data.get(layout_channel)
+    robot_output = process_state_channel(data[state_channel], plant,
+                                         layout_data)
     robot_input = process_effort_channel(data[input_channel], plant)
     osc_debug = process_osc_channel(data[osc_debug_channel])
     osc_debug = permute_osc_joint_ordering(
-        osc_debug, data[state_channel][0], plant)
+        osc_debug, data[state_channel][0], plant, layout_data)
 
     return robot_output, robot_input, osc_debug
 
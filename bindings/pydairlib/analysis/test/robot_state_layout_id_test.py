@@ -0,0 +1,41 @@
+import unittest
+
+from mbp_plotting_utils import robot_state_layout_id
+from pydairlib.systems.robot_lcm_systems import RobotStateLayoutId
+
+
+class RobotStateLayoutIdTest(unittest.TestCase):
+    """ The layout ids of the plotting utilities must match the ones of
+    RobotOutputSender, which resolves compact messages by id """
+
+    names = [
+        ([], [], []),
+        (['base_x', 'hip_pin'], ['base_xdot', 'hip_pindot'], ['hip_torque']),
+        # Same names, moved from one list to the next
+        (['base_x', 'hip_pin', 'base_xdot'], ['hip_pindot'], ['hip_torque']),
+        (['gelenk_ü'], ['gelenk_üdot'], []),
+    ]
+
+    def test_matches_cpp(self):
+        for position_names, velocity_names, effort_names in self.names:
+            self.assertEqual(
+                robot_state_layout_id(position_names, velocity_names,
+                                      effort_names),
+                RobotStateLayoutId(position_names, velocity_names,
+                                   effort_names))
+
+    def test_known_values(self):
+        # From the C++ implementation, as signed 64-bit integers like the
+        # layout_id field of the messages
+        self.assertEqual(robot_state_layout_id([], [], []),
+                         -8124929027759675468)
+        self.assertEqual(robot_state_layout_id(*self.names[1]),
+                         -8760330431511635604)
+
+    def test_order_changes_id(self):
+        ids = {robot_state_layout_id(*names) for names in self.names}
+        self.assertEqual(len(ids), len(self.names))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -19,20 +19,34 @@ PYBIND11_MODULE(robot_lcm_systems, m) {
   using drake::multibody::MultibodyPlant;
   using systems::RobotOutputSender;
 
+  m.def("RobotStateLayoutId", &systems::RobotStateLayoutId,
+        py::arg("position_names"), py::arg("velocity_names"),
+        py::arg("effort_names"));
+  py::enum_<systems::RobotStateFormat>(m, "RobotStateFormat")
+      .value("kNamed", systems::RobotStateFormat::kNamed)
+      .value("kCompact", systems::RobotStateFormat::kCompact);
   py::class_<systems::RobotOutputReceiver, drake::systems::LeafSystem<double>>(
       m, "RobotOutputReceiver")
-      .def(py::init<const MultibodyPlant<double>&>());
+      .def(py::init<const MultibodyPlant<double>&>())
+      .def(py::init<const MultibodyPlant<double>&, systems::RobotStateFormat>())
+      .def("get_input_port_layout",
+          &systems::RobotOutputReceiver::get_input_port_layout,
+          py_rvp::reference_internal);
   py::class_<systems::RobotInputReceiver, drake::systems::LeafSystem<double>>(
       m, "RobotInputReceiver")
       .def(py::init<const MultibodyPlant<double>&>());
   py::class_<RobotOutputSender, drake::systems::LeafSystem<double>>(
       m, "RobotOutputSender")
       .def(py::init<const MultibodyPlant<double>&, bool>())
+      .def(py::init<const MultibodyPlant<double>&, bool, bool,
+                    systems::RobotStateFormat>())
       .def("get_input_port_state", &RobotOutputSender::get_input_port_state,
           py_rvp::reference_internal)
       .def("get_input_port_effort", &RobotOutputSender::get_input_port_effort,
           py_rvp::reference_internal)
       .def("get_input_port_imu", &RobotOutputSender::get_input_port_imu,
+          py_rvp::reference_internal)
+      .def("get_output_port_layout", &RobotOutputSender::get_output_port_layout,
           py_rvp::reference_internal);
   py::class_<systems::RobotCommandSender, drake::systems::LeafSystem<double>>(
       m, "RobotCommandSender")
@@ -0,0 +1,96 @@
+#include "common/allocation_counter.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Plain thread locals with the initial-exec model, so that reading them from
+// inside malloc never allocates
+__attribute__((tls_model("initial-exec"))) thread_local int64_t
+    num_allocations = 0;
+__attribute__((tls_model("initial-exec"))) thread_local int num_counters = 0;
+
+inline void Count() {
+  if (num_counters > 0) {
+    ++num_allocations;
+  }
+}
+
+}  // namespace
+
+namespace dairlib {
+
+AllocationCounter::AllocationCounter() : start_(num_allocations) {
+  ++num_counters;
+}
+
+AllocationCounter::~AllocationCounter() { --num_counters; }
+
+int64_t AllocationCounter::count() const {
+  return num_allocations - start_;
+}
+
+}  // namespace dairlib
+
+#if defined(__GLIBC__)
+
+// Every allocation (operator new, Eigen's aligned_malloc, ...) ends up in one
+// of these
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t n, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+
+void* malloc(size_t size) {
+  Count();
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+  Count();
+  return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+  Count();
+  return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+  Count();
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+  Count();
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+  Count();
+  *ptr = __libc_memalign(alignment, size);
+  return *ptr == nullptr ? ENOMEM : 0;
+}
+}  // extern "C"
+
+#else
+
+void* operator new(std::size_t size) {
+  Count();
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+#endif
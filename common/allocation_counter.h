@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+
+/// Test hook that counts the heap allocations made by the calling thread
+/// while an AllocationCounter is alive, e.g. to check that a real-time code
+/// path does not allocate in steady state:
+///
+///   AllocationCounter counter;
+///   solver.Solve(...);
+///   EXPECT_EQ(counter.count(), 0);
+///
+/// Linking //common:allocation_counter replaces malloc and friends (on glibc)
+/// or the global operator new (elsewhere) of the whole binary, so it should
+/// only be a dependency of tests and benchmarks. Eigen allocates with
+/// std::malloc, which is why replacing operator new alone is not enough.
+class AllocationCounter {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(AllocationCounter)
+
+  AllocationCounter();
+  ~AllocationCounter();
+
+  /// Number of allocations since construction
+  int64_t count() const;
+
+ private:
+  int64_t start_;
+};
+
+}  // namespace dairlib
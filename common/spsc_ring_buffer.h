@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#include "drake/common/drake_assert.h"
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+
+/// Bounded lock-free ring buffer for exactly one producer thread and one
+/// consumer thread. Push() and Pop() never block or allocate; Push() fails
+/// when the buffer is full and Pop() fails when it is empty. The storage is
+/// allocated once in the constructor, with the capacity rounded up to a power
+/// of two.
+template <typename T>
+class SpscRingBuffer {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(SpscRingBuffer)
+
+  explicit SpscRingBuffer(int capacity) {
+    DRAKE_DEMAND(capacity > 0);
+    size_t size = 1;
+    while (size < static_cast<size_t>(capacity)) size <<= 1;
+    buffer_.resize(size);
+    mask_ = size - 1;
+  }
+
+  /// Producer side. Returns false (and drops `value`) if the buffer is full.
+  bool Push(const T& value) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == buffer_.size()) {
+      return false;
+    }
+    buffer_[head & mask_] = value;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side. Returns false if the buffer is empty.
+  bool Pop(T* value) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *value = buffer_[tail & mask_];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Number of elements currently in the buffer. Only exact when called from
+  /// one of the two threads while the other is idle.
+  int size() const {
+    return static_cast<int>(head_.load(std::memory_order_acquire) -
+                            tail_.load(std::memory_order_acquire));
+  }
+  int capacity() const { return static_cast<int>(buffer_.size()); }
+
+ private:
+  std::vector<T> buffer_;
+  size_t mask_;
+  // Monotonic write and read counters, kept on separate cache lines so the
+  // two threads do not false share
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace dairlib
@@ -0,0 +1,87 @@
+#include "common/stage_timer.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "drake/common/drake_assert.h"
+
+namespace dairlib {
+
+StageTimer::StageTimer(const std::vector<std::string>& stage_names,
+                       int capacity)
+    : stage_names_(stage_names), buffer_(capacity) {
+  DRAKE_DEMAND(static_cast<int>(stage_names_.size()) < kMaxStages);
+  current_.fill(0);
+  samples_.reserve(buffer_.capacity());
+  values_.reserve(buffer_.capacity());
+}
+
+const std::vector<float>& StageTimer::BinEdges() {
+  static const std::vector<float> edges = {
+      1,    2,    5,    10,   20,   50,   100,
+      200,  500,  1000, 2000, 5000, std::numeric_limits<float>::infinity()};
+  return edges;
+}
+
+void StageTimer::BeginTick() {
+  if (tick_open_ && !buffer_.Push(current_)) {
+    num_dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+  current_.fill(0);
+  tick_open_ = true;
+  mark_ = Clock::now();
+}
+
+void StageTimer::CollectStatistics(lcmt_stage_timing* msg) {
+  samples_.clear();
+  Sample sample;
+  while (static_cast<int>(samples_.size()) < buffer_.capacity() &&
+         buffer_.Pop(&sample)) {
+    samples_.push_back(sample);
+  }
+  // The total of a tick is stored in the slot after the last stage
+  const int n_stages = num_stages();
+  for (auto& s : samples_) {
+    float total = 0;
+    for (int i = 0; i < n_stages; ++i) {
+      total += s[i];
+    }
+    s[n_stages] = total;
+  }
+
+  const std::vector<float>& edges = BinEdges();
+  const int n_bins = edges.size();
+  const int n_samples = samples_.size();
+  msg->num_samples = n_samples;
+  msg->num_dropped = num_dropped_.exchange(0, std::memory_order_relaxed);
+  msg->num_stages = n_stages + 1;
+  msg->num_bins = n_bins;
+  msg->stage_names = stage_names_;
+  msg->stage_names.push_back("total");
+  msg->bin_edges_us = edges;
+  msg->counts.assign(n_stages + 1, std::vector<int32_t>(n_bins, 0));
+  msg->p50_us.assign(n_stages + 1, 0);
+  msg->p99_us.assign(n_stages + 1, 0);
+  msg->max_us.assign(n_stages + 1, 0);
+  if (n_samples == 0) return;
+
+  for (int i = 0; i <= n_stages; ++i) {
+    values_.clear();
+    for (const auto& s : samples_) {
+      values_.push_back(s[i]);
+      const int bin =
+          std::lower_bound(edges.begin(), edges.end(), s[i]) - edges.begin();
+      msg->counts[i][std::min(bin, n_bins - 1)]++;
+    }
+    auto nth = [&](double quantile) {
+      auto it = values_.begin() + static_cast<int>(quantile * (n_samples - 1));
+      std::nth_element(values_.begin(), it, values_.end());
+      return *it;
+    };
+    msg->p50_us[i] = nth(0.5);
+    msg->p99_us[i] = nth(0.99);
+    msg->max_us[i] = *std::max_element(values_.begin(), values_.end());
+  }
+}
+
+}  // namespace dairlib
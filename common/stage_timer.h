@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "common/spsc_ring_buffer.h"
+#include "dairlib/lcmt_stage_timing.hpp"
+
+namespace dairlib {
+
+/// Low-overhead latency instrumentation of the stages of a periodic
+/// computation (e.g. one controller tick).
+///
+/// The producer (the thread running the computation) calls BeginTick() at the
+/// start of each tick and Lap(stage) at the end of each stage, which charges
+/// the time since the previous Lap() (or BeginTick()) to `stage`. Work that
+/// happens outside of the straight line code of the tick can be charged with
+/// a ScopedStage instead. The per-stage times of a tick are pushed into a
+/// lock-free ring buffer by the next BeginTick(); nothing is allocated on the
+/// producer side.
+///
+/// The consumer periodically calls CollectStatistics(), which drains the
+/// buffer and summarizes the samples as a histogram plus p50/p99/max per
+/// stage. A "total" entry (sum over the stages of a tick) is appended.
+class StageTimer {
+ public:
+  static constexpr int kMaxStages = 32;
+
+  /// @param stage_names name of each stage, indexed by the stage ids passed
+  /// to Lap() and ScopedStage
+  /// @param capacity number of ticks buffered between two calls to
+  /// CollectStatistics(). Ticks that do not fit are counted as dropped.
+  explicit StageTimer(const std::vector<std::string>& stage_names,
+                      int capacity = 1024);
+
+  void BeginTick();
+  void Lap(int stage) {
+    const auto now = Clock::now();
+    current_[stage] +=
+        std::chrono::duration<float, std::micro>(now - mark_).count();
+    mark_ = now;
+  }
+
+  /// Charges the lifetime of the object to `stage` without moving the lap
+  /// mark.
+  class ScopedStage {
+   public:
+    ScopedStage(StageTimer* timer, int stage)
+        : timer_(timer),
+          stage_(stage),
+          start_(std::chrono::steady_clock::now()) {}
+    ~ScopedStage() {
+      timer_->current_[stage_] += std::chrono::duration<float, std::micro>(
+                                      std::chrono::steady_clock::now() - start_)
+                                      .count();
+    }
+
+   private:
+    StageTimer* timer_;
+    int stage_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  /// Consumer side. Drains the buffered ticks into `msg` (utime is left to
+  /// the caller).
+  void CollectStatistics(lcmt_stage_timing* msg);
+
+  int num_stages() const { return stage_names_.size(); }
+  /// Upper edges of the histogram bins in microseconds (1-2-5 series). The
+  /// last bin is unbounded.
+  static const std::vector<float>& BinEdges();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  using Sample = std::array<float, kMaxStages>;
+
+  std::vector<std::string> stage_names_;
+  SpscRingBuffer<Sample> buffer_;
+  std::atomic<int> num_dropped_{0};
+
+  // Producer state
+  Sample current_;
+  bool tick_open_ = false;
+  Clock::time_point mark_;
+
+  // Consumer scratch space
+  std::vector<Sample> samples_;
+  std::vector<float> values_;
+};
+
+}  // namespace dairlib
@@ -0,0 +1,38 @@
+#include "common/allocation_counter.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace {
+
+TEST(AllocationCounterTest, CountsAllocations) {
+  Eigen::VectorXd preallocated = Eigen::VectorXd::Zero(100);
+  AllocationCounter counter;
+  // Eigen allocates with malloc, not operator new
+  Eigen::VectorXd v = Eigen::VectorXd::Ones(100);
+  EXPECT_EQ(counter.count(), 1);
+  auto p = std::make_unique<int>(1);
+  EXPECT_EQ(counter.count(), 2);
+  // Reusing storage does not allocate
+  preallocated = 2 * v;
+  preallocated.noalias() += v;
+  EXPECT_EQ(counter.count(), 2);
+}
+
+TEST(AllocationCounterTest, OtherThreadsAreNotCounted) {
+  AllocationCounter counter;
+  std::vector<int> allocated_by_other_thread;
+  // Creating the thread itself allocates on this thread
+  std::thread thread([&]() { allocated_by_other_thread.resize(1000); });
+  const int64_t count = counter.count();
+  thread.join();
+  EXPECT_EQ(counter.count(), count);
+}
+
+}  // namespace
+}  // namespace dairlib
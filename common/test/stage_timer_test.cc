@@ -0,0 +1,87 @@
+#include "common/stage_timer.h"
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace {
+
+TEST(SpscRingBufferTest, FullAndEmpty) {
+  SpscRingBuffer<int> buffer(3);
+  ASSERT_EQ(buffer.capacity(), 4);
+
+  int value;
+  EXPECT_FALSE(buffer.Pop(&value));
+  // Wrap around the storage a few times
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_TRUE(buffer.Push(10 * round + i));
+    }
+    EXPECT_FALSE(buffer.Push(-1));
+    EXPECT_EQ(buffer.size(), 4);
+    for (int i = 0; i < 4; ++i) {
+      ASSERT_TRUE(buffer.Pop(&value));
+      EXPECT_EQ(value, 10 * round + i);
+    }
+    EXPECT_FALSE(buffer.Pop(&value));
+  }
+}
+
+TEST(SpscRingBufferTest, TwoThreads) {
+  const int n = 10000;
+  SpscRingBuffer<int> buffer(64);
+  std::thread producer([&]() {
+    for (int i = 0; i < n; ++i) {
+      while (!buffer.Push(i)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  int expected = 0;
+  int value;
+  while (expected < n) {
+    if (buffer.Pop(&value)) {
+      ASSERT_EQ(value, expected);
+      ++expected;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+}
+
+TEST(StageTimerTest, Statistics) {
+  StageTimer timer({"a", "b"}, 8);
+  // Only ticks that have been closed by the next BeginTick() are reported
+  for (int i = 0; i < 5; ++i) {
+    timer.BeginTick();
+    timer.Lap(0);
+    { StageTimer::ScopedStage scoped(&timer, 1); }
+  }
+  lcmt_stage_timing msg;
+  timer.CollectStatistics(&msg);
+  EXPECT_EQ(msg.num_samples, 4);
+  EXPECT_EQ(msg.num_dropped, 0);
+  ASSERT_EQ(msg.num_stages, 3);
+  EXPECT_EQ(msg.stage_names.back(), "total");
+  ASSERT_EQ(msg.num_bins, static_cast<int>(StageTimer::BinEdges().size()));
+  for (int i = 0; i < msg.num_stages; ++i) {
+    int count = 0;
+    for (int c : msg.counts[i]) count += c;
+    EXPECT_EQ(count, 4);
+    EXPECT_LE(msg.p50_us[i], msg.p99_us[i]);
+    EXPECT_LE(msg.p99_us[i], msg.max_us[i]);
+  }
+
+  // Overflowing the buffer drops ticks instead of blocking
+  for (int i = 0; i < 20; ++i) {
+    timer.BeginTick();
+  }
+  timer.CollectStatistics(&msg);
+  EXPECT_EQ(msg.num_samples, 8);
+  EXPECT_EQ(msg.num_dropped, 12);
+}
+
+}  // namespace
+}  // namespace dairlib
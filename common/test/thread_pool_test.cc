@@ -0,0 +1,49 @@
+#include "common/thread_pool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace {
+
+TEST(ThreadPoolTest, EachIndexOnce) {
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.num_threads(), 4);
+  // Reuse the pool for loops of different sizes
+  for (int n : {0, 1, 3, 100, 1000}) {
+    std::vector<std::atomic<int>> calls(n);
+    pool.ParallelFor(n, [&](int i) { calls[i]++; });
+    for (int i = 0; i < n; ++i) {
+      EXPECT_EQ(calls[i], 1);
+    }
+  }
+}
+
+TEST(ThreadPoolTest, SingleThread) {
+  ThreadPool pool(1);
+  std::vector<int> order;
+  pool.ParallelFor(5, [&](int i) { order.push_back(i); });
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
+
+TEST(ThreadPoolTest, Exception) {
+  ThreadPool pool(3);
+  std::atomic<int> num_calls{0};
+  EXPECT_THROW(pool.ParallelFor(50,
+                                [&](int i) {
+                                  num_calls++;
+                                  if (i == 7) throw std::runtime_error("7");
+                                }),
+               std::runtime_error);
+  EXPECT_EQ(num_calls, 50);
+  // The pool is still usable
+  num_calls = 0;
+  pool.ParallelFor(20, [&](int i) { num_calls++; });
+  EXPECT_EQ(num_calls, 20);
+}
+
+}  // namespace
+}  // namespace dairlib
@@ -0,0 +1,86 @@
+#include "common/thread_pool.h"
+
+#include <algorithm>
+
+namespace dairlib {
+
+ThreadPool::ThreadPool(int num_threads) {
+  if (num_threads < 1) {
+    num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (int i = 0; i < num_threads - 1; ++i) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::ParallelFor(int n, const std::function<void(int)>& f) {
+  if (n <= 0) return;
+  std::lock_guard<std::mutex> loop_lock(loop_mutex_);
+  if (workers_.empty() || n == 1) {
+    for (int i = 0; i < n; ++i) f(i);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    f_ = &f;
+    n_ = n;
+    next_index_ = 0;
+    exception_ = nullptr;
+    num_busy_workers_ = workers_.size();
+    generation_++;
+  }
+  start_.notify_all();
+  RunIndices();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_.wait(lock, [this]() { return num_busy_workers_ == 0; });
+  f_ = nullptr;
+  if (exception_) {
+    std::rethrow_exception(exception_);
+  }
+}
+
+void ThreadPool::RunIndices() {
+  for (;;) {
+    const int i = next_index_.fetch_add(1);
+    if (i >= n_) return;
+    try {
+      (*f_)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!exception_) exception_ = std::current_exception();
+    }
+  }
+}
+
+void ThreadPool::WorkerLoop() {
+  int64_t generation = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_.wait(lock,
+                  [&]() { return stop_ || generation_ != generation; });
+      if (stop_) return;
+      generation = generation_;
+    }
+    RunIndices();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      num_busy_workers_--;
+    }
+    done_.notify_one();
+  }
+}
+
+}  // namespace dairlib
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+
+/// A fixed set of worker threads for data-parallel loops.
+///
+/// ParallelFor(n, f) calls f(0), ..., f(n - 1), distributed dynamically over
+/// the workers and the calling thread, and returns once all calls have
+/// returned. If a call throws, the remaining indices are still processed and
+/// the first exception is rethrown to the caller. Calls to ParallelFor() from
+/// different threads are serialized; ParallelFor() must not be called from
+/// inside f.
+class ThreadPool {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(ThreadPool)
+
+  /// @param num_threads total number of threads working on a loop, including
+  /// the calling thread (so num_threads - 1 workers are started). Values
+  /// below 1 use std::thread::hardware_concurrency().
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  int num_threads() const { return workers_.size() + 1; }
+
+  void ParallelFor(int n, const std::function<void(int)>& f);
+
+ private:
+  void WorkerLoop();
+  // Runs loop indices until there are none left
+  void RunIndices();
+
+  std::vector<std::thread> workers_;
+  // Serializes ParallelFor() calls
+  std::mutex loop_mutex_;
+
+  // Current loop, guarded by mutex_ (except for the atomics)
+  std::mutex mutex_;
+  std::condition_variable start_;
+  std::condition_variable done_;
+  const std::function<void(int)>* f_ = nullptr;
+  int n_ = 0;
+  std::atomic<int> next_index_{0};
+  int64_t generation_ = 0;
+  int num_busy_workers_ = 0;
+  std::exception_ptr exception_;
+  bool stop_ = false;
+};
+
+}  // namespace dairlib
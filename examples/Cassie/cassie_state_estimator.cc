@@ -40,6 +40,43 @@ using systems::OutputVector;
 
 static const int SPACE_DIM = 3;
 
+CassieStateEstimatorWorkspace::CassieStateEstimatorWorkspace(
+    const MultibodyPlant<double>& plant)
+    : f_app(plant) {
+  Resize(plant);
+}
+
+CassieStateEstimatorWorkspace& CassieStateEstimatorWorkspace::operator=(
+    const CassieStateEstimatorWorkspace& other) {
+  if (other.plant != plant) {
+    Resize(*other.plant);
+  }
+  return *this;
+}
+
+void CassieStateEstimatorWorkspace::Resize(
+    const MultibodyPlant<double>& plant) {
+  this->plant = &plant;
+  const int n_v = plant.num_velocities();
+  filtered_output = std::make_unique<OutputVector<double>>(
+      plant.num_positions(), n_v, plant.num_actuators());
+  output_gt = std::make_unique<OutputVector<double>>(
+      plant.num_positions(), n_v, plant.num_actuators());
+  J = MatrixXd::Zero(SPACE_DIM, n_v);
+  lambda_est = VectorXd::Zero(2 * SPACE_DIM);
+  M.resize(n_v, n_v);
+  C.resize(n_v);
+  tau_d.resize(n_v);
+  f_app = drake::multibody::MultibodyForces<double>(plant);
+  J_contact.resize(SPACE_DIM, n_v);
+  SJt.resize(n_v, SPACE_DIM);
+  S_tau_d.resize(n_v);
+  qr = Eigen::ColPivHouseholderQR<MatrixXd>(n_v, SPACE_DIM);
+  // Two points per foot
+  measured_kinematics.reserve(4);
+  contacts.reserve(4);
+}
+
 CassieStateEstimator::CassieStateEstimator(
     const MultibodyPlant<double>& plant,
     const KinematicEvaluatorSet<double>* fourbar_evaluator,
@@ -75,6 +112,7 @@ CassieStateEstimator::CassieStateEstimator(
   n_q_ = plant.num_positions();
   n_v_ = plant.num_velocities();
   n_u_ = plant.num_actuators();
+  B_ = plant.MakeActuationMatrix();
 
   // Declare input/output ports
   cassie_out_input_port_ = this->DeclareAbstractInputPort(
@@ -90,6 +128,22 @@ CassieStateEstimator::CassieStateEstimator(
   actuator_idx_map_ = multibody::MakeNameToActuatorsMap(plant);
   position_idx_map_ = multibody::MakeNameToPositionsMap(plant);
   velocity_idx_map_ = multibody::MakeNameToVelocitiesMap(plant);
+  const vector<string> drives = {"hip_roll", "hip_yaw", "hip_pitch", "knee",
+                                 "toe"};
+  const vector<string> joints = {"knee_joint", "ankle_joint",
+                                 "ankle_spring_joint"};
+  const vector<string> sides = {"_left", "_right"};
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 8; j++) {
+      const string name = (j < 5 ? drives[j] : joints[j - 5]) + sides[i];
+      leg_idx_[i].positions[j] = position_idx_map_.at(name);
+      leg_idx_[i].velocities[j] = velocity_idx_map_.at(name + "dot");
+    }
+    for (int j = 0; j < 5; j++) {
+      leg_idx_[i].efforts[j] = actuator_idx_map_.at(drives[j] + sides[i] +
+                                                    "_motor");
+    }
+  }
 
   if (is_floating_base_) {
     contact_output_port_ =
@@ -119,6 +173,18 @@ CassieStateEstimator::CassieStateEstimator(
     // a state which stores previous timestamp
     time_idx_ = DeclareDiscreteState(VectorXd::Zero(1));
 
+    const vector<string> base_positions = {"base_qw", "base_qx", "base_qy",
+                                           "base_qz", "base_x",  "base_y",
+                                           "base_z"};
+    const vector<string> base_velocities = {"base_wx", "base_wy", "base_wz",
+                                            "base_vx", "base_vy", "base_vz"};
+    for (int i = 0; i < 7; i++) {
+      base_position_idx_[i] = position_idx_map_.at(base_positions[i]);
+    }
+    for (int i = 0; i < 6; i++) {
+      base_velocity_idx_[i] = velocity_idx_map_.at(base_velocities[i]);
+    }
+
     // Joint selection matrices initialization
     joint_selection_matrices.emplace_back(MatrixXd::Zero(n_v_, n_v_));
     joint_selection_matrices.emplace_back(MatrixXd::Zero(n_v_, n_v_));
@@ -164,6 +230,9 @@ CassieStateEstimator::CassieStateEstimator(
     // 2. estimated EKF state (imu frame)
     inekf::InEKF value(initial_state, noise_params);
     ekf_idx_ = DeclareAbstractState(*AbstractValue::Make<inekf::InEKF>(value));
+    workspace_idx_ = DeclareAbstractState(
+        drake::Value<CassieStateEstimatorWorkspace>(
+            CassieStateEstimatorWorkspace(plant)));
 
     // 3. state for previous imu value
     // Measured accelrometer should point toward positive z when the robot rests
@@ -224,12 +293,17 @@ CassieStateEstimator::CassieStateEstimator(
 void CassieStateEstimator::solveFourbarLinkage(
     const VectorXd& q, double* left_heel_spring,
     double* right_heel_spring) const {
+  plant_.SetPositions(context_.get(), q);
+  SolveFourbarLinkageInContext(left_heel_spring, right_heel_spring);
+}
+
+void CassieStateEstimator::SolveFourbarLinkageInContext(
+    double* left_heel_spring, double* right_heel_spring) const {
   // Get the spring length
   double spring_length = rod_on_heel_springs_[0].first.norm();
   // Spring rest angle offset
   double spring_rest_offset =
       atan2(rod_on_heel_springs_[0].first(1), rod_on_heel_springs_[0].first(0));
-  plant_.SetPositions(context_.get(), q);
 
   for (int i = 0; i < 2; i++) {
     // Get thigh pose and heel spring pose
@@ -315,27 +389,16 @@ void CassieStateEstimator::AssignImuValueToOutputVector(
 void CassieStateEstimator::AssignActuationFeedbackToOutputVector(
     const cassie_out_t& cassie_out, OutputVector<double>* output) const {
   // Copy actuators
-  output->SetEffortAtIndex(actuator_idx_map_.at("hip_roll_left_motor"),
-                           cassie_out.leftLeg.hipRollDrive.torque);
-  output->SetEffortAtIndex(actuator_idx_map_.at("hip_yaw_left_motor"),
-                           cassie_out.leftLeg.hipYawDrive.torque);
-  output->SetEffortAtIndex(actuator_idx_map_.at("hip_pitch_left_motor"),
-                           cassie_out.leftLeg.hipPitchDrive.torque);
-  output->SetEffortAtIndex(actuator_idx_map_.at("knee_left_motor"),
-                           cassie_out.leftLeg.kneeDrive.torque);
-  output->SetEffortAtIndex(actuator_idx_map_.at("toe_left_motor"),
-                           cassie_out.leftLeg.footDrive.torque);
-
-  output->SetEffortAtIndex(actuator_idx_map_.at("hip_roll_right_motor"),
-                           cassie_out.rightLeg.hipRollDrive.torque);
-  output->SetEffortAtIndex(actuator_idx_map_.at("hip_yaw_right_motor"),
-                           cassie_out.rightLeg.hipYawDrive.torque);
-  output->SetEffortAtIndex(actuator_idx_map_.at("hip_pitch_right_motor"),
-                           cassie_out.rightLeg.hipPitchDrive.torque);
-  output->SetEffortAtIndex(actuator_idx_map_.at("knee_right_motor"),
-                           cassie_out.rightLeg.kneeDrive.torque);
-  output->SetEffortAtIndex(actuator_idx_map_.at("toe_right_motor"),
-                           cassie_out.rightLeg.footDrive.torque);
+  for (int i = 0; i < 2; i++) {
+    const cassie_leg_out_t& leg =
+        (i == 0) ? cassie_out.leftLeg : cassie_out.rightLeg;
+    const auto& idx = leg_idx_[i].efforts;
+    output->SetEffortAtIndex(idx[0], leg.hipRollDrive.torque);
+    output->SetEffortAtIndex(idx[1], leg.hipYawDrive.torque);
+    output->SetEffortAtIndex(idx[2], leg.hipPitchDrive.torque);
+    output->SetEffortAtIndex(idx[3], leg.kneeDrive.torque);
+    output->SetEffortAtIndex(idx[4], leg.footDrive.torque);
+  }
 }
 
 void CassieStateEstimator::AssignNonFloatingBaseStateToOutputVector(
@@ -343,112 +406,58 @@ void CassieStateEstimator::AssignNonFloatingBaseStateToOutputVector(
   // Copy the robot state excluding floating base
   // TODO(yuming): check what cassie_out.leftLeg.footJoint.position is.
   // Similarly, the other leg and the velocity of these joints.
-  output->SetPositionAtIndex(position_idx_map_.at("hip_roll_left"),
-                             cassie_out.leftLeg.hipRollDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("hip_yaw_left"),
-                             cassie_out.leftLeg.hipYawDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("hip_pitch_left"),
-                             cassie_out.leftLeg.hipPitchDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("knee_left"),
-                             cassie_out.leftLeg.kneeDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("toe_left"),
-                             cassie_out.leftLeg.footDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("knee_joint_left"),
-                             cassie_out.leftLeg.shinJoint.position);
-  output->SetPositionAtIndex(position_idx_map_.at("ankle_joint_left"),
-                             cassie_out.leftLeg.tarsusJoint.position);
-  output->SetPositionAtIndex(position_idx_map_.at("ankle_spring_joint_left"),
-                             0.0);
-
-  output->SetPositionAtIndex(position_idx_map_.at("hip_roll_right"),
-                             cassie_out.rightLeg.hipRollDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("hip_yaw_right"),
-                             cassie_out.rightLeg.hipYawDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("hip_pitch_right"),
-                             cassie_out.rightLeg.hipPitchDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("knee_right"),
-                             cassie_out.rightLeg.kneeDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("toe_right"),
-                             cassie_out.rightLeg.footDrive.position);
-  output->SetPositionAtIndex(position_idx_map_.at("knee_joint_right"),
-                             cassie_out.rightLeg.shinJoint.position);
-  output->SetPositionAtIndex(position_idx_map_.at("ankle_joint_right"),
-                             cassie_out.rightLeg.tarsusJoint.position);
-  output->SetPositionAtIndex(position_idx_map_.at("ankle_spring_joint_right"),
-                             0.0);
-
-  output->SetVelocityAtIndex(velocity_idx_map_.at("hip_roll_leftdot"),
-                             cassie_out.leftLeg.hipRollDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("hip_yaw_leftdot"),
-                             cassie_out.leftLeg.hipYawDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("hip_pitch_leftdot"),
-                             cassie_out.leftLeg.hipPitchDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("knee_leftdot"),
-                             cassie_out.leftLeg.kneeDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("toe_leftdot"),
-                             cassie_out.leftLeg.footDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("knee_joint_leftdot"),
-                             cassie_out.leftLeg.shinJoint.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("ankle_joint_leftdot"),
-                             cassie_out.leftLeg.tarsusJoint.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("ankle_spring_joint_leftdot"),
-                             0.0);
-
-  output->SetVelocityAtIndex(velocity_idx_map_.at("hip_roll_rightdot"),
-                             cassie_out.rightLeg.hipRollDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("hip_yaw_rightdot"),
-                             cassie_out.rightLeg.hipYawDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("hip_pitch_rightdot"),
-                             cassie_out.rightLeg.hipPitchDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("knee_rightdot"),
-                             cassie_out.rightLeg.kneeDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("toe_rightdot"),
-                             cassie_out.rightLeg.footDrive.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("knee_joint_rightdot"),
-                             cassie_out.rightLeg.shinJoint.velocity);
-  output->SetVelocityAtIndex(velocity_idx_map_.at("ankle_joint_rightdot"),
-                             cassie_out.rightLeg.tarsusJoint.velocity);
-  output->SetVelocityAtIndex(
-      velocity_idx_map_.at("ankle_spring_joint_rightdot"), 0.0);
+  for (int i = 0; i < 2; i++) {
+    const cassie_leg_out_t& leg =
+        (i == 0) ? cassie_out.leftLeg : cassie_out.rightLeg;
+    const auto& q_idx = leg_idx_[i].positions;
+    output->SetPositionAtIndex(q_idx[0], leg.hipRollDrive.position);
+    output->SetPositionAtIndex(q_idx[1], leg.hipYawDrive.position);
+    output->SetPositionAtIndex(q_idx[2], leg.hipPitchDrive.position);
+    output->SetPositionAtIndex(q_idx[3], leg.kneeDrive.position);
+    output->SetPositionAtIndex(q_idx[4], leg.footDrive.position);
+    output->SetPositionAtIndex(q_idx[5], leg.shinJoint.position);
+    output->SetPositionAtIndex(q_idx[6], leg.tarsusJoint.position);
+    output->SetPositionAtIndex(q_idx[7], 0.0);
+
+    const auto& v_idx = leg_idx_[i].velocities;
+    output->SetVelocityAtIndex(v_idx[0], leg.hipRollDrive.velocity);
+    output->SetVelocityAtIndex(v_idx[1], leg.hipYawDrive.velocity);
+    output->SetVelocityAtIndex(v_idx[2], leg.hipPitchDrive.velocity);
+    output->SetVelocityAtIndex(v_idx[3], leg.kneeDrive.velocity);
+    output->SetVelocityAtIndex(v_idx[4], leg.footDrive.velocity);
+    output->SetVelocityAtIndex(v_idx[5], leg.shinJoint.velocity);
+    output->SetVelocityAtIndex(v_idx[6], leg.tarsusJoint.velocity);
+    output->SetVelocityAtIndex(v_idx[7], 0.0);
+  }
 
   // Solve fourbar linkage for heel spring positions
   double left_heel_spring = 0;
   double right_heel_spring = 0;
-  VectorXd q = output->GetPositions() + joint_offsets_;
-  output->SetPositions(q);
-  
+  output->GetMutablePositions() += joint_offsets_;
+  plant_.SetPositions(context_.get(), output->GetMutablePositions());
+
   if (is_floating_base_) {
     // Floating-base state doesn't affect the spring values
     // We assign the floating base of q in case output's floating base is
     // not initialized.
-    for (int i = 0; i < 7; i++) {
-      q[i] = 0;
-    }
-    q[0] = 1;
+    auto q = plant_.GetMutablePositions(context_.get());
+    q.head(7).setZero();
+    q(0) = 1;
   }
-  solveFourbarLinkage(q, &left_heel_spring, &right_heel_spring);
-  output->SetPositionAtIndex(position_idx_map_.at("ankle_spring_joint_left"),
-                             left_heel_spring);
-  output->SetPositionAtIndex(position_idx_map_.at("ankle_spring_joint_right"),
-                             right_heel_spring);
+  SolveFourbarLinkageInContext(&left_heel_spring, &right_heel_spring);
+  output->SetPositionAtIndex(leg_idx_[0].positions[7], left_heel_spring);
+  output->SetPositionAtIndex(leg_idx_[1].positions[7], right_heel_spring);
 }
 
 void CassieStateEstimator::AssignFloatingBaseStateToOutputVector(
-    const VectorXd& est_fb_state, OutputVector<double>* output) const {
-  output->SetPositionAtIndex(position_idx_map_.at("base_qw"), est_fb_state(0));
-  output->SetPositionAtIndex(position_idx_map_.at("base_qx"), est_fb_state(1));
-  output->SetPositionAtIndex(position_idx_map_.at("base_qy"), est_fb_state(2));
-  output->SetPositionAtIndex(position_idx_map_.at("base_qz"), est_fb_state(3));
-  output->SetPositionAtIndex(position_idx_map_.at("base_x"), est_fb_state(4));
-  output->SetPositionAtIndex(position_idx_map_.at("base_y"), est_fb_state(5));
-  output->SetPositionAtIndex(position_idx_map_.at("base_z"), est_fb_state(6));
-
-  output->SetVelocityAtIndex(velocity_idx_map_.at("base_wx"), est_fb_state(7));
-  output->SetVelocityAtIndex(velocity_idx_map_.at("base_wy"), est_fb_state(8));
-  output->SetVelocityAtIndex(velocity_idx_map_.at("base_wz"), est_fb_state(9));
-  output->SetVelocityAtIndex(velocity_idx_map_.at("base_vx"), est_fb_state(10));
-  output->SetVelocityAtIndex(velocity_idx_map_.at("base_vy"), est_fb_state(11));
-  output->SetVelocityAtIndex(velocity_idx_map_.at("base_vz"), est_fb_state(12));
+    const Eigen::Ref<const VectorXd>& est_fb_state,
+    OutputVector<double>* output) const {
+  for (int i = 0; i < 7; i++) {
+    output->SetPositionAtIndex(base_position_idx_[i], est_fb_state(i));
+  }
+  for (int i = 0; i < 6; i++) {
+    output->SetVelocityAtIndex(base_velocity_idx_[i], est_fb_state(7 + i));
+  }
 }
 
 /// EstimateContactFromSprings(). Conservative estimation.
@@ -503,13 +512,13 @@ void CassieStateEstimator::EstimateContactForEkf(
   // deflections are *both* over some thresholds. We don't update anything
   // if it's under the threshold.
   const double& left_knee_spring =
-      output.GetPositionAtIndex(position_idx_map_.at("knee_joint_left"));
+      output.GetPositionAtIndex(leg_idx_[0].positions[5]);
   const double& right_knee_spring =
-      output.GetPositionAtIndex(position_idx_map_.at("knee_joint_right"));
-  const double& left_heel_spring = output.GetPositionAtIndex(
-      position_idx_map_.at("ankle_spring_joint_left"));
-  const double& right_heel_spring = output.GetPositionAtIndex(
-      position_idx_map_.at("ankle_spring_joint_right"));
+      output.GetPositionAtIndex(leg_idx_[1].positions[5]);
+  const double& left_heel_spring =
+      output.GetPositionAtIndex(leg_idx_[0].positions[7]);
+  const double& right_heel_spring =
+      output.GetPositionAtIndex(leg_idx_[1].positions[7]);
   bool left_contact_spring = (left_knee_spring < knee_spring_threshold_ekf_ &&
                               left_heel_spring < ankle_spring_threshold_ekf_);
   bool right_contact_spring = (right_knee_spring < knee_spring_threshold_ekf_ &&
@@ -566,13 +575,13 @@ void CassieStateEstimator::EstimateContactForController(
   // deflection is over a threshold. We don't update anything if it's under
   // the threshold.
   const double& left_knee_spring =
-      output.GetPositionAtIndex(position_idx_map_.at("knee_joint_left"));
+      output.GetPositionAtIndex(leg_idx_[0].positions[5]);
   const double& right_knee_spring =
-      output.GetPositionAtIndex(position_idx_map_.at("knee_joint_right"));
-  const double& left_heel_spring = output.GetPositionAtIndex(
-      position_idx_map_.at("ankle_spring_joint_left"));
-  const double& right_heel_spring = output.GetPositionAtIndex(
-      position_idx_map_.at("ankle_spring_joint_right"));
+      output.GetPositionAtIndex(leg_idx_[1].positions[5]);
+  const double& left_heel_spring =
+      output.GetPositionAtIndex(leg_idx_[0].positions[7]);
+  const double& right_heel_spring =
+      output.GetPositionAtIndex(leg_idx_[1].positions[7]);
   bool left_contact_spring = (left_knee_spring < knee_spring_threshold_ctrl_ ||
                               left_heel_spring < ankle_spring_threshold_ctrl_);
   bool right_contact_spring =
@@ -607,10 +616,15 @@ EventStatus CassieStateEstimator::Update(
     cout << "dt: " << dt << endl;
   }
 
+  auto& workspace =
+      state->get_mutable_abstract_state<CassieStateEstimatorWorkspace>(
+          workspace_idx_);
+  auto& J = workspace.J;
+
   // Get ground truth information
-  OutputVector<double> output_gt(n_q_, n_v_, n_u_);
-  VectorXd imu_pos_wrt_world_gt(7);
-  VectorXd imu_vel_wrt_world_gt(6);
+  OutputVector<double>& output_gt = *workspace.output_gt;
+  Eigen::Matrix<double, 7, 1> imu_pos_wrt_world_gt;
+  Eigen::Matrix<double, 6, 1> imu_vel_wrt_world_gt;
   if (test_with_ground_truth_state_) {
     const OutputVector<double>* cassie_state =
         (OutputVector<double>*)this->EvalVectorInput(context,
@@ -619,38 +633,39 @@ EventStatus CassieStateEstimator::Update(
     AssignImuValueToOutputVector(cassie_out, &output_gt);
     AssignActuationFeedbackToOutputVector(cassie_out, &output_gt);
     AssignNonFloatingBaseStateToOutputVector(cassie_out, &output_gt);
-    VectorXd fb_state_gt(13);
-    fb_state_gt.head(7) = cassie_state->GetPositions().head(7);
-    fb_state_gt.tail(6) = cassie_state->GetVelocities().head(6);
+    Eigen::Matrix<double, 13, 1> fb_state_gt;
+    fb_state_gt.head(7) = cassie_state->get_value().head(7);
+    fb_state_gt.tail(6) = cassie_state->get_value().segment(n_q_, 6);
     AssignFloatingBaseStateToOutputVector(fb_state_gt, &output_gt);
 
     // We get 0's cassie_state in the beginning because dispatcher_robot_out
     // is not triggered by CASSIE_STATE_SIMULATION message.
     // This wouldn't be an issue when you don't use ground truth state.
-    if (output_gt.GetPositions().head(7).norm() == 0) {
-      output_gt.SetPositionAtIndex(position_idx_map_.at("base_qw"), 1);
+    if (output_gt.get_value().head(7).norm() == 0) {
+      output_gt.SetPositionAtIndex(base_position_idx_[0], 1);
     }
 
     // Get kinematics cache for ground truth
-    plant_.SetPositionsAndVelocities(context_gt_.get(), output_gt.GetState());
+    plant_.SetPositionsAndVelocities(context_gt_.get(),
+                                     output_gt.get_value().head(n_q_ + n_v_));
     // rotational position
-    Eigen::Vector4d quat = output_gt.GetPositions().segment<4>(0);
+    Eigen::Vector4d quat = output_gt.get_value().head(4);
     imu_pos_wrt_world_gt.head(4) = quat;
     // translational position
-    VectorXd pos(3);
+    Vector3d pos;
     plant_.CalcPointsPositions(*context_gt_, pelvis_frame_, imu_pos_, world_,
                                &pos);
     imu_pos_wrt_world_gt.tail(3) = pos;
     // rotational velocity
     imu_vel_wrt_world_gt.head(3) =
         Quaterniond(quat(0), quat(1), quat(2), quat(3)).toRotationMatrix() *
-        output_gt.GetVelocities().head(3);
+        output_gt.get_value().segment<3>(n_q_);
     // translational velocity
-    MatrixXd J(3, n_v_);
     plant_.CalcJacobianTranslationalVelocity(
         *context_gt_, JacobianWrtVariable::kV, pelvis_frame_, imu_pos_, world_,
         world_, &J);
-    imu_vel_wrt_world_gt.tail(3) = J * output_gt.GetVelocities();
+    imu_vel_wrt_world_gt.tail(3).noalias() =
+        J * output_gt.get_value().segment(n_q_, n_v_);
     if (print_info_to_terminal_) {
       // Print for debugging
       cout << "Ground Truth: " << endl;
@@ -664,7 +679,7 @@ EventStatus CassieStateEstimator::Update(
   }
 
   // Extract imu measurement
-  VectorXd imu_measurement(6);
+  Eigen::Matrix<double, 6, 1> imu_measurement;
   const double* imu_linear_acceleration =
       cassie_out.pelvis.vectorNav.linearAcceleration;
   const double* imu_angular_velocity =
@@ -679,7 +694,19 @@ EventStatus CassieStateEstimator::Update(
 
   // Step 2 - EKF (Propagate step)
   auto& ekf = state->get_mutable_abstract_state<inekf::InEKF>(ekf_idx_);
+  // The InEKF library allocates internally, and returns its state by value.
+  // The parts of it used below are copied out once after each EKF step.
+  Matrix3d ekf_rotation;
+  Vector3d ekf_velocity;
+  Vector3d ekf_position;
+  auto copy_ekf_state = [&]() {
+    const inekf::RobotState ekf_state = ekf.getState();
+    ekf_rotation = ekf_state.getRotation();
+    ekf_velocity = ekf_state.getVelocity();
+    ekf_position = ekf_state.getPosition();
+  };
   ekf.Propagate(context.get_discrete_state(prev_imu_idx_).get_value(), dt);
+  copy_ekf_state();
 
   // Print for debugging
   if (print_info_to_terminal_) {
@@ -704,26 +731,24 @@ EventStatus CassieStateEstimator::Update(
   }
 
   // Estimated floating base state (pelvis)
-  VectorXd estimated_fb_state(13);
-  Vector3d r_imu_to_pelvis_global = ekf.getState().getRotation() * (-imu_pos_);
+  Eigen::Matrix<double, 13, 1> estimated_fb_state;
+  Vector3d r_imu_to_pelvis_global = ekf_rotation * (-imu_pos_);
   // Rotational position
-  Quaterniond q(ekf.getState().getRotation());
+  Quaterniond q(ekf_rotation);
   q.normalize();
   estimated_fb_state[0] = q.w();
   estimated_fb_state.segment<3>(1) = q.vec();
   // Translational position
-  estimated_fb_state.segment<3>(4) =
-      ekf.getState().getPosition() + r_imu_to_pelvis_global;
+  estimated_fb_state.segment<3>(4) = ekf_position + r_imu_to_pelvis_global;
   // Rotational velocity
-  Vector3d omega_global =
-      ekf.getState().getRotation() * imu_measurement.head(3);
+  Vector3d omega_global = ekf_rotation * imu_measurement.head(3);
   estimated_fb_state.segment<3>(7) = omega_global;
   // Translational velocity
   estimated_fb_state.tail(3) =
-      ekf.getState().getVelocity() + omega_global.cross(r_imu_to_pelvis_global);
+      ekf_velocity + omega_global.cross(r_imu_to_pelvis_global);
 
   // Estimated robot output
-  OutputVector<double> filtered_output(n_q_, n_v_, n_u_);
+  OutputVector<double>& filtered_output = *workspace.filtered_output;
   AssignImuValueToOutputVector(cassie_out, &filtered_output);
   AssignActuationFeedbackToOutputVector(cassie_out, &filtered_output);
   AssignNonFloatingBaseStateToOutputVector(cassie_out, &filtered_output);
@@ -734,13 +759,14 @@ EventStatus CassieStateEstimator::Update(
   int left_contact = 0;
   int right_contact = 0;
 
-  VectorXd lambda_est = VectorXd::Zero(num_contacts_ * 3);
+  VectorXd& lambda_est = workspace.lambda_est;
+  lambda_est.setZero();
   if (test_with_ground_truth_state_) {
     EstimateContactForEkf(output_gt, &left_contact, &right_contact);
   } else {
     EstimateContactForEkf(filtered_output, &left_contact, &right_contact);
     // EstimateContactForces(context, filtered_output, lambda_est, left_contact,
-    //                       right_contact);
+    //                       right_contact, &workspace);
   }
   state->get_mutable_discrete_state(contact_forces_idx_).get_mutable_value()
       << lambda_est;
@@ -761,7 +787,7 @@ EventStatus CassieStateEstimator::Update(
     right_contact = 1;
 
     if ((*counter_for_testing_) % 5000 == 0) {
-      cout << "pos = " << ekf.getState().getPosition().transpose() << endl;
+      cout << "pos = " << ekf_position.transpose() << endl;
     }
     *counter_for_testing_ = *counter_for_testing_ + 1;
   } else if (hardware_test_mode_ == 1) {
@@ -776,7 +802,8 @@ EventStatus CassieStateEstimator::Update(
       << left_contact,
       right_contact;
 
-  std::vector<std::pair<int, bool>> contacts;
+  auto& contacts = workspace.contacts;
+  contacts.clear();
   // TODO(yangwill): Decide whether to use both contacts per foot or just one.
   // Possibly leave it as an option to the state estimator
   contacts.push_back(std::pair<int, bool>(0, left_contact));
@@ -786,13 +813,16 @@ EventStatus CassieStateEstimator::Update(
   ekf.setContacts(contacts);
 
   // Step 4 - EKF (measurement step)
-  plant_.SetPositionsAndVelocities(context_.get(), filtered_output.GetState());
+  plant_.SetPositionsAndVelocities(
+      context_.get(), filtered_output.get_value().head(n_q_ + n_v_));
 
   // rotation part of pose and covariance is unused in EKF
   Eigen::Matrix4d rear_toe_pose = Eigen::Matrix4d::Identity();
   Eigen::Matrix4d front_toe_pose = Eigen::Matrix4d::Identity();
-  Eigen::Matrix<double, 6, 6> rear_covariance = MatrixXd::Identity(6, 6);
-  Eigen::Matrix<double, 6, 6> front_covariance = MatrixXd::Identity(6, 6);
+  Eigen::Matrix<double, 6, 6> rear_covariance =
+      Eigen::Matrix<double, 6, 6>::Identity();
+  Eigen::Matrix<double, 6, 6> front_covariance =
+      Eigen::Matrix<double, 6, 6>::Identity();
 
   if (test_with_ground_truth_state_) {
     // Print for debugging
@@ -802,16 +832,17 @@ EventStatus CassieStateEstimator::Update(
       cout << ekf.getState().getRotation() << endl;
       cout << "Ground truth rotation: " << endl;
       Quaterniond q_real;
-      q_real.w() = output_gt.GetPositions()[0];
-      q_real.vec() = output_gt.GetPositions().segment<3>(1);
+      q_real.w() = output_gt.get_value()(0);
+      q_real.vec() = output_gt.get_value().segment<3>(1);
       MatrixXd R_actual = q_real.toRotationMatrix();
       cout << R_actual << endl;
     }
   }
 
-  inekf::vectorKinematics measured_kinematics;
+  inekf::vectorKinematics& measured_kinematics =
+      workspace.measured_kinematics;
+  measured_kinematics.clear();
   Vector3d toe_pos = Vector3d::Zero();
-  MatrixXd J = MatrixXd::Zero(3, n_v_);
   for (int i = 0; i < 2; i++) {
     plant_.CalcPointsPositions(*context_, *toe_frames_[i], rear_contact_disp_,
                                pelvis_frame_, &toe_pos);
@@ -831,19 +862,16 @@ EventStatus CassieStateEstimator::Update(
     plant_.CalcJacobianTranslationalVelocity(
         *context_, JacobianWrtVariable::kV, *toe_frames_[i], rear_contact_disp_,
         pelvis_frame_, pelvis_frame_, &J);
-    MatrixXd J_wrt_joints = J.block(0, 6, 3, 16);
     rear_covariance.block<3, 3>(3, 3) =
-        J_wrt_joints * cov_w_ * J_wrt_joints.transpose();
-    inekf::Kinematics rear_frame(2 * i, rear_toe_pose, rear_covariance);
-    measured_kinematics.push_back(rear_frame);
+        J.block<3, 16>(0, 6) * cov_w_ * J.block<3, 16>(0, 6).transpose();
+    measured_kinematics.emplace_back(2 * i, rear_toe_pose, rear_covariance);
     plant_.CalcJacobianTranslationalVelocity(
         *context_, JacobianWrtVariable::kV, *toe_frames_[i],
         front_contact_disp_, pelvis_frame_, pelvis_frame_, &J);
-    J_wrt_joints = J.block(0, 6, 3, 16);
     front_covariance.block<3, 3>(3, 3) =
-        J_wrt_joints * cov_w_ * J_wrt_joints.transpose();
-    inekf::Kinematics front_frame(2 * i + 1, front_toe_pose, front_covariance);
-    measured_kinematics.push_back(front_frame);
+        J.block<3, 16>(0, 6) * cov_w_ * J.block<3, 16>(0, 6).transpose();
+    measured_kinematics.emplace_back(2 * i + 1, front_toe_pose,
+                                     front_covariance);
 
     if (print_info_to_terminal_) {
       cout << "covariance.block<3, 3>(3, 3) = \n"
@@ -854,6 +882,7 @@ EventStatus CassieStateEstimator::Update(
   //  outfile.open("../ekf_error.txt", std::ios_base::app);
   //  outfile << current_time << ", ";
   ekf.CorrectKinematics(measured_kinematics);
+  copy_ekf_state();
 
   if (print_info_to_terminal_) {
     // Print for debugging
@@ -888,19 +917,18 @@ EventStatus CassieStateEstimator::Update(
   // We get the angular velocity directly from the IMU without filtering
   // because the magnitude of noise is about 2e-3.
   // Rotational position
-  q = Quaterniond(ekf.getState().getRotation()).normalized();
+  q = Quaterniond(ekf_rotation).normalized();
   estimated_fb_state[0] = q.w();
   estimated_fb_state.segment<3>(1) = q.vec();
   // Translational position
-  r_imu_to_pelvis_global = ekf.getState().getRotation() * (-imu_pos_);
-  estimated_fb_state.segment<3>(4) =
-      ekf.getState().getPosition() + r_imu_to_pelvis_global;
+  r_imu_to_pelvis_global = ekf_rotation * (-imu_pos_);
+  estimated_fb_state.segment<3>(4) = ekf_position + r_imu_to_pelvis_global;
   // Rotational velocity
-  omega_global = ekf.getState().getRotation() * imu_measurement.head(3);
+  omega_global = ekf_rotation * imu_measurement.head(3);
   estimated_fb_state.segment<3>(7) = omega_global;
   // Translational velocity
   estimated_fb_state.tail(3) =
-      ekf.getState().getVelocity() + omega_global.cross(r_imu_to_pelvis_global);
+      ekf_velocity + omega_global.cross(r_imu_to_pelvis_global);
   state->get_mutable_discrete_state()
           .get_mutable_vector(fb_state_idx_)
           .get_mutable_value()
@@ -1019,40 +1047,46 @@ void CassieStateEstimator::setPreviousImuMeasurement(
 }
 void CassieStateEstimator::EstimateContactForces(
     const Context<double>& context, const systems::OutputVector<double>& output,
-    VectorXd& lambda, int& left_contact, int& right_contact) const {
+    VectorXd& lambda, int& left_contact, int& right_contact,
+    CassieStateEstimatorWorkspace* workspace) const {
 
   // TODO(yangwill) add a discrete time filter to the force estimate
-  VectorXd v_prev =
+  const auto v_prev =
       context.get_discrete_state(previous_velocity_idx_).get_value();
-  plant_.SetPositionsAndVelocities(context_.get(), output.GetState());
-  MatrixXd M = MatrixXd(n_v_, n_v_);
+  const auto x = output.get_value().head(n_q_ + n_v_);
+  const auto v = output.get_value().segment(n_q_, n_v_);
+  const auto u = output.get_value().segment(n_q_ + n_v_, n_u_);
+  plant_.SetPositionsAndVelocities(context_.get(), x);
+  MatrixXd& M = workspace->M;
   plant_.CalcMassMatrix(*context_, &M);
-  VectorXd C(n_v_);
-  plant_.CalcBiasTerm(*context_, &C);
-  MatrixXd B = plant_.MakeActuationMatrix();
-  drake::multibody::MultibodyForces<double> f_app(plant_);
-  plant_.CalcForceElementsContribution(*context_, &f_app);
+  plant_.CalcBiasTerm(*context_, &workspace->C);
+  plant_.CalcForceElementsContribution(*context_, &workspace->f_app);
   double beta = 0.01;
   double gamma = 0.01;
 
-  VectorXd v = output.GetVelocities();
-  VectorXd g = plant_.CalcGravityGeneralizedForces(*context_);
-  VectorXd tau_d = gamma * beta * M * v_prev -
-                   (1 - gamma) * (beta * M * v + B * output.GetEfforts() + C -
-                                  g + f_app.generalized_forces());
+  // tau_d = gamma * beta * M * v_prev -
+  //         (1 - gamma) * (beta * M * v + B * u + C - g + f_app)
+  VectorXd& tau_d = workspace->tau_d;
+  tau_d = workspace->C - plant_.CalcGravityGeneralizedForces(*context_) +
+          workspace->f_app.generalized_forces();
+  tau_d.noalias() += B_ * u;
+  tau_d.noalias() += beta * M * v;
+  tau_d *= -(1 - gamma);
+  tau_d.noalias() += gamma * beta * M * v_prev;
 
   // Simplifying to 2 feet contacts, might need to change it to two contacts per
   // foot and sum them up
+  const Vector3d toe_origin = Vector3d::Zero();
   for (int leg = 0; leg < num_contacts_; ++leg) {
-    MatrixXd J_contact(3, n_v_);
     plant_.CalcJacobianTranslationalVelocity(
-        *context_, JacobianWrtVariable::kV, *toe_frames_[leg],
-        VectorXd::Zero(3), world_, world_, &J_contact);
+        *context_, JacobianWrtVariable::kV, *toe_frames_[leg], toe_origin,
+        world_, world_, &workspace->J_contact);
+    workspace->SJt.noalias() =
+        joint_selection_matrices[leg] * workspace->J_contact.transpose();
+    workspace->S_tau_d.noalias() = joint_selection_matrices[leg] * tau_d;
+    workspace->qr.compute(workspace->SJt);
     lambda.segment(3 * leg, SPACE_DIM) =
-        (joint_selection_matrices[leg] * J_contact.transpose())
-            .colPivHouseholderQr()
-            .solve(joint_selection_matrices[leg] * tau_d)
-            .transpose();
+        workspace->qr.solve(workspace->S_tau_d);
   }
   double contact_force_threshold = 70;
   if (!(lambda[2] > 2 * contact_force_threshold) !=
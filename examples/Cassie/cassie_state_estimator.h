@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -18,12 +19,53 @@
 #include "systems/framework/timestamped_vector.h"
 
 #include "drake/multibody/plant/multibody_plant.h"
+#include "drake/multibody/tree/multibody_forces.h"
 #include "drake/solvers/mathematical_program.h"
 #include "drake/systems/framework/leaf_system.h"
 
 namespace dairlib {
 namespace systems {
 
+/// Preallocated scratch storage for CassieStateEstimator's update, held in its
+/// abstract state so that the estimator's own work in a tick does not
+/// allocate. The contents are meaningless between updates, so a copy and an
+/// assignment only size the storage like that of `other`. An assignment
+/// between workspaces of the same plant (e.g. when the state is updated) is
+/// then free.
+struct CassieStateEstimatorWorkspace {
+  explicit CassieStateEstimatorWorkspace(
+      const drake::multibody::MultibodyPlant<double>& plant);
+  CassieStateEstimatorWorkspace(const CassieStateEstimatorWorkspace& other)
+      : CassieStateEstimatorWorkspace(*other.plant) {}
+  CassieStateEstimatorWorkspace& operator=(
+      const CassieStateEstimatorWorkspace& other);
+
+  // Sizes the storage for `plant`
+  void Resize(const drake::multibody::MultibodyPlant<double>& plant);
+
+  const drake::multibody::MultibodyPlant<double>* plant;
+
+  // Robot output assembled from the message (and from the ground truth state)
+  std::unique_ptr<OutputVector<double>> filtered_output;
+  std::unique_ptr<OutputVector<double>> output_gt;
+  // Translational Jacobian of a contact point, 3 x n_v
+  Eigen::MatrixXd J;
+  // InEKF inputs, refilled every tick within their reserved capacity
+  inekf::vectorKinematics measured_kinematics;
+  std::vector<std::pair<int, bool>> contacts;
+  Eigen::VectorXd lambda_est;
+
+  // EstimateContactForces()
+  Eigen::MatrixXd M;
+  Eigen::VectorXd C;
+  Eigen::VectorXd tau_d;
+  drake::multibody::MultibodyForces<double> f_app;
+  Eigen::MatrixXd J_contact;
+  Eigen::MatrixXd SJt;
+  Eigen::VectorXd S_tau_d;
+  Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr;
+};
+
 /// CassieStateEstimator does the following things
 /// 1. reads in cassie_out_t,
 /// 2. estimates floating-base state and feet contact
@@ -96,7 +138,8 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
   void EstimateContactForces(const drake::systems::Context<double>& context,
                              const systems::OutputVector<double>& output,
                              Eigen::VectorXd& lambda, int& left_contact,
-                             int& right_contact) const;
+                             int& right_contact,
+                             CassieStateEstimatorWorkspace* workspace) const;
 
   // Setters for initial values
   void setPreviousTime(drake::systems::Context<double>* context,
@@ -139,8 +182,12 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
       systems::OutputVector<double>* output) const;
   void AssignActuationFeedbackToOutputVector(const cassie_out_t& cassie_out,
       systems::OutputVector<double>* output) const;
-  void AssignFloatingBaseStateToOutputVector(const Eigen::VectorXd& state_est,
+  void AssignFloatingBaseStateToOutputVector(
+      const Eigen::Ref<const Eigen::VectorXd>& state_est,
       systems::OutputVector<double>* output) const;
+  // solveFourbarLinkage() at the positions already set in context_
+  void SolveFourbarLinkageInContext(double* left_heel_spring,
+                                    double* right_heel_spring) const;
 
   drake::systems::EventStatus Update(
       const drake::systems::Context<double>& context,
@@ -169,12 +216,25 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
   std::map<std::string, int> position_idx_map_;
   std::map<std::string, int> velocity_idx_map_;
   std::map<std::string, int> actuator_idx_map_;
+  // Indices of one leg's joints in the order of cassie_leg_out_t: the hip
+  // roll, hip yaw, hip pitch, knee and toe drives, then the knee, ankle and
+  // heel spring joints. They are looked up by name once, so that copying a
+  // message does not build strings.
+  struct LegIndices {
+    std::array<int, 8> positions;
+    std::array<int, 8> velocities;
+    std::array<int, 5> efforts;
+  };
+  std::array<LegIndices, 2> leg_idx_;  // left, right
+  std::array<int, 7> base_position_idx_;
+  std::array<int, 6> base_velocity_idx_;
 
   // Body frames
   std::vector<const drake::multibody::Frame<double>*> toe_frames_;
   const drake::multibody::Frame<double>& pelvis_frame_;
   const drake::multibody::Body<double>& pelvis_;
   std::vector<Eigen::MatrixXd> joint_selection_matrices;
+  Eigen::MatrixXd B_;
 
   // Input/output port indices
   int cassie_out_input_port_;
@@ -189,6 +249,7 @@ class CassieStateEstimator : public drake::systems::LeafSystem<double> {
   // States related to EKF
   drake::systems::DiscreteStateIndex fb_state_idx_;
   drake::systems::AbstractStateIndex ekf_idx_;
+  drake::systems::AbstractStateIndex workspace_idx_;
   drake::systems::DiscreteStateIndex prev_imu_idx_;
   drake::systems::DiscreteStateIndex contact_idx_;
   drake::systems::DiscreteStateIndex contact_forces_idx_;
@@ -9,6 +9,7 @@
 #include "examples/Cassie/cassie_utils.h"
 #include "examples/Cassie/networking/cassie_output_receiver.h"
 #include "examples/Cassie/networking/cassie_output_sender.h"
+#include "examples/Cassie/networking/cassie_udp_receive_thread.h"
 #include "examples/Cassie/networking/simple_cassie_udp_subscriber.h"
 #include "multibody/kinematic/kinematic_evaluator_set.h"
 #include "multibody/kinematic/world_point_evaluator.h"
@@ -48,6 +49,12 @@ DEFINE_bool(broadcast_robot_state, false, "broadcast to planner thread");
 // Simulation parameters.
 DEFINE_string(address, "127.0.0.1", "IPv4 address to receive on.");
 DEFINE_int64(port, 25001, "Port to receive on.");
+DEFINE_bool(udp_receive_thread, true,
+            "Receive the UDP messages on a dedicated thread, instead of "
+            "between the state estimator updates");
+DEFINE_int32(udp_realtime_priority, 0,
+             "SCHED_FIFO priority of the UDP receive thread (0 to keep the "
+             "default scheduling)");
 DEFINE_double(pub_rate, 0.1, "Network LCM pubishing period (s).");
 DEFINE_double(fast_network_pub_rate, 0.01, "Network LCM pubishing period (s).");
 DEFINE_bool(simulation, false,
@@ -255,6 +262,14 @@ int do_main(int argc, char* argv[]) {
       builder.Connect(state_receiver->get_output_port(0),
                       state_estimator->get_input_port(1));
     }
+  } else {
+    // On hardware, each message from Cassie is written once into this diagram
+    // input, which the state estimator and the echo sender both read by
+    // reference. The echo is only converted to lcmt_cassie_out when its
+    // periodic publisher evaluates it.
+    const auto cassie_out_port = builder.ExportInput(
+        state_estimator->get_input_port(0), "cassie_out_t");
+    builder.ConnectInput(cassie_out_port, output_sender->get_input_port(0));
   }
 
   // Create and connect RobotOutput publisher.
@@ -405,35 +420,58 @@ int do_main(int argc, char* argv[]) {
       prev_time = time;
     }
   } else {
-    auto& output_sender_context =
-        diagram.GetMutableSubsystemContext(*output_sender, &diagram_context);
-    auto& state_estimator_context =
-        diagram.GetMutableSubsystemContext(*state_estimator, &diagram_context);
+    std::unique_ptr<CassieUdpReceiveThread> udp_thread;
+    std::unique_ptr<SimpleCassieUdpSubscriber> udp_sub;
+    if (FLAGS_udp_receive_thread) {
+      udp_thread = std::make_unique<CassieUdpReceiveThread>(
+          FLAGS_port, FLAGS_udp_realtime_priority);
+    } else {
+      udp_sub = std::make_unique<SimpleCassieUdpSubscriber>(FLAGS_address,
+                                                            FLAGS_port);
+    }
+    auto& cassie_out_value = diagram.GetInputPort("cassie_out_t")
+                                 .FixValue(&diagram_context, cassie_out_t{});
+    // Blocks until the next message from Cassie, and writes it in place into
+    // the diagram input. Getting the mutable value also invalidates everything
+    // computed from the previous message.
+    double time = 0;
+    auto receive = [&]() -> const cassie_out_t& {
+      auto& message =
+          cassie_out_value.GetMutableData()->get_mutable_value<cassie_out_t>();
+      if (udp_thread) {
+        udp_thread->WaitForNewest(&message, &time);
+      } else {
+        udp_sub->Poll();
+        message = udp_sub->message();
+        time = udp_sub->message_time();
+      }
+      return message;
+    };
 
     // Wait for the first message.
-    SimpleCassieUdpSubscriber udp_sub(FLAGS_address, FLAGS_port);
     drake::log()->info("Waiting for first UDP message from Cassie");
-    udp_sub.Poll();
+    const cassie_out_t& first_message = receive();
 
     // Initialize the context based on the first message.
-    const double t0 = udp_sub.message_time();
+    const double t0 = time;
     if (FLAGS_floating_base) {
       // Set EKF time and initial states
-      setInitialEkfState(t0, udp_sub.message(), plant, diagram,
-                         *state_estimator, &diagram_context);
+      setInitialEkfState(t0, first_message, plant, diagram, *state_estimator,
+                         &diagram_context);
     }
     diagram_context.SetTime(t0);
-    auto& output_sender_value = output_sender->get_input_port(0).FixValue(
-        &output_sender_context, udp_sub.message());
-    auto& state_estimator_value = state_estimator->get_input_port(0).FixValue(
-        &state_estimator_context, udp_sub.message());
     drake::log()->info("dispatcher_robot_out started");
 
+    double next_report_time = t0 + 10;
     while (true) {
-      udp_sub.Poll();
-      output_sender_value.GetMutableData()->set_value(udp_sub.message());
-      state_estimator_value.GetMutableData()->set_value(udp_sub.message());
-      const double time = udp_sub.message_time();
+      receive();
+
+      if (udp_thread && time > next_report_time) {
+        drake::log()->info("UDP packets received: {}, dropped: {}, stale: {}",
+                           udp_thread->num_received(),
+                           udp_thread->num_dropped(), udp_thread->num_stale());
+        next_report_time = time + 10;
+      }
 
       // Check if we are very far ahead or behind
       // (likely due to a restart of the driving clock)
@@ -101,12 +101,10 @@ drake::systems::EventStatus CassieUDPPublisher::PublishInputAsUDPMessage(
   const drake::AbstractValue* const input_value =
       this->EvalAbstractInput(context, kPortIndex);
   DRAKE_ASSERT(input_value != nullptr);
-  std::vector<uint8_t> message_bytes;
+  serializer_->Serialize(*input_value, &message_bytes_);
 
-  serializer_->Serialize(*input_value, &message_bytes);
-
-  int result = sendto(socket_, message_bytes.data(),
-      message_bytes.size(), 0,
+  int result = sendto(socket_, message_bytes_.data(),
+      message_bytes_.size(), 0,
       (struct sockaddr *)&server_address_, sizeof(server_address_));
   DRAKE_THROW_UNLESS(result >= 0);
   return drake::systems::EventStatus::Succeeded();
@@ -149,6 +149,11 @@ class CassieUDPPublisher : public drake::systems::LeafSystem<double> {
 
   // Converts Value<cassie_user_in_t> objects into UDP message bytes.
   std::unique_ptr<CassieUDPInSerializer> serializer_;
+
+  // Buffer for the serialized message, reused by every publish so that
+  // sending does not allocate. This makes publishing from two threads with
+  // the same CassieUDPPublisher unsafe.
+  mutable std::vector<uint8_t> message_bytes_;
 };
 
 }  // namespace systems
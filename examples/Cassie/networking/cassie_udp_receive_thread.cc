@@ -0,0 +1,189 @@
+#include "examples/Cassie/networking/cassie_udp_receive_thread.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cstring>
+
+#include "drake/common/drake_assert.h"
+#include "drake/common/drake_throw.h"
+#include "drake/common/text_logging.h"
+
+namespace dairlib {
+
+using std::chrono::duration;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+namespace {
+
+// Two header bytes (sequence numbers) followed by the packed cassie_out_t
+constexpr int kPacketLength = 2 + CASSIE_OUT_T_LEN;
+// Number of datagrams read by one recvmmsg() call
+constexpr int kBatchSize = 16;
+// Period at which the receive thread checks whether it should stop
+constexpr int kStopCheckMs = 100;
+// The slot being written, the newest published one, and the one being read
+constexpr int kNumSlots = 3;
+
+}  // namespace
+
+CassieUdpReceiveThread::CassieUdpReceiveThread(int port,
+                                               int realtime_priority)
+    : buffers_(kBatchSize, std::vector<unsigned char>(kPacketLength)),
+      iovecs_(kBatchSize),
+      headers_(kBatchSize),
+      newest_(kPacketLength),
+      slots_(kNumSlots),
+      write_slot_(0),
+      free_(kNumSlots) {
+  socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+  DRAKE_THROW_UNLESS(socket_ >= 0);
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(port);
+  DRAKE_THROW_UNLESS(bind(socket_, (const struct sockaddr*)&address,
+                          sizeof(address)) >= 0);
+  socklen_t length = sizeof(address);
+  DRAKE_THROW_UNLESS(getsockname(socket_, (struct sockaddr*)&address,
+                                 &length) >= 0);
+  port_ = ntohs(address.sin_port);
+  event_fd_ = eventfd(0, EFD_NONBLOCK);
+  DRAKE_THROW_UNLESS(event_fd_ >= 0);
+
+  // A datagram longer than its buffer is truncated and flagged MSG_TRUNC
+  for (int i = 0; i < kBatchSize; i++) {
+    iovecs_[i].iov_base = buffers_[i].data();
+    iovecs_[i].iov_len = kPacketLength;
+    memset(&headers_[i], 0, sizeof(headers_[i]));
+    headers_[i].msg_hdr.msg_iov = &iovecs_[i];
+    headers_[i].msg_hdr.msg_iovlen = 1;
+  }
+  for (int i = 1; i < kNumSlots; i++) {
+    free_.Push(i);
+  }
+
+  start_ = steady_clock::now();
+  thread_ = std::thread(&CassieUdpReceiveThread::Run, this);
+  if (realtime_priority > 0) {
+    struct sched_param param;
+    param.sched_priority = realtime_priority;
+    if (pthread_setschedparam(thread_.native_handle(), SCHED_FIFO, &param)) {
+      drake::log()->warn(
+          "CassieUdpReceiveThread: could not set real-time priority {}",
+          realtime_priority);
+    }
+  }
+}
+
+CassieUdpReceiveThread::~CassieUdpReceiveThread() {
+  stop_ = true;
+  thread_.join();
+  close(event_fd_);
+  close(socket_);
+}
+
+void CassieUdpReceiveThread::Run() {
+  struct pollfd fd = {.fd = socket_, .events = POLLIN, .revents = 0};
+  while (!stop_) {
+    if (poll(&fd, 1, kStopCheckMs) <= 0) continue;
+
+    // Drain the socket, keeping a copy of the newest valid packet. Every
+    // other valid packet is stale.
+    int num_valid = 0;
+    double time = 0;
+    int n;
+    do {
+      n = recvmmsg(socket_, headers_.data(), kBatchSize, MSG_DONTWAIT,
+                   nullptr);
+      if (n <= 0) break;
+      time = duration<double>(steady_clock::now() - start_).count();
+      int newest = -1;
+      for (int i = 0; i < n; i++) {
+        if (headers_[i].msg_len != kPacketLength ||
+            (headers_[i].msg_hdr.msg_flags & MSG_TRUNC)) {
+          num_dropped_++;
+        } else {
+          newest = i;
+          num_valid++;
+        }
+      }
+      if (newest >= 0) {
+        memcpy(newest_.data(), buffers_[newest].data(), kPacketLength);
+      }
+    } while (n == kBatchSize);
+    if (num_valid == 0) continue;
+
+    CassieOutPacket& slot = slots_[write_slot_];
+    unpack_cassie_out_t(&newest_[2], &slot.message);
+    slot.time = time;
+    slot.sequence = num_received_ + num_valid - 1;
+    const int previous =
+        newest_slot_.exchange(write_slot_, std::memory_order_acq_rel);
+    if (previous >= 0) {
+      // The consumer never took the previous packet: reuse its slot
+      write_slot_ = previous;
+      num_stale_++;
+    } else {
+      // The consumer holds at most one slot, so one of the three is free
+      const bool popped = free_.Pop(&write_slot_);
+      DRAKE_DEMAND(popped);
+    }
+    // Counted once the packet is published, so that a consumer that sees
+    // num_received() also finds the packet
+    num_stale_ += num_valid - 1;
+    num_received_ += num_valid;
+    const uint64_t one = 1;
+    (void)!write(event_fd_, &one, sizeof(one));
+  }
+}
+
+bool CassieUdpReceiveThread::WaitForNewest(CassieOutPacket* packet,
+                                           int timeout_ms) {
+  const int index = WaitForNewestSlot(timeout_ms);
+  if (index < 0) return false;
+  *packet = slots_[index];
+  free_.Push(index);
+  return true;
+}
+
+bool CassieUdpReceiveThread::WaitForNewest(cassie_out_t* message,
+                                           double* time, int timeout_ms) {
+  const int index = WaitForNewestSlot(timeout_ms);
+  if (index < 0) return false;
+  *message = slots_[index].message;
+  *time = slots_[index].time;
+  free_.Push(index);
+  return true;
+}
+
+int CassieUdpReceiveThread::WaitForNewestSlot(int timeout_ms) {
+  const auto deadline = steady_clock::now() + milliseconds(timeout_ms);
+  struct pollfd fd = {.fd = event_fd_, .events = POLLIN, .revents = 0};
+  for (;;) {
+    const int index = newest_slot_.exchange(-1, std::memory_order_acq_rel);
+    if (index >= 0) return index;
+
+    // Sleep until the receive thread signals a new packet. The counter may
+    // also be left over from a packet that was already taken above, in which
+    // case nothing is waiting and we wait again.
+    int wait_ms = -1;
+    if (timeout_ms >= 0) {
+      const auto remaining = deadline - steady_clock::now();
+      if (remaining <= steady_clock::duration::zero()) return -1;
+      wait_ms = std::chrono::ceil<milliseconds>(remaining).count();
+    }
+    if (poll(&fd, 1, wait_ms) > 0) {
+      uint64_t count;
+      (void)!read(event_fd_, &count, sizeof(count));
+    }
+  }
+}
+
+}  // namespace dairlib
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "common/spsc_ring_buffer.h"
+#include "examples/Cassie/datatypes/cassie_out_t.h"
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+
+/// A cassie_out_t received over UDP
+struct CassieOutPacket {
+  cassie_out_t message;
+  /// Time the packet was read from the socket, in seconds since the
+  /// CassieUdpReceiveThread was constructed
+  double time = 0;
+  /// Number of valid packets received before this one
+  int64_t sequence = 0;
+};
+
+/**
+ * Receives the UDP messages from Cassie on a dedicated thread, so that the
+ * time spent processing one message (e.g. by the state estimator) does not
+ * delay reading the next one from the socket.
+ *
+ * The receive thread drains the socket in batches with recvmmsg(),
+ * timestamps them, and unpacks only the newest valid packet of each batch
+ * into one of three preallocated slots: the one being written by the
+ * receive thread, the newest packet waiting for the consumer, and the one
+ * being copied by the consumer. A new packet is published by atomically
+ * swapping its slot with the waiting one; if the waiting packet was never
+ * taken, its slot is reclaimed for the next packet, so the newest packet is
+ * never dropped. Slots taken by the consumer are returned to the receive
+ * thread through a lock-free single-producer/single-consumer ring. The
+ * consumer is woken through an eventfd, so neither side takes a lock.
+ *
+ * Packets that are never seen by the consumer are counted:
+ *  - dropped: packets of the wrong length;
+ *  - stale: valid packets superseded by a newer one before the consumer
+ *    asked for a packet, either within a batch or while waiting.
+ *
+ * WaitForNewest() must only be called from one thread.
+ */
+class CassieUdpReceiveThread final {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(CassieUdpReceiveThread)
+
+  /**
+   * Binds to `port` on all interfaces and starts the receive thread
+   *
+   * @param port the UDP port, or 0 to bind to any free port (see port())
+   * @param realtime_priority if positive, the receive thread is run with
+   * this SCHED_FIFO priority. Failing to set it (usually for lack of
+   * permissions) is logged and otherwise ignored.
+   */
+  explicit CassieUdpReceiveThread(int port, int realtime_priority = 0);
+
+  /** Stops the receive thread and closes the socket */
+  ~CassieUdpReceiveThread();
+
+  /**
+   * Blocks until a packet newer than the last returned one is available,
+   * and copies the newest one into `packet`. Returns false if no packet
+   * arrived within `timeout_ms` milliseconds (a negative timeout waits
+   * forever).
+   */
+  bool WaitForNewest(CassieOutPacket* packet, int timeout_ms = -1);
+
+  /**
+   * As above, but copies only the message, e.g. straight into the fixed
+   * input port value of a diagram, and its receive time into `time`
+   */
+  bool WaitForNewest(cassie_out_t* message, double* time,
+                     int timeout_ms = -1);
+
+  /** Returns the port the socket is bound to */
+  int port() const { return port_; }
+
+  /** Returns the number of valid packets received */
+  int64_t num_received() const { return num_received_; }
+  int64_t num_dropped() const { return num_dropped_; }
+  int64_t num_stale() const { return num_stale_; }
+
+ private:
+  void Run();
+  // Waits for the newest published slot, and returns its index or -1 on
+  // timeout. The caller must return the slot to free_.
+  int WaitForNewestSlot(int timeout_ms);
+
+  int socket_;
+  int port_;
+  int event_fd_;
+  std::chrono::steady_clock::time_point start_;
+
+  // recvmmsg() batch buffers, and a copy of the newest valid packet, written
+  // only by the receive thread
+  std::vector<std::vector<unsigned char>> buffers_;
+  std::vector<struct iovec> iovecs_;
+  std::vector<struct mmsghdr> headers_;
+  std::vector<unsigned char> newest_;
+
+  std::vector<CassieOutPacket> slots_;
+  // Slot the receive thread writes the next packet into, owned by it
+  int write_slot_;
+  // Slot of the newest packet not yet taken by the consumer, or -1
+  std::atomic<int> newest_slot_{-1};
+  // Slot indices returned by the consumer to the receive thread
+  SpscRingBuffer<int> free_;
+
+  std::atomic<bool> stop_{false};
+  std::atomic<int64_t> num_received_{0};
+  std::atomic<int64_t> num_dropped_{0};
+  std::atomic<int64_t> num_stale_{0};
+  std::thread thread_;
+};
+
+}  // namespace dairlib
@@ -0,0 +1,125 @@
+#include "examples/Cassie/networking/cassie_udp_receive_thread.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace dairlib {
+namespace {
+
+// Returns whether `condition` became true within a second
+template <typename Condition>
+bool WaitUntil(Condition condition) {
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) return false;
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+class CassieUdpReceiveThreadTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(socket_, 0);
+    memset(&address_, 0, sizeof(address_));
+    address_.sin_family = AF_INET;
+    address_.sin_port = htons(receiver_.port());
+    inet_aton("127.0.0.1", &address_.sin_addr);
+  }
+
+  void TearDown() override { close(socket_); }
+
+  // Sends a cassie_out_t, tagged by its pressure reading, with the two
+  // header bytes. A nonzero `extra_bytes` makes the packet invalid.
+  void Send(double pressure, int extra_bytes = 0) {
+    cassie_out_t message;
+    memset(&message, 0, sizeof(message));
+    message.pelvis.vectorNav.pressure = pressure;
+    std::vector<unsigned char> buffer(2 + CASSIE_OUT_T_LEN + extra_bytes);
+    pack_cassie_out_t(&message, &buffer[2]);
+    ASSERT_EQ(sendto(socket_, buffer.data(), buffer.size(), 0,
+                     (const struct sockaddr*)&address_, sizeof(address_)),
+              static_cast<ssize_t>(buffer.size()));
+  }
+
+  // Bound to any free port
+  CassieUdpReceiveThread receiver_{0};
+  int socket_;
+  struct sockaddr_in address_;
+};
+
+TEST_F(CassieUdpReceiveThreadTest, NewestPacket) {
+  EXPECT_GT(receiver_.port(), 0);
+  CassieOutPacket packet;
+  EXPECT_FALSE(receiver_.WaitForNewest(&packet, 10));
+
+  Send(1);
+  ASSERT_TRUE(receiver_.WaitForNewest(&packet, 1000));
+  EXPECT_EQ(packet.message.pelvis.vectorNav.pressure, 1);
+  EXPECT_EQ(packet.sequence, 0);
+  EXPECT_GT(packet.time, 0);
+
+  // A burst of packets, one of them invalid. Only the newest valid one is
+  // returned.
+  for (int i = 2; i <= 6; i++) {
+    Send(i);
+  }
+  Send(7, 1);
+  ASSERT_TRUE(WaitUntil([&]() {
+    return receiver_.num_received() == 6 && receiver_.num_dropped() == 1;
+  }));
+  ASSERT_TRUE(receiver_.WaitForNewest(&packet, 1000));
+  EXPECT_EQ(packet.message.pelvis.vectorNav.pressure, 6);
+  EXPECT_EQ(packet.sequence, 5);
+  EXPECT_EQ(receiver_.num_received(), 6);
+  EXPECT_EQ(receiver_.num_stale(), 4);
+  EXPECT_EQ(receiver_.num_dropped(), 1);
+
+  // Nothing newer has arrived
+  EXPECT_FALSE(receiver_.WaitForNewest(&packet, 10));
+
+  // Copying only the message
+  Send(8);
+  cassie_out_t message;
+  double time = 0;
+  ASSERT_TRUE(receiver_.WaitForNewest(&message, &time, 1000));
+  EXPECT_EQ(message.pelvis.vectorNav.pressure, 8);
+  EXPECT_GT(time, packet.time);
+}
+
+// Packets that are never taken by the consumer do not use up the slots: the
+// newest one is always returned, and none are dropped
+TEST_F(CassieUdpReceiveThreadTest, ReclaimsUntakenSlots) {
+  for (int i = 1; i <= 10; i++) {
+    Send(i);
+    ASSERT_TRUE(WaitUntil([&]() { return receiver_.num_received() == i; }));
+  }
+  CassieOutPacket packet;
+  ASSERT_TRUE(receiver_.WaitForNewest(&packet, 1000));
+  EXPECT_EQ(packet.message.pelvis.vectorNav.pressure, 10);
+  EXPECT_EQ(packet.sequence, 9);
+  EXPECT_EQ(receiver_.num_stale(), 9);
+  EXPECT_EQ(receiver_.num_dropped(), 0);
+
+  Send(11);
+  ASSERT_TRUE(receiver_.WaitForNewest(&packet, 1000));
+  EXPECT_EQ(packet.message.pelvis.vectorNav.pressure, 11);
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
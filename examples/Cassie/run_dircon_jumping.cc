@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <iostream>
 
@@ -20,6 +22,8 @@
 #include "multibody/visualization_utils.h"
 #include "solvers/nonlinear_cost.h"
 #include "systems/trajectory_optimization/dircon/dircon.h"
+#include "systems/trajectory_optimization/dircon/dircon_continuation.h"
+#include "systems/trajectory_optimization/dircon/dircon_multi_start.h"
 
 #include "drake/multibody/parsing/parser.h"
 #include "drake/solvers/solve.h"
@@ -50,7 +54,9 @@ using dairlib::systems::trajectory_optimization::DirconDynamicConstraint;
 using dairlib::systems::trajectory_optimization::DirconKinConstraintType;
 using dairlib::systems::trajectory_optimization::DirconKinematicConstraint;
 using dairlib::systems::trajectory_optimization::DirconMode;
+using dairlib::systems::trajectory_optimization::DirconContinuationOptions;
 using dairlib::systems::trajectory_optimization::DirconModeSequence;
+using dairlib::systems::trajectory_optimization::DirconMultiStartOptions;
 using dairlib::systems::trajectory_optimization::DirconOptions;
 using dairlib::systems::trajectory_optimization::HybridDircon;
 using dairlib::systems::trajectory_optimization::PointPositionConstraint;
@@ -92,13 +98,47 @@ DEFINE_bool(same_knotpoints, false,
             "Set flag to true if seeding with a trajectory with the same "
             "number of knotpoints");
 DEFINE_double(cost_scaling, 1.0, "Common scaling factor for costs.");
+DEFINE_int32(num_threads, 1,
+             "Threads used to evaluate the dynamics and kinematic "
+             "constraints (0 for all cores)");
+DEFINE_bool(colored_finite_differences, true,
+            "Detect the sparsity of the constraint Jacobians and perturb "
+            "independent variables together when finite differencing");
+DEFINE_bool(analytic_dynamics_gradients, false,
+            "Differentiate the collocation constraints analytically instead "
+            "of by finite differences");
+DEFINE_string(sweep_heights, "",
+              "Comma-separated jump heights to solve for in parallel instead "
+              "of --height. Solution i is saved to save_filename_i");
+DEFINE_int32(num_starts, 1,
+             "Number of solves per height, all but the first from a "
+             "perturbed initial guess");
+DEFINE_double(initial_guess_noise, 0.05,
+              "Magnitude of the initial guess perturbation of --num_starts");
+DEFINE_int32(sweep_threads, 0,
+             "Problems of --sweep_heights/--num_starts solved at the same "
+             "time (0 for all cores). Use with --num_threads=1");
+DEFINE_bool(continuation, false,
+            "Solve --sweep_heights by continuation, seeding each height with "
+            "the solution of its nearest solved neighbor, and write a library "
+            "index to save_filename_index.csv");
 
 namespace dairlib {
 
 HybridDircon<double>* createDircon(MultibodyPlant<double>& plant);
 
+std::unique_ptr<Dircon<double>> BuildDircon(
+    const MultibodyPlant<double>& plant, DirconModeSequence<double>* all_modes,
+    double height, const MatrixXd& spr_map, bool verbose);
+void SolveSweep(const MultibodyPlant<double>& plant,
+                DirconModeSequence<double>* all_modes,
+                const MatrixXd& spr_map);
+void SolveContinuation(const MultibodyPlant<double>& plant,
+                       DirconModeSequence<double>* all_modes,
+                       const MatrixXd& spr_map, const vector<double>& heights);
 void SetKinematicConstraints(Dircon<double>* trajopt,
-                             const MultibodyPlant<double>& plant);
+                             const MultibodyPlant<double>& plant,
+                             double height);
 void AddCosts(Dircon<double>* trajopt, const MultibodyPlant<double>& plant,
               DirconModeSequence<double>*);
 void AddCostsSprings(Dircon<double>* trajopt,
@@ -286,14 +326,100 @@ void DoMain() {
   land_mode.MakeConstraintRelative(right_heel_eval_ind, 1);
   land_mode.MakeConstraintRelative(right_heel_eval_ind, 2);
 
+  for (auto* mode : {&crouch_mode, &flight_mode, &land_mode}) {
+    mode->SetColoredFiniteDifferences(FLAGS_colored_finite_differences);
+    mode->SetAnalyticDynamicsGradients(FLAGS_analytic_dynamics_gradients);
+  }
+
   auto all_modes = DirconModeSequence<double>(plant);
   all_modes.AddMode(&crouch_mode);
   all_modes.AddMode(&flight_mode);
   all_modes.AddMode(&land_mode);
+  all_modes.SetNumThreads(FLAGS_num_threads);
+
+  if (!FLAGS_sweep_heights.empty() || FLAGS_num_starts > 1) {
+    SolveSweep(plant, &all_modes, spr_map);
+    return;
+  }
 
-  auto trajopt = Dircon<double>(all_modes);
+  auto trajopt_ptr =
+      BuildDircon(plant, &all_modes, FLAGS_height, spr_map, true);
+  auto& trajopt = *trajopt_ptr;
   auto& prog = trajopt.prog();
 
+  std::cout << "Setting initial conditions: " << std::endl;
+  vector<int> mode_lengths = {FLAGS_knot_points, FLAGS_knot_points,
+                              FLAGS_knot_points};
+
+  int num_knot_points = trajopt.N();
+  std::cout << "nq: " << n_q << endl;
+  std::cout << "nv: " << n_v << endl;
+  std::cout << "nu: " << plant.num_actuators() << endl;
+  cout << "N: " << num_knot_points << endl;
+  cout << "Num decision vars: " <<
+    prog.decision_variables().size() << endl;
+
+  double alpha = .2;
+  int num_poses = std::min(FLAGS_knot_points, 5);
+  trajopt.CreateVisualizationCallback(file_name, num_poses, alpha);
+
+  cout << "\nChoose the best solver: "
+       << drake::solvers::ChooseBestSolver(prog).name() << endl;
+
+  cout << "Solving DIRCON\n\n";
+  auto start = std::chrono::high_resolution_clock::now();
+  const auto result = drake::solvers::Solve(prog, prog.initial_guess());
+  auto finish = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsed = finish - start;
+  cout << "Solve time:" << elapsed.count() << std::endl;
+  std::cout << "Cost:" << result.get_optimal_cost() << std::endl;
+  std::cout << "Solve result: " << result.get_solution_result() << std::endl;
+  for (int mode = 0; mode < trajopt.num_modes(); ++mode) {
+    const auto stats = trajopt.dynamics_cache(mode).GetStatistics();
+    const int64_t lookups = stats.hits + stats.misses;
+    cout << "Dynamics cache (mode " << mode << "): hit rate "
+         << stats.hit_rate() << ", " << lookups << " lookups, "
+         << 1e6 * stats.lookup_time / std::max<int64_t>(lookups, 1)
+         << " us/lookup, "
+         << 1e6 * stats.compute_time / std::max<int64_t>(stats.misses, 1)
+         << " us/evaluation" << endl;
+  }
+
+  std::cout << "Lambda sol: " << result.GetSolution(trajopt.impulse_vars(1))
+            << std::endl;
+
+  // Save trajectory to file
+  DirconTrajectory saved_traj(plant, trajopt, result, "jumping_trajectory",
+                              "Decision variables and state/input trajectories "
+                              "for jumping");
+  saved_traj.WriteToFile(FLAGS_data_directory + FLAGS_save_filename);
+  std::cout << "Wrote to file: " << FLAGS_data_directory + FLAGS_save_filename
+            << std::endl;
+  drake::trajectories::PiecewisePolynomial<double> optimal_traj =
+      trajopt.ReconstructStateTrajectory(result);
+  multibody::ConnectTrajectoryVisualizer(&plant_vis, &builder, &scene_graph,
+                                         optimal_traj);
+
+  auto diagram = builder.Build();
+
+  while (true) {
+    drake::systems::Simulator<double> simulator(*diagram);
+    simulator.set_target_realtime_rate(0.5);
+    simulator.Initialize();
+    simulator.AdvanceTo(optimal_traj.end_time());
+  }
+}
+
+/// Builds the jumping problem for a jump height: solver options, constraints,
+/// costs and the initial guess from --load_filename. Solver output files and
+/// progress messages are only written if verbose is set, since the problems
+/// of a sweep are built on worker threads and would share them.
+std::unique_ptr<Dircon<double>> BuildDircon(
+    const MultibodyPlant<double>& plant, DirconModeSequence<double>* all_modes,
+    double height, const MatrixXd& spr_map, bool verbose) {
+  auto trajopt = std::make_unique<Dircon<double>>(*all_modes);
+  auto& prog = trajopt->prog();
+
   double tol = FLAGS_tol;
   if (FLAGS_ipopt) {
     // Ipopt settings adapted from CaSaDi and FROST
@@ -307,7 +433,9 @@ void DoMain() {
     prog.SetSolverOption(id, "nlp_upper_bound_inf", 1e6);
     prog.SetSolverOption(id, "print_timing_statistics", "yes");
     prog.SetSolverOption(id, "print_level", 5);
-    prog.SetSolverOption(id, "output_file", "../ipopt.out");
+    if (verbose) {
+      prog.SetSolverOption(id, "output_file", "../ipopt.out");
+    }
 
     // Set to ignore overall tolerance/dual infeasibility, but terminate when
     // primal feasible and objective fails to increase over 5 iterations.
@@ -319,9 +447,9 @@ void DoMain() {
   } else {
     // Snopt settings
     auto id = drake::solvers::SnoptSolver::id();
-    if (FLAGS_use_springs) {
+    if (verbose && FLAGS_use_springs) {
       prog.SetSolverOption(id, "Print file", "../w_springs_snopt.out");
-    } else {
+    } else if (verbose) {
       prog.SetSolverOption(id, "Print file", "../snopt.out");
     }
     prog.SetSolverOption(id, "Major iterations limit", 1e5);
@@ -339,76 +467,153 @@ void DoMain() {
     prog.SetSolverOption(id, "Major feasibility tolerance", tol);
   }
 
-  std::cout << "Adding kinematic constraints: " << std::endl;
-  SetKinematicConstraints(&trajopt, plant);
+  if (verbose) {
+    std::cout << "Adding kinematic constraints: " << std::endl;
+  }
+  SetKinematicConstraints(trajopt.get(), plant, height);
   if (FLAGS_use_springs) {
-    AddCostsSprings(&trajopt, plant, &all_modes);
+    AddCostsSprings(trajopt.get(), plant, all_modes);
   } else {
-    AddCosts(&trajopt, plant, &all_modes);
+    AddCosts(trajopt.get(), plant, all_modes);
   }
-  std::cout << "Setting initial conditions: " << std::endl;
-  vector<int> mode_lengths = {FLAGS_knot_points, FLAGS_knot_points,
-                              FLAGS_knot_points};
 
-  int num_knot_points = trajopt.N();
-  std::cout << "nq: " << n_q << endl;
-  std::cout << "nv: " << n_v << endl;
-  std::cout << "nu: " << plant.num_actuators() << endl;
-  cout << "N: " << num_knot_points << endl;
-  cout << "Num decision vars: " <<
-    prog.decision_variables().size() << endl;
 
   if (!FLAGS_load_filename.empty()) {
-    std::cout << "Loading: " << FLAGS_load_filename << std::endl;
-    SetInitialGuessFromTrajectory(trajopt, plant,
+    if (verbose) {
+      std::cout << "Loading: " << FLAGS_load_filename << std::endl;
+      if (FLAGS_use_springs && FLAGS_convert_to_springs &&
+          !FLAGS_same_knotpoints) {
+        std::cout << "Using spring conversion" << std::endl;
+      }
+    }
+    SetInitialGuessFromTrajectory(*trajopt, plant,
                                   FLAGS_data_directory + FLAGS_load_filename,
                                   FLAGS_same_knotpoints, spr_map);
-    //    trajopt->SetInitialGuessForAllVariables(decisionVars);
   }
+  return trajopt;
+}
 
-  double alpha = .2;
-  int num_poses = std::min(FLAGS_knot_points, 5);
-  trajopt.CreateVisualizationCallback(file_name, num_poses, alpha);
-
-  cout << "\nChoose the best solver: "
-       << drake::solvers::ChooseBestSolver(prog).name() << endl;
+/// Solves the jumping problem for each of --sweep_heights (or --height), from
+/// --num_starts initial guesses each, in parallel. Every successful solution
+/// is saved, and the lowest-cost one for each height is reported.
+void SolveSweep(const MultibodyPlant<double>& plant,
+                DirconModeSequence<double>* all_modes,
+                const MatrixXd& spr_map) {
+  vector<double> heights;
+  std::stringstream sweep(FLAGS_sweep_heights);
+  string height;
+  while (std::getline(sweep, height, ',')) {
+    heights.push_back(std::stod(height));
+  }
+  if (heights.empty()) {
+    heights.push_back(FLAGS_height);
+  }
+  if (FLAGS_continuation) {
+    SolveContinuation(plant, all_modes, spr_map, heights);
+    return;
+  }
+  const int num_starts = std::max(FLAGS_num_starts, 1);
+
+  // Problem i solves heights[i / num_starts], start i % num_starts
+  auto build_problem = [&](int i) {
+    auto trajopt =
+        BuildDircon(plant, all_modes, heights[i / num_starts], spr_map, false);
+    if (i % num_starts > 0) {
+      systems::trajectory_optimization::PerturbInitialGuess(
+          FLAGS_initial_guess_noise, i, &trajopt->prog());
+    }
+    return trajopt;
+  };
 
-  cout << "Solving DIRCON\n\n";
+  DirconMultiStartOptions options;
+  // IpoptSolver (with MUMPS) is not thread-safe
+  options.num_threads = FLAGS_ipopt ? 1 : FLAGS_sweep_threads;
+  options.filepath_prefix = FLAGS_data_directory + FLAGS_save_filename;
+  options.name = "jumping_trajectory";
+  options.description =
+      "Decision variables and state/input trajectories for jumping";
+
+  drake::solvers::IpoptSolver ipopt;
+  drake::solvers::SnoptSolver snopt;
+  const drake::solvers::SolverInterface& solver =
+      FLAGS_ipopt ? static_cast<const drake::solvers::SolverInterface&>(ipopt)
+                  : snopt;
+
+  cout << "Solving " << heights.size() * num_starts << " DIRCON problems\n\n";
   auto start = std::chrono::high_resolution_clock::now();
-  const auto result = drake::solvers::Solve(prog, prog.initial_guess());
+  const auto results = systems::trajectory_optimization::SolveDirconMultiStart(
+      plant, heights.size() * num_starts, build_problem, solver, options);
   auto finish = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double> elapsed = finish - start;
-  cout << "Solve time:" << elapsed.count() << std::endl;
-  std::cout << "Cost:" << result.get_optimal_cost() << std::endl;
-  std::cout << "Solve result: " << result.get_solution_result() << std::endl;
-
-  std::cout << "Lambda sol: " << result.GetSolution(trajopt.impulse_vars(1))
-            << std::endl;
-
-  // Save trajectory to file
-  DirconTrajectory saved_traj(plant, trajopt, result, "jumping_trajectory",
-                              "Decision variables and state/input trajectories "
-                              "for jumping");
-  saved_traj.WriteToFile(FLAGS_data_directory + FLAGS_save_filename);
-  std::cout << "Wrote to file: " << FLAGS_data_directory + FLAGS_save_filename
-            << std::endl;
-  drake::trajectories::PiecewisePolynomial<double> optimal_traj =
-      trajopt.ReconstructStateTrajectory(result);
-  multibody::ConnectTrajectoryVisualizer(&plant_vis, &builder, &scene_graph,
-                                         optimal_traj);
+  cout << "Total solve time:" << elapsed.count() << std::endl;
+
+  for (int h = 0; h < static_cast<int>(heights.size()); ++h) {
+    const vector<systems::trajectory_optimization::DirconMultiStartResult>
+        height_results(results.begin() + h * num_starts,
+                       results.begin() + (h + 1) * num_starts);
+    for (const auto& result : height_results) {
+      cout << "Height " << heights[h] << ", start "
+           << result.index % num_starts << ": " << result.solution_result
+           << ", cost " << result.cost << ", solve time " << result.solve_time
+           << endl;
+    }
+    const int best = systems::trajectory_optimization::
+        FindBestDirconMultiStartResult(height_results);
+    if (best < 0) {
+      cout << "Height " << heights[h] << ": no solution" << endl;
+    } else {
+      cout << "Height " << heights[h] << ": best solution "
+           << height_results[best].filepath << endl;
+    }
+  }
+}
 
-  auto diagram = builder.Build();
+/// Solves the jumping problem for each height by continuation, starting from
+/// the first height (from --load_filename, if given)
+void SolveContinuation(const MultibodyPlant<double>& plant,
+                       DirconModeSequence<double>* all_modes,
+                       const MatrixXd& spr_map, const vector<double>& heights) {
+  vector<VectorXd> grid;
+  for (double height : heights) {
+    grid.push_back(VectorXd::Constant(1, height));
+  }
+  auto build_problem = [&](const VectorXd& parameters) {
+    return BuildDircon(plant, all_modes, parameters(0), spr_map, false);
+  };
 
-  while (true) {
-    drake::systems::Simulator<double> simulator(*diagram);
-    simulator.set_target_realtime_rate(0.5);
-    simulator.Initialize();
-    simulator.AdvanceTo(optimal_traj.end_time());
+  DirconContinuationOptions options;
+  // IpoptSolver (with MUMPS) is not thread-safe
+  options.num_threads = FLAGS_ipopt ? 1 : FLAGS_sweep_threads;
+  options.filepath_prefix = FLAGS_data_directory + FLAGS_save_filename;
+  options.index_filepath =
+      FLAGS_data_directory + FLAGS_save_filename + "_index.csv";
+  options.parameter_names = {"height"};
+  options.name = "jumping_trajectory";
+  options.description =
+      "Decision variables and state/input trajectories for jumping";
+
+  drake::solvers::IpoptSolver ipopt;
+  drake::solvers::SnoptSolver snopt;
+  const drake::solvers::SolverInterface& solver =
+      FLAGS_ipopt ? static_cast<const drake::solvers::SolverInterface&>(ipopt)
+                  : snopt;
+
+  const auto entries =
+      systems::trajectory_optimization::SolveDirconContinuation(
+          plant, grid, build_problem, solver, options);
+  for (const auto& entry : entries) {
+    cout << "Height " << entry.parameters(0) << " (seeded from "
+         << (entry.seed_index < 0 ? string("initial guess")
+                                  : std::to_string(heights[entry.seed_index]))
+         << "): " << entry.solution_result << ", cost " << entry.cost
+         << ", solve time " << entry.solve_time << endl;
   }
+  cout << "Wrote library index to: " << options.index_filepath << endl;
 }
 
 void SetKinematicConstraints(Dircon<double>* trajopt,
-                             const MultibodyPlant<double>& plant) {
+                             const MultibodyPlant<double>& plant,
+                             double height) {
   // Create maps for joints
   map<string, int> pos_map = multibody::MakeNameToPositionsMap(plant);
   map<string, int> vel_map = multibody::MakeNameToVelocitiesMap(plant);
@@ -473,11 +678,11 @@ void SetKinematicConstraints(Dircon<double>* trajopt,
   // Jumping height constraints
   prog.AddBoundingBoxConstraint(rest_height - eps, rest_height + eps,
                                     x_0(pos_map.at("base_z")));
-  prog.AddBoundingBoxConstraint(0.5 * FLAGS_height + rest_height - eps,
-                                    FLAGS_height + rest_height + eps,
+  prog.AddBoundingBoxConstraint(0.5 * height + rest_height - eps,
+                                    height + rest_height + eps,
                                     x_top(pos_map.at("base_z")));
-  prog.AddBoundingBoxConstraint(0.8 * FLAGS_height + rest_height - eps,
-                                    0.8 * FLAGS_height + rest_height + eps,
+  prog.AddBoundingBoxConstraint(0.8 * height + rest_height - eps,
+                                    0.8 * height + rest_height + eps,
                                     x_f(pos_map.at("base_z")));
 
   // Zero starting and final velocities
@@ -540,8 +745,6 @@ void SetKinematicConstraints(Dircon<double>* trajopt,
   }
 
   // joint limits
-  std::cout << "Joint limit constraints: " << std::endl;
-
   for (const auto& member : joint_names) {
     trajopt->AddConstraintToAllKnotPoints(
         x(pos_map.at(member)) <=
@@ -552,7 +755,6 @@ void SetKinematicConstraints(Dircon<double>* trajopt,
   }
 
   // actuator limits
-  std::cout << "Actuator limit constraints: " << std::endl;
   for (int i = 0; i < trajopt->N(); i++) {
     auto ui = trajopt->input(i);
     prog.AddBoundingBoxConstraint(VectorXd::Constant(n_u, -175),
@@ -625,39 +827,39 @@ void SetKinematicConstraints(Dircon<double>* trajopt,
   auto left_foot_z_constraint =
       std::make_shared<PointPositionConstraint<double>>(
           plant, "toe_left", Vector3d::Zero(), Eigen::RowVector3d(0, 0, 1),
-          (1.25 * FLAGS_height - eps) * VectorXd::Ones(1),
-          (1.25 * FLAGS_height + eps) * VectorXd::Ones(1));
+          (1.25 * height - eps) * VectorXd::Ones(1),
+          (1.25 * height + eps) * VectorXd::Ones(1));
   auto right_foot_z_constraint =
       std::make_shared<PointPositionConstraint<double>>(
           plant, "toe_right", Vector3d::Zero(), Eigen::RowVector3d(0, 0, 1),
-          (1.25 * FLAGS_height - eps) * VectorXd::Ones(1),
-          (1.25 * FLAGS_height + eps) * VectorXd::Ones(1));
+          (1.25 * height - eps) * VectorXd::Ones(1),
+          (1.25 * height + eps) * VectorXd::Ones(1));
   prog.AddConstraint(left_foot_z_constraint, x_top.head(n_q));
   prog.AddConstraint(right_foot_z_constraint, x_top.head(n_q));
 
   auto left_foot_rear_z_final_constraint =
       std::make_shared<PointPositionConstraint<double>>(
           plant, "toe_left", pt_rear_contact, Eigen::RowVector3d(0, 0, 1),
-          (FLAGS_height - eps) * VectorXd::Ones(1),
-          (FLAGS_height + eps) * VectorXd::Ones(1));
+          (height - eps) * VectorXd::Ones(1),
+          (height + eps) * VectorXd::Ones(1));
   auto right_foot_rear_z_final_constraint =
       std::make_shared<PointPositionConstraint<double>>(
           plant, "toe_right", pt_rear_contact, Eigen::RowVector3d(0, 0, 1),
-          (FLAGS_height - eps) * VectorXd::Ones(1),
-          (FLAGS_height + eps) * VectorXd::Ones(1));
+          (height - eps) * VectorXd::Ones(1),
+          (height + eps) * VectorXd::Ones(1));
   prog.AddConstraint(left_foot_rear_z_final_constraint, x_f.head(n_q));
   prog.AddConstraint(right_foot_rear_z_final_constraint, x_f.head(n_q));
 
   auto left_foot_front_z_final_constraint =
       std::make_shared<PointPositionConstraint<double>>(
           plant, "toe_left", pt_front_contact, Eigen::RowVector3d(0, 0, 1),
-          (FLAGS_height - eps) * VectorXd::Ones(1),
-          (FLAGS_height + eps) * VectorXd::Ones(1));
+          (height - eps) * VectorXd::Ones(1),
+          (height + eps) * VectorXd::Ones(1));
   auto right_foot_front_z_final_constraint =
       std::make_shared<PointPositionConstraint<double>>(
           plant, "toe_right", pt_front_contact, Eigen::RowVector3d(0, 0, 1),
-          (FLAGS_height - eps) * VectorXd::Ones(1),
-          (FLAGS_height + eps) * VectorXd::Ones(1));
+          (height - eps) * VectorXd::Ones(1),
+          (height + eps) * VectorXd::Ones(1));
   prog.AddConstraint(left_foot_front_z_final_constraint, x_f.head(n_q));
   prog.AddConstraint(right_foot_front_z_final_constraint, x_f.head(n_q));
 
@@ -865,7 +1067,6 @@ void AddCostsSprings(Dircon<double>* trajopt,
     }
   }
 
-  std::cout << "n_v_: " << n_v << std::endl;
   MatrixXd Q = 0.01 * MatrixXd::Identity(n_v, n_v);
   MatrixXd R = 1e-4 * MatrixXd::Identity(n_u, n_u);
   Q *= FLAGS_cost_scaling;
@@ -916,7 +1117,6 @@ void SetInitialGuessFromTrajectory(Dircon<double>& trajopt,
   }
   PiecewisePolynomial<double> state_traj;
   if (FLAGS_use_springs && FLAGS_convert_to_springs) {
-    std::cout << "Using spring conversion" << std::endl;
     state_traj = previous_traj.ReconstructStateTrajectoryWithSprings(spr_map);
   } else {
     state_traj = previous_traj.ReconstructStateTrajectory();
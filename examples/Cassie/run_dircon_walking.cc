@@ -94,6 +94,9 @@ DEFINE_double(ground_incline, 0.0,
 // Parameters which enable scaling to improve solving speed
 DEFINE_bool(is_scale_constraint, true, "Scale the nonlinear constraint values");
 DEFINE_bool(is_scale_variable, true, "Scale the decision variable");
+DEFINE_bool(colored_finite_differences, true,
+            "Detect the sparsity of the constraint Jacobians and perturb "
+            "independent variables together when finite differencing");
 
 // Others
 DEFINE_bool(visualize_init_guess, false,
@@ -399,6 +402,8 @@ void DoMain(double duration, double stride_length, double ground_incline,
   // set force cost weight
   for (int i = 0; i < 2; i++) {
     options_list[i].setForceCost(w_lambda);
+    options_list[i].setColoredFiniteDifferences(
+        FLAGS_colored_finite_differences);
   }
 
   // Be careful in setting relative constraint, because we skip constraints
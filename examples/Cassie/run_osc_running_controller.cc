@@ -176,6 +176,10 @@ int DoMain(int argc, char* argv[]) {
   auto osc_debug_pub =
       builder.AddSystem(LcmPublisherSystem::Make<dairlib::lcmt_osc_output>(
           "OSC_DEBUG_RUNNING", &lcm, TriggerTypeSet({TriggerType::kForced})));
+  auto osc_timing_pub =
+      builder.AddSystem(LcmPublisherSystem::Make<dairlib::lcmt_stage_timing>(
+          "OSC_TIMING_RUNNING", &lcm, TriggerTypeSet({TriggerType::kPeriodic}),
+          0.1));
   auto failure_aggregator =
       builder.AddSystem<systems::ControllerFailureAggregator>(FLAGS_channel_u,
                                                               1);
@@ -602,6 +606,8 @@ int DoMain(int argc, char* argv[]) {
                   command_pub->get_input_port());
   builder.Connect(osc->get_output_port_osc_debug(),
                   osc_debug_pub->get_input_port());
+  builder.Connect(osc->get_output_port_timing(),
+                  osc_timing_pub->get_input_port());
   builder.Connect(osc->get_output_port_failure(),
                   failure_aggregator->get_input_port(0));
   builder.Connect(failure_aggregator->get_status_output_port(),
@@ -155,8 +155,10 @@ int DoMain(int argc, char* argv[]) {
   builder.Connect(target_height_receiver->get_output_port(),
                   com_traj_generator->get_input_port_target_height());
 
-  // Create Operational space control
-  auto osc = builder.AddSystem<systems::controllers::OperationalSpaceControl>(
+  // Create Operational space control (with the sizes of the plant without
+  // springs and the four contact points fixed at compile time)
+  auto osc = builder.AddSystem<
+      systems::controllers::CassieFixedSpringsOperationalSpaceControl>(
       plant_w_springs, plant_wo_springs, context_w_spr.get(),
       context_wo_spr.get(), false);
 
@@ -637,6 +637,13 @@ int DoMain(int argc, char* argv[]) {
             TriggerTypeSet({TriggerType::kForced})));
     builder.Connect(osc->get_output_port_osc_debug(),
                     osc_debug_pub->get_input_port());
+    // Per-stage latency histogram of the controller ticks, at a low rate
+    auto osc_timing_pub =
+        builder.AddSystem(LcmPublisherSystem::Make<dairlib::lcmt_stage_timing>(
+            "OSC_TIMING_WALKING", &lcm_local,
+            TriggerTypeSet({TriggerType::kPeriodic}), 0.1));
+    builder.Connect(osc->get_output_port_timing(),
+                    osc_timing_pub->get_input_port());
   }
 
   // Create the diagram
@@ -1,260 +1,422 @@
-#include <iostream>
+#include <map>
 #include <memory>
-#include <chrono>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include <benchmark/benchmark.h>
 #include <gflags/gflags.h>
 
 #include "common/find_resource.h"
-#include "drake/multibody/joints/floating_base_types.h"
-#include "drake/multibody/parsers/urdf_parser.h"
-#include "drake/multibody/rigid_body_plant/drake_visualizer.h"
-#include "drake/multibody/rigid_body_tree.h"
-#include "drake/systems/framework/diagram.h"
-#include "drake/systems/framework/diagram_builder.h"
-#include "drake/multibody/rigid_body_plant/rigid_body_plant.h"
+#include "examples/Cassie/cassie_utils.h"
+#include "multibody/kinematic/kinematic_evaluator_set.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "multibody/multibody_utils.h"
+#include "multibody/view_frame.h"
+#include "solvers/solver_options_io.h"
+#include "systems/controllers/osc/joint_space_tracking_data.h"
+#include "systems/controllers/osc/operational_space_control.h"
+#include "systems/controllers/osc/rot_space_tracking_data.h"
+#include "systems/controllers/osc/trans_space_tracking_data.h"
+#include "systems/framework/output_vector.h"
+
+#include "drake/common/trajectories/piecewise_polynomial.h"
+#include "drake/common/yaml/yaml_io.h"
 #include "drake/math/autodiff.h"
-#include "drake/multibody/parsing/parser.h"
-#include "drake/geometry/scene_graph.h"
-
-using drake::multibody::MultibodyPlant;
-using drake::geometry::SceneGraph;
-
-namespace drake {
-namespace examples {
+#include "drake/solvers/osqp_solver.h"
+#include "drake/systems/framework/basic_vector.h"
+
+/// Benchmarks of the dynamics and controller computations run every control
+/// tick, on Cassie with and without springs:
+///  - mass matrix and bias term (double and AutoDiffXd)
+///  - KinematicEvaluatorSet Jacobians (double and AutoDiffXd)
+///  - KinematicEvaluatorSet::CalcTimeDerivativesWithForce (double and
+///    AutoDiffXd)
+///  - OscTrackingData::Update for translational, rotational and joint tracking
+///  - a full OSC solve (the osc_command output, which calls SolveQp)
+///
+/// Every benchmark is repeated --repetitions times and reported as mean,
+/// median, standard deviation and coefficient of variation. The usual Google
+/// Benchmark flags apply, e.g. --benchmark_filter=AutoDiff to select
+/// benchmarks, or
+///   --benchmark_out=results.json --benchmark_out_format=json
+/// to save the results. Saved results are compared against a baseline with
+/// compare_benchmarks (see compare_benchmarks.py).
+///
+/// The state is set at every iteration, so that nothing is served from the
+/// plant's cache; the timings include that cost.
+
+DEFINE_int32(repetitions, 10,
+             "Number of repetitions of every benchmark, over which the "
+             "statistics are computed");
+
+namespace dairlib {
 namespace {
 
-typedef std::chrono::steady_clock my_clock;
-
-int do_main() {
-  const int num_reps = 100000;
-  const int num_autodiff_reps = 500;
-
-  // Build and test RigidBodyPlant
-  auto tree = std::make_unique<RigidBodyTree<double>>();
-  parsers::urdf::AddModelInstanceFromUrdfFileToWorld(
-    dairlib::FindResourceOrThrow("examples/Cassie/urdf/cassie_v2.urdf"),
-    multibody::joints::kFixed, tree.get());
-  systems::RigidBodyPlant<double> rigid_body_plant(std::move(tree));
+using drake::AutoDiffXd;
+using drake::MatrixX;
+using drake::VectorX;
+using drake::multibody::MultibodyPlant;
+using drake::systems::Context;
+using drake::trajectories::PiecewisePolynomial;
+using Eigen::Matrix3d;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+using multibody::KinematicEvaluator;
+using multibody::KinematicEvaluatorSet;
+using multibody::WorldPointEvaluator;
+using systems::OutputVector;
+using systems::controllers::JointSpaceTrackingData;
+using systems::controllers::OperationalSpaceControl;
+using systems::controllers::OscTrackingData;
+using systems::controllers::RotTaskSpaceTrackingData;
+using systems::controllers::TransTaskSpaceTrackingData;
+
+const int kLeftStance = 0;
+const int kRightStance = 1;
+
+std::unique_ptr<MultibodyPlant<double>> MakePlant(bool springs) {
+  auto plant = std::make_unique<MultibodyPlant<double>>(0.0);
+  AddCassieMultibody(plant.get(), nullptr, true /*floating base*/,
+                     springs ? "examples/Cassie/urdf/cassie_v2.urdf"
+                             : "examples/Cassie/urdf/cassie_fixed_springs.urdf",
+                     springs /*spring model*/, false /*loop closure*/);
+  plant->Finalize();
+  return plant;
+}
 
-  int nq = rigid_body_plant.get_rigid_body_tree().get_num_positions();
+// Standing state with bent knees and a small velocity
+VectorXd NominalState(const MultibodyPlant<double>& plant) {
+  VectorXd x(plant.num_positions() + plant.num_velocities());
+  auto context = plant.CreateDefaultContext();
+  x << plant.GetPositions(*context),
+      VectorXd::Constant(plant.num_velocities(), 0.1);
+  x(6) = 0.95;
+  auto pos_map = multibody::MakeNameToPositionsMap(plant);
+  for (const auto& side : {"_left", "_right"}) {
+    x(pos_map.at(std::string("knee") + side)) = -1.1;
+    x(pos_map.at(std::string("ankle_joint") + side)) = 1.4;
+    x(pos_map.at(std::string("toe") + side)) = -1.5;
+  }
+  return x;
+}
 
-  Eigen::VectorXd x = Eigen::VectorXd::Zero(2*nq);
+// Plant, context and the holonomic and contact constraints of the walking
+// controllers (loop closures and the four toe contacts)
+template <typename T>
+struct CassieModel {
+  explicit CassieModel(bool springs) {
+    auto plant_double = MakePlant(springs);
+    x_double = NominalState(*plant_double);
+    if constexpr (std::is_same_v<T, double>) {
+      plant = std::move(plant_double);
+      x = x_double;
+    } else {
+      plant = drake::systems::System<double>::ToAutoDiffXd(*plant_double);
+      x = drake::math::InitializeAutoDiff(x_double);
+    }
+    context = plant->CreateDefaultContext();
+    plant->get_actuation_input_port().FixValue(
+        context.get(), VectorX<T>::Zero(plant->num_actuators()));
+
+    evaluators = std::make_unique<KinematicEvaluatorSet<T>>(*plant);
+    owned.push_back(std::make_unique<multibody::DistanceEvaluator<T>>(
+        LeftLoopClosureEvaluator(*plant)));
+    owned.push_back(std::make_unique<multibody::DistanceEvaluator<T>>(
+        RightLoopClosureEvaluator(*plant)));
+    for (const auto& pt : {LeftToeFront(*plant), LeftToeRear(*plant),
+                           RightToeFront(*plant), RightToeRear(*plant)}) {
+      owned.push_back(std::make_unique<WorldPointEvaluator<T>>(
+          *plant, pt.first, pt.second));
+    }
+    for (const auto& e : owned) {
+      evaluators->add_evaluator(e.get());
+    }
+  }
 
-  auto start =  my_clock::now();
-  for (int i = 0; i < num_reps; i++) {
-    x(0) = i;
-    auto cache = rigid_body_plant.get_rigid_body_tree().doKinematics(
-        x.head(nq));
-    rigid_body_plant.get_rigid_body_tree().massMatrix(cache);
+  // Sets the state, perturbed by `i` so that consecutive iterations differ
+  void SetState(int i) {
+    if constexpr (std::is_same_v<T, double>) {
+      x(0) = 1 - 1e-6 * (i % 10);
+    } else {
+      x(0).value() = 1 - 1e-6 * (i % 10);
+    }
+    plant->SetPositionsAndVelocities(context.get(), x);
   }
-  auto stop =  my_clock::now();
-  auto duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-      std::cout << "c" << std::endl;
-  std::cout << "(rigid_body_plant) " << std::to_string(num_reps) <<
-      "x inertia calculations took " << duration.count() << " miliseconds. " << 
-      1000*duration.count()/num_reps << " microseconds per." << std::endl;
-
-  start =  my_clock::now();
-  for (int i = 0; i < num_autodiff_reps; i++) {
-    x(0) = i;
-    auto cache = rigid_body_plant.get_rigid_body_tree().
-        doKinematics(math::initializeAutoDiff(x.head(nq)));
-    rigid_body_plant.get_rigid_body_tree().massMatrix(cache);
+
+  std::unique_ptr<MultibodyPlant<T>> plant;
+  std::unique_ptr<Context<T>> context;
+  VectorXd x_double;
+  VectorX<T> x;
+  std::vector<std::unique_ptr<KinematicEvaluator<T>>> owned;
+  std::unique_ptr<KinematicEvaluatorSet<T>> evaluators;
+};
+
+// Models are built once per scalar type and spring configuration, outside of
+// the timed regions
+template <typename T>
+CassieModel<T>* GetModel(bool springs) {
+  static std::map<bool, std::unique_ptr<CassieModel<T>>> models;
+  auto& model = models[springs];
+  if (!model) {
+    model = std::make_unique<CassieModel<T>>(springs);
   }
-  stop =  my_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  std::cout << "(rigid_body_plant) " << std::to_string(num_autodiff_reps) <<
-      "x inertia autodiff calculations took " << duration.count() <<
-      " miliseconds. " << 1000*duration.count()/num_autodiff_reps <<
-      " microseconds per." << std::endl;
-
-
-  // Build and test multibody plant
-  systems::DiagramBuilder<double> builder;
-  MultibodyPlant<double>& multibody_plant =
-      *builder.AddSystem<MultibodyPlant>(0.0);
-
-  SceneGraph<double>& scene_graph = *builder.AddSystem<SceneGraph>();
-  scene_graph.set_name("scene_graph");
-
-  multibody::Parser parser(&multibody_plant, &scene_graph);
-  parser.AddModelFromFile(dairlib::FindResourceOrThrow(
-      "examples/Cassie/urdf/cassie_v2.urdf"));
-
-  multibody_plant.WeldFrames(
-    multibody_plant.world_frame(), multibody_plant.GetFrameByName("pelvis"));
-  multibody_plant.Finalize();
-
-  auto multibody_context = multibody_plant.CreateDefaultContext();
-  multibody_context->EnableCaching();
-
-  start =  my_clock::now();
-  Eigen::MatrixXd M(nq, nq);
-  for (int i = 0; i < num_reps; i++) {
-    x(0) = i;
-    multibody_context->get_mutable_continuous_state_vector().SetFromVector(x);
-    multibody_plant.CalcMassMatrixViaInverseDynamics(*multibody_context, &M);
+  return model.get();
+}
+
+template <typename T>
+void MassMatrix(benchmark::State& state, bool springs) {
+  auto* model = GetModel<T>(springs);
+  const int n_v = model->plant->num_velocities();
+  MatrixX<T> M(n_v, n_v);
+  int i = 0;
+  for (auto _ : state) {
+    model->SetState(i++);
+    model->plant->CalcMassMatrix(*model->context, &M);
+    benchmark::DoNotOptimize(M.data());
   }
-  stop =  my_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  std::cout << "(multibody_plant) " << std::to_string(num_reps) <<
-      "x inverse-dynamics inertia calculations took " << duration.count() << " miliseconds. " <<
-      1000*duration.count()/num_reps << " microseconds per." << std::endl;
-
-  start =  my_clock::now();
-  for (int i = 0; i < num_reps; i++) {
-    x(0) = i;
-    multibody_context->get_mutable_continuous_state_vector().SetFromVector(x);
-    multibody_plant.CalcMassMatrix(*multibody_context, &M);
+}
+
+template <typename T>
+void BiasTerm(benchmark::State& state, bool springs) {
+  auto* model = GetModel<T>(springs);
+  VectorX<T> C(model->plant->num_velocities());
+  int i = 0;
+  for (auto _ : state) {
+    model->SetState(i++);
+    model->plant->CalcBiasTerm(*model->context, &C);
+    benchmark::DoNotOptimize(C.data());
   }
-  stop =  my_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  std::cout << "(multibody_plant) " << std::to_string(num_reps) <<
-      "x inertia calculations took " << duration.count() << " miliseconds. " <<
-      1000*duration.count()/num_reps << " microseconds per." << std::endl;
-
-
-  // Build and test multibody plant w/autodiff
-  // std::unique_ptr<MultibodyPlant<AutoDiffXd>> multibody_plant_autodiff =
-  //   multibody_plant.ToAutoDiffXd();
-
-
-  std::unique_ptr<MultibodyPlant<AutoDiffXd>> multibody_plant_autodiff =
-      systems::System<double>::ToAutoDiffXd(multibody_plant);
-
-  auto multibody_context_autodiff =
-    multibody_plant_autodiff->CreateDefaultContext();
-  multibody_context_autodiff->EnableCaching();
-
-  start =  my_clock::now();
-  MatrixX<AutoDiffXd> M_autodiff(nq, nq);
-  for (int i = 0; i < num_autodiff_reps; i++) {
-    x(0) = i;
-    multibody_context_autodiff->get_mutable_continuous_state_vector().
-        SetFromVector(math::initializeAutoDiff(x));
-    multibody_plant_autodiff->CalcMassMatrixViaInverseDynamics(
-        *multibody_context_autodiff, &M_autodiff);
+}
+
+template <typename T>
+void EvaluatorJacobian(benchmark::State& state, bool springs) {
+  auto* model = GetModel<T>(springs);
+  MatrixX<T> J(model->evaluators->count_full(),
+               model->plant->num_velocities());
+  int i = 0;
+  for (auto _ : state) {
+    model->SetState(i++);
+    model->evaluators->EvalFullJacobian(*model->context, &J);
+    benchmark::DoNotOptimize(J.data());
   }
-  stop =  my_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  std::cout << "(multibody_plant) " << std::to_string(num_autodiff_reps) <<
-      "x inverse-dynamics inertia autodiff calculations took " << duration.count() <<
-      " miliseconds. " << 1000*duration.count()/num_autodiff_reps <<
-      " microseconds per." << std::endl;
-
-  start =  my_clock::now();
-  for (int i = 0; i < num_autodiff_reps; i++) {
-    x(0) = i;
-    multibody_context_autodiff->get_mutable_continuous_state_vector().
-        SetFromVector(math::initializeAutoDiff(x));
-    multibody_plant_autodiff->CalcMassMatrix(
-        *multibody_context_autodiff, &M_autodiff);
+}
+
+template <typename T>
+void TimeDerivativesWithForce(benchmark::State& state, bool springs) {
+  auto* model = GetModel<T>(springs);
+  VectorX<T> lambda = VectorX<T>::Zero(model->evaluators->count_active());
+  // Vertical contact forces supporting the robot
+  for (int j = 0; j < 4; j++) {
+    lambda(2 + 3 * j + 2) = 80;
   }
-  stop =  my_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  std::cout << "(multibody_plant) " << std::to_string(num_autodiff_reps) <<
-      "x inertia autodiff calculations took " << duration.count() <<
-      " miliseconds. " << 1000*duration.count()/num_autodiff_reps <<
-      " microseconds per." << std::endl;
-
-
-  // rigid body inverse dynamics
-  Eigen::VectorXd desired_vdot(nq);
-  start =  my_clock::now();
-    RigidBodyTree<double>::BodyToWrenchMap external_wrenches;
-
-  for (int i = 0; i < num_reps; i++) {
-    x = Eigen::VectorXd::Constant(2*nq, i);
-    desired_vdot = Eigen::VectorXd::Constant(nq, i);
-    auto cache = rigid_body_plant.get_rigid_body_tree().doKinematics(x.head(nq),
-                                                                     x.tail(nq));
-    rigid_body_plant.get_rigid_body_tree().inverseDynamics(cache,
-        external_wrenches, desired_vdot);
+  int i = 0;
+  for (auto _ : state) {
+    model->SetState(i++);
+    VectorX<T> xdot = model->evaluators->CalcTimeDerivativesWithForce(
+        model->context.get(), lambda);
+    benchmark::DoNotOptimize(xdot.data());
   }
-  stop =  my_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  std::cout << "(rigid_body_plant) " << std::to_string(num_reps) <<
-      "x inverse dynamics calculations took "<< duration.count() <<
-      " miliseconds. " << 1000*duration.count()/num_reps << " microseconds per."
-      << std::endl;
-
-
-  start =  my_clock::now();
-    RigidBodyTree<AutoDiffXd>::BodyToWrenchMap external_wrenches_autodiff;
-
-  for (int i = 0; i < num_autodiff_reps; i++) {
-    x = Eigen::VectorXd::Constant(2*nq, i);
-    desired_vdot = Eigen::VectorXd::Constant(nq, i);
-    auto cache = rigid_body_plant.get_rigid_body_tree().doKinematics(
-        math::initializeAutoDiff(x.head(nq)),
-        math::initializeAutoDiff(x.tail(nq)));
-    rigid_body_plant.get_rigid_body_tree().inverseDynamics(cache,
-        external_wrenches_autodiff, math::initializeAutoDiff(desired_vdot));
+}
+
+// Tracking data with a constant target, checked and updated as in the OSC
+void TrackingDataUpdate(benchmark::State& state, bool springs,
+                        const std::string& type) {
+  auto* model = GetModel<double>(springs);
+  const auto& plant = *model->plant;
+  MatrixXd K_p = 100 * MatrixXd::Identity(3, 3);
+  MatrixXd K_d = 10 * MatrixXd::Identity(3, 3);
+  MatrixXd W = 10 * MatrixXd::Identity(3, 3);
+  std::unique_ptr<OscTrackingData> tracking_data;
+  VectorXd target;
+  if (type == "trans") {
+    auto data = std::make_unique<TransTaskSpaceTrackingData>(
+        "pelvis_traj", K_p, K_d, W, plant, plant);
+    data->AddPointToTrack("pelvis");
+    tracking_data = std::move(data);
+    target = Vector3d(0, 0, 0.95);
+  } else if (type == "rot") {
+    auto data = std::make_unique<RotTaskSpaceTrackingData>(
+        "pelvis_rot_traj", K_p, K_d, W, plant, plant);
+    data->AddFrameToTrack("pelvis");
+    tracking_data = std::move(data);
+    target = Eigen::Vector4d(1, 0, 0, 0);
+  } else {
+    DRAKE_DEMAND(type == "joint");
+    auto data = std::make_unique<JointSpaceTrackingData>(
+        "swing_toe_traj", K_p.topLeftCorner(1, 1), K_d.topLeftCorner(1, 1),
+        W.topLeftCorner(1, 1), plant, plant);
+    data->AddJointToTrack("toe_right", "toe_rightdot");
+    tracking_data = std::move(data);
+    target = -1.5 * VectorXd::Ones(1);
   }
-  stop =  my_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  std::cout << "(rigid_body_plant) " << std::to_string(num_autodiff_reps) <<
-      "xautodiff inverse dynamics calculations took "<< duration.count() <<
-      " miliseconds. " << 1000*duration.count()/num_autodiff_reps <<
-      " microseconds per." << std::endl;
-
-  // multibody inverse dynamics
-  start =  my_clock::now();
-  multibody::MultibodyForces<double> external_forces(multibody_plant);
-
-  for (int i = 0; i < num_reps; i++) {
-    x = Eigen::VectorXd::Constant(2*nq, i);
-    desired_vdot = Eigen::VectorXd::Constant(nq, i);
-    multibody_context->get_mutable_continuous_state_vector().SetFromVector(x);
-    multibody_plant.CalcInverseDynamics(*multibody_context, desired_vdot,
-                                        external_forces);
+  tracking_data->CheckOscTrackingData();
+  const PiecewisePolynomial<double> traj(target);
+  const VectorXd v_proj = VectorXd::Zero(plant.num_velocities());
+
+  int i = 0;
+  for (auto _ : state) {
+    model->SetState(i);
+    double t = 5e-4 * i++;
+    tracking_data->Update(model->x, *model->context, model->x, *model->context,
+                          traj, t, t, kLeftStance, v_proj);
+    benchmark::DoNotOptimize(tracking_data->GetYddotCommand().data());
   }
-  stop =  my_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  std::cout << "(multibody_plant) " << std::to_string(num_reps) <<
-      "x inverse dynamics calculations took " << duration.count() <<
-      " miliseconds. " << 1000*duration.count()/num_reps << " microseconds per."
-      << std::endl;
-
-
-  start =  my_clock::now();
-  multibody::MultibodyForces<AutoDiffXd> external_forces_autodiff(
-      *multibody_plant_autodiff);
-
-  for (int i = 0; i < num_autodiff_reps; i++) {
-    x = Eigen::VectorXd::Constant(2*nq, i);
-    desired_vdot = Eigen::VectorXd::Constant(nq, i);
-    multibody_context_autodiff->get_mutable_continuous_state_vector().
-        SetFromVector(math::initializeAutoDiff(x));
-    multibody_plant_autodiff->CalcInverseDynamics(*multibody_context_autodiff,
-        math::initializeAutoDiff(desired_vdot), external_forces_autodiff);
+}
+
+// Owns the walking OSC in left stance and the constraints it references
+struct OscSetup {
+  explicit OscSetup(CassieModel<double>* model)
+      : view_frame(model->plant->GetBodyByName("pelvis")) {
+    const auto& plant = *model->plant;
+    int n_v = plant.num_velocities();
+    int n_u = plant.num_actuators();
+    osc = std::make_unique<OperationalSpaceControl>(
+        plant, plant, model->context.get(), model->context.get(), true);
+    osc->SetAccelerationCostWeights(1e-4 * MatrixXd::Identity(n_v, n_v));
+    osc->SetInputSmoothingCostWeights(1e-6 * MatrixXd::Identity(n_u, n_u));
+    osc->SetContactSoftConstraintWeight(10);
+    osc->SetContactFriction(0.4);
+
+    // Loop closures as holonomic constraints
+    loops = std::make_unique<KinematicEvaluatorSet<double>>(plant);
+    loops->add_evaluator(model->owned[0].get());
+    loops->add_evaluator(model->owned[1].get());
+    osc->AddKinematicConstraint(loops.get());
+
+    auto add_contact = [&](const std::pair<const Vector3d,
+                                           const drake::multibody::Frame<
+                                               double>&>& pt,
+                           int state, std::vector<int> active_directions) {
+      contacts.push_back(std::make_unique<WorldPointEvaluator<double>>(
+          plant, pt.first, pt.second, view_frame, Matrix3d::Identity(),
+          Vector3d::Zero(), active_directions));
+      osc->AddStateAndContactPoint(state, contacts.back().get());
+    };
+    add_contact(LeftToeFront(plant), kLeftStance, {1, 2});
+    add_contact(LeftToeRear(plant), kLeftStance, {0, 1, 2});
+    add_contact(RightToeFront(plant), kRightStance, {1, 2});
+    add_contact(RightToeRear(plant), kRightStance, {0, 1, 2});
+
+    MatrixXd K_p = 100 * MatrixXd::Identity(3, 3);
+    MatrixXd K_d = 10 * MatrixXd::Identity(3, 3);
+    MatrixXd W = 10 * MatrixXd::Identity(3, 3);
+    auto pelvis_traj = std::make_unique<TransTaskSpaceTrackingData>(
+        "pelvis_traj", K_p, K_d, W, plant, plant);
+    pelvis_traj->AddPointToTrack("pelvis");
+    osc->AddConstTrackingData(std::move(pelvis_traj), Vector3d(0, 0, 0.95));
+    auto pelvis_rot_traj = std::make_unique<RotTaskSpaceTrackingData>(
+        "pelvis_rot_traj", K_p, K_d, W, plant, plant);
+    pelvis_rot_traj->AddFrameToTrack("pelvis");
+    osc->AddConstTrackingData(std::move(pelvis_rot_traj),
+                              Eigen::Vector4d(1, 0, 0, 0));
+    auto swing_ft_traj = std::make_unique<TransTaskSpaceTrackingData>(
+        "swing_ft_traj", K_p, K_d, W, plant, plant);
+    swing_ft_traj->AddStateAndPointToTrack(kLeftStance, "toe_right");
+    swing_ft_traj->AddStateAndPointToTrack(kRightStance, "toe_left");
+    osc->AddConstTrackingData(std::move(swing_ft_traj), Vector3d(0, 0, 0.1));
+
+    osc->SetOsqpSolverOptions(
+        drake::yaml::LoadYamlFile<solvers::SolverOptionsFromYaml>(
+            FindResourceOrThrow("examples/Cassie/osc/solver_settings/"
+                                "osqp_options_walking.yaml"))
+            .GetAsSolverOptions(drake::solvers::OsqpSolver::id()));
+    osc->Build();
   }
-  stop =  my_clock::now();
-  duration =
-      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
-  std::cout << "(multibody_plant) " << std::to_string(num_autodiff_reps) <<
-      "xautodiff inverse dynamics calculations took " << duration.count() <<
-      " miliseconds. " << 1000*duration.count()/num_autodiff_reps <<
-      " microseconds per." << std::endl;
 
+  multibody::WorldYawViewFrame<double> view_frame;
+  std::unique_ptr<KinematicEvaluatorSet<double>> loops;
+  std::vector<std::unique_ptr<WorldPointEvaluator<double>>> contacts;
+  std::unique_ptr<OperationalSpaceControl> osc;
+};
+
+void OscSolve(benchmark::State& state, bool springs) {
+  auto* model = GetModel<double>(springs);
+  const auto& plant = *model->plant;
+  OscSetup setup(model);
+  auto osc_context = setup.osc->CreateDefaultContext();
+  const auto& output_port = setup.osc->get_output_port_osc_command();
+  auto output = output_port.Allocate();
+
+  const int n_q = plant.num_positions();
+  const int n_v = plant.num_velocities();
+  const int n_u = plant.num_actuators();
+  OutputVector<double> robot_output(n_q, n_v, n_u);
+  robot_output.SetPositions(model->x_double.head(n_q));
+  robot_output.SetVelocities(VectorXd::Zero(n_v));
+  robot_output.SetEfforts(VectorXd::Zero(n_u));
+  drake::systems::BasicVector<double> fsm(1);
+  drake::systems::BasicVector<double> clock(1);
+  fsm[0] = kLeftStance;
+
+  int i = 0;
+  for (auto _ : state) {
+    double t = 5e-4 * i;
+    clock[0] = t;
+    robot_output.set_timestamp(t);
+    robot_output.get_mutable_value()(0) = 1 - 1e-6 * (i % 10);
+    i++;
+    osc_context->SetTime(t);
+    setup.osc->get_input_port_robot_output().FixValue(osc_context.get(),
+                                                      robot_output);
+    setup.osc->get_input_port_fsm().FixValue(osc_context.get(), fsm);
+    setup.osc->get_input_port_clock().FixValue(osc_context.get(), clock);
+    output_port.Calc(*osc_context, output.get());
+  }
+}
 
-  return 0;
+void RegisterBenchmarks() {
+  for (bool springs : {true, false}) {
+    const std::string suffix = springs ? "/springs" : "/fixed_springs";
+    std::vector<benchmark::internal::Benchmark*> benchmarks = {
+        benchmark::RegisterBenchmark(("MassMatrix/double" + suffix).c_str(),
+                                     MassMatrix<double>, springs),
+        benchmark::RegisterBenchmark(("MassMatrix/AutoDiff" + suffix).c_str(),
+                                     MassMatrix<AutoDiffXd>, springs),
+        benchmark::RegisterBenchmark(("BiasTerm/double" + suffix).c_str(),
+                                     BiasTerm<double>, springs),
+        benchmark::RegisterBenchmark(("BiasTerm/AutoDiff" + suffix).c_str(),
+                                     BiasTerm<AutoDiffXd>, springs),
+        benchmark::RegisterBenchmark(
+            ("EvaluatorJacobian/double" + suffix).c_str(),
+            EvaluatorJacobian<double>, springs),
+        benchmark::RegisterBenchmark(
+            ("EvaluatorJacobian/AutoDiff" + suffix).c_str(),
+            EvaluatorJacobian<AutoDiffXd>, springs),
+        benchmark::RegisterBenchmark(
+            ("TimeDerivativesWithForce/double" + suffix).c_str(),
+            TimeDerivativesWithForce<double>, springs),
+        benchmark::RegisterBenchmark(
+            ("TimeDerivativesWithForce/AutoDiff" + suffix).c_str(),
+            TimeDerivativesWithForce<AutoDiffXd>, springs),
+        benchmark::RegisterBenchmark(
+            ("TrackingDataUpdate/trans" + suffix).c_str(), TrackingDataUpdate,
+            springs, std::string("trans")),
+        benchmark::RegisterBenchmark(
+            ("TrackingDataUpdate/rot" + suffix).c_str(), TrackingDataUpdate,
+            springs, std::string("rot")),
+        benchmark::RegisterBenchmark(
+            ("TrackingDataUpdate/joint" + suffix).c_str(), TrackingDataUpdate,
+            springs, std::string("joint")),
+        benchmark::RegisterBenchmark(("OscSolve" + suffix).c_str(), OscSolve,
+                                     springs)};
+    for (auto* b : benchmarks) {
+      b->Unit(benchmark::kMicrosecond)
+          ->Repetitions(FLAGS_repetitions)
+          ->ReportAggregatesOnly(true);
+    }
+  }
 }
 
 }  // namespace
-}  // namespace examples
-}  // namespace drake
+}  // namespace dairlib
 
 int main(int argc, char* argv[]) {
+  benchmark::Initialize(&argc, argv);
   gflags::ParseCommandLineFlags(&argc, &argv, true);
-  return drake::examples::do_main();
-}
\ No newline at end of file
+  dairlib::RegisterBenchmarks();
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
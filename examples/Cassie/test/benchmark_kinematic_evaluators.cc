@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "examples/Cassie/cassie_utils.h"
+#include "multibody/kinematic/distance_evaluator.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "multibody/multibody_utils.h"
+#include "multibody/view_frame.h"
+
+/// Microbenchmark of the Cassie toe contact and loop closure evaluators, as
+/// evaluated by the OSC every tick. Each evaluation (phi, active Jacobian and
+/// active Jdot * v) is timed through
+///  - the baseline: the by-value implementation the evaluators had before
+///    the fixed-size evaluators, reproduced here from the plant queries,
+///  - the API returning by value, and
+///  - the output-parameter API writing into preallocated outputs.
+/// The baseline results are checked against the output-parameter ones.
+
+DEFINE_int32(num_evals, 20000, "Number of evaluations per configuration");
+
+namespace dairlib {
+namespace {
+
+using drake::multibody::Frame;
+using drake::multibody::MultibodyPlant;
+using drake::systems::Context;
+using Eigen::Matrix3d;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+using multibody::KinematicEvaluator;
+using multibody::WorldPointEvaluator;
+
+typedef std::chrono::steady_clock my_clock;
+
+// Selects the active rows of a full evaluation, by value
+MatrixXd ActiveRows(const KinematicEvaluator<double>& e, const MatrixXd& full) {
+  MatrixXd active(e.num_active(), full.cols());
+  for (int i = 0; i < e.num_active(); i++) {
+    active.row(i) = full.row(e.active_inds().at(i));
+  }
+  return active;
+}
+
+// The baseline evaluation of a toe contact (one point, in the view frame,
+// with no offset or ground rotation) or of a loop closure (two points),
+// with the same temporaries as the original implementation
+void EvalBaseline(const MultibodyPlant<double>& plant,
+                  const Context<double>& context,
+                  const multibody::ViewFrame<double>& view_frame,
+                  const KinematicEvaluator<double>& e, VectorXd* phi,
+                  MatrixXd* J, VectorXd* Jdotv) {
+  using drake::multibody::JacobianWrtVariable;
+  const auto& world = plant.world_frame();
+  const auto points = e.GetPoints();
+  const int n_v = plant.num_velocities();
+  VectorXd phi_full;
+  MatrixXd J_full;
+  VectorXd Jdotv_full;
+  if (points.size() == 1) {
+    const Frame<double>& frame = *points[0].first;
+    const Vector3d& pt = points[0].second;
+    VectorXd pt_world(3);
+    plant.CalcPointsPositions(context, frame, pt, world, &pt_world);
+    phi_full = Matrix3d::Identity() * pt_world;
+
+    J_full.resize(3, n_v);
+    plant.CalcJacobianTranslationalVelocity(context, JacobianWrtVariable::kV,
+                                            frame, pt, world, world, &J_full);
+    J_full = view_frame.CalcWorldToFrameRotation(plant, context) *
+             (Matrix3d::Identity() * J_full);
+
+    MatrixXd Jdot_times_V = plant.CalcBiasTranslationalAcceleration(
+        context, JacobianWrtVariable::kV, frame, pt, world, world);
+    Jdotv_full = view_frame.CalcWorldToFrameRotation(plant, context) *
+                 (Matrix3d::Identity() * Jdot_times_V);
+  } else {
+    const Frame<double>& frame_A = *points[0].first;
+    const Frame<double>& frame_B = *points[1].first;
+    const Vector3d& pt_A = points[0].second;
+    const Vector3d& pt_B = points[1].second;
+    VectorXd pt_A_world(3);
+    VectorXd pt_B_world(3);
+    plant.CalcPointsPositions(context, frame_A, pt_A, world, &pt_A_world);
+    plant.CalcPointsPositions(context, frame_B, pt_B, world, &pt_B_world);
+    VectorXd rel_pos = pt_A_world - pt_B_world;
+    phi_full = VectorXd::Constant(1, rel_pos.norm() - kCassieAchillesLength);
+
+    MatrixXd J_A(3, n_v);
+    MatrixXd J_B(3, n_v);
+    plant.CalcJacobianTranslationalVelocity(context, JacobianWrtVariable::kV,
+                                            frame_A, pt_A, world, world, &J_A);
+    plant.CalcJacobianTranslationalVelocity(context, JacobianWrtVariable::kV,
+                                            frame_B, pt_B, world, world, &J_B);
+    MatrixXd J_rel = J_A - J_B;
+    J_full = (rel_pos.transpose() * J_rel) / rel_pos.norm();
+
+    VectorXd J_rel_dot_times_v =
+        plant.CalcBiasTranslationalAcceleration(
+            context, JacobianWrtVariable::kV, frame_A, pt_A, world, world) -
+        plant.CalcBiasTranslationalAcceleration(
+            context, JacobianWrtVariable::kV, frame_B, pt_B, world, world);
+    double phi = rel_pos.norm();
+    double phidot = J_full.row(0).dot(plant.GetVelocities(context));
+    VectorXd J_rel_v = J_rel * plant.GetVelocities(context);
+    Jdotv_full = VectorXd::Constant(
+        1, J_rel_v.squaredNorm() / phi + rel_pos.dot(J_rel_dot_times_v) / phi -
+               phidot * rel_pos.dot(J_rel_v) / (phi * phi));
+  }
+  phi->head(e.num_active()) = ActiveRows(e, phi_full);
+  J->topRows(e.num_active()) = ActiveRows(e, J_full);
+  Jdotv->head(e.num_active()) = ActiveRows(e, Jdotv_full);
+}
+
+void PrintStats(const std::string& name, std::vector<double> times_us) {
+  std::sort(times_us.begin(), times_us.end());
+  double mean = 0;
+  for (double t : times_us) mean += t;
+  mean /= times_us.size();
+  std::cout << name << ": mean " << mean << " us, median "
+            << times_us[times_us.size() / 2] << " us, p99 "
+            << times_us[static_cast<int>(0.99 * (times_us.size() - 1))]
+            << " us" << std::endl;
+}
+
+// Times `eval` on every evaluator, with the state perturbed between calls so
+// that nothing is served from the plant's cache
+template <typename F>
+void Time(const std::string& name, const MultibodyPlant<double>& plant,
+          Context<double>* context,
+          const std::vector<const KinematicEvaluator<double>*>& evaluators,
+          F eval) {
+  VectorXd v = VectorXd::Constant(plant.num_velocities(), 0.1);
+  std::vector<double> times_us;
+  times_us.reserve(FLAGS_num_evals);
+  for (int i = 0; i < FLAGS_num_evals; i++) {
+    v(0) = 1e-3 * (i % 7);
+    plant.SetVelocities(context, v);
+    auto start = my_clock::now();
+    for (const auto* e : evaluators) {
+      eval(*e);
+    }
+    auto stop = my_clock::now();
+    times_us.push_back(
+        std::chrono::duration<double, std::micro>(stop - start).count());
+  }
+  PrintStats(name, times_us);
+}
+
+int DoMain(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  MultibodyPlant<double> plant(0.0);
+  AddCassieMultibody(&plant, nullptr, true /*floating base*/,
+                     "examples/Cassie/urdf/cassie_v2.urdf",
+                     true /*spring model*/, false /*loop closure*/);
+  plant.Finalize();
+  auto context = plant.CreateDefaultContext();
+  VectorXd q = plant.GetPositions(*context);
+  q(6) = 0.95;
+  auto pos_map = multibody::MakeNameToPositionsMap(plant);
+  for (const auto& side : {"_left", "_right"}) {
+    q(pos_map.at(std::string("knee") + side)) = -1.1;
+    q(pos_map.at(std::string("ankle_joint") + side)) = 1.4;
+    q(pos_map.at(std::string("toe") + side)) = -1.5;
+  }
+  plant.SetPositions(context.get(), q);
+
+  // Toe contacts as in the walking controller, and the loop closures
+  multibody::WorldYawViewFrame<double> view_frame(
+      plant.GetBodyByName("pelvis"));
+  std::vector<std::unique_ptr<KinematicEvaluator<double>>> owned;
+  auto add_contact =
+      [&](const std::pair<const Vector3d, const Frame<double>&>& pt,
+          std::vector<int> active_directions) {
+        owned.push_back(std::make_unique<WorldPointEvaluator<double>>(
+            plant, pt.first, pt.second, view_frame, Matrix3d::Identity(),
+            Vector3d::Zero(), active_directions));
+      };
+  add_contact(LeftToeFront(plant), {1, 2});
+  add_contact(LeftToeRear(plant), {0, 1, 2});
+  add_contact(RightToeFront(plant), {1, 2});
+  add_contact(RightToeRear(plant), {0, 1, 2});
+  std::vector<const KinematicEvaluator<double>*> contacts;
+  for (const auto& e : owned) contacts.push_back(e.get());
+
+  owned.push_back(std::make_unique<multibody::DistanceEvaluator<double>>(
+      LeftLoopClosureEvaluator(plant)));
+  owned.push_back(std::make_unique<multibody::DistanceEvaluator<double>>(
+      RightLoopClosureEvaluator(plant)));
+  std::vector<const KinematicEvaluator<double>*> loops = {
+      owned[4].get(), owned[5].get()};
+
+  const int n_v = plant.num_velocities();
+  VectorXd phi(3);
+  MatrixXd J(3, n_v);
+  VectorXd Jdotv(3);
+
+  // The baseline computes the same quantities as the evaluators
+  plant.SetVelocities(context.get(), VectorXd::Constant(n_v, 0.1));
+  double max_error = 0;
+  for (const auto& e : owned) {
+    const int n = e->num_active();
+    EvalBaseline(plant, *context, view_frame, *e, &phi, &J, &Jdotv);
+    VectorXd phi_e(n);
+    MatrixXd J_e(n, n_v);
+    VectorXd Jdotv_e(n);
+    e->EvalActive(*context, &phi_e);
+    e->EvalActiveJacobian(*context, &J_e);
+    e->EvalActiveJacobianDotTimesV(*context, &Jdotv_e);
+    max_error = std::max({max_error, (phi.head(n) - phi_e).norm(),
+                          (J.topRows(n) - J_e).norm(),
+                          (Jdotv.head(n) - Jdotv_e).norm()});
+  }
+  std::cout << "max difference from the baseline: " << max_error << std::endl;
+
+  for (const auto& [name, evaluators] :
+       {std::make_pair(std::string("toe contacts"), contacts),
+        std::make_pair(std::string("loop closures"), loops)}) {
+    Time(name + " (baseline)", plant, context.get(), evaluators,
+         [&](const KinematicEvaluator<double>& e) {
+           EvalBaseline(plant, *context, view_frame, e, &phi, &J, &Jdotv);
+         });
+    Time(name + " (by value)", plant, context.get(), evaluators,
+         [&](const KinematicEvaluator<double>& e) {
+           phi.head(e.num_active()) = e.EvalActive(*context);
+           J.topRows(e.num_active()) = e.EvalActiveJacobian(*context);
+           Jdotv.head(e.num_active()) = e.EvalActiveJacobianDotTimesV(*context);
+         });
+    Time(name + " (output parameter)", plant, context.get(), evaluators,
+         [&](const KinematicEvaluator<double>& e) {
+           auto phi_e = phi.head(e.num_active());
+           auto J_e = J.topRows(e.num_active());
+           auto Jdotv_e = Jdotv.head(e.num_active());
+           e.EvalActive(*context, &phi_e);
+           e.EvalActiveJacobian(*context, &J_e);
+           e.EvalActiveJacobianDotTimesV(*context, &Jdotv_e);
+         });
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::DoMain(argc, argv); }
@@ -0,0 +1,455 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "common/find_resource.h"
+#include "dairlib/lcmt_stage_timing.hpp"
+#include "examples/Cassie/cassie_utils.h"
+#include "multibody/kinematic/fixed_joint_evaluator.h"
+#include "multibody/kinematic/kinematic_evaluator_set.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "multibody/multibody_utils.h"
+#include "solvers/solver_options_io.h"
+#include "systems/controllers/osc/joint_space_tracking_data.h"
+#include "systems/controllers/osc/operational_space_control.h"
+#include "systems/controllers/osc/rot_space_tracking_data.h"
+#include "systems/controllers/osc/trans_space_tracking_data.h"
+#include "systems/framework/output_vector.h"
+
+#include "drake/systems/framework/basic_vector.h"
+
+/// Microbenchmark of a single OSC controller tick (CalcOutput of the
+/// osc_command port) with a Cassie walking-like, running-like or jumping-like
+/// setup. The same controller is timed with every OscQpBackend so that the
+/// overhead of the MathematicalProgram path can be compared against the
+/// direct-matrix and reduced-space paths, and the direct and reduced QPs are
+/// solved with both OSQP and the dense active-set solver (see OscQpSolver).
+/// The trajectories are constant; this only measures the cost of assembling
+/// and solving the QP. The flops spent on the tracking costs are printed once
+/// for every fsm state, the wall-clock time spent on them per tick is printed
+/// per fsm state (from the OSC's "tracking_cost" timing stage), and the OSQP
+/// iteration counts are printed per contact mode (see --warm_start_bank).
+/// With --qp_snapshot_log, the QPs of the direct backend solved with OSQP are
+/// logged for benchmark_qp_replay.
+
+DEFINE_string(controller, "walking",
+              "Controller configuration to benchmark: walking, running or "
+              "jumping");
+DEFINE_int32(num_ticks, 5000, "Number of controller ticks per backend");
+DEFINE_int32(ticks_per_mode, 200,
+             "Number of ticks before switching to the next fsm state");
+DEFINE_bool(spring_model, true, "Use the plant with leaf springs");
+DEFINE_bool(warm_start_bank, true,
+            "Warm start every contact mode switch from the last solution of "
+            "the new mode instead of the previous solve");
+DEFINE_string(qp_snapshot_log, "",
+              "If not empty, log the QPs of the direct backend (solved with "
+              "OSQP) to this file");
+
+namespace dairlib {
+namespace {
+
+using drake::multibody::MultibodyPlant;
+using Eigen::Matrix3d;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+using multibody::FixedJointEvaluator;
+using multibody::WorldPointEvaluator;
+using multibody::WorldYawViewFrame;
+using systems::OutputVector;
+using systems::controllers::JointSpaceTrackingData;
+using systems::controllers::OperationalSpaceControl;
+using systems::controllers::OscQpBackend;
+using systems::controllers::OscQpSolver;
+using systems::controllers::RotTaskSpaceTrackingData;
+using systems::controllers::TransTaskSpaceTrackingData;
+
+typedef std::chrono::steady_clock my_clock;
+
+// Crouch and landing (both in double support) for jumping
+const int kLeftStance = 0;
+const int kRightStance = 1;
+// Double support for walking, flight for running and jumping
+const int kPostLeft = 3;
+const int kPostRight = 4;
+
+enum class Controller { kWalking, kRunning, kJumping };
+
+// Owns the constraint evaluators, which need to outlive the controller
+struct OscSetup {
+  std::unique_ptr<multibody::KinematicEvaluatorSet<double>> evaluators;
+  std::vector<std::unique_ptr<FixedJointEvaluator<double>>> springs;
+  std::unique_ptr<multibody::DistanceEvaluator<double>> left_loop;
+  std::unique_ptr<multibody::DistanceEvaluator<double>> right_loop;
+  std::unique_ptr<WorldYawViewFrame<double>> view_frame;
+  std::vector<std::unique_ptr<WorldPointEvaluator<double>>> contacts;
+  std::unique_ptr<OperationalSpaceControl> osc;
+};
+
+void BuildOsc(const MultibodyPlant<double>& plant,
+              drake::systems::Context<double>* context, Controller controller,
+              OscQpBackend backend, OscQpSolver qp_solver, OscSetup* setup) {
+  bool running = controller == Controller::kRunning;
+  bool jumping = controller == Controller::kJumping;
+  int n_v = plant.num_velocities();
+  int n_u = plant.num_actuators();
+  setup->osc = std::make_unique<OperationalSpaceControl>(plant, plant, context,
+                                                         context, true);
+  auto* osc = setup->osc.get();
+  osc->SetQpBackend(backend);
+  osc->SetQpSolver(qp_solver);
+  if (!FLAGS_qp_snapshot_log.empty() && backend == OscQpBackend::kDirect &&
+      qp_solver == OscQpSolver::kOsqp) {
+    osc->SetQpSnapshotLog(FLAGS_qp_snapshot_log);
+  }
+  osc->SetAccelerationCostWeights(1e-4 * MatrixXd::Identity(n_v, n_v));
+  osc->SetInputSmoothingCostWeights(1e-6 * MatrixXd::Identity(n_u, n_u));
+  osc->SetContactSoftConstraintWeight(10);
+  osc->SetContactFriction(0.4);
+
+  // Four bar linkages and fixed springs
+  setup->evaluators =
+      std::make_unique<multibody::KinematicEvaluatorSet<double>>(plant);
+  setup->left_loop = std::make_unique<multibody::DistanceEvaluator<double>>(
+      LeftLoopClosureEvaluator(plant));
+  setup->right_loop = std::make_unique<multibody::DistanceEvaluator<double>>(
+      RightLoopClosureEvaluator(plant));
+  setup->evaluators->add_evaluator(setup->left_loop.get());
+  setup->evaluators->add_evaluator(setup->right_loop.get());
+  if (FLAGS_spring_model) {
+    auto pos_map = multibody::MakeNameToPositionsMap(plant);
+    auto vel_map = multibody::MakeNameToVelocitiesMap(plant);
+    for (const auto& joint :
+         {"knee_joint_left", "knee_joint_right", "ankle_spring_joint_left",
+          "ankle_spring_joint_right"}) {
+      setup->springs.push_back(std::make_unique<FixedJointEvaluator<double>>(
+          plant, pos_map.at(joint), vel_map.at(std::string(joint) + "dot"),
+          0));
+      setup->evaluators->add_evaluator(setup->springs.back().get());
+    }
+  }
+  osc->AddKinematicConstraint(setup->evaluators.get());
+
+  // Contact points
+  setup->view_frame = std::make_unique<WorldYawViewFrame<double>>(
+      plant.GetBodyByName("pelvis"));
+  auto add_contact = [&](const std::pair<const Vector3d,
+                                         const drake::multibody::Frame<double>&>&
+                             pt,
+                         std::vector<int> active_directions) {
+    setup->contacts.push_back(std::make_unique<WorldPointEvaluator<double>>(
+        plant, pt.first, pt.second, *setup->view_frame, Matrix3d::Identity(),
+        Vector3d::Zero(), active_directions));
+    return setup->contacts.back().get();
+  };
+  auto left_toe = add_contact(LeftToeFront(plant), {1, 2});
+  auto left_heel = add_contact(LeftToeRear(plant), {0, 1, 2});
+  auto right_toe = add_contact(RightToeFront(plant), {1, 2});
+  auto right_heel = add_contact(RightToeRear(plant), {0, 1, 2});
+  if (jumping) {
+    for (int state : {kLeftStance, kRightStance}) {
+      for (auto* contact : {left_toe, left_heel, right_toe, right_heel}) {
+        osc->AddStateAndContactPoint(state, contact);
+      }
+    }
+  } else {
+    osc->AddStateAndContactPoint(kLeftStance, left_toe);
+    osc->AddStateAndContactPoint(kLeftStance, left_heel);
+    osc->AddStateAndContactPoint(kRightStance, right_toe);
+    osc->AddStateAndContactPoint(kRightStance, right_heel);
+  }
+  if (controller == Controller::kWalking) {
+    for (int state : {kPostLeft, kPostRight}) {
+      for (auto* contact : {left_toe, left_heel, right_toe, right_heel}) {
+        osc->AddStateAndContactPoint(state, contact);
+      }
+    }
+  }
+
+  // Tracking data with constant targets
+  MatrixXd K_p = 100 * MatrixXd::Identity(3, 3);
+  MatrixXd K_d = 10 * MatrixXd::Identity(3, 3);
+  MatrixXd W = 10 * MatrixXd::Identity(3, 3);
+  auto pelvis_traj = std::make_unique<TransTaskSpaceTrackingData>(
+      "pelvis_traj", K_p, K_d, W, plant, plant);
+  pelvis_traj->AddPointToTrack("pelvis");
+  osc->AddConstTrackingData(std::move(pelvis_traj), Vector3d(0, 0, 0.95));
+
+  auto pelvis_rot_traj = std::make_unique<RotTaskSpaceTrackingData>(
+      "pelvis_rot_traj", K_p, K_d, W, plant, plant);
+  pelvis_rot_traj->AddFrameToTrack("pelvis");
+  osc->AddConstTrackingData(std::move(pelvis_rot_traj),
+                            Eigen::Vector4d(1, 0, 0, 0));
+
+  auto swing_ft_traj = std::make_unique<TransTaskSpaceTrackingData>(
+      "swing_ft_traj", K_p, K_d, W, plant, plant);
+  if (!jumping) {
+    swing_ft_traj->AddStateAndPointToTrack(kLeftStance, "toe_right");
+    swing_ft_traj->AddStateAndPointToTrack(kRightStance, "toe_left");
+  }
+  if (running || jumping) {
+    // Keep tracking the previous swing foot during flight
+    swing_ft_traj->AddStateAndPointToTrack(kPostLeft, "toe_right");
+    swing_ft_traj->AddStateAndPointToTrack(kPostRight, "toe_left");
+  }
+  osc->AddConstTrackingData(std::move(swing_ft_traj), Vector3d(0, 0, 0.1));
+
+  MatrixXd K_p_joint = 50 * MatrixXd::Identity(1, 1);
+  MatrixXd K_d_joint = 5 * MatrixXd::Identity(1, 1);
+  MatrixXd W_joint = MatrixXd::Identity(1, 1);
+  auto swing_toe_traj = std::make_unique<JointSpaceTrackingData>(
+      "swing_toe_traj", K_p_joint, K_d_joint, W_joint, plant, plant);
+  swing_toe_traj->AddStateAndJointToTrack(kLeftStance, "toe_right",
+                                          "toe_rightdot");
+  swing_toe_traj->AddStateAndJointToTrack(kRightStance, "toe_left",
+                                          "toe_leftdot");
+  osc->AddConstTrackingData(std::move(swing_toe_traj), -1.5 * VectorXd::Ones(1));
+
+  auto swing_hip_yaw_traj = std::make_unique<JointSpaceTrackingData>(
+      "swing_hip_yaw_traj", K_p_joint, K_d_joint, W_joint, plant, plant);
+  swing_hip_yaw_traj->AddStateAndJointToTrack(kLeftStance, "hip_yaw_right",
+                                              "hip_yaw_rightdot");
+  swing_hip_yaw_traj->AddStateAndJointToTrack(kRightStance, "hip_yaw_left",
+                                              "hip_yaw_leftdot");
+  osc->AddConstTrackingData(std::move(swing_hip_yaw_traj), VectorXd::Zero(1));
+
+  auto solver_options =
+      drake::yaml::LoadYamlFile<solvers::SolverOptionsFromYaml>(
+          FindResourceOrThrow(
+              running
+                  ? "examples/Cassie/osc_run/osc_running_qp_settings.yaml"
+                  : "examples/Cassie/osc/solver_settings/"
+                    "osqp_options_walking.yaml"))
+          .GetAsSolverOptions(drake::solvers::OsqpSolver::id());
+  solver_options.SetOption(drake::solvers::OsqpSolver::id(), "warm_start_bank",
+                           FLAGS_warm_start_bank ? 1 : 0);
+  osc->SetOsqpSolverOptions(solver_options);
+  osc->Build();
+}
+
+// Prints the floating point operations needed to build the tracking costs of
+// the active tracking data, once with dense Jacobians and once restricted to
+// the column support of each Jacobian (as done in the OSC).
+void PrintTrackingCostFlops(OperationalSpaceControl* osc, int fsm_state,
+                            int n_v) {
+  int total_dense = 0;
+  int total_support = 0;
+  std::cout << "Tracking cost flops in fsm state " << fsm_state << std::endl;
+  for (const auto& tracking_data : *osc->GetAllTrackingData()) {
+    if (!tracking_data->IsActive(fsm_state)) continue;
+    int n_y = tracking_data->GetYdotDim();
+    int k = tracking_data->GetJColumnSupport().size();
+    // W*J, J^T*(W*J) and J^T*(W*c)
+    int dense = 2 * n_y * n_y * n_v + 2 * n_y * n_v * n_v + 2 * n_y * n_v;
+    // W*J_s, upper triangle of J_s^T*(W*J_s) and J_s^T*(W*c)
+    int support = 2 * n_y * n_y * k + n_y * k * (k + 1) + 2 * n_y * k;
+    std::cout << "  " << tracking_data->GetName() << ": " << k << "/" << n_v
+              << " columns, " << dense << " -> " << support << std::endl;
+    total_dense += dense;
+    total_support += support;
+  }
+  std::cout << "  total: " << total_dense << " -> " << total_support
+            << std::endl;
+}
+
+// Per-tick wall-clock time of one timing stage of the OSC, in windows of
+// --ticks_per_mode ticks
+struct StageWindows {
+  std::vector<float> p50_us;
+  std::vector<float> p99_us;
+  std::vector<float> max_us;
+};
+
+// Adds the statistics of `stage` in `msg` to `windows`
+void AddStageWindow(const lcmt_stage_timing& msg, const std::string& stage,
+                    StageWindows* windows) {
+  for (int i = 0; i < msg.num_stages; i++) {
+    if (msg.stage_names[i] == stage && msg.num_samples > 0) {
+      windows->p50_us.push_back(msg.p50_us[i]);
+      windows->p99_us.push_back(msg.p99_us[i]);
+      windows->max_us.push_back(msg.max_us[i]);
+    }
+  }
+}
+
+// Prints the time spent on the tracking costs per tick in each fsm state: the
+// median of the per-window medians and p99s, and the overall max
+void PrintTrackingCostTimes(const std::map<int, StageWindows>& windows) {
+  auto median = [](std::vector<float> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+  };
+  for (const auto& [fsm_state, stage] : windows) {
+    if (stage.p50_us.empty()) continue;
+    std::cout << "  tracking cost per tick in fsm state " << fsm_state
+              << ": median " << median(stage.p50_us) << " us, p99 "
+              << median(stage.p99_us) << " us, max "
+              << *std::max_element(stage.max_us.begin(), stage.max_us.end())
+              << " us (" << stage.p50_us.size() << " windows)" << std::endl;
+  }
+}
+
+// Prints the OSQP iterations per contact mode, separately for the first solve
+// after a mode switch
+void PrintIterations(const OperationalSpaceControl& osc) {
+  for (const auto& [mode, stats] : osc.GetWarmStartStatistics()) {
+    int num_other = stats.num_solves - stats.num_switch_solves;
+    std::cout << "  contact mode " << mode << ": " << stats.num_solves
+              << " solves, mean iterations "
+              << static_cast<double>(stats.total_iterations) / stats.num_solves
+              << ", after a switch "
+              << (stats.num_switch_solves > 0
+                      ? static_cast<double>(stats.switch_iterations) /
+                            stats.num_switch_solves
+                      : 0)
+              << ", otherwise "
+              << (num_other > 0 ? static_cast<double>(stats.total_iterations -
+                                                      stats.switch_iterations) /
+                                      num_other
+                                : 0)
+              << ", max " << stats.max_iterations << std::endl;
+  }
+}
+
+void PrintStats(const std::string& name, std::vector<double> times_us) {
+  std::sort(times_us.begin(), times_us.end());
+  double mean = 0;
+  for (double t : times_us) mean += t;
+  mean /= times_us.size();
+  std::cout << name << ": mean " << mean << " us, median "
+            << times_us[times_us.size() / 2] << " us, p99 "
+            << times_us[static_cast<int>(0.99 * (times_us.size() - 1))]
+            << " us, max " << times_us.back() << " us" << std::endl;
+}
+
+int DoMain(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  Controller controller;
+  if (FLAGS_controller == "walking") {
+    controller = Controller::kWalking;
+  } else if (FLAGS_controller == "running") {
+    controller = Controller::kRunning;
+  } else {
+    DRAKE_DEMAND(FLAGS_controller == "jumping");
+    controller = Controller::kJumping;
+  }
+
+  MultibodyPlant<double> plant(0.0);
+  if (FLAGS_spring_model) {
+    AddCassieMultibody(&plant, nullptr, true /*floating base*/,
+                       "examples/Cassie/urdf/cassie_v2.urdf",
+                       true /*spring model*/, false /*loop closure*/);
+  } else {
+    AddCassieMultibody(&plant, nullptr, true /*floating base*/,
+                       "examples/Cassie/urdf/cassie_fixed_springs.urdf",
+                       false /*spring model*/, false /*loop closure*/);
+  }
+  plant.Finalize();
+  auto plant_context = plant.CreateDefaultContext();
+
+  int n_q = plant.num_positions();
+  int n_v = plant.num_velocities();
+  int n_u = plant.num_actuators();
+  VectorXd q = plant.GetPositions(*plant_context);
+  q(6) = 0.95;
+  auto pos_map = multibody::MakeNameToPositionsMap(plant);
+  for (const auto& side : {"_left", "_right"}) {
+    q(pos_map.at(std::string("knee") + side)) = -1.1;
+    q(pos_map.at(std::string("ankle_joint") + side)) = 1.4;
+    q(pos_map.at(std::string("toe") + side)) = -1.5;
+  }
+
+  std::vector<int> fsm_states = {kLeftStance, kPostLeft, kRightStance,
+                                 kPostRight};
+
+  const std::vector<std::pair<OscQpBackend, OscQpSolver>> configurations = {
+      {OscQpBackend::kMathematicalProgram, OscQpSolver::kOsqp},
+      {OscQpBackend::kDirect, OscQpSolver::kOsqp},
+      {OscQpBackend::kReduced, OscQpSolver::kOsqp},
+      {OscQpBackend::kDirect, OscQpSolver::kDenseActiveSet},
+      {OscQpBackend::kReduced, OscQpSolver::kDenseActiveSet}};
+  for (const auto& [backend, qp_solver] : configurations) {
+    OscSetup setup;
+    BuildOsc(plant, plant_context.get(), controller, backend, qp_solver,
+             &setup);
+    auto osc_context = setup.osc->CreateDefaultContext();
+    const auto& output_port = setup.osc->get_output_port_osc_command();
+    auto output = output_port.Allocate();
+    const auto& timing_port = setup.osc->get_output_port_timing();
+    auto timing = timing_port.Allocate();
+    std::map<int, StageWindows> tracking_cost_times;
+
+    OutputVector<double> robot_output(n_q, n_v, n_u);
+    robot_output.SetPositions(q);
+    robot_output.SetVelocities(VectorXd::Zero(n_v));
+    robot_output.SetEfforts(VectorXd::Zero(n_u));
+    drake::systems::BasicVector<double> fsm(1);
+    drake::systems::BasicVector<double> clock(1);
+
+    std::vector<double> times_us;
+    times_us.reserve(FLAGS_num_ticks);
+    for (int i = 0; i < FLAGS_num_ticks; i++) {
+      double t = 5e-4 * i;
+      fsm[0] = fsm_states[(i / FLAGS_ticks_per_mode) % fsm_states.size()];
+      clock[0] = t;
+      // Small perturbation so that nothing is served from a cache
+      robot_output.set_timestamp(t);
+      robot_output.get_mutable_value()(0) = 1 - 1e-6 * (i % 10);
+      robot_output.get_mutable_value()(n_q) = 1e-3 * (i % 7);
+      osc_context->SetTime(t);
+      setup.osc->get_input_port_robot_output().FixValue(osc_context.get(),
+                                                        robot_output);
+      setup.osc->get_input_port_fsm().FixValue(osc_context.get(), fsm);
+      setup.osc->get_input_port_clock().FixValue(osc_context.get(), clock);
+
+      auto start = my_clock::now();
+      output_port.Calc(*osc_context, output.get());
+      auto stop = my_clock::now();
+      times_us.push_back(
+          std::chrono::duration<double, std::micro>(stop - start).count());
+
+      // This tick's BeginTick() has handed all the ticks of the previous
+      // window, which were all in one fsm state, to the stage timer
+      if (i > 0 && i % FLAGS_ticks_per_mode == 0) {
+        timing_port.Calc(*osc_context, timing.get());
+        int window_state =
+            fsm_states[((i - 1) / FLAGS_ticks_per_mode) % fsm_states.size()];
+        AddStageWindow(timing->get_value<lcmt_stage_timing>(), "tracking_cost",
+                       &tracking_cost_times[window_state]);
+      }
+
+      if (backend == OscQpBackend::kDirect &&
+          qp_solver == OscQpSolver::kOsqp &&
+          i < FLAGS_ticks_per_mode * static_cast<int>(fsm_states.size()) &&
+          (i + 1) % FLAGS_ticks_per_mode == 0) {
+        PrintTrackingCostFlops(setup.osc.get(), static_cast<int>(fsm[0]), n_v);
+      }
+    }
+    std::string backend_name = " (mathematical program)";
+    if (backend == OscQpBackend::kDirect) {
+      backend_name = " (direct)";
+    } else if (backend == OscQpBackend::kReduced) {
+      backend_name = " (reduced)";
+    }
+    if (qp_solver == OscQpSolver::kDenseActiveSet) {
+      backend_name += " (active set)";
+    }
+    PrintStats(FLAGS_controller + backend_name, times_us);
+    PrintTrackingCostTimes(tracking_cost_times);
+    if (qp_solver == OscQpSolver::kOsqp) {
+      PrintIterations(*setup.osc);
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) { return dairlib::DoMain(argc, argv); }
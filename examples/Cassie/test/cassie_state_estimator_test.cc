@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include "common/allocation_counter.h"
 #include "multibody/kinematic/world_point_evaluator.h"
 #include "multibody/multibody_solvers.h"
 
@@ -22,6 +23,24 @@ using multibody::DistanceEvaluator;
 using multibody::KinematicEvaluatorSet;
 using multibody::WorldPointEvaluator;
 
+// A message from Cassie standing still, with the joint angles of the example
+// configuration of solveFourbarLinkageTest
+cassie_out_t StandingCassieOut() {
+  cassie_out_t cassie_out{};
+  cassie_out.pelvis.vectorNav.linearAcceleration[2] = 9.81;
+  for (int i = 0; i < 2; i++) {
+    cassie_leg_out_t& leg = (i == 0) ? cassie_out.leftLeg : cassie_out.rightLeg;
+    leg.hipRollDrive.position = (i == 0) ? -0.084017 : 0.084017;
+    leg.hipYawDrive.position = (i == 0) ? -0.00120735 : 0.00120735;
+    leg.hipPitchDrive.position = 0.366012;
+    leg.kneeDrive.position = -0.6305;
+    leg.footDrive.position = 0.205351;
+    leg.shinJoint.position = 0.00205363;
+    leg.tarsusJoint.position = 0.838878;
+  }
+  return cassie_out;
+}
+
 class CassieStateEstimatorTest : public ::testing::Test {};
 
 class ContactEstimationTest : public ::testing::Test {
@@ -151,6 +170,100 @@ TEST_F(ContactEstimationTest, solveFourbarLinkageTest) {
   EXPECT_NEAR(calc_right_heel_spring, nlp_right_heel_spring, 1e-5);
 }
 
+// Copying a new message to the robot output does not allocate
+TEST_F(ContactEstimationTest, CopyStateOutAllocations) {
+  auto context = estimator_->CreateDefaultContext();
+  auto& input = estimator_->get_input_port(0).FixValue(context.get(),
+                                                        StandingCassieOut());
+  const auto& port = estimator_->get_robot_output_port();
+  auto tick = [&](int i) {
+    input.GetMutableData()
+        ->get_mutable_value<cassie_out_t>()
+        .leftLeg.kneeDrive.velocity = 1e-3 * i;
+    EXPECT_EQ(port.Eval(*context)(0), 1);
+  };
+  tick(0);
+  AllocationCounter counter;
+  for (int i = 1; i <= 10000; i++) {
+    tick(i);
+  }
+  EXPECT_EQ(counter.count(), 0);
+}
+
+// The estimator's own work in Update() uses the preallocated workspace. The
+// InEKF library and MultibodyPlant still allocate internally, but the same
+// amount on every tick.
+TEST_F(ContactEstimationTest, UpdateAllocations) {
+  auto context = estimator_->CreateDefaultContext();
+  auto& input = estimator_->get_input_port(0).FixValue(context.get(),
+                                                        StandingCassieOut());
+  auto events = estimator_->AllocateCompositeEventCollection();
+  double next_update_time;
+  estimator_->set_next_message_time(1);
+  estimator_->CalcNextUpdateTime(*context, events.get(), &next_update_time);
+  const auto& updates = events->get_unrestricted_update_events();
+  ASSERT_TRUE(updates.HasEvents());
+  auto state = context->CloneState();
+
+  auto tick = [&](int i) {
+    context->SetTime(1 + 5e-4 * i);
+    input.GetMutableData()
+        ->get_mutable_value<cassie_out_t>()
+        .pelvis.vectorNav.angularVelocity[0] = 1e-3 * (i % 7);
+    estimator_->CalcUnrestrictedUpdate(*context, updates, state.get());
+    estimator_->ApplyUnrestrictedUpdate(updates, state.get(), context.get());
+  };
+  // The first ticks size the filter's contact states
+  for (int i = 0; i < 10; i++) {
+    tick(i);
+  }
+  int64_t per_tick;
+  {
+    AllocationCounter counter;
+    tick(10);
+    per_tick = counter.count();
+  }
+  AllocationCounter counter;
+  for (int i = 11; i < 10011; i++) {
+    tick(i);
+  }
+  EXPECT_EQ(counter.count(), 10000 * per_tick);
+  EXPECT_TRUE(
+      estimator_->get_robot_output_port().Eval(*context).allFinite());
+}
+
+// A copy or an assignment sizes the workspace like the other one, and an
+// assignment between workspaces of the same plant does not allocate
+TEST_F(ContactEstimationTest, WorkspaceCopyAndAssign) {
+  drake::multibody::MultibodyPlant<double> plant_fixed_springs(1e-3);
+  AddCassieMultibody(&plant_fixed_springs, nullptr, true,
+                     "examples/Cassie/urdf/cassie_fixed_springs.urdf", false,
+                     false);
+  plant_fixed_springs.Finalize();
+
+  CassieStateEstimatorWorkspace workspace(plant_);
+  const CassieStateEstimatorWorkspace copy(workspace);
+  EXPECT_EQ(copy.plant, &plant_);
+  EXPECT_EQ(copy.filtered_output->GetPositions().size(),
+            plant_.num_positions());
+  EXPECT_EQ(copy.M.rows(), plant_.num_velocities());
+
+  const CassieStateEstimatorWorkspace other(plant_fixed_springs);
+  workspace = other;
+  EXPECT_EQ(workspace.plant, &plant_fixed_springs);
+  EXPECT_EQ(workspace.filtered_output->GetPositions().size(),
+            plant_fixed_springs.num_positions());
+  EXPECT_EQ(workspace.output_gt->GetVelocities().size(),
+            plant_fixed_springs.num_velocities());
+  EXPECT_EQ(workspace.J.cols(), plant_fixed_springs.num_velocities());
+  EXPECT_EQ(workspace.M.rows(), plant_fixed_springs.num_velocities());
+  EXPECT_EQ(workspace.SJt.rows(), plant_fixed_springs.num_velocities());
+
+  AllocationCounter counter;
+  workspace = other;
+  EXPECT_EQ(counter.count(), 0);
+}
+
 }  // namespace
 }  // namespace systems
 }  // namespace dairlib
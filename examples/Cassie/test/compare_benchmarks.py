@@ -0,0 +1,80 @@
+"""Compares two Google Benchmark JSON outputs of benchmark_dynamics.
+
+Usage:
+  bazel-bin/examples/Cassie/compare_benchmarks baseline.json contender.json
+
+Both files are written by
+  benchmark_dynamics --benchmark_out=<file> --benchmark_out_format=json
+
+A benchmark has regressed if its median CPU time grew by more than
+--threshold (relative), and the growth of the mean is larger than
+--num_std_errors standard errors of the difference, so that noisy benchmarks
+are not reported. Exits with status 1 if any benchmark regressed.
+"""
+
+import argparse
+import json
+import math
+import sys
+
+
+def load_aggregates(filename):
+    """Returns {run_name: {aggregate_name: cpu_time, 'repetitions': n}}."""
+    with open(filename) as f:
+        data = json.load(f)
+    results = {}
+    for b in data['benchmarks']:
+        if b.get('run_type') != 'aggregate':
+            continue
+        entry = results.setdefault(b['run_name'], {'unit': b['time_unit']})
+        entry[b['aggregate_name']] = b['cpu_time']
+        entry['repetitions'] = b.get('repetitions', 1)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter)
+    parser.add_argument('baseline')
+    parser.add_argument('contender')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='relative growth of the median to report')
+    parser.add_argument('--num_std_errors', type=float, default=2.0,
+                        help='significance of the growth of the mean')
+    args = parser.parse_args()
+
+    baseline = load_aggregates(args.baseline)
+    contender = load_aggregates(args.contender)
+
+    regressions = []
+    print(f'{"benchmark":50} {"baseline":>12} {"contender":>12} {"change":>8}')
+    for name in sorted(set(baseline) & set(contender)):
+        base = baseline[name]
+        new = contender[name]
+        if 'median' not in base or 'median' not in new:
+            continue
+        change = (new['median'] - base['median']) / base['median']
+        std_error = math.sqrt(
+            base.get('stddev', 0) ** 2 / base['repetitions'] +
+            new.get('stddev', 0) ** 2 / new['repetitions'])
+        significant = (new['mean'] - base['mean'] >
+                       args.num_std_errors * std_error)
+        regressed = change > args.threshold and significant
+        if regressed:
+            regressions.append(name)
+        print(f'{name:50} {base["median"]:10.2f}{base["unit"]:>2} '
+              f'{new["median"]:10.2f}{new["unit"]:>2} {100 * change:+7.1f}%'
+              f'{"  REGRESSION" if regressed else ""}')
+
+    for name in sorted(set(baseline) ^ set(contender)):
+        print(f'{name:50} only in '
+              f'{"baseline" if name in baseline else "contender"}')
+
+    if regressions:
+        print(f'{len(regressions)} benchmark(s) regressed')
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
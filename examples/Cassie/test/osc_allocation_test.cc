@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/allocation_counter.h"
+#include "examples/Cassie/cassie_utils.h"
+#include "multibody/kinematic/kinematic_evaluator_set.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "multibody/multibody_utils.h"
+#include "systems/controllers/osc/joint_space_tracking_data.h"
+#include "systems/controllers/osc/operational_space_control.h"
+#include "systems/controllers/osc/rot_space_tracking_data.h"
+#include "systems/controllers/osc/trans_space_tracking_data.h"
+#include "systems/framework/output_vector.h"
+
+#include "drake/systems/framework/basic_vector.h"
+
+namespace dairlib {
+namespace {
+
+using drake::multibody::MultibodyPlant;
+using Eigen::Matrix3d;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+using multibody::WorldPointEvaluator;
+using multibody::WorldYawViewFrame;
+using systems::OutputVector;
+using systems::controllers::CassieFixedSpringsOperationalSpaceControl;
+using systems::controllers::JointSpaceTrackingData;
+using systems::controllers::OperationalSpaceControl;
+using systems::controllers::OscQpBackend;
+using systems::controllers::OscQpSolver;
+using systems::controllers::RotTaskSpaceTrackingData;
+using systems::controllers::TransTaskSpaceTrackingData;
+
+const int kLeftStance = 0;
+const int kRightStance = 1;
+const int kDoubleSupport = 3;
+
+/// A walking-like OSC on the Cassie plant with fixed springs, with
+/// constant targets for the pelvis, the swing foot and a swing joint (see
+/// benchmark_osc_tick for the timed version). Parameterized on the QP backend
+/// and solver, and on whether the OSC is the fixed-size variant for Cassie.
+class OscAllocationTest
+    : public ::testing::TestWithParam<
+          std::tuple<std::pair<OscQpBackend, OscQpSolver>, bool>> {
+ protected:
+  void SetUp() override {
+    AddCassieMultibody(&plant_, nullptr, true /*floating base*/,
+                       "examples/Cassie/urdf/cassie_fixed_springs.urdf",
+                       false /*spring model*/, false /*loop closure*/);
+    plant_.Finalize();
+    plant_context_ = plant_.CreateDefaultContext();
+    if (std::get<1>(GetParam())) {
+      osc_ = MakeOsc<CassieFixedSpringsOperationalSpaceControl>();
+    } else {
+      osc_ = MakeOsc<OperationalSpaceControl>();
+    }
+  }
+
+  // The ports are looked up here since osc_ only holds the LeafSystem
+  template <typename Osc>
+  std::unique_ptr<drake::systems::LeafSystem<double>> MakeOsc() {
+    int n_v = plant_.num_velocities();
+    int n_u = plant_.num_actuators();
+
+    auto osc = std::make_unique<Osc>(plant_, plant_, plant_context_.get(),
+                                     plant_context_.get(), true);
+    osc->SetQpBackend(std::get<0>(GetParam()).first);
+    osc->SetQpSolver(std::get<0>(GetParam()).second);
+    osc->SetAccelerationCostWeights(1e-4 * MatrixXd::Identity(n_v, n_v));
+    osc->SetInputSmoothingCostWeights(1e-6 * MatrixXd::Identity(n_u, n_u));
+    osc->SetContactSoftConstraintWeight(10);
+    osc->SetContactFriction(0.4);
+
+    evaluators_ =
+        std::make_unique<multibody::KinematicEvaluatorSet<double>>(plant_);
+    left_loop_ = std::make_unique<multibody::DistanceEvaluator<double>>(
+        LeftLoopClosureEvaluator(plant_));
+    right_loop_ = std::make_unique<multibody::DistanceEvaluator<double>>(
+        RightLoopClosureEvaluator(plant_));
+    evaluators_->add_evaluator(left_loop_.get());
+    evaluators_->add_evaluator(right_loop_.get());
+    osc->AddKinematicConstraint(evaluators_.get());
+
+    view_frame_ = std::make_unique<WorldYawViewFrame<double>>(
+        plant_.GetBodyByName("pelvis"));
+    auto add_contact =
+        [&](const std::pair<const Vector3d,
+                            const drake::multibody::Frame<double>&>& pt,
+            std::vector<int> active_directions) {
+          contacts_.push_back(std::make_unique<WorldPointEvaluator<double>>(
+              plant_, pt.first, pt.second, *view_frame_, Matrix3d::Identity(),
+              Vector3d::Zero(), active_directions));
+          return contacts_.back().get();
+        };
+    auto left_toe = add_contact(LeftToeFront(plant_), {1, 2});
+    auto left_heel = add_contact(LeftToeRear(plant_), {0, 1, 2});
+    auto right_toe = add_contact(RightToeFront(plant_), {1, 2});
+    auto right_heel = add_contact(RightToeRear(plant_), {0, 1, 2});
+    osc->AddStateAndContactPoint(kLeftStance, left_toe);
+    osc->AddStateAndContactPoint(kLeftStance, left_heel);
+    osc->AddStateAndContactPoint(kRightStance, right_toe);
+    osc->AddStateAndContactPoint(kRightStance, right_heel);
+    for (auto* contact : {left_toe, left_heel, right_toe, right_heel}) {
+      osc->AddStateAndContactPoint(kDoubleSupport, contact);
+    }
+
+    MatrixXd K_p = 100 * MatrixXd::Identity(3, 3);
+    MatrixXd K_d = 10 * MatrixXd::Identity(3, 3);
+    MatrixXd W = 10 * MatrixXd::Identity(3, 3);
+    auto pelvis_traj = std::make_unique<TransTaskSpaceTrackingData>(
+        "pelvis_traj", K_p, K_d, W, plant_, plant_);
+    pelvis_traj->AddPointToTrack("pelvis");
+    osc->AddConstTrackingData(std::move(pelvis_traj), Vector3d(0, 0, 0.95));
+
+    auto pelvis_rot_traj = std::make_unique<RotTaskSpaceTrackingData>(
+        "pelvis_rot_traj", K_p, K_d, W, plant_, plant_);
+    pelvis_rot_traj->AddFrameToTrack("pelvis");
+    osc->AddConstTrackingData(std::move(pelvis_rot_traj),
+                              Eigen::Vector4d(1, 0, 0, 0));
+
+    auto swing_ft_traj = std::make_unique<TransTaskSpaceTrackingData>(
+        "swing_ft_traj", K_p, K_d, W, plant_, plant_);
+    swing_ft_traj->AddStateAndPointToTrack(kLeftStance, "toe_right");
+    swing_ft_traj->AddStateAndPointToTrack(kRightStance, "toe_left");
+    osc->AddConstTrackingData(std::move(swing_ft_traj), Vector3d(0, 0, 0.1));
+
+    auto swing_toe_traj = std::make_unique<JointSpaceTrackingData>(
+        "swing_toe_traj", 50 * MatrixXd::Identity(1, 1),
+        5 * MatrixXd::Identity(1, 1), MatrixXd::Identity(1, 1), plant_,
+        plant_);
+    swing_toe_traj->AddStateAndJointToTrack(kLeftStance, "toe_right",
+                                            "toe_rightdot");
+    swing_toe_traj->AddStateAndJointToTrack(kRightStance, "toe_left",
+                                            "toe_leftdot");
+    osc->AddConstTrackingData(std::move(swing_toe_traj),
+                              -1.5 * VectorXd::Ones(1));
+    osc->Build();
+    command_port_ = &osc->get_output_port_osc_command();
+    robot_output_port_ = &osc->get_input_port_robot_output();
+    fsm_port_ = &osc->get_input_port_fsm();
+    clock_port_ = &osc->get_input_port_clock();
+    return osc;
+  }
+
+  MultibodyPlant<double> plant_{0.0};
+  std::unique_ptr<drake::systems::Context<double>> plant_context_;
+  std::unique_ptr<multibody::KinematicEvaluatorSet<double>> evaluators_;
+  std::unique_ptr<multibody::DistanceEvaluator<double>> left_loop_;
+  std::unique_ptr<multibody::DistanceEvaluator<double>> right_loop_;
+  std::unique_ptr<WorldYawViewFrame<double>> view_frame_;
+  std::vector<std::unique_ptr<WorldPointEvaluator<double>>> contacts_;
+  std::unique_ptr<drake::systems::LeafSystem<double>> osc_;
+  const drake::systems::OutputPort<double>* command_port_;
+  const drake::systems::InputPort<double>* robot_output_port_;
+  const drake::systems::InputPort<double>* fsm_port_;
+  const drake::systems::InputPort<double>* clock_port_;
+};
+
+// Once every fsm state has been visited, the OSC's own code does not allocate
+// any more, but drake still does on every tick (e.g. the temporaries of
+// MultibodyPlant's by-value queries, and MathematicalProgram's bindings and
+// result with the kMathematicalProgram backend). This test measures those
+// allocations, reports them as the "allocations_per_tick" property and checks
+// that they are the same on every pass over the fsm states, i.e. that the
+// steady state does not grow anything. The QP assembly and the dense solver,
+// which do not allocate at all, are checked in osc_direct_qp_test.
+TEST_P(OscAllocationTest, SteadyStateTick) {
+  int n_q = plant_.num_positions();
+  int n_v = plant_.num_velocities();
+  int n_u = plant_.num_actuators();
+  VectorXd q = plant_.GetPositions(*plant_context_);
+  q(6) = 0.95;
+  auto pos_map = multibody::MakeNameToPositionsMap(plant_);
+  for (const auto& side : {"_left", "_right"}) {
+    q(pos_map.at(std::string("knee") + side)) = -1.1;
+    q(pos_map.at(std::string("ankle_joint") + side)) = 1.4;
+    q(pos_map.at(std::string("toe") + side)) = -1.5;
+  }
+
+  auto osc_context = osc_->CreateDefaultContext();
+  const auto& output_port = *command_port_;
+  auto output = output_port.Allocate();
+  OutputVector<double> robot_output(n_q, n_v, n_u);
+  robot_output.SetPositions(q);
+  robot_output.SetVelocities(VectorXd::Zero(n_v));
+  robot_output.SetEfforts(VectorXd::Zero(n_u));
+  drake::systems::BasicVector<double> fsm(1);
+  drake::systems::BasicVector<double> clock(1);
+
+  const std::vector<int> fsm_states = {kLeftStance, kDoubleSupport,
+                                       kRightStance, kDoubleSupport};
+  const int n_states = fsm_states.size();
+  // Allocations of the ticks of the second pass, once the first pass has
+  // sized the workspaces
+  std::vector<int> steady_state_count(n_states);
+  for (int i = 0; i < 3 * n_states; i++) {
+    double t = 5e-4 * i;
+    fsm[0] = fsm_states[i % n_states];
+    clock[0] = t;
+    robot_output.set_timestamp(t);
+    robot_output.get_mutable_value()(n_q) = 1e-3 * i;
+    osc_context->SetTime(t);
+    // Fixing the inputs allocates, and is not part of a tick
+    robot_output_port_->FixValue(osc_context.get(), robot_output);
+    fsm_port_->FixValue(osc_context.get(), fsm);
+    clock_port_->FixValue(osc_context.get(), clock);
+
+    AllocationCounter counter;
+    output_port.Calc(*osc_context, output.get());
+    const int count = counter.count();
+    if (i >= 2 * n_states) {
+      EXPECT_EQ(count, steady_state_count[i % n_states]) << "tick " << i;
+    } else if (i >= n_states) {
+      steady_state_count[i % n_states] = count;
+    }
+  }
+
+  const int per_tick = *std::max_element(steady_state_count.begin(),
+                                         steady_state_count.end());
+  RecordProperty("allocations_per_tick", per_tick);
+  std::cout << "allocations per tick: " << per_tick << std::endl;
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Backends, OscAllocationTest,
+    ::testing::Combine(
+        ::testing::Values(
+            std::make_pair(OscQpBackend::kMathematicalProgram,
+                           OscQpSolver::kOsqp),
+            std::make_pair(OscQpBackend::kDirect, OscQpSolver::kOsqp),
+            std::make_pair(OscQpBackend::kReduced, OscQpSolver::kOsqp),
+            std::make_pair(OscQpBackend::kDirect,
+                           OscQpSolver::kDenseActiveSet),
+            std::make_pair(OscQpBackend::kReduced,
+                           OscQpSolver::kDenseActiveSet)),
+        ::testing::Bool()));
+
+}  // namespace
+}  // namespace dairlib
@@ -0,0 +1,183 @@
+#include "multibody/kinematic/constrained_dynamics_solver.h"
+
+#include "drake/common/drake_assert.h"
+#include "drake/common/drake_throw.h"
+
+namespace dairlib {
+namespace multibody {
+
+using drake::MatrixX;
+using drake::VectorX;
+using drake::systems::Context;
+
+template <typename T>
+ConstrainedDynamicsSolver<T>::ConstrainedDynamicsSolver(
+    const KinematicEvaluatorSet<T>& evaluators)
+    : evaluators_(evaluators),
+      plant_(evaluators.plant()),
+      M_llt_(evaluators.plant().num_velocities()),
+      M_ldlt_(evaluators.plant().num_velocities()),
+      f_app_(evaluators.plant()) {
+  const int n_v = plant_.num_velocities();
+  const int n_full = evaluators_.count_full();
+  const int n_active = evaluators_.count_active();
+  M_.resize(n_v, n_v);
+  B_ = plant_.MakeActuationMatrix();
+  zero_vdot_ = VectorX<T>::Zero(n_v);
+  tau_.resize(n_v);
+  v_.resize(n_v);
+  phi_.resize(n_full);
+  J_.resize(n_full, n_v);
+  Jdotv_.resize(n_full);
+
+  J_active_.resize(n_active, n_v);
+  rhs_.resize(n_active);
+  Minv_JT_.resize(n_v, n_active);
+  Minv_tau_.resize(n_v);
+  S_.resize(n_active, n_active);
+  S_ldlt_ = Eigen::LDLT<MatrixX<T>>(n_active);
+}
+
+template <typename T>
+void ConstrainedDynamicsSolver<T>::UpdateTerms(const Context<T>& context) {
+  plant_.CalcForceElementsContribution(context, &f_app_);
+  // The inverse dynamics at vdot = 0 are C - tau_g - f_app, where f_app
+  // includes the spatial forces of the force elements (e.g. the bushings of
+  // a loop closure) and not only their generalized forces
+  tau_ = -plant_.CalcInverseDynamics(context, zero_vdot_, f_app_);
+  tau_.noalias() += B_ * plant_.get_actuation_input_port().Eval(context);
+  v_ = plant_.GetPositionsAndVelocities(context).tail(plant_.num_velocities());
+}
+
+template <typename T>
+void ConstrainedDynamicsSolver<T>::Update(const Context<T>& context) {
+  plant_.CalcMassMatrix(context, &M_);
+  UpdateTerms(context);
+  evaluators_.EvalFullKinematics(context, &points_, &phi_, &J_, &Jdotv_);
+
+  M_llt_.compute(M_);
+  M_factored_ = M_llt_.info() == Eigen::Success;
+  if (!M_factored_) {
+    M_ldlt_.compute(M_);
+  }
+  M_updated_ = true;
+}
+
+template <typename T>
+void ConstrainedDynamicsSolver<T>::UpdateForces(const Context<T>& context) {
+  UpdateTerms(context);
+  evaluators_.EvalFullKinematics(context, &points_, nullptr, &J_, nullptr);
+  M_updated_ = false;
+}
+
+template <typename T>
+void ConstrainedDynamicsSolver<T>::CalcActiveConstraints(
+    double alpha, MatrixX<T>* J_active, VectorX<T>* rhs) const {
+  const int n_active = evaluators_.count_active();
+  J_active->resize(n_active, plant_.num_velocities());
+  rhs->resize(n_active);
+  int row = 0;
+  int start = 0;
+  for (const auto& e : evaluators_.get_evaluators()) {
+    for (int i : e->active_inds()) {
+      J_active->row(row) = J_.row(start + i);
+      (*rhs)(row) = -(Jdotv_(start + i) + alpha * alpha * phi_(start + i));
+      row++;
+    }
+    start += e->num_full();
+  }
+  // phidot = J v
+  rhs->noalias() -= (2 * alpha) * (*J_active) * v_;
+}
+
+template <typename T>
+void ConstrainedDynamicsSolver<T>::CalcVDot(double alpha, VectorX<T>* lambda,
+                                            VectorX<T>* vdot) const {
+  DRAKE_DEMAND(M_updated_);
+  CalcActiveConstraints(alpha, &J_active_, &rhs_);
+  const int n_v = plant_.num_velocities();
+  const int n_active = J_active_.rows();
+
+  if (!M_factored_) {
+    // [[M -J^T]  [[vdot  ]  =  [[tau]
+    //  [J  0 ]]  [lambda]]     [rhs]]
+    // Only reached for a singular mass matrix, so it may allocate
+    kkt_.resize(n_v + n_active, n_v + n_active);
+    kkt_rhs_.resize(n_v + n_active);
+    kkt_ << M_, -J_active_.transpose(), J_active_,
+        MatrixX<T>::Zero(n_active, n_active);
+    kkt_rhs_ << tau_, rhs_;
+    kkt_solution_ = kkt_.ldlt().solve(kkt_rhs_);
+    *lambda = kkt_solution_.tail(n_active);
+    *vdot = kkt_solution_.head(n_v);
+    return;
+  }
+
+  // vdot = M^-1 (tau + J^T lambda), so J vdot = rhs gives
+  //   (J M^-1 J^T) lambda = rhs - J M^-1 tau
+  Minv_JT_ = J_active_.transpose();
+  M_llt_.solveInPlace(Minv_JT_);
+  Minv_tau_ = tau_;
+  M_llt_.solveInPlace(Minv_tau_);
+  S_.noalias() = J_active_ * Minv_JT_;
+  S_ldlt_.compute(S_);
+  rhs_.noalias() -= J_active_ * Minv_tau_;
+  *lambda = rhs_;
+  S_ldlt_.solveInPlace(*lambda);
+  *vdot = Minv_tau_;
+  vdot->noalias() += Minv_JT_ * (*lambda);
+}
+
+template <typename T>
+VectorX<T> ConstrainedDynamicsSolver<T>::CalcVDot(double alpha,
+                                                  VectorX<T>* lambda) const {
+  VectorX<T> vdot(plant_.num_velocities());
+  CalcVDot(alpha, lambda, &vdot);
+  return vdot;
+}
+
+template <typename T>
+void ConstrainedDynamicsSolver<T>::CalcVDotWithForce(
+    const Eigen::Ref<const VectorX<T>>& lambda,
+    drake::EigenPtr<VectorX<T>> vdot) const {
+  DRAKE_DEMAND(M_updated_);
+  CalcMassMatrixTimesVDot(lambda, vdot);
+  if (M_factored_) {
+    M_llt_.solveInPlace(*vdot);
+  } else {
+    M_ldlt_.solveInPlace(*vdot);
+  }
+}
+
+template <typename T>
+VectorX<T> ConstrainedDynamicsSolver<T>::CalcVDotWithForce(
+    const VectorX<T>& lambda) const {
+  VectorX<T> vdot(plant_.num_velocities());
+  CalcVDotWithForce(lambda, &vdot);
+  return vdot;
+}
+
+template <typename T>
+void ConstrainedDynamicsSolver<T>::CalcMassMatrixTimesVDot(
+    const Eigen::Ref<const VectorX<T>>& lambda,
+    drake::EigenPtr<VectorX<T>> M_vdot) const {
+  DRAKE_THROW_UNLESS(lambda.size() == J_.rows());
+  DRAKE_THROW_UNLESS(M_vdot != nullptr);
+  DRAKE_THROW_UNLESS(M_vdot->size() == J_.cols());
+  *M_vdot = tau_;
+  M_vdot->noalias() += J_.transpose() * lambda;
+}
+
+template <typename T>
+VectorX<T> ConstrainedDynamicsSolver<T>::CalcMassMatrixTimesVDot(
+    const VectorX<T>& lambda) const {
+  VectorX<T> M_vdot(plant_.num_velocities());
+  CalcMassMatrixTimesVDot(lambda, &M_vdot);
+  return M_vdot;
+}
+
+DRAKE_DEFINE_CLASS_TEMPLATE_INSTANTIATIONS_ON_DEFAULT_NONSYMBOLIC_SCALARS(
+    class ::dairlib::multibody::ConstrainedDynamicsSolver)
+
+}  // namespace multibody
+}  // namespace dairlib
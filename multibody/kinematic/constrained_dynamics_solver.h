@@ -0,0 +1,134 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+#include "multibody/kinematic/kinematic_evaluator_set.h"
+
+#include "drake/common/drake_copyable.h"
+#include "drake/multibody/plant/multibody_forces.h"
+
+namespace dairlib {
+namespace multibody {
+
+/// Forward dynamics of a plant subject to the constraints of a
+/// KinematicEvaluatorSet, from the manipulator equation
+///   M(q) vdot + C(q,v) = tau_g(q) + f_app + Bu + J(q)^T lambda
+///
+/// Update() evaluates the dynamics and constraint terms at a context and
+/// factors M = L L^T once. Solving for the constraint forces then only needs
+/// the Schur complement J M^-1 J^T of the active constraints, rather than the
+/// (n_v + n_c) KKT matrix, and the same factorization serves every
+/// stabilization gain alpha and every given constraint force.
+///
+/// Redundant active constraints make J M^-1 J^T singular. It is factored with
+/// a pivoting LDLT, which drops the dependent directions, so one of the
+/// admissible forces is returned and vdot still satisfies the (consistent)
+/// constraints. If M is not positive definite, the solver falls back to the
+/// LDLT of the full KKT matrix.
+///
+/// f_app are the forces of all of the plant's force elements, including their
+/// spatial forces (e.g. gravity, or the bushings of a loop closure).
+///
+/// Storage is allocated in the constructor, and for double, the
+/// output-parameter Calc methods do not allocate (except in the KKT fallback).
+/// Update() and UpdateForces() allocate inside MultibodyPlant's dynamics
+/// queries, which return by value. Not thread safe: use one object per thread.
+template <typename T>
+class ConstrainedDynamicsSolver {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(ConstrainedDynamicsSolver)
+
+  explicit ConstrainedDynamicsSolver(
+      const KinematicEvaluatorSet<T>& evaluators);
+
+  /// Evaluates and factors the dynamics at the state and actuation input of
+  /// `context`. Must be called before the Calc methods, and again whenever
+  /// the context changes.
+  void Update(const drake::systems::Context<T>& context);
+
+  /// Evaluates only the terms needed by CalcMassMatrixTimesVDot, i.e.
+  /// everything but the mass matrix and the constraint accelerations. The
+  /// other Calc methods need Update().
+  void UpdateForces(const drake::systems::Context<T>& context);
+
+  /// Computes vdot and the forces lambda on the active constraints, such that
+  ///   J vdot + Jdot v = -alpha^2 phi - 2 alpha phidot
+  /// for the active rows. See KinematicEvaluatorSet::CalcTimeDerivatives.
+  void CalcVDot(double alpha, drake::VectorX<T>* lambda,
+                drake::VectorX<T>* vdot) const;
+  drake::VectorX<T> CalcVDot(double alpha, drake::VectorX<T>* lambda) const;
+
+  /// Computes vdot = M^-1 (tau_g + f_app + Bu - C + J^T lambda), given forces
+  /// on the full constraints. This matches
+  /// KinematicEvaluatorSet::CalcTimeDerivativesWithForce for continuous plants
+  /// without a SceneGraph, but neither changes the context nor evaluates the
+  /// plant's ports.
+  void CalcVDotWithForce(const Eigen::Ref<const drake::VectorX<T>>& lambda,
+                         drake::EigenPtr<drake::VectorX<T>> vdot) const;
+  drake::VectorX<T> CalcVDotWithForce(const drake::VectorX<T>& lambda) const;
+
+  /// Computes M vdot given forces on the full constraints. See
+  /// KinematicEvaluatorSet::CalcMassMatrixTimesVDot.
+  void CalcMassMatrixTimesVDot(
+      const Eigen::Ref<const drake::VectorX<T>>& lambda,
+      drake::EigenPtr<drake::VectorX<T>> M_vdot) const;
+  drake::VectorX<T> CalcMassMatrixTimesVDot(
+      const drake::VectorX<T>& lambda) const;
+
+  /// Mass matrix at the last Update()
+  const drake::MatrixX<T>& M() const { return M_; }
+
+  /// Full constraint Jacobian w.r.t. v at the last Update()
+  const drake::MatrixX<T>& J() const { return J_; }
+
+  /// False if M was not positive definite at the last Update(), in which
+  /// case the KKT fallback is used
+  bool is_mass_matrix_factored() const { return M_factored_; }
+
+ private:
+  // Active rows of the constraint Jacobian and right-hand side
+  // -(Jdotv + alpha^2 phi + 2 alpha phidot) of the constrained solve
+  void CalcActiveConstraints(double alpha, drake::MatrixX<T>* J_active,
+                             drake::VectorX<T>* rhs) const;
+
+  // Evaluates tau_ and J_
+  void UpdateTerms(const drake::systems::Context<T>& context);
+
+  const KinematicEvaluatorSet<T>& evaluators_;
+  const drake::multibody::MultibodyPlant<T>& plant_;
+
+  drake::MatrixX<T> M_;
+  Eigen::LLT<drake::MatrixX<T>> M_llt_;
+  // Only computed if the LLT fails
+  Eigen::LDLT<drake::MatrixX<T>> M_ldlt_;
+  bool M_factored_ = false;
+  // False after UpdateForces(), until the next Update()
+  bool M_updated_ = false;
+  drake::MatrixX<T> B_;
+  drake::VectorX<T> zero_vdot_;
+  drake::multibody::MultibodyForces<T> f_app_;
+  // tau_g + f_app + Bu - C
+  drake::VectorX<T> tau_;
+  drake::VectorX<T> v_;
+
+  // Full constraint terms
+  PointKinematics<T> points_;
+  drake::VectorX<T> phi_;
+  drake::MatrixX<T> J_;
+  drake::VectorX<T> Jdotv_;
+
+  // Scratch for CalcVDot, sized for the active constraints
+  mutable drake::MatrixX<T> J_active_;
+  mutable drake::VectorX<T> rhs_;
+  mutable drake::MatrixX<T> Minv_JT_;
+  mutable drake::VectorX<T> Minv_tau_;
+  mutable drake::MatrixX<T> S_;
+  mutable Eigen::LDLT<drake::MatrixX<T>> S_ldlt_;
+  // KKT fallback, [vdot; lambda]
+  mutable drake::MatrixX<T> kkt_;
+  mutable drake::VectorX<T> kkt_rhs_;
+  mutable drake::VectorX<T> kkt_solution_;
+};
+
+}  // namespace multibody
+}  // namespace dairlib
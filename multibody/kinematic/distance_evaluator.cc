@@ -19,7 +19,7 @@ DistanceEvaluator<T>::DistanceEvaluator(const MultibodyPlant<T>& plant,
                                         const Vector3d pt_B,
                                         const Frame<T>& frame_B,
                                         double distance)
-    : KinematicEvaluator<T>(plant, 1),
+    : FixedSizeKinematicEvaluator<T, 1>(plant),
       pt_A_(pt_A),
       frame_A_(frame_A),
       pt_B_(pt_B),
@@ -27,20 +27,18 @@ DistanceEvaluator<T>::DistanceEvaluator(const MultibodyPlant<T>& plant,
       distance_(distance) {}
 
 template <typename T>
-VectorX<T> DistanceEvaluator<T>::EvalFull(const Context<T>& context) const {
+void DistanceEvaluator<T>::EvalFull(const Context<T>& context,
+                                    drake::EigenPtr<VectorX<T>> phi) const {
   // Transform points A and B to world frame
   const drake::multibody::Frame<T>& world = plant().world_frame();
-  static Vector3<T> pt_A_W;
-  static Vector3<T> pt_B_W;
+  Vector3<T> pt_A_W;
+  Vector3<T> pt_B_W;
 
   plant().CalcPointsPositions(context, frame_A_, pt_A_.template cast<T>(),
                               world, &pt_A_W);
   plant().CalcPointsPositions(context, frame_B_, pt_B_.template cast<T>(),
                               world, &pt_B_W);
-  auto rel_pos = pt_A_W - pt_B_W;
-  VectorX<T> difference(1);
-  difference << rel_pos.norm() - distance_;
-  return difference;
+  (*phi)(0) = (pt_A_W - pt_B_W).norm() - distance_;
 }
 
 template <typename T>
@@ -48,88 +46,134 @@ void DistanceEvaluator<T>::EvalFullJacobian(
     const Context<T>& context, drake::EigenPtr<MatrixX<T>> J) const {
   /// Jacobian of ||pt_A - pt_B||, evaluated all in world frame, is
   ///   (pt_A - pt_B)^T * (J_A - J_B) / ||pt_A - pt_B||
-
-  // Create static Jacobians and point positions for re-use. Warning: not thread
-  // safe
-  static Matrix3X<T> J_A(3, plant().num_velocities());
-  static Matrix3X<T> J_B(3, plant().num_velocities());
-  static Vector3<T> pt_A_W;;
-  static Vector3<T> pt_B_W;
-
   const drake::multibody::Frame<T>& world = plant().world_frame();
+  Vector3<T> pt_A_W;
+  Vector3<T> pt_B_W;
 
   plant().CalcPointsPositions(context, frame_A_, pt_A_.template cast<T>(),
                               world, &pt_A_W);
   plant().CalcPointsPositions(context, frame_B_, pt_B_.template cast<T>(),
                               world, &pt_B_W);
-  auto rel_pos = pt_A_W - pt_B_W;
-
-  // .template cast<T> converts pt_A_, as a double, into type T
-  plant().CalcJacobianTranslationalVelocity(
-      context, drake::multibody::JacobianWrtVariable::kV, frame_A_,
-      pt_A_.template cast<T>(), world, world, &J_A);
-  plant().CalcJacobianTranslationalVelocity(
-      context, drake::multibody::JacobianWrtVariable::kV, frame_B_,
-      pt_B_.template cast<T>(), world, world, &J_B);
-  *J = (rel_pos.transpose() * (J_A - J_B)) / rel_pos.norm();
+  const Vector3<T> direction = (pt_A_W - pt_B_W).normalized();
+
+  auto calc_jacobian = [&](auto* J_A, auto* J_B) {
+    // .template cast<T> converts pt_A_, as a double, into type T
+    plant().CalcJacobianTranslationalVelocity(
+        context, drake::multibody::JacobianWrtVariable::kV, frame_A_,
+        pt_A_.template cast<T>(), world, world, J_A);
+    plant().CalcJacobianTranslationalVelocity(
+        context, drake::multibody::JacobianWrtVariable::kV, frame_B_,
+        pt_B_.template cast<T>(), world, world, J_B);
+    for (int i = 0; i < J->cols(); i++) {
+      (*J)(0, i) = direction.dot(J_A->col(i) - J_B->col(i));
+    }
+  };
+  const int n_v = plant().num_velocities();
+  if (this->fits_on_stack()) {
+    typename DistanceEvaluator<T>::template StackJacobian<3> J_A(3, n_v);
+    typename DistanceEvaluator<T>::template StackJacobian<3> J_B(3, n_v);
+    calc_jacobian(&J_A, &J_B);
+  } else {
+    Matrix3X<T> J_A(3, n_v);
+    Matrix3X<T> J_B(3, n_v);
+    calc_jacobian(&J_A, &J_B);
+  }
 }
 
 template <typename T>
-VectorX<T> DistanceEvaluator<T>::EvalFullJacobianDotTimesV(
-    const Context<T>& context) const {
+void DistanceEvaluator<T>::EvalFullJacobianDotTimesV(
+    const Context<T>& context, drake::EigenPtr<VectorX<T>> Jdotv) const {
   // From applying the chain rule to Jacobian, Jdot * v is
   //
   // ||(J_A - J_B) * v||^2/phi ...
   //   + (pt_A - pt_B)^T * (J_A_dot * v  -J_B_dot * v) / phi ...
   //   - phidot * (pt_A - pt_B)^T (J_A - J_B) *v / phi^2
+  //
+  // (J_A - J_B) * v is the relative velocity of the points, computed from
+  // the spatial velocities of the frames so that no Jacobian is needed
   const drake::multibody::Frame<T>& world = plant().world_frame();
 
-  static MatrixX<T> J_A(3, plant().num_velocities());
-  static MatrixX<T> J_B(3, plant().num_velocities());
-  static VectorX<T> pt_A_world(3);
-  static VectorX<T> pt_B_world(3);
-
-  auto pt_A_cast = pt_A_.template cast<T>();
-  auto pt_B_cast = pt_B_.template cast<T>();
-
-  // Perform all kinematic calculations, finding A, B in world frame,
-  // Jacobians J_A and J_B, and Jdotv for both A and B
-  plant().CalcPointsPositions(context, frame_A_, pt_A_cast, world, &pt_A_world);
-  plant().CalcPointsPositions(context, frame_B_, pt_B_cast, world, &pt_B_world);
-  auto rel_pos = pt_A_world - pt_B_world;
-
-  plant().CalcJacobianTranslationalVelocity(
-      context, drake::multibody::JacobianWrtVariable::kV, frame_A_, pt_A_cast,
-      world, world, &J_A);
-  plant().CalcJacobianTranslationalVelocity(
-      context, drake::multibody::JacobianWrtVariable::kV, frame_B_, pt_B_cast,
-      world, world, &J_B);
-  auto J_rel = J_A - J_B;
-
-  VectorX<T> J_A_dot_times_v = plant().CalcBiasTranslationalAcceleration(
-      context, drake::multibody::JacobianWrtVariable::kV, frame_A_, pt_A_cast,
-      world, world);
-  VectorX<T> J_B_dot_times_v = plant().CalcBiasTranslationalAcceleration(
-      context, drake::multibody::JacobianWrtVariable::kV, frame_B_, pt_B_cast,
-      world, world);
-
-  auto J_rel_dot_times_v = J_A_dot_times_v - J_B_dot_times_v;
-  T phi = rel_pos.norm();
+  const auto X_WA = frame_A_.CalcPoseInWorld(context);
+  const auto X_WB = frame_B_.CalcPoseInWorld(context);
+  const Vector3<T> p_AoA_W = X_WA.rotation() * pt_A_.template cast<T>();
+  const Vector3<T> p_BoB_W = X_WB.rotation() * pt_B_.template cast<T>();
+  const Vector3<T> rel_pos =
+      (X_WA.translation() + p_AoA_W) - (X_WB.translation() + p_BoB_W);
+
+  const Vector3<T> J_rel_v =
+      frame_A_.CalcSpatialVelocityInWorld(context)
+          .Shift(p_AoA_W)
+          .translational() -
+      frame_B_.CalcSpatialVelocityInWorld(context)
+          .Shift(p_BoB_W)
+          .translational();
+
+  const Vector3<T> J_rel_dot_times_v =
+      plant()
+          .CalcBiasSpatialAcceleration(
+              context, drake::multibody::JacobianWrtVariable::kV, frame_A_,
+              pt_A_.template cast<T>(), world, world)
+          .translational() -
+      plant()
+          .CalcBiasSpatialAcceleration(
+              context, drake::multibody::JacobianWrtVariable::kV, frame_B_,
+              pt_B_.template cast<T>(), world, world)
+          .translational();
+
+  const T phi = rel_pos.norm();
+  const T phidot = rel_pos.dot(J_rel_v) / phi;
 
-  auto J = (rel_pos.transpose() * J_rel) / phi;
-
-  T phidot = J.dot(plant().GetVelocities(context));
+  // Compute all terms as scalars using dot products
+  (*Jdotv)(0) = J_rel_v.squaredNorm() / phi +
+                rel_pos.dot(J_rel_dot_times_v) / phi -
+                phidot * rel_pos.dot(J_rel_v) / (phi * phi);
+}
 
-  // Compute (J_A - J_B) * v, as this is used multiple times
-  VectorX<T> J_rel_v(3);
-  J_rel_v << J_rel * plant().GetVelocities(context);
+template <typename T>
+std::vector<std::pair<const Frame<T>*, Vector3d>>
+DistanceEvaluator<T>::GetPoints() const {
+  return {{&frame_A_, pt_A_}, {&frame_B_, pt_B_}};
+}
 
-  // Compute all terms as scalars using dot products
-  VectorX<T> J_dot_times_v(1);
-  J_dot_times_v << (J_rel_v).squaredNorm() / phi +
-                       rel_pos.dot(J_rel_dot_times_v) / phi -
-                       phidot * rel_pos.dot(J_rel_v) / (phi * phi);
-  return J_dot_times_v;
+template <typename T>
+void DistanceEvaluator<T>::EvalFullFromPoints(
+    const Context<T>& context, const PointKinematics<T>& points,
+    const std::vector<int>& point_indices, drake::EigenPtr<VectorX<T>> phi,
+    drake::EigenPtr<MatrixX<T>> J, drake::EigenPtr<VectorX<T>> Jdotv) const {
+  const int a = point_indices.at(0);
+  const int b = point_indices.at(1);
+  const Vector3<T> rel_pos = points.p_W.col(a) - points.p_W.col(b);
+  const T norm = rel_pos.norm();
+  if (phi) {
+    (*phi)(0) = norm - distance_;
+  }
+  if (!J && !Jdotv) {
+    return;
+  }
+
+  // Same terms as EvalFullJacobian and EvalFullJacobianDotTimesV, with
+  // J_rel = J_A - J_B used column by column
+  const auto J_A = points.J_W.template middleRows<3>(3 * a);
+  const auto J_B = points.J_W.template middleRows<3>(3 * b);
+  if (J) {
+    for (int i = 0; i < J->cols(); i++) {
+      (*J)(0, i) = rel_pos.dot(J_A.col(i) - J_B.col(i)) / norm;
+    }
+  }
+  if (Jdotv) {
+    // A block of the state, where GetVelocities would return a copy
+    const auto v = plant().GetPositionsAndVelocities(context).tail(
+        plant().num_velocities());
+    Vector3<T> J_rel_v;
+    J_rel_v.noalias() = J_A * v;
+    J_rel_v.noalias() -= J_B * v;
+    const Vector3<T> J_rel_dot_times_v =
+        points.bias_W.col(a) - points.bias_W.col(b);
+    const T phidot = rel_pos.dot(J_rel_v) / norm;
+    (*Jdotv)(0) = J_rel_v.squaredNorm() / norm +
+                  rel_pos.dot(J_rel_dot_times_v) / norm -
+                  phidot * rel_pos.dot(J_rel_v) / (norm * norm);
+  }
 }
 
 DRAKE_DEFINE_CLASS_TEMPLATE_INSTANTIATIONS_ON_DEFAULT_NONSYMBOLIC_SCALARS(
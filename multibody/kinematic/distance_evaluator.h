@@ -1,5 +1,5 @@
 #pragma once
-#include "multibody/kinematic/kinematic_evaluator.h"
+#include "multibody/kinematic/fixed_size_kinematic_evaluator.h"
 
 #include "drake/multibody/plant/multibody_plant.h"
 #include "drake/systems/framework/context.h"
@@ -14,7 +14,7 @@ namespace multibody {
 /// The one exception is Jdotv, since Drake does not currently support
 /// MultibodyPlant.CalcBiasSpatialAcceleration with non-world frames,
 template <typename T>
-class DistanceEvaluator : public KinematicEvaluator<T> {
+class DistanceEvaluator : public FixedSizeKinematicEvaluator<T, 1> {
  public:
   /// Constructor for DistanceEvaluator
   /// @param plant
@@ -29,16 +29,29 @@ class DistanceEvaluator : public KinematicEvaluator<T> {
                     const Eigen::Vector3d pt_B,
                     const drake::multibody::Frame<T>& frame_B, double distance);
 
-  drake::VectorX<T> EvalFull(
-      const drake::systems::Context<T>& context) const override;
+  void EvalFull(const drake::systems::Context<T>& context,
+                drake::EigenPtr<drake::VectorX<T>> phi) const override;
 
   void EvalFullJacobian(const drake::systems::Context<T>& context,
                         drake::EigenPtr<drake::MatrixX<T>> J) const override;
 
-  drake::VectorX<T> EvalFullJacobianDotTimesV(
-      const drake::systems::Context<T>& context) const override;
+  void EvalFullJacobianDotTimesV(
+      const drake::systems::Context<T>& context,
+      drake::EigenPtr<drake::VectorX<T>> Jdotv) const override;
 
-  using KinematicEvaluator<T>::EvalFullJacobian;
+  std::vector<std::pair<const drake::multibody::Frame<T>*, Eigen::Vector3d>>
+  GetPoints() const override;
+
+  void EvalFullFromPoints(
+      const drake::systems::Context<T>& context,
+      const PointKinematics<T>& points, const std::vector<int>& point_indices,
+      drake::EigenPtr<drake::VectorX<T>> phi,
+      drake::EigenPtr<drake::MatrixX<T>> J,
+      drake::EigenPtr<drake::VectorX<T>> Jdotv) const override;
+
+  using FixedSizeKinematicEvaluator<T, 1>::EvalFull;
+  using FixedSizeKinematicEvaluator<T, 1>::EvalFullJacobian;
+  using FixedSizeKinematicEvaluator<T, 1>::EvalFullJacobianDotTimesV;
   using KinematicEvaluator<T>::plant;
 
  private:
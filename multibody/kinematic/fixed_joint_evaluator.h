@@ -28,7 +28,9 @@ class FixedJointEvaluator : public KinematicEvaluator<T> {
   drake::VectorX<T> EvalFullJacobianDotTimesV(
       const drake::systems::Context<T>& context) const override;
 
+  using KinematicEvaluator<T>::EvalFull;
   using KinematicEvaluator<T>::EvalFullJacobian;
+  using KinematicEvaluator<T>::EvalFullJacobianDotTimesV;
   using KinematicEvaluator<T>::plant;
 
  private:
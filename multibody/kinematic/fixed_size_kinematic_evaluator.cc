@@ -0,0 +1,89 @@
+#include "multibody/kinematic/fixed_size_kinematic_evaluator.h"
+
+using drake::MatrixX;
+using drake::VectorX;
+using drake::multibody::MultibodyPlant;
+using drake::systems::Context;
+
+namespace dairlib {
+namespace multibody {
+
+template <typename T, int kRows>
+FixedSizeKinematicEvaluator<T, kRows>::FixedSizeKinematicEvaluator(
+    const MultibodyPlant<T>& plant)
+    : KinematicEvaluator<T>(plant, kRows) {}
+
+template <typename T, int kRows>
+VectorX<T> FixedSizeKinematicEvaluator<T, kRows>::EvalFull(
+    const Context<T>& context) const {
+  VectorX<T> phi(kRows);
+  EvalFull(context, &phi);
+  return phi;
+}
+
+template <typename T, int kRows>
+VectorX<T> FixedSizeKinematicEvaluator<T, kRows>::EvalFullJacobianDotTimesV(
+    const Context<T>& context) const {
+  VectorX<T> Jdotv(kRows);
+  EvalFullJacobianDotTimesV(context, &Jdotv);
+  return Jdotv;
+}
+
+template <typename T, int kRows>
+void FixedSizeKinematicEvaluator<T, kRows>::EvalActive(
+    const Context<T>& context, drake::EigenPtr<VectorX<T>> phi) const {
+  if (this->all_active_default_order()) {
+    EvalFull(context, phi);
+    return;
+  }
+  VectorR phi_full;
+  EvalFull(context, &phi_full);
+  for (int i = 0; i < this->num_active(); i++) {
+    (*phi)(i) = phi_full(this->active_inds().at(i));
+  }
+}
+
+template <typename T, int kRows>
+void FixedSizeKinematicEvaluator<T, kRows>::EvalActiveJacobian(
+    const Context<T>& context, drake::EigenPtr<MatrixX<T>> J) const {
+  if (this->all_active_default_order()) {
+    this->EvalFullJacobian(context, J);
+    return;
+  }
+  auto select_rows = [&](auto* J_full) {
+    this->EvalFullJacobian(context, J_full);
+    for (int i = 0; i < this->num_active(); i++) {
+      J->row(i) = J_full->row(this->active_inds().at(i));
+    }
+  };
+  const int n_v = this->plant().num_velocities();
+  if (fits_on_stack()) {
+    StackJacobian<kRows> J_full(kRows, n_v);
+    select_rows(&J_full);
+  } else {
+    MatrixX<T> J_full(kRows, n_v);
+    select_rows(&J_full);
+  }
+}
+
+template <typename T, int kRows>
+void FixedSizeKinematicEvaluator<T, kRows>::EvalActiveJacobianDotTimesV(
+    const Context<T>& context, drake::EigenPtr<VectorX<T>> Jdotv) const {
+  if (this->all_active_default_order()) {
+    EvalFullJacobianDotTimesV(context, Jdotv);
+    return;
+  }
+  VectorR Jdotv_full;
+  EvalFullJacobianDotTimesV(context, &Jdotv_full);
+  for (int i = 0; i < this->num_active(); i++) {
+    (*Jdotv)(i) = Jdotv_full(this->active_inds().at(i));
+  }
+}
+
+template class FixedSizeKinematicEvaluator<double, 1>;
+template class FixedSizeKinematicEvaluator<double, 3>;
+template class FixedSizeKinematicEvaluator<drake::AutoDiffXd, 1>;
+template class FixedSizeKinematicEvaluator<drake::AutoDiffXd, 3>;
+
+}  // namespace multibody
+}  // namespace dairlib
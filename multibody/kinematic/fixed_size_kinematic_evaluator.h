@@ -0,0 +1,72 @@
+#pragma once
+
+#include "multibody/kinematic/kinematic_evaluator.h"
+
+namespace dairlib {
+namespace multibody {
+
+/// KinematicEvaluator whose number of rows, kRows, is known at compile time,
+/// such as a point (3) or a distance (1).
+///
+/// Implementations provide the output-parameter evaluations (EvalFull,
+/// EvalFullJacobian and EvalFullJacobianDotTimesV into preallocated outputs),
+/// using fixed-size temporaries. The versions that return by value and the
+/// active-row versions are implemented here in terms of them; the latter keep
+/// the full rows on the stack for up to kMaxVelocities velocities, so that
+/// for T = double the output-parameter API allocates nothing beyond what the
+/// plant's kinematics queries do.
+template <typename T, int kRows>
+class FixedSizeKinematicEvaluator : public KinematicEvaluator<T> {
+ public:
+  static constexpr int kNumRows = kRows;
+  /// Largest number of velocities for which the scratch Jacobians are kept
+  /// on the stack. Larger plants allocate them.
+  static constexpr int kMaxVelocities = 64;
+
+  explicit FixedSizeKinematicEvaluator(
+      const drake::multibody::MultibodyPlant<T>& plant);
+
+  drake::VectorX<T> EvalFull(
+      const drake::systems::Context<T>& context) const final;
+
+  drake::VectorX<T> EvalFullJacobianDotTimesV(
+      const drake::systems::Context<T>& context) const final;
+
+  void EvalFull(const drake::systems::Context<T>& context,
+                drake::EigenPtr<drake::VectorX<T>> phi) const override = 0;
+
+  void EvalFullJacobianDotTimesV(
+      const drake::systems::Context<T>& context,
+      drake::EigenPtr<drake::VectorX<T>> Jdotv) const override = 0;
+
+  void EvalActive(const drake::systems::Context<T>& context,
+                  drake::EigenPtr<drake::VectorX<T>> phi) const override;
+
+  void EvalActiveJacobian(const drake::systems::Context<T>& context,
+                          drake::EigenPtr<drake::MatrixX<T>> J) const override;
+
+  void EvalActiveJacobianDotTimesV(
+      const drake::systems::Context<T>& context,
+      drake::EigenPtr<drake::VectorX<T>> Jdotv) const override;
+
+  using KinematicEvaluator<T>::EvalActive;
+  using KinematicEvaluator<T>::EvalActiveJacobian;
+  using KinematicEvaluator<T>::EvalActiveJacobianDotTimesV;
+  using KinematicEvaluator<T>::EvalFullJacobian;
+
+ protected:
+  using VectorR = Eigen::Matrix<T, kRows, 1>;
+  /// Rows x velocities scratch matrix, on the stack for up to kMaxVelocities
+  /// columns. Only use it if the plant has no more velocities (see
+  /// fits_on_stack()).
+  template <int kScratchRows>
+  using StackJacobian = Eigen::Matrix<T, kScratchRows, Eigen::Dynamic, 0,
+                                      kScratchRows, kMaxVelocities>;
+
+  bool fits_on_stack() const {
+    return this->plant().num_velocities() <= kMaxVelocities;
+  }
+};
+
+}  // namespace multibody
+}  // namespace dairlib
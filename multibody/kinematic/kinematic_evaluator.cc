@@ -94,6 +94,48 @@ VectorX<T> KinematicEvaluator<T>::EvalActiveJacobianDotTimesV(
   return Jdot_v;
 }
 
+template <typename T>
+void KinematicEvaluator<T>::EvalFull(const Context<T>& context,
+                                     drake::EigenPtr<VectorX<T>> phi) const {
+  *phi = EvalFull(context);
+}
+
+template <typename T>
+void KinematicEvaluator<T>::EvalFullJacobianDotTimesV(
+    const Context<T>& context, drake::EigenPtr<VectorX<T>> Jdotv) const {
+  *Jdotv = EvalFullJacobianDotTimesV(context);
+}
+
+template <typename T>
+void KinematicEvaluator<T>::EvalActive(const Context<T>& context,
+                                       drake::EigenPtr<VectorX<T>> phi) const {
+  if (all_active_default_order_) {
+    EvalFull(context, phi);
+  } else {
+    *phi = EvalActive(context);
+  }
+}
+
+template <typename T>
+void KinematicEvaluator<T>::EvalActiveJacobian(
+    const Context<T>& context, drake::EigenPtr<MatrixX<T>> J) const {
+  if (all_active_default_order_) {
+    EvalFullJacobian(context, J);
+  } else {
+    *J = EvalActiveJacobian(context);
+  }
+}
+
+template <typename T>
+void KinematicEvaluator<T>::EvalActiveJacobianDotTimesV(
+    const Context<T>& context, drake::EigenPtr<VectorX<T>> Jdotv) const {
+  if (all_active_default_order_) {
+    EvalFullJacobianDotTimesV(context, Jdotv);
+  } else {
+    *Jdotv = EvalActiveJacobianDotTimesV(context);
+  }
+}
+
 template <typename T>
 VectorX<T> KinematicEvaluator<T>::EvalFullTimeDerivative(
     const Context<T>& context) const {
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
 #include "drake/multibody/plant/multibody_plant.h"
 #include "drake/solvers/constraint.h"
 #include "drake/systems/framework/context.h"
@@ -7,6 +11,17 @@
 namespace dairlib {
 namespace multibody {
 
+/// World positions, translational Jacobians w.r.t. v and bias accelerations
+/// (Jdot * v) of a list of points, as computed in one pass by
+/// KinematicEvaluatorSet::EvalFullKinematics. Point i is column i of p_W and
+/// bias_W and rows 3i to 3i + 2 of J_W.
+template <typename T>
+struct PointKinematics {
+  drake::Matrix3X<T> p_W;
+  drake::MatrixX<T> J_W;
+  drake::Matrix3X<T> bias_W;
+};
+
 /// Virtual class to represent arbitrary kinematic evaluations
 /// Evaluations are defined by some function phi(q). Implementations
 /// must generate phi(q), J(q) (the Jacobian w.r.t. velocities v),
@@ -74,6 +89,51 @@ class KinematicEvaluator {
   virtual drake::VectorX<T> EvalFullJacobianDotTimesV(
       const drake::systems::Context<T>& context) const = 0;
 
+  /// Output-parameter versions of the evaluations above, writing into
+  /// preallocated vectors and matrices of num_full() or num_active() rows.
+  /// The defaults go through the versions that return by value;
+  /// FixedSizeKinematicEvaluator implements them with no heap temporaries of
+  /// its own.
+  virtual void EvalFull(const drake::systems::Context<T>& context,
+                        drake::EigenPtr<drake::VectorX<T>> phi) const;
+
+  virtual void EvalFullJacobianDotTimesV(
+      const drake::systems::Context<T>& context,
+      drake::EigenPtr<drake::VectorX<T>> Jdotv) const;
+
+  virtual void EvalActive(const drake::systems::Context<T>& context,
+                          drake::EigenPtr<drake::VectorX<T>> phi) const;
+
+  virtual void EvalActiveJacobian(const drake::systems::Context<T>& context,
+                                  drake::EigenPtr<drake::MatrixX<T>> J) const;
+
+  virtual void EvalActiveJacobianDotTimesV(
+      const drake::systems::Context<T>& context,
+      drake::EigenPtr<drake::VectorX<T>> Jdotv) const;
+
+  /// The points, each fixed in a frame, that this evaluator is a function
+  /// of. Evaluators that return any must implement EvalFullFromPoints, which
+  /// lets KinematicEvaluatorSet compute the kinematics of the points of all of
+  /// its evaluators together, one call per frame. Default: none.
+  virtual std::vector<
+      std::pair<const drake::multibody::Frame<T>*, Eigen::Vector3d>>
+  GetPoints() const {
+    return {};
+  }
+
+  /// Evaluates phi(q), the Jacobian w.r.t. v and Jdot * v from the kinematics
+  /// of the points returned by GetPoints, where GetPoints()[i] is point
+  /// point_indices[i] of `points`. Outputs that are nullptr are skipped.
+  virtual void EvalFullFromPoints(
+      const drake::systems::Context<T>& context,
+      const PointKinematics<T>& points, const std::vector<int>& point_indices,
+      drake::EigenPtr<drake::VectorX<T>> phi,
+      drake::EigenPtr<drake::MatrixX<T>> J,
+      drake::EigenPtr<drake::VectorX<T>> Jdotv) const {
+    throw std::logic_error(
+        "EvalFullFromPoints is not implemented for this evaluator.");
+  }
+
   void set_active_inds(std::vector<int> active_inds);
 
   const std::vector<int>& active_inds() const;
@@ -116,6 +176,10 @@ class KinematicEvaluator {
 
   double mu() const { return mu_; };
 
+ protected:
+  /// True if all rows are active, in the order {0, 1, ...}
+  bool all_active_default_order() const { return all_active_default_order_; }
+
  private:
   const drake::multibody::MultibodyPlant<T>& plant_;
   int num_active_;
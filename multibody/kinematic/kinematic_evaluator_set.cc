@@ -1,5 +1,10 @@
 #include "multibody/kinematic/kinematic_evaluator_set.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "multibody/kinematic/constrained_dynamics_solver.h"
+
 #include "drake/math/autodiff_gradient.h"
 
 namespace dairlib {
@@ -22,6 +27,15 @@ KinematicEvaluatorSet<T>::KinematicEvaluatorSet(
   }
 }
 
+template <typename T>
+KinematicEvaluatorSet<T>::KinematicEvaluatorSet(
+    const KinematicEvaluatorSet<T>& other)
+    : plant_(other.plant_),
+      evaluators_(other.evaluators_),
+      frame_points_(other.frame_points_),
+      num_points_(other.num_points_),
+      point_indices_(other.point_indices_) {}
+
 template <typename T>
 VectorX<T> KinematicEvaluatorSet<T>::EvalActive(
     const Context<T>& context) const {
@@ -76,11 +90,8 @@ VectorX<T> KinematicEvaluatorSet<T>::EvalActiveJacobianDotTimesV(
 template <typename T>
 VectorX<T> KinematicEvaluatorSet<T>::EvalFull(const Context<T>& context) const {
   VectorX<T> phi(count_full());
-  int ind = 0;
-  for (const auto& e : evaluators_) {
-    phi.segment(ind, e->num_full()) = e->EvalFull(context);
-    ind += e->num_full();
-  }
+  PointKinematics<T> points;
+  EvalFullKinematics(context, &points, &phi, nullptr, nullptr);
   return phi;
 }
 
@@ -120,12 +131,8 @@ void KinematicEvaluatorSet<T>::EvalFullJacobian(
   const int num_velocities = plant_.num_velocities();
   DRAKE_THROW_UNLESS(J->rows() == count_full());
   DRAKE_THROW_UNLESS(J->cols() == num_velocities);
-  int ind = 0;
-  for (const auto& e : evaluators_) {
-    auto J_i = J->block(ind, 0, e->num_full(), num_velocities);
-    e->EvalFullJacobian(context, &J_i);
-    ind += e->num_full();
-  }
+  PointKinematics<T> points;
+  EvalFullKinematics(context, &points, nullptr, J, nullptr);
 }
 
 template <typename T>
@@ -140,12 +147,89 @@ template <typename T>
 VectorX<T> KinematicEvaluatorSet<T>::EvalFullJacobianDotTimesV(
     const Context<T>& context) const {
   VectorX<T> Jdotv(count_full());
+  PointKinematics<T> points;
+  EvalFullKinematics(context, &points, nullptr, nullptr, &Jdotv);
+  return Jdotv;
+}
+
+template <typename T>
+void KinematicEvaluatorSet<T>::EvalFullKinematics(
+    const Context<T>& context, PointKinematics<T>* points,
+    drake::EigenPtr<VectorX<T>> phi, drake::EigenPtr<MatrixX<T>> J,
+    drake::EigenPtr<VectorX<T>> Jdotv) const {
+  const int num_velocities = plant_.num_velocities();
+  DRAKE_THROW_UNLESS(!phi || phi->size() == count_full());
+  DRAKE_THROW_UNLESS(!J || (J->rows() == count_full() &&
+                            J->cols() == num_velocities));
+  DRAKE_THROW_UNLESS(!Jdotv || Jdotv->size() == count_full());
+
+  // Kinematics of all points, one call per frame. Jdot * v also needs the
+  // point Jacobians (see DistanceEvaluator).
+  const bool need_jacobian = J || Jdotv;
+  const auto& world = plant_.world_frame();
+  points->p_W.resize(3, num_points_);
+  if (need_jacobian) {
+    points->J_W.resize(3 * num_points_, num_velocities);
+  }
+  if (Jdotv) {
+    points->bias_W.resize(3, num_points_);
+  }
+  for (const auto& group : frame_points_) {
+    const int n = group.p_B.cols();
+    auto p_W = points->p_W.middleCols(group.start, n);
+    plant_.CalcPointsPositions(context, *group.frame, group.p_B, world, &p_W);
+    if (need_jacobian) {
+      auto J_W = points->J_W.middleRows(3 * group.start, 3 * n);
+      plant_.CalcJacobianTranslationalVelocity(
+          context, drake::multibody::JacobianWrtVariable::kV, *group.frame,
+          group.p_B, world, world, &J_W);
+    }
+    if (Jdotv) {
+      points->bias_W.middleCols(group.start, n) =
+          plant_.CalcBiasTranslationalAcceleration(
+              context, drake::multibody::JacobianWrtVariable::kV,
+              *group.frame, group.p_B, world, world);
+    }
+  }
+
   int ind = 0;
-  for (const auto& e : evaluators_) {
-    Jdotv.segment(ind, e->num_full()) = e->EvalFullJacobianDotTimesV(context);
-    ind += e->num_full();
+  for (int i = 0; i < num_evaluators(); i++) {
+    const auto& e = *evaluators_[i];
+    const int n = e.num_full();
+    if (point_indices_[i].empty()) {
+      if (phi) {
+        auto phi_i = phi->segment(ind, n);
+        e.EvalFull(context, &phi_i);
+      }
+      if (J) {
+        auto J_i = J->middleRows(ind, n);
+        e.EvalFullJacobian(context, &J_i);
+      }
+      if (Jdotv) {
+        auto Jdotv_i = Jdotv->segment(ind, n);
+        e.EvalFullJacobianDotTimesV(context, &Jdotv_i);
+      }
+    } else {
+      drake::EigenPtr<VectorX<T>> phi_i = nullptr;
+      drake::EigenPtr<MatrixX<T>> J_i = nullptr;
+      drake::EigenPtr<VectorX<T>> Jdotv_i = nullptr;
+      if (phi) {
+        auto block = phi->segment(ind, n);
+        phi_i = &block;
+      }
+      if (J) {
+        auto block = J->middleRows(ind, n);
+        J_i = &block;
+      }
+      if (Jdotv) {
+        auto block = Jdotv->segment(ind, n);
+        Jdotv_i = &block;
+      }
+      e.EvalFullFromPoints(context, *points, point_indices_[i], phi_i, J_i,
+                           Jdotv_i);
+    }
+    ind += n;
   }
-  return Jdotv;
 }
 
 template <typename T>
@@ -154,9 +238,83 @@ int KinematicEvaluatorSet<T>::add_evaluator(KinematicEvaluator<T>* e) {
   DRAKE_DEMAND(&plant_ == &e->plant());
 
   evaluators_.push_back(e);
+  UpdatePointGroups();
+  {
+    std::lock_guard<std::mutex> lock(solvers_mutex_);
+    solvers_.clear();
+  }
   return evaluators_.size() - 1;
 }
 
+template <typename T>
+std::shared_ptr<ConstrainedDynamicsSolver<T>>
+KinematicEvaluatorSet<T>::AcquireSolver() const {
+  {
+    std::lock_guard<std::mutex> lock(solvers_mutex_);
+    if (!solvers_.empty()) {
+      auto solver = std::move(solvers_.back());
+      solvers_.pop_back();
+      return solver;
+    }
+  }
+  return std::make_shared<ConstrainedDynamicsSolver<T>>(*this);
+}
+
+template <typename T>
+void KinematicEvaluatorSet<T>::ReleaseSolver(
+    std::shared_ptr<ConstrainedDynamicsSolver<T>> solver) const {
+  std::lock_guard<std::mutex> lock(solvers_mutex_);
+  solvers_.push_back(std::move(solver));
+}
+
+template <typename T>
+bool KinematicEvaluatorSet<T>::NeedsPlantPorts() const {
+  return plant_.is_discrete() || plant_.geometry_source_is_registered();
+}
+
+template <typename T>
+void KinematicEvaluatorSet<T>::UpdatePointGroups() {
+  // Collect the points of each frame, recording where each evaluator's
+  // points land as (group, index within the group)
+  std::vector<const drake::multibody::Frame<T>*> frames;
+  std::vector<std::vector<Eigen::Vector3d>> frame_points;
+  std::vector<std::vector<std::pair<int, int>>> locations;
+  for (const auto& e : evaluators_) {
+    locations.emplace_back();
+    for (const auto& [frame, pt] : e->GetPoints()) {
+      int group = std::find(frames.begin(), frames.end(), frame) -
+                  frames.begin();
+      if (group == static_cast<int>(frames.size())) {
+        frames.push_back(frame);
+        frame_points.emplace_back();
+      }
+      locations.back().emplace_back(group, frame_points[group].size());
+      frame_points[group].push_back(pt);
+    }
+  }
+
+  frame_points_.clear();
+  num_points_ = 0;
+  for (int group = 0; group < static_cast<int>(frames.size()); group++) {
+    const int n = frame_points[group].size();
+    FramePoints frame_group{frames[group], drake::Matrix3X<T>(3, n),
+                            num_points_};
+    for (int j = 0; j < n; j++) {
+      frame_group.p_B.col(j) = frame_points[group][j].template cast<T>();
+    }
+    frame_points_.push_back(frame_group);
+    num_points_ += n;
+  }
+
+  point_indices_.clear();
+  for (const auto& evaluator_locations : locations) {
+    point_indices_.emplace_back();
+    for (const auto& [group, j] : evaluator_locations) {
+      point_indices_.back().push_back(frame_points_[group].start + j);
+    }
+  }
+}
+
 template <typename T>
 std::vector<int> KinematicEvaluatorSet<T>::FindUnion(
     KinematicEvaluatorSet<T> other) const {
@@ -206,47 +364,56 @@ template <typename T>
 VectorX<T> KinematicEvaluatorSet<T>::CalcMassMatrixTimesVDot(
     const Context<T>& context, const VectorX<T>& lambda) const {
   // M(q)vdot + C(q,v) = tau_g(q) + F_app + Bu + J(q)^T lambda
-  VectorX<T> C(plant_.num_velocities());
-  plant_.CalcBiasTerm(context, &C);
-
-  VectorX<T> Bu = plant_.MakeActuationMatrix() *
-                  plant_.get_actuation_input_port().Eval(context);
-
-  VectorX<T> tau_g = plant_.CalcGravityGeneralizedForces(context);
-
-  drake::multibody::MultibodyForces<T> f_app(plant_);
-  plant_.CalcForceElementsContribution(context, &f_app);
-
-  VectorX<T> J_transpose_lambda =
-      EvalFullJacobian(context).transpose() * lambda;
-
-  return tau_g + f_app.generalized_forces() + Bu + J_transpose_lambda - C;
+  VectorX<T> M_vdot(plant_.num_velocities());
+  auto solver = AcquireSolver();
+  solver->UpdateForces(context);
+  solver->CalcMassMatrixTimesVDot(lambda, &M_vdot);
+  ReleaseSolver(std::move(solver));
+  return M_vdot;
 }
 
 template <typename T>
 VectorX<T> KinematicEvaluatorSet<T>::CalcTimeDerivativesWithForce(
     Context<T>* context, const VectorX<T>& lambda) const {
-  MatrixX<T> J(count_full(), plant_.num_velocities());
-  EvalFullJacobian(*context, &J);
-  VectorX<T> J_transpose_lambda = J.transpose() * lambda;
-
-  plant_.get_applied_generalized_force_input_port().FixValue(
-      context, J_transpose_lambda);
-
-  // N.B. Evaluating the generalized acceleration port rather than the time
-  // derivatives to ensure that this supports continuous and discrete plants
-  // (discrete plants would not compute time derivatives)
-  const VectorX<T>& v_dot =
-      plant_.get_generalized_acceleration_output_port()
-          .template Eval<drake::systems::BasicVector<double>>(*context)
-          .CopyToVector();
   VectorX<T> x_dot(plant_.num_positions() + plant_.num_velocities());
-  VectorX<T> q_dot(plant_.num_positions());
-  plant_.MapVelocityToQDot(*context, plant_.GetVelocities(*context), &q_dot);
-  x_dot << q_dot, v_dot;
+  CalcTimeDerivativesWithForce(context, lambda, &x_dot);
   return x_dot;
 }
 
+template <typename T>
+void KinematicEvaluatorSet<T>::CalcTimeDerivativesWithForce(
+    Context<T>* context, const Eigen::Ref<const VectorX<T>>& lambda,
+    VectorX<T>* xdot) const {
+  const int n_q = plant_.num_positions();
+  const int n_v = plant_.num_velocities();
+  xdot->resize(n_q + n_v);
+  auto q_dot = xdot->head(n_q);
+  auto v_dot = xdot->tail(n_v);
+
+  if (NeedsPlantPorts()) {
+    MatrixX<T> J(count_full(), n_v);
+    EvalFullJacobian(*context, &J);
+    VectorX<T> J_transpose_lambda = J.transpose() * lambda;
+
+    plant_.get_applied_generalized_force_input_port().FixValue(
+        context, J_transpose_lambda);
+
+    // N.B. Evaluating the generalized acceleration port rather than the time
+    // derivatives to ensure that this supports continuous and discrete plants
+    // (discrete plants would not compute time derivatives)
+    v_dot = plant_.get_generalized_acceleration_output_port()
+                .template Eval<drake::systems::BasicVector<double>>(*context)
+                .CopyToVector();
+  } else {
+    auto solver = AcquireSolver();
+    solver->Update(*context);
+    solver->CalcVDotWithForce(lambda, &v_dot);
+    ReleaseSolver(std::move(solver));
+  }
+  plant_.MapVelocityToQDot(
+      *context, plant_.GetPositionsAndVelocities(*context).tail(n_v), &q_dot);
+}
+
 template <typename T>
 VectorX<T> KinematicEvaluatorSet<T>::CalcTimeDerivatives(
     const Context<T>& context, double alpha) const {
@@ -259,46 +426,21 @@ VectorX<T> KinematicEvaluatorSet<T>::CalcTimeDerivatives(
     const Context<T>& context, VectorX<T>* lambda, double alpha) const {
   // M(q) vdot + C(q,v) = tau_g(q) + f_app + Bu + J(q)^T lambda
   // J vdot + Jdotv  + kp phi + kd phidot = 0
-  // Produces linear system of equations
-  // [[M -J^T]  [[vdot  ]  =  [[tau_g + f_app + Bu - C     ]
-  //  [J  0 ]]  [lambda]]     [ -Jdotv - kp phi - kd phidot]]
-
-  // Evaluate manipulator equation terms
-  MatrixX<T> M(plant_.num_velocities(), plant_.num_velocities());
-  plant_.CalcMassMatrix(context, &M);
-
-  VectorX<T> C(plant_.num_velocities());
-  plant_.CalcBiasTerm(context, &C);
-
-  VectorX<T> Bu = plant_.MakeActuationMatrix() *
-                  plant_.get_actuation_input_port().Eval(context);
-
-  VectorX<T> tau_g = plant_.CalcGravityGeneralizedForces(context);
-
-  drake::multibody::MultibodyForces<T> f_app(plant_);
-  plant_.CalcForceElementsContribution(context, &f_app);
-
-  // Evaluate active constraint terms.
-  VectorX<T> phi = EvalActive(context);
-  VectorX<T> phidot = EvalActiveTimeDerivative(context);
-  MatrixX<T> J = EvalActiveJacobian(context);
-  VectorX<T> Jdotv = EvalActiveJacobianDotTimesV(context);
-
-  MatrixX<T> A(M.rows() + J.rows(), M.cols() + J.rows());
-  VectorX<T> b(M.rows() + J.rows());
-  A << M, -J.transpose(), J, MatrixX<T>::Zero(J.rows(), J.rows());
-  b << tau_g + f_app.generalized_forces() + Bu - C,
-      -(Jdotv + alpha * alpha * phi + 2 * alpha * phidot);
-  const VectorX<T> vdot_lambda = A.ldlt().solve(b);
-
-  *lambda = vdot_lambda.tail(J.rows());
-
-  VectorX<T> x_dot(plant_.num_positions() + plant_.num_velocities());
-  VectorX<T> q_dot(plant_.num_positions());
-
-  plant_.MapVelocityToQDot(context, plant_.GetVelocities(context), &q_dot);
-
-  x_dot << q_dot, vdot_lambda.head(plant_.num_velocities());
+  // Solved through the Schur complement J M^-1 J^T, see
+  // ConstrainedDynamicsSolver
+  const int n_q = plant_.num_positions();
+  const int n_v = plant_.num_velocities();
+  VectorX<T> x_dot(n_q + n_v);
+  VectorX<T> v_dot(n_v);
+  auto solver = AcquireSolver();
+  solver->Update(context);
+  solver->CalcVDot(alpha, lambda, &v_dot);
+  ReleaseSolver(std::move(solver));
+
+  auto q_dot = x_dot.head(n_q);
+  plant_.MapVelocityToQDot(
+      context, plant_.GetPositionsAndVelocities(context).tail(n_v), &q_dot);
+  x_dot.tail(n_v) = v_dot;
 
   return x_dot;
 }
@@ -1,10 +1,17 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "multibody/kinematic/kinematic_evaluator.h"
 
 namespace dairlib {
 namespace multibody {
 
+template <typename T>
+class ConstrainedDynamicsSolver;
+
 /// Simple class that maintains a vector pointers to KinematicEvaluator
 /// objects. Provides a basic API for counting and accumulating evaluations
 /// and their Jacobians.
@@ -20,6 +27,9 @@ class KinematicEvaluatorSet {
   explicit KinematicEvaluatorSet(
       const drake::multibody::MultibodyPlant<T>& plant);
 
+  /// Copies the evaluators, but not the solvers held for CalcTimeDerivatives
+  KinematicEvaluatorSet(const KinematicEvaluatorSet<T>& other);
+
   /// Evaluates phi(q), limited only to active rows
   drake::VectorX<T> EvalActive(const drake::systems::Context<T>& context) const;
 
@@ -71,6 +81,23 @@ class KinematicEvaluatorSet {
   drake::VectorX<T> EvalFullJacobianDotTimesV(
       const drake::systems::Context<T>& context) const;
 
+  /// Evaluates phi(q), the Jacobian w.r.t. v and Jdot * v, including inactive
+  /// rows, in one pass. The points of the evaluators that report them (see
+  /// KinematicEvaluator::GetPoints) are grouped by frame, so that each frame
+  /// takes one CalcPointsPositions, CalcJacobianTranslationalVelocity and
+  /// CalcBiasTranslationalAcceleration call for all of its points, rather than
+  /// one per evaluator and quantity. Other evaluators are evaluated one by
+  /// one. EvalFull, EvalFullJacobian and EvalFullJacobianDotTimesV use this.
+  /// @param points scratch memory for the point kinematics. Reusing it across
+  ///   calls avoids reallocating; use one per thread.
+  /// @param phi, J, Jdotv outputs with count_full() rows, written in place.
+  ///   Any of them can be nullptr.
+  void EvalFullKinematics(const drake::systems::Context<T>& context,
+                          PointKinematics<T>* points,
+                          drake::EigenPtr<drake::VectorX<T>> phi,
+                          drake::EigenPtr<drake::MatrixX<T>> J,
+                          drake::EigenPtr<drake::VectorX<T>> Jdotv) const;
+
   /// Determines the list of evaluators objects contained in the union with
   /// another set Specifically, `index` is in the returned vector if
   /// other.evaluators_.at(index) is an element of other.evaluators, as judged
@@ -112,10 +139,21 @@ class KinematicEvaluatorSet {
   /// @param context
   /// @param lambda constraint forces, applied via
   ///   evaluators.EvalActiveJacobian().transpose() * lambda
+  /// For continuous plants without a SceneGraph, this neither changes the
+  /// context nor evaluates the plant's ports (see ConstrainedDynamicsSolver).
   drake::VectorX<T> CalcTimeDerivativesWithForce(
       drake::systems::Context<T>* context,
       const drake::VectorX<T>& lambda) const;
 
+  /// As above, writing to xdot, which is resized if needed. For double,
+  /// continuous plants without a SceneGraph and a sized xdot, this allocates
+  /// only inside the plant's dynamics queries once a first call has made the
+  /// solver.
+  void CalcTimeDerivativesWithForce(
+      drake::systems::Context<T>* context,
+      const Eigen::Ref<const drake::VectorX<T>>& lambda,
+      drake::VectorX<T>* xdot) const;
+
   /// Computes vdot given the state and control inputs, satisfying kinematic
   /// constraints.
   /// Solves for the constraint forces using the ACTIVE kinematic elements.
@@ -129,6 +167,8 @@ class KinematicEvaluatorSet {
   /// @param context
   /// @param alpha Inverse time constant for constraint stabilization.
   ///   Results in kp = alpha^2, kd = 2*alpha. Default = 0
+  /// To evaluate several variants at the same state (other alphas, given
+  /// forces) from one factorization, use ConstrainedDynamicsSolver.
   drake::VectorX<T> CalcTimeDerivatives(
       const drake::systems::Context<T>& context, double alpha = 0) const;
 
@@ -173,8 +213,36 @@ class KinematicEvaluatorSet {
   const drake::multibody::MultibodyPlant<T>& plant() const { return plant_; };
 
  private:
+  // Points of the evaluators, grouped by frame, for EvalFullKinematics
+  struct FramePoints {
+    const drake::multibody::Frame<T>* frame;
+    drake::Matrix3X<T> p_B;
+    // Index of the first point of the group
+    int start;
+  };
+
+  // Rebuilds frame_points_ and point_indices_ from evaluators_
+  void UpdatePointGroups();
+
+  // Takes a solver from solvers_, or makes one if all are in use. Solvers
+  // are returned with ReleaseSolver, so that concurrent callers (e.g. the
+  // threads of a ConstraintBatch) each use their own.
+  std::shared_ptr<ConstrainedDynamicsSolver<T>> AcquireSolver() const;
+  void ReleaseSolver(std::shared_ptr<ConstrainedDynamicsSolver<T>> solver) const;
+
+  // True if the dynamics must be evaluated through the plant's ports, which
+  // include contact forces from a SceneGraph and discrete updates
+  bool NeedsPlantPorts() const;
+
   const drake::multibody::MultibodyPlant<T>& plant_;
   std::vector<KinematicEvaluator<T>*> evaluators_;
+  std::vector<FramePoints> frame_points_;
+  int num_points_ = 0;
+  // For each evaluator, the indices of its points (empty if it has none)
+  std::vector<std::vector<int>> point_indices_;
+  // Idle solvers, sized for the current evaluators
+  mutable std::mutex solvers_mutex_;
+  mutable std::vector<std::shared_ptr<ConstrainedDynamicsSolver<T>>> solvers_;
 };
 
 }  // namespace multibody
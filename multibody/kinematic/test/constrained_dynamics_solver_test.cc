@@ -0,0 +1,265 @@
+#include "multibody/kinematic/constrained_dynamics_solver.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "common/allocation_counter.h"
+#include "common/find_resource.h"
+#include "examples/Cassie/cassie_utils.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/multibody/parsing/parser.h"
+#include "drake/multibody/plant/multibody_plant.h"
+
+namespace dairlib {
+namespace multibody {
+namespace {
+
+using drake::CompareMatrices;
+using drake::multibody::MultibodyPlant;
+using drake::multibody::Parser;
+using drake::systems::Context;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+
+class ConstrainedDynamicsSolverTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // No SceneGraph, so that the plant's accelerations have no contact forces
+    plant_ = std::make_unique<MultibodyPlant<double>>(0.0);
+    Parser parser(plant_.get());
+    std::string full_name =
+        dairlib::FindResourceOrThrow("examples/PlanarWalker/PlanarWalker.urdf");
+    parser.AddModelFromFile(full_name);
+    plant_->WeldFrames(plant_->world_frame(), plant_->GetFrameByName("base"),
+                       drake::math::RigidTransform<double>());
+    plant_->Finalize();
+
+    context_ = plant_->CreateDefaultContext();
+    VectorXd q(plant_->num_positions());
+    VectorXd v(plant_->num_velocities());
+    VectorXd u(plant_->num_actuators());
+    for (int i = 0; i < q.size(); i++) q(i) = 0.2 * (i + 1);
+    for (int i = 0; i < v.size(); i++) v(i) = 0.5 * (i - 3);
+    for (int i = 0; i < u.size(); i++) u(i) = 1.0 - i;
+    plant_->SetPositions(context_.get(), q);
+    plant_->SetVelocities(context_.get(), v);
+    plant_->get_actuation_input_port().FixValue(context_.get(), u);
+  }
+
+  std::unique_ptr<MultibodyPlant<double>> plant_;
+  std::unique_ptr<Context<double>> context_;
+};
+
+// The y direction of a point of the planar walker has a zero Jacobian row, so
+// the active constraints are rank deficient
+TEST_F(ConstrainedDynamicsSolverTest, RankDeficientConstraints) {
+  const double tolerance = 1e-8;
+  const double alpha = 2;
+
+  WorldPointEvaluator<double> toe(*plant_, Vector3d(0, 0, -.5),
+                                  plant_->GetFrameByName("right_lower_leg"));
+  WorldPointEvaluator<double> heel(*plant_, Vector3d(.1, 0, -.5),
+                                   plant_->GetFrameByName("left_lower_leg"),
+                                   Vector3d(0, 0, 1), Vector3d::Zero(), false);
+  KinematicEvaluatorSet<double> evaluators(*plant_);
+  evaluators.add_evaluator(&toe);
+  evaluators.add_evaluator(&heel);
+
+  ConstrainedDynamicsSolver<double> solver(evaluators);
+  solver.Update(*context_);
+  EXPECT_TRUE(solver.is_mass_matrix_factored());
+
+  VectorXd lambda;
+  const VectorXd vdot = solver.CalcVDot(alpha, &lambda);
+  ASSERT_EQ(lambda.size(), evaluators.count_active());
+
+  // Stabilized constraint accelerations
+  const MatrixXd J = evaluators.EvalActiveJacobian(*context_);
+  const VectorXd residual = J * vdot +
+                            evaluators.EvalActiveJacobianDotTimesV(*context_) +
+                            alpha * alpha * evaluators.EvalActive(*context_) +
+                            2 * alpha *
+                                evaluators.EvalActiveTimeDerivative(*context_);
+  EXPECT_TRUE(CompareMatrices(residual, VectorXd::Zero(J.rows()), tolerance));
+
+  // Manipulator equation, with the active forces mapped to the full rows
+  VectorXd lambda_full = VectorXd::Zero(evaluators.count_full());
+  lambda_full.head(3) = lambda.head(3);
+  lambda_full(5) = lambda(3);
+  MatrixXd M(plant_->num_velocities(), plant_->num_velocities());
+  plant_->CalcMassMatrix(*context_, &M);
+  EXPECT_TRUE(CompareMatrices(
+      M * vdot, evaluators.CalcMassMatrixTimesVDot(*context_, lambda_full),
+      tolerance));
+
+  // Same as the set
+  VectorXd lambda_set;
+  const VectorXd xdot =
+      evaluators.CalcTimeDerivatives(*context_, &lambda_set, alpha);
+  EXPECT_TRUE(CompareMatrices(xdot.tail(plant_->num_velocities()), vdot,
+                              tolerance));
+  EXPECT_TRUE(CompareMatrices(lambda_set, lambda, tolerance));
+}
+
+TEST_F(ConstrainedDynamicsSolverTest, GivenForce) {
+  const double tolerance = 1e-8;
+
+  WorldPointEvaluator<double> toe(*plant_, Vector3d(0, 0, -.5),
+                                  plant_->GetFrameByName("right_lower_leg"));
+  KinematicEvaluatorSet<double> evaluators(*plant_);
+  evaluators.add_evaluator(&toe);
+
+  ConstrainedDynamicsSolver<double> solver(evaluators);
+  solver.Update(*context_);
+
+  const VectorXd lambda = Vector3d(1, 2, 30);
+  EXPECT_TRUE(CompareMatrices(
+      solver.CalcMassMatrixTimesVDot(lambda),
+      evaluators.CalcMassMatrixTimesVDot(*context_, lambda), tolerance));
+
+  const VectorXd vdot = solver.CalcVDotWithForce(lambda);
+  const VectorXd xdot =
+      evaluators.CalcTimeDerivativesWithForce(context_.get(), lambda);
+  EXPECT_TRUE(CompareMatrices(vdot, xdot.tail(plant_->num_velocities()),
+                              tolerance));
+
+  // Both match the plant's own forward dynamics
+  plant_->get_applied_generalized_force_input_port().FixValue(
+      context_.get(),
+      VectorXd(evaluators.EvalFullJacobian(*context_).transpose() * lambda));
+  const VectorXd vdot_plant =
+      plant_->get_generalized_acceleration_output_port().Eval(*context_);
+  EXPECT_TRUE(CompareMatrices(vdot, vdot_plant, tolerance));
+}
+
+// Once a first call has sized the scratch and made the set's solver, the
+// output-parameter Calc methods do not allocate. Update() and
+// CalcTimeDerivativesWithForce() allocate inside the plant's dynamics queries,
+// which return by value, but the same number of times every pass.
+TEST_F(ConstrainedDynamicsSolverTest, SteadyStateAllocations) {
+  WorldPointEvaluator<double> toe(*plant_, Vector3d(0, 0, -.5),
+                                  plant_->GetFrameByName("right_lower_leg"));
+  WorldPointEvaluator<double> heel(*plant_, Vector3d(.1, 0, -.5),
+                                   plant_->GetFrameByName("left_lower_leg"),
+                                   Vector3d(0, 0, 1), Vector3d::Zero(), false);
+  KinematicEvaluatorSet<double> evaluators(*plant_);
+  evaluators.add_evaluator(&toe);
+  evaluators.add_evaluator(&heel);
+
+  ConstrainedDynamicsSolver<double> solver(evaluators);
+  const int n_v = plant_->num_velocities();
+  VectorXd lambda(evaluators.count_active());
+  VectorXd vdot(n_v);
+  const VectorXd lambda_full = VectorXd::Ones(evaluators.count_full());
+  VectorXd M_vdot(n_v);
+  VectorXd xdot(plant_->num_positions() + n_v);
+
+  int64_t update_count = 0;
+  int64_t set_count = 0;
+  for (int i = 0; i < 3; i++) {
+    plant_->SetVelocities(context_.get(), VectorXd::Constant(n_v, 0.1 * i));
+    int64_t update_count_i;
+    {
+      AllocationCounter counter;
+      solver.Update(*context_);
+      update_count_i = counter.count();
+    }
+    {
+      AllocationCounter counter;
+      solver.CalcVDot(2, &lambda, &vdot);
+      solver.CalcVDotWithForce(lambda_full, &vdot);
+      solver.CalcMassMatrixTimesVDot(lambda_full, &M_vdot);
+      if (i > 0) {
+        EXPECT_EQ(counter.count(), 0) << "pass " << i;
+      }
+    }
+    int64_t set_count_i;
+    {
+      AllocationCounter counter;
+      evaluators.CalcTimeDerivativesWithForce(context_.get(), lambda_full,
+                                              &xdot);
+      set_count_i = counter.count();
+    }
+    if (i == 1) {
+      update_count = update_count_i;
+      set_count = set_count_i;
+    } else if (i > 1) {
+      EXPECT_EQ(update_count_i, update_count) << "pass " << i;
+      EXPECT_EQ(set_count_i, set_count) << "pass " << i;
+    }
+  }
+}
+
+// Cassie with springs has force elements (the loop closure bushings) that
+// apply spatial forces, which the solver path of CalcTimeDerivativesWithForce
+// must include to match the plant's own forward dynamics
+TEST(ConstrainedDynamicsSolverCassieTest, WithSpringsMatchesPlant) {
+  // No SceneGraph, so that CalcTimeDerivativesWithForce uses the solver
+  MultibodyPlant<double> plant(0.0);
+  AddCassieMultibody(&plant, nullptr, true,
+                     "examples/Cassie/urdf/cassie_v2.urdf", true, true);
+  plant.Finalize();
+
+  auto left_loop = LeftLoopClosureEvaluator(plant);
+  auto right_loop = RightLoopClosureEvaluator(plant);
+  const auto left_toe_front = LeftToeFront(plant);
+  const auto left_toe_rear = LeftToeRear(plant);
+  const auto right_toe_front = RightToeFront(plant);
+  const auto right_toe_rear = RightToeRear(plant);
+  WorldPointEvaluator<double> left_front(plant, left_toe_front.first,
+                                         left_toe_front.second);
+  WorldPointEvaluator<double> left_rear(plant, left_toe_rear.first,
+                                        left_toe_rear.second);
+  WorldPointEvaluator<double> right_front(plant, right_toe_front.first,
+                                          right_toe_front.second);
+  WorldPointEvaluator<double> right_rear(plant, right_toe_rear.first,
+                                         right_toe_rear.second);
+  KinematicEvaluatorSet<double> evaluators(plant);
+  evaluators.add_evaluator(&left_loop);
+  evaluators.add_evaluator(&right_loop);
+  evaluators.add_evaluator(&left_front);
+  evaluators.add_evaluator(&left_rear);
+  evaluators.add_evaluator(&right_front);
+  evaluators.add_evaluator(&right_rear);
+
+  auto context = plant.CreateDefaultContext();
+  const int n_q = plant.num_positions();
+  const int n_v = plant.num_velocities();
+  std::srand(0);
+  // Perturb the joints (and not the floating base quaternion), so that the
+  // springs and bushings are deflected
+  VectorXd q = plant.GetPositions(*context);
+  q.tail(n_q - 7) += 0.1 * VectorXd::Random(n_q - 7);
+  plant.SetPositions(context.get(), q);
+  plant.SetVelocities(context.get(), VectorXd::Random(n_v));
+  plant.get_actuation_input_port().FixValue(
+      context.get(), VectorXd(10 * VectorXd::Random(plant.num_actuators())));
+  const VectorXd lambda = 10 * VectorXd::Random(evaluators.count_full());
+
+  const VectorXd xdot =
+      evaluators.CalcTimeDerivativesWithForce(context.get(), lambda);
+
+  plant.get_applied_generalized_force_input_port().FixValue(
+      context.get(),
+      VectorXd(evaluators.EvalFullJacobian(*context).transpose() * lambda));
+  const VectorXd vdot_plant =
+      plant.get_generalized_acceleration_output_port().Eval(*context);
+  const double tolerance = 1e-8 * std::max(1.0, vdot_plant.norm());
+  EXPECT_TRUE(CompareMatrices(xdot.tail(n_v), vdot_plant, tolerance));
+}
+
+}  // namespace
+}  // namespace multibody
+}  // namespace dairlib
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,12 +1,15 @@
 #include "multibody/kinematic/kinematic_evaluator.h"
 
+#include <cstdint>
 #include <memory>
 #include <utility>
 
 #include <gtest/gtest.h>
 
+#include "common/allocation_counter.h"
 #include "common/find_resource.h"
 #include "multibody/kinematic/distance_evaluator.h"
+#include "multibody/kinematic/kinematic_evaluator_set.h"
 #include "multibody/kinematic/world_point_evaluator.h"
 
 #include "drake/common/test_utilities/eigen_matrix_compare.h"
@@ -243,6 +246,246 @@ TEST_F(KinematicEvaluatorTest, DistanceEvaluatorTest) {
   EXPECT_TRUE(CompareMatrices(Jdotv, Jdot_approx * v, dt * 100));
 }
 
+// The batched evaluation of the set must match the evaluators on their own,
+// with points sharing a frame and a non-default ground frame and offset
+TEST_F(KinematicEvaluatorTest, KinematicEvaluatorSetBatchTest) {
+  const double tolerance = 1e-10;
+
+  const auto& right = plant_->GetFrameByName("right_lower_leg");
+  const auto& left = plant_->GetFrameByName("left_lower_leg");
+  auto toe = WorldPointEvaluator<double>(
+      *plant_, Vector3d({0, 0, -.5}), right, Vector3d({1, 0, 1}).normalized(),
+      Vector3d({1, 2, 3}), false);
+  auto heel = WorldPointEvaluator<double>(*plant_, Vector3d({.1, 0, -.4}),
+                                          right);
+  auto distance = DistanceEvaluator<double>(*plant_, Vector3d({0, 0, -.25}),
+                                            right, Vector3d({0, 0, -.5}),
+                                            left, .5);
+  std::vector<KinematicEvaluator<double>*> evaluators = {&toe, &distance,
+                                                         &heel};
+  KinematicEvaluatorSet<double> evaluator_set(*plant_);
+  for (auto* e : evaluators) {
+    evaluator_set.add_evaluator(e);
+  }
+
+  auto context = plant_->CreateDefaultContext();
+  VectorXd q(plant_->num_positions());
+  VectorXd v(plant_->num_velocities());
+  for (int i = 0; i < q.size(); i++) {
+    q(i) = 0.1 * (i + 1);
+  }
+  for (int i = 0; i < v.size(); i++) {
+    v(i) = 0.3 * (i - 2);
+  }
+  plant_->SetPositions(context.get(), q);
+  plant_->SetVelocities(context.get(), v);
+
+  const int n = evaluator_set.count_full();
+  VectorXd phi(n);
+  MatrixXd J(n, plant_->num_velocities());
+  VectorXd Jdotv(n);
+  PointKinematics<double> points;
+  evaluator_set.EvalFullKinematics(*context, &points, &phi, &J, &Jdotv);
+
+  int ind = 0;
+  for (const auto* e : evaluators) {
+    EXPECT_TRUE(CompareMatrices(phi.segment(ind, e->num_full()),
+                                e->EvalFull(*context), tolerance));
+    EXPECT_TRUE(CompareMatrices(J.middleRows(ind, e->num_full()),
+                                e->EvalFullJacobian(*context), tolerance));
+    EXPECT_TRUE(CompareMatrices(Jdotv.segment(ind, e->num_full()),
+                                e->EvalFullJacobianDotTimesV(*context),
+                                tolerance));
+    ind += e->num_full();
+  }
+
+  // Reusing the scratch memory, and skipping outputs
+  VectorXd Jdotv_only(n);
+  evaluator_set.EvalFullKinematics(*context, &points, nullptr, nullptr,
+                                   &Jdotv_only);
+  EXPECT_TRUE(CompareMatrices(Jdotv_only, Jdotv, tolerance));
+  EXPECT_TRUE(CompareMatrices(evaluator_set.EvalFull(*context), phi,
+                              tolerance));
+}
+
+// The output-parameter evaluations of the fixed-size evaluators must match
+// the ones returning by value, including active rows in a non-default order
+TEST_F(KinematicEvaluatorTest, OutputParameterTest) {
+  const double tolerance = 1e-10;
+
+  const auto& right = plant_->GetFrameByName("right_lower_leg");
+  const auto& left = plant_->GetFrameByName("left_lower_leg");
+  auto point = WorldPointEvaluator<double>(
+      *plant_, Vector3d({.1, 0, -.5}), right, Eigen::Matrix3d::Identity(),
+      Vector3d({1, 2, 3}), {2, 0});
+  auto distance = DistanceEvaluator<double>(*plant_, Vector3d({0, 0, -.25}),
+                                            right, Vector3d({0, 0, -.5}),
+                                            left, .5);
+
+  auto context = plant_->CreateDefaultContext();
+  VectorXd q(plant_->num_positions());
+  VectorXd v(plant_->num_velocities());
+  for (int i = 0; i < q.size(); i++) {
+    q(i) = 0.2 * (i + 1);
+  }
+  for (int i = 0; i < v.size(); i++) {
+    v(i) = 0.4 * (i - 3);
+  }
+  plant_->SetPositions(context.get(), q);
+  plant_->SetVelocities(context.get(), v);
+
+  for (const KinematicEvaluator<double>* e :
+       std::vector<const KinematicEvaluator<double>*>{&point, &distance}) {
+    VectorXd phi(e->num_full());
+    MatrixXd J(e->num_full(), plant_->num_velocities());
+    VectorXd Jdotv(e->num_full());
+    e->EvalFull(*context, &phi);
+    e->EvalFullJacobian(*context, &J);
+    e->EvalFullJacobianDotTimesV(*context, &Jdotv);
+    EXPECT_TRUE(CompareMatrices(phi, e->EvalFull(*context), tolerance));
+    EXPECT_TRUE(CompareMatrices(J, e->EvalFullJacobian(*context), tolerance));
+    EXPECT_TRUE(CompareMatrices(Jdotv, e->EvalFullJacobianDotTimesV(*context),
+                                tolerance));
+
+    VectorXd phi_active(e->num_active());
+    MatrixXd J_active(e->num_active(), plant_->num_velocities());
+    VectorXd Jdotv_active(e->num_active());
+    e->EvalActive(*context, &phi_active);
+    e->EvalActiveJacobian(*context, &J_active);
+    e->EvalActiveJacobianDotTimesV(*context, &Jdotv_active);
+    for (int i = 0; i < e->num_active(); i++) {
+      const int row = e->active_inds().at(i);
+      EXPECT_NEAR(phi_active(i), phi(row), tolerance);
+      EXPECT_TRUE(CompareMatrices(J_active.row(i), J.row(row), tolerance));
+      EXPECT_NEAR(Jdotv_active(i), Jdotv(row), tolerance);
+    }
+  }
+}
+
+// Once the outputs are sized, the output-parameter evaluations of the
+// fixed-size evaluators, and EvalFullKinematics with reused point
+// kinematics, allocate only inside the plant's kinematics queries: the
+// evaluators' own temporaries are on the stack. Each pass makes the same plant
+// queries directly and expects the same number of allocations.
+TEST_F(KinematicEvaluatorTest, OutputParameterAllocatesOnlyInPlant) {
+  const auto& right = plant_->GetFrameByName("right_lower_leg");
+  const auto& left = plant_->GetFrameByName("left_lower_leg");
+  const Vector3d pt_point(.1, 0, -.5);
+  const Vector3d pt_A(0, 0, -.25);
+  const Vector3d pt_B(0, 0, -.5);
+  auto point = WorldPointEvaluator<double>(
+      *plant_, pt_point, right, Eigen::Matrix3d::Identity(),
+      Vector3d({1, 2, 3}), {2, 0});
+  auto distance =
+      DistanceEvaluator<double>(*plant_, pt_A, right, pt_B, left, .5);
+  KinematicEvaluatorSet<double> evaluators(*plant_);
+  evaluators.add_evaluator(&point);
+  evaluators.add_evaluator(&distance);
+
+  auto context = plant_->CreateDefaultContext();
+  const int n_v = plant_->num_velocities();
+  VectorXd phi(3);
+  MatrixXd J(3, n_v);
+  VectorXd Jdotv(3);
+  PointKinematics<double> points;
+  VectorXd phi_set(evaluators.count_full());
+  MatrixXd J_set(evaluators.count_full(), n_v);
+  VectorXd Jdotv_set(evaluators.count_full());
+
+  // Outputs of the plant queries
+  const auto& world = plant_->world_frame();
+  const auto kV = drake::multibody::JacobianWrtVariable::kV;
+  Vector3d p_W;
+  MatrixXd J_W(3, n_v);
+  Eigen::Matrix3Xd p_right(3, 2);
+  p_right << pt_point, pt_A;
+  Eigen::Matrix3Xd p_right_W(3, 2);
+  MatrixXd J_right_W(6, n_v);
+  Eigen::Matrix3Xd bias_right_W(3, 2);
+  Eigen::Matrix3Xd bias_left_W(3, 1);
+
+  for (int i = 0; i < 3; i++) {
+    plant_->SetVelocities(context.get(), VectorXd::Constant(n_v, 0.1 * i));
+    int64_t evaluator_count;
+    {
+      AllocationCounter counter;
+      for (const KinematicEvaluator<double>* e :
+           {static_cast<const KinematicEvaluator<double>*>(&point),
+            static_cast<const KinematicEvaluator<double>*>(&distance)}) {
+        auto phi_e = phi.head(e->num_full());
+        auto J_e = J.topRows(e->num_full());
+        auto Jdotv_e = Jdotv.head(e->num_full());
+        e->EvalFull(*context, &phi_e);
+        e->EvalFullJacobian(*context, &J_e);
+        e->EvalFullJacobianDotTimesV(*context, &Jdotv_e);
+
+        auto phi_active = phi.head(e->num_active());
+        auto J_active = J.topRows(e->num_active());
+        auto Jdotv_active = Jdotv.head(e->num_active());
+        e->EvalActive(*context, &phi_active);
+        e->EvalActiveJacobian(*context, &J_active);
+        e->EvalActiveJacobianDotTimesV(*context, &Jdotv_active);
+      }
+      evaluators.EvalFullKinematics(*context, &points, &phi_set, &J_set,
+                                    &Jdotv_set);
+      evaluator_count = counter.count();
+    }
+
+    int64_t plant_count;
+    {
+      AllocationCounter counter;
+      // The point evaluates its full rows twice, the second time to select
+      // the active ones
+      for (int j = 0; j < 2; j++) {
+        plant_->CalcPointsPositions(*context, right, pt_point, world, &p_W);
+        plant_->CalcJacobianTranslationalVelocity(*context, kV, right,
+                                                  pt_point, world, world,
+                                                  &J_W);
+        plant_->CalcBiasSpatialAcceleration(*context, kV, right, pt_point,
+                                            world, world);
+      }
+      // The distance's only row is active, so the active evaluations are the
+      // full ones
+      for (int j = 0; j < 2; j++) {
+        for (int k = 0; k < 2; k++) {
+          plant_->CalcPointsPositions(*context, right, pt_A, world, &p_W);
+          plant_->CalcPointsPositions(*context, left, pt_B, world, &p_W);
+        }
+        plant_->CalcJacobianTranslationalVelocity(*context, kV, right, pt_A,
+                                                  world, world, &J_W);
+        plant_->CalcJacobianTranslationalVelocity(*context, kV, left, pt_B,
+                                                  world, world, &J_W);
+        right.CalcPoseInWorld(*context);
+        left.CalcPoseInWorld(*context);
+        right.CalcSpatialVelocityInWorld(*context);
+        left.CalcSpatialVelocityInWorld(*context);
+        plant_->CalcBiasSpatialAcceleration(*context, kV, right, pt_A, world,
+                                            world);
+        plant_->CalcBiasSpatialAcceleration(*context, kV, left, pt_B, world,
+                                            world);
+      }
+      // EvalFullKinematics makes one query per frame
+      plant_->CalcPointsPositions(*context, right, p_right, world,
+                                  &p_right_W);
+      plant_->CalcJacobianTranslationalVelocity(*context, kV, right, p_right,
+                                                world, world, &J_right_W);
+      bias_right_W = plant_->CalcBiasTranslationalAcceleration(
+          *context, kV, right, p_right, world, world);
+      plant_->CalcPointsPositions(*context, left, pt_B, world, &p_W);
+      plant_->CalcJacobianTranslationalVelocity(*context, kV, left, pt_B,
+                                                world, world, &J_W);
+      bias_left_W = plant_->CalcBiasTranslationalAcceleration(
+          *context, kV, left, pt_B, world, world);
+      plant_count = counter.count();
+    }
+
+    // The first pass sizes the point kinematics
+    if (i > 0) {
+      EXPECT_EQ(evaluator_count, plant_count) << "pass " << i;
+    }
+  }
+}
+
 }  // namespace
 }  // namespace multibody
 }  // namespace dairlib
@@ -25,7 +25,7 @@ WorldPointEvaluator<T>::WorldPointEvaluator(const MultibodyPlant<T>& plant,
                                             const Matrix3d& R_GW,
                                             const Vector3d& offset,
                                             std::vector<int> active_directions)
-    : KinematicEvaluator<T>(plant, 3),
+    : FixedSizeKinematicEvaluator<T, 3>(plant),
       pt_A_(pt_A),
       frame_A_(frame_A),
       offset_(offset),
@@ -39,7 +39,7 @@ WorldPointEvaluator<T>::WorldPointEvaluator(
     const Frame<T>& frame_A, const multibody::ViewFrame<T>& view_frame,
     const Matrix3d& R_GW, const Vector3d& offset,
     std::vector<int> active_directions)
-    : KinematicEvaluator<T>(plant, 3),
+    : FixedSizeKinematicEvaluator<T, 3>(plant),
       pt_A_(pt_A),
       frame_A_(frame_A),
       offset_(offset),
@@ -55,7 +55,7 @@ WorldPointEvaluator<T>::WorldPointEvaluator(const MultibodyPlant<T>& plant,
                                             const Vector3d& normal,
                                             const Vector3d& offset,
                                             bool tangent_active)
-    : KinematicEvaluator<T>(plant, 3),
+    : FixedSizeKinematicEvaluator<T, 3>(plant),
       pt_A_(pt_A),
       frame_A_(frame_A),
       offset_(offset),
@@ -66,14 +66,15 @@ WorldPointEvaluator<T>::WorldPointEvaluator(const MultibodyPlant<T>& plant,
 }
 
 template <typename T>
-VectorX<T> WorldPointEvaluator<T>::EvalFull(const Context<T>& context) const {
-  VectorX<T> pt_world(3);
+void WorldPointEvaluator<T>::EvalFull(const Context<T>& context,
+                                      drake::EigenPtr<VectorX<T>> phi) const {
+  drake::Vector3<T> pt_world;
   const drake::multibody::Frame<T>& world = plant().world_frame();
 
   plant().CalcPointsPositions(context, frame_A_, pt_A_.template cast<T>(),
                               world, &pt_world);
 
-  return R_WB_ * (pt_world - offset_);
+  *phi = R_WB_ * (pt_world - offset_);
 }
 
 template <typename T>
@@ -86,28 +87,66 @@ void WorldPointEvaluator<T>::EvalFullJacobian(
       context, drake::multibody::JacobianWrtVariable::kV, frame_A_,
       pt_A_.template cast<T>(), world, world, J);
 
-  if (view_frame_ == nullptr) {
-    *J = R_WB_ * (*J);
-  } else {
-    *J = view_frame_->CalcWorldToFrameRotation(plant(), context) *
-         (R_WB_ * (*J));
+  // Rotate column by column, which needs no temporary of the size of J
+  const drake::Matrix3<T> R = CalcRotation(context);
+  for (int i = 0; i < J->cols(); i++) {
+    const drake::Vector3<T> J_i = R * J->col(i);
+    J->col(i) = J_i;
   }
 }
 
 template <typename T>
-VectorX<T> WorldPointEvaluator<T>::EvalFullJacobianDotTimesV(
-    const Context<T>& context) const {
+void WorldPointEvaluator<T>::EvalFullJacobianDotTimesV(
+    const Context<T>& context, drake::EigenPtr<VectorX<T>> Jdotv) const {
   const drake::multibody::Frame<T>& world = plant().world_frame();
 
-  MatrixX<T> Jdot_times_V = plant().CalcBiasTranslationalAcceleration(
-      context, drake::multibody::JacobianWrtVariable::kV, frame_A_,
-      pt_A_.template cast<T>(), world, world);
+  // Translational part of the bias spatial acceleration of frame A shifted
+  // to pt_A, which unlike CalcBiasTranslationalAcceleration is fixed-size
+  const drake::Vector3<T> Jdot_times_V =
+      plant()
+          .CalcBiasSpatialAcceleration(
+              context, drake::multibody::JacobianWrtVariable::kV, frame_A_,
+              pt_A_.template cast<T>(), world, world)
+          .translational();
+
+  *Jdotv = CalcRotation(context) * Jdot_times_V;
+}
 
+template <typename T>
+drake::Matrix3<T> WorldPointEvaluator<T>::CalcRotation(
+    const Context<T>& context) const {
   if (view_frame_ == nullptr) {
-    return R_WB_ * Jdot_times_V;
-  } else {
-    return view_frame_->CalcWorldToFrameRotation(plant(), context) *
-           (R_WB_ * Jdot_times_V);
+    return R_WB_.matrix().template cast<T>();
+  }
+  return view_frame_->CalcWorldToFrameRotation(plant(), context) *
+         R_WB_.matrix().template cast<T>();
+}
+
+template <typename T>
+vector<std::pair<const Frame<T>*, Vector3d>>
+WorldPointEvaluator<T>::GetPoints() const {
+  return {{&frame_A_, pt_A_}};
+}
+
+template <typename T>
+void WorldPointEvaluator<T>::EvalFullFromPoints(
+    const Context<T>& context, const PointKinematics<T>& points,
+    const vector<int>& point_indices, drake::EigenPtr<VectorX<T>> phi,
+    drake::EigenPtr<MatrixX<T>> J, drake::EigenPtr<VectorX<T>> Jdotv) const {
+  const int i = point_indices.at(0);
+  if (phi) {
+    *phi = R_WB_ * (points.p_W.col(i) - offset_);
+  }
+  if (!J && !Jdotv) {
+    return;
+  }
+
+  const drake::Matrix3<T> R = CalcRotation(context);
+  if (J) {
+    J->noalias() = R * points.J_W.template middleRows<3>(3 * i);
+  }
+  if (Jdotv) {
+    *Jdotv = R * points.bias_W.col(i);
   }
 }
 
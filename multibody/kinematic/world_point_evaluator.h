@@ -1,5 +1,5 @@
 #pragma once
-#include "multibody/kinematic/kinematic_evaluator.h"
+#include "multibody/kinematic/fixed_size_kinematic_evaluator.h"
 #include "multibody/view_frame.h"
 
 #include "drake/math/rotation_matrix.h"
@@ -11,7 +11,7 @@ namespace multibody {
 
 /// Basic contact evaluator for a point on a body w.r.t. the world
 template <typename T>
-class WorldPointEvaluator : public KinematicEvaluator<T> {
+class WorldPointEvaluator : public FixedSizeKinematicEvaluator<T, 3> {
  public:
   /// The basic constructor for WorldPointEvaluator, defined via a rotation
   /// matrix.
@@ -69,16 +69,29 @@ class WorldPointEvaluator : public KinematicEvaluator<T> {
                       const Eigen::Vector3d& offset = Eigen::Vector3d::Zero(),
                       bool tangent_active = true);
 
-  drake::VectorX<T> EvalFull(
-      const drake::systems::Context<T>& context) const override;
+  void EvalFull(const drake::systems::Context<T>& context,
+                drake::EigenPtr<drake::VectorX<T>> phi) const override;
 
   void EvalFullJacobian(const drake::systems::Context<T>& context,
                         drake::EigenPtr<drake::MatrixX<T>> J) const override;
 
-  drake::VectorX<T> EvalFullJacobianDotTimesV(
-      const drake::systems::Context<T>& context) const override;
+  void EvalFullJacobianDotTimesV(
+      const drake::systems::Context<T>& context,
+      drake::EigenPtr<drake::VectorX<T>> Jdotv) const override;
 
-  using KinematicEvaluator<T>::EvalFullJacobian;
+  std::vector<std::pair<const drake::multibody::Frame<T>*, Eigen::Vector3d>>
+  GetPoints() const override;
+
+  void EvalFullFromPoints(
+      const drake::systems::Context<T>& context,
+      const PointKinematics<T>& points, const std::vector<int>& point_indices,
+      drake::EigenPtr<drake::VectorX<T>> phi,
+      drake::EigenPtr<drake::MatrixX<T>> J,
+      drake::EigenPtr<drake::VectorX<T>> Jdotv) const override;
+
+  using FixedSizeKinematicEvaluator<T, 3>::EvalFull;
+  using FixedSizeKinematicEvaluator<T, 3>::EvalFullJacobian;
+  using FixedSizeKinematicEvaluator<T, 3>::EvalFullJacobianDotTimesV;
   using KinematicEvaluator<T>::plant;
 
   std::vector<std::shared_ptr<drake::solvers::Constraint>>
@@ -94,6 +107,11 @@ class WorldPointEvaluator : public KinematicEvaluator<T> {
   void set_frictional() { is_frictional_ = true; };
 
  private:
+  // Rotation from the world to the evaluation frame: R_WB_, preceded by the
+  // view frame rotation if there is one
+  drake::Matrix3<T> CalcRotation(
+      const drake::systems::Context<T>& context) const;
+
   const Eigen::Vector3d pt_A_;
   const drake::multibody::Frame<T>& frame_A_;
   const Eigen::Vector3d offset_;
@@ -118,6 +118,14 @@ void SetInputsIfNew(const MultibodyPlant<T>& plant,
   }
 }
 
+template <typename T>
+void CalcGravityGeneralizedForces(const MultibodyPlant<T>& plant,
+                                  const Context<T>& context,
+                                  drake::EigenPtr<VectorX<T>> tau_g) {
+  DRAKE_DEMAND(tau_g->size() == plant.num_velocities());
+  *tau_g = plant.CalcGravityGeneralizedForces(context);
+}
+
 template <typename T>
 void AddFlatTerrain(MultibodyPlant<T>* plant, SceneGraph<T>* scene_graph,
                     double mu_static, double mu_kinetic,
@@ -471,6 +479,36 @@ Vector2d ReExpressWorldVector2InBodyYawFrame(const MultibodyPlant<T>& plant,
                   -sin(yaw) * vec(0) + cos(yaw)*vec(1));
 }
 
+template <typename T>
+std::vector<int> KinematicPathVelocityIndices(
+    const MultibodyPlant<T>& plant, const drake::multibody::Body<T>& body) {
+  // Inboard joint of every body that is not a floating base
+  map<BodyIndex, JointIndex> inboard_joint;
+  for (JointIndex i(0); i < plant.num_joints(); ++i) {
+    inboard_joint[plant.get_joint(i).child_body().index()] = i;
+  }
+
+  std::set<int> indices;
+  const drake::multibody::Body<T>* current = &body;
+  while (current->index() != plant.world_body().index()) {
+    if (inboard_joint.count(current->index())) {
+      const auto& joint = plant.get_joint(inboard_joint.at(current->index()));
+      for (int i = 0; i < joint.num_velocities(); ++i) {
+        indices.insert(joint.velocity_start() + i);
+      }
+      current = &joint.parent_body();
+    } else {
+      DRAKE_DEMAND(current->is_floating());
+      int start = current->floating_velocities_start() - plant.num_positions();
+      for (int i = 0; i < 6; ++i) {
+        indices.insert(start + i);
+      }
+      break;
+    }
+  }
+  return vector<int>(indices.begin(), indices.end());
+}
+
 VectorXd MakeJointPositionOffsetFromMap(
     const drake::multibody::MultibodyPlant<double>& plant,
     const std::map<std::string, double>& joint_offset_map) {
@@ -507,6 +545,8 @@ Eigen::MatrixXd JwrtqdotToJwrtv(
   return ret;
 }
 
+template vector<int> KinematicPathVelocityIndices(const MultibodyPlant<double>& plant, const drake::multibody::Body<double>& body);  // NOLINT
+template vector<int> KinematicPathVelocityIndices(const MultibodyPlant<AutoDiffXd>& plant, const drake::multibody::Body<AutoDiffXd>& body);  // NOLINT
 template int QuaternionStartIndex(const MultibodyPlant<double>& plant);  // NOLINT
 template int QuaternionStartIndex(const MultibodyPlant<AutoDiffXd>& plant);  // NOLINT
 template std::vector<int> QuaternionStartIndices(const MultibodyPlant<double>& plant);  // NOLINT
@@ -542,5 +582,7 @@ template void SetVelocitiesIfNew(const MultibodyPlant<AutoDiffXd>&, const Eigen:
 template void SetVelocitiesIfNew(const MultibodyPlant<double>&, const Eigen::Ref<const VectorXd>&, Context<double>*);  // NOLINT
 template void SetInputsIfNew(const MultibodyPlant<AutoDiffXd>&, const Eigen::Ref<const AutoDiffVecXd>&, Context<AutoDiffXd>*);  // NOLINT
 template void SetInputsIfNew(const MultibodyPlant<double>&, const Eigen::Ref<const VectorXd>&, Context<double>*);  // NOLINT
+template void CalcGravityGeneralizedForces(const MultibodyPlant<AutoDiffXd>&, const Context<AutoDiffXd>&, drake::EigenPtr<AutoDiffVecXd>);  // NOLINT
+template void CalcGravityGeneralizedForces(const MultibodyPlant<double>&, const Context<double>&, drake::EigenPtr<VectorXd>);  // NOLINT
 }  // namespace multibody
 }  // namespace dairlib
@@ -58,6 +58,16 @@ void SetInputsIfNew(const drake::multibody::MultibodyPlant<T>& plant,
                     const Eigen::Ref<const drake::VectorX<T>>& u,
                     drake::systems::Context<T>* context);
 
+/// Writes the generalized forces tau_g(q) due to gravity into the
+/// preallocated `tau_g`, for callers that keep it in per-tick storage.
+/// MultibodyPlant only computes it by value, so this still allocates one
+/// temporary per call.
+template <typename T>
+void CalcGravityGeneralizedForces(
+    const drake::multibody::MultibodyPlant<T>& plant,
+    const drake::systems::Context<T>& context,
+    drake::EigenPtr<drake::VectorX<T>> tau_g);
+
 /// Add terrain to an initialized, but not finalized, MultibodyPlant
 /// and scene graph. Uses the given values for coefficients of friction.
 /// normal_W is the normal direction of the ground (pointing to z as the
@@ -156,6 +166,16 @@ Eigen::Vector2d ReExpressWorldVector2InBodyYawFrame(
     const Eigen::Vector2d& vec);
 
 
+/// Returns the indices of the generalized velocities that can contribute to
+/// the spatial velocity of `body`, i.e. the velocities of every joint
+/// (including a floating base) on the kinematic path from the world to
+/// `body`, in increasing order. Every column of a Jacobian of a point or frame
+/// on `body` (w.r.t. v) that is not in this set is structurally zero.
+template <typename T>
+std::vector<int> KinematicPathVelocityIndices(
+    const drake::multibody::MultibodyPlant<T>& plant,
+    const drake::multibody::Body<T>& body);
+
 /// Given a map of join position offsets labeled by name, i.e.
 /// {'toe_left': 0.02, 'knee_right': .0115}, constructs the vector q_offset,
 /// such that the corrected position vector is given by q + q_offset.
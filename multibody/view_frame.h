@@ -19,7 +19,7 @@ template <typename T>
 class ViewFrame {
  public:
   virtual ~ViewFrame() = 0;
-  virtual drake::Matrix3X<T> CalcWorldToFrameRotation(
+  virtual drake::Matrix3<T> CalcWorldToFrameRotation(
       const drake::multibody::MultibodyPlant<T>& plant_w_spr,
       const drake::systems::Context<T>& context_w_spr) const = 0;
 };
@@ -31,7 +31,7 @@ class WorldYawViewFrame : public ViewFrame<T> {
   explicit WorldYawViewFrame(const drake::multibody::Body<T>& body)
       : ViewFrame<T>(), body_(body) {}
 
-  drake::Matrix3X<T> CalcWorldToFrameRotation(
+  drake::Matrix3<T> CalcWorldToFrameRotation(
       const drake::multibody::MultibodyPlant<T>& plant_w_spr,
       const drake::systems::Context<T>& context_w_spr) const override;
 
@@ -45,7 +45,7 @@ class IdentityViewFrame : public ViewFrame<T> {
   explicit IdentityViewFrame() : ViewFrame<T>() {}
   ~IdentityViewFrame() = default;
 
-  drake::Matrix3X<T> CalcWorldToFrameRotation(
+  drake::Matrix3<T> CalcWorldToFrameRotation(
       const drake::multibody::MultibodyPlant<T>& plant_w_spr,
       const drake::systems::Context<T>& context_w_spr) const override;
 };
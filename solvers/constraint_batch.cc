@@ -0,0 +1,189 @@
+#include "solvers/constraint_batch.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+
+namespace dairlib {
+namespace solvers {
+
+using drake::AutoDiffVecXd;
+using drake::solvers::Binding;
+using drake::solvers::VectorXDecisionVariable;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace {
+
+typedef std::vector<Binding<drake::solvers::Constraint>> Bindings;
+
+// The union of the bindings' variables, in order of first appearance
+VectorXDecisionVariable CollectVariables(const Bindings& bindings) {
+  std::unordered_map<drake::symbolic::Variable::Id, int> index;
+  std::vector<drake::symbolic::Variable> variables;
+  for (const auto& binding : bindings) {
+    for (int i = 0; i < binding.variables().size(); ++i) {
+      const auto& var = binding.variables()(i);
+      if (index.emplace(var.get_id(), variables.size()).second) {
+        variables.push_back(var);
+      }
+    }
+  }
+  VectorXDecisionVariable result(variables.size());
+  for (int i = 0; i < result.size(); ++i) {
+    result(i) = variables[i];
+  }
+  return result;
+}
+
+int CountRows(const Bindings& bindings) {
+  int rows = 0;
+  for (const auto& binding : bindings) {
+    rows += binding.evaluator()->num_constraints();
+  }
+  return rows;
+}
+
+VectorXd StackBounds(const Bindings& bindings, bool lower) {
+  VectorXd bounds(CountRows(bindings));
+  int row = 0;
+  for (const auto& binding : bindings) {
+    const auto& constraint = *binding.evaluator();
+    bounds.segment(row, constraint.num_constraints()) =
+        lower ? constraint.lower_bound() : constraint.upper_bound();
+    row += constraint.num_constraints();
+  }
+  return bounds;
+}
+
+}  // namespace
+
+ConstraintBatch::ConstraintBatch(const Bindings& bindings, int num_threads,
+                                 const std::string& description)
+    : drake::solvers::Constraint(CountRows(bindings),
+                                 CollectVariables(bindings).size(),
+                                 StackBounds(bindings, true),
+                                 StackBounds(bindings, false), description),
+      variables_(CollectVariables(bindings)),
+      thread_pool_(num_threads) {
+  std::unordered_map<drake::symbolic::Variable::Id, int> index;
+  for (int i = 0; i < variables_.size(); ++i) {
+    index.emplace(variables_(i).get_id(), i);
+  }
+
+  std::vector<std::pair<int, int>> sparsity_pattern;
+  int row_start = 0;
+  for (const auto& binding : bindings) {
+    Entry entry;
+    entry.constraint = binding.evaluator();
+    for (int i = 0; i < binding.variables().size(); ++i) {
+      entry.var_indices.push_back(index.at(binding.variables()(i).get_id()));
+    }
+    entry.row_start = row_start;
+
+    const auto& pattern = entry.constraint->gradient_sparsity_pattern();
+    if (pattern.has_value()) {
+      for (const auto& [row, col] : pattern.value()) {
+        sparsity_pattern.emplace_back(row_start + row,
+                                      entry.var_indices[col]);
+      }
+    } else {
+      for (int row = 0; row < entry.constraint->num_constraints(); ++row) {
+        for (int col : entry.var_indices) {
+          sparsity_pattern.emplace_back(row_start + row, col);
+        }
+      }
+    }
+    row_start += entry.constraint->num_constraints();
+    bindings_.push_back(std::move(entry));
+  }
+  // A variable can appear more than once in a binding
+  std::sort(sparsity_pattern.begin(), sparsity_pattern.end());
+  sparsity_pattern.erase(
+      std::unique(sparsity_pattern.begin(), sparsity_pattern.end()),
+      sparsity_pattern.end());
+  SetGradientSparsityPattern(sparsity_pattern);
+}
+
+void ConstraintBatch::DoEval(const Eigen::Ref<const VectorXd>& x,
+                             VectorXd* y) const {
+  y->resize(num_constraints());
+  thread_pool_.ParallelFor(bindings_.size(), [&](int i) {
+    Entry& entry = bindings_[i];
+    entry.x.resize(entry.var_indices.size());
+    for (int j = 0; j < entry.x.size(); ++j) {
+      entry.x(j) = x(entry.var_indices[j]);
+    }
+    entry.constraint->Eval(entry.x, &entry.y);
+    y->segment(entry.row_start, entry.y.size()) = entry.y;
+  });
+}
+
+void ConstraintBatch::DoEval(const Eigen::Ref<const AutoDiffVecXd>& x,
+                             AutoDiffVecXd* y) const {
+  // (x(i) returns AutoDiffXd by value, so read the derivatives through data())
+  const drake::AutoDiffXd* x_data = x.data();
+  const int num_derivatives = x.size() > 0 ? x_data[0].derivatives().size() : 0;
+  // The solver passes in the identity gradient (dx/dx) in which case the
+  // gradients of the bindings only have to be scattered into the output
+  bool is_identity = (num_derivatives == x.size());
+  for (int i = 0; is_identity && i < x.size(); ++i) {
+    const auto& derivatives = x_data[i].derivatives();
+    is_identity = derivatives.size() == num_derivatives &&
+                  derivatives(i) == 1 &&
+                  derivatives.head(i).isZero(0) &&
+                  derivatives.tail(num_derivatives - i - 1).isZero(0);
+  }
+
+  y->resize(num_constraints());
+  thread_pool_.ParallelFor(bindings_.size(), [&](int i) {
+    Entry& entry = bindings_[i];
+    const int num_vars = entry.var_indices.size();
+    entry.x.resize(num_vars);
+    for (int j = 0; j < num_vars; ++j) {
+      entry.x(j) = x_data[entry.var_indices[j]].value();
+    }
+    entry.x_ad = drake::math::InitializeAutoDiff(entry.x);
+    entry.constraint->Eval(entry.x_ad, &entry.y_ad);
+    const MatrixXd dy = drake::math::ExtractGradient(entry.y_ad, num_vars);
+
+    MatrixXd dx;
+    if (!is_identity) {
+      dx.resize(num_vars, num_derivatives);
+      for (int j = 0; j < num_vars; ++j) {
+        const auto& derivatives = x_data[entry.var_indices[j]].derivatives();
+        if (derivatives.size() == 0) {
+          dx.row(j).setZero();
+        } else {
+          dx.row(j) = derivatives.transpose();
+        }
+      }
+    }
+    for (int row = 0; row < entry.y_ad.size(); ++row) {
+      auto& y_row = (*y)(entry.row_start + row);
+      y_row.value() = entry.y_ad(row).value();
+      if (is_identity) {
+        y_row.derivatives().setZero(num_derivatives);
+        for (int j = 0; j < num_vars; ++j) {
+          y_row.derivatives()(entry.var_indices[j]) += dy(row, j);
+        }
+      } else {
+        y_row.derivatives() = (dy.row(row) * dx).transpose();
+      }
+    }
+  });
+}
+
+void ConstraintBatch::DoEval(
+    const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+    drake::VectorX<drake::symbolic::Expression>* y) const {
+  throw std::logic_error(
+      "ConstraintBatch does not support symbolic evaluation.");
+}
+
+}  // namespace solvers
+}  // namespace dairlib
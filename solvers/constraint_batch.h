@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/thread_pool.h"
+
+#include "drake/solvers/binding.h"
+#include "drake/solvers/constraint.h"
+
+namespace dairlib {
+namespace solvers {
+
+/// Evaluates a set of constraint bindings in parallel, as a single constraint
+/// on the union of their variables (see variables()). The outputs of the
+/// bindings are stacked in order.
+///
+/// This is meant for the expensive, mutually independent constraints of a
+/// trajectory optimization (e.g. one dynamics constraint per knot point).
+/// Added to a MathematicalProgram as one binding, the solver gets all of them
+/// from a single evaluation, which runs them on a thread pool. The
+/// constraints must be safe to evaluate concurrently, i.e. must not share
+/// mutable state such as a Context.
+///
+/// The gradient sparsity pattern is the union of the patterns of the
+/// bindings (a dense block for bindings without one), so that the solver
+/// only copies the structurally nonzero entries. Note that the AutoDiffXd
+/// gradients that Drake passes in and out are still dense over all of the
+/// batch's variables.
+class ConstraintBatch : public drake::solvers::Constraint {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(ConstraintBatch)
+
+  /// @param bindings the constraints and the variables they are bound to
+  /// @param num_threads threads used for the evaluation (see ThreadPool)
+  ConstraintBatch(
+      const std::vector<drake::solvers::Binding<drake::solvers::Constraint>>&
+          bindings,
+      int num_threads, const std::string& description = "");
+
+  /// The variables this constraint has to be bound to
+  const drake::solvers::VectorXDecisionVariable& variables() const {
+    return variables_;
+  }
+
+  int num_bindings() const { return bindings_.size(); }
+
+  int num_threads() const { return thread_pool_.num_threads(); }
+
+ private:
+  struct Entry {
+    std::shared_ptr<drake::solvers::Constraint> constraint;
+    // Index of each of the binding's variables in variables_
+    std::vector<int> var_indices;
+    int row_start;
+    // Scratch space, so that the entries can be evaluated concurrently
+    Eigen::VectorXd x;
+    Eigen::VectorXd y;
+    drake::AutoDiffVecXd x_ad;
+    drake::AutoDiffVecXd y_ad;
+  };
+
+  void DoEval(const Eigen::Ref<const Eigen::VectorXd>& x,
+              Eigen::VectorXd* y) const override;
+
+  void DoEval(const Eigen::Ref<const drake::AutoDiffVecXd>& x,
+              drake::AutoDiffVecXd* y) const override;
+
+  void DoEval(
+      const Eigen::Ref<const drake::VectorX<drake::symbolic::Variable>>& x,
+      drake::VectorX<drake::symbolic::Expression>* y) const override;
+
+  drake::solvers::VectorXDecisionVariable variables_;
+  mutable std::vector<Entry> bindings_;
+  mutable ThreadPool thread_pool_;
+};
+
+}  // namespace solvers
+}  // namespace dairlib
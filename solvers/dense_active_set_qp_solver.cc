@@ -0,0 +1,351 @@
+#include "solvers/dense_active_set_qp_solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include "drake/common/drake_assert.h"
+
+using drake::solvers::SolutionResult;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace dairlib {
+namespace solvers {
+
+namespace {
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr double kEps = std::numeric_limits<double>::epsilon();
+// Bounds beyond this magnitude are treated as infinite (OSQP_INFTY is 1e30)
+constexpr double kInfiniteBound = 1e20;
+}  // namespace
+
+DenseActiveSetQpSolver::DenseActiveSetQpSolver(int num_vars,
+                                               int num_constraints)
+    : n_(num_vars), m_(num_constraints) {
+  max_iterations_ = 10 * (n_ + m_);
+  H_ = MatrixXd::Zero(n_, n_);
+  At_ = MatrixXd::Zero(n_, m_);
+  lower_ = VectorXd::Zero(m_);
+  upper_ = VectorXd::Zero(m_);
+  is_equality_.assign(m_, false);
+
+  H_llt_ = Eigen::LLT<MatrixXd>(n_);
+  J_ = MatrixXd::Zero(n_, n_);
+  R_ = MatrixXd::Zero(n_, n_);
+  d_ = VectorXd::Zero(n_);
+  z_ = VectorXd::Zero(n_);
+  r_ = VectorXd::Zero(n_);
+  np_ = VectorXd::Zero(n_);
+  x_ = VectorXd::Zero(n_);
+  // One extra slot for the constraint that is being added
+  u_ = VectorXd::Zero(n_ + 1);
+  active_.assign(n_ + 1, 0);
+  Ax_ = VectorXd::Zero(m_);
+  is_active_.assign(2 * m_, false);
+  was_active_.assign(2 * m_, false);
+}
+
+void DenseActiveSetQpSolver::ResetWarmStart() {
+  std::fill(was_active_.begin(), was_active_.end(), false);
+}
+
+double DenseActiveSetQpSolver::ConstraintValue(int k) const {
+  return (k < m_) ? Ax_(k) - lower_(k) : upper_(k - m_) - Ax_(k - m_);
+}
+
+void DenseActiveSetQpSolver::ConstraintNormal(int k, VectorXd* normal) const {
+  if (k < m_) {
+    *normal = At_.col(k);
+  } else {
+    *normal = -At_.col(k - m_);
+  }
+}
+
+bool DenseActiveSetQpSolver::IsInequality(int k) const {
+  const int row = (k < m_) ? k : k - m_;
+  if (is_equality_[row]) return false;
+  return (k < m_) ? lower_(row) > -kInfiniteBound
+                  : upper_(row) < kInfiniteBound;
+}
+
+void DenseActiveSetQpSolver::UpdateStepDirections() {
+  const int q = num_active_;
+  // Primal step in the null space of the active constraints
+  z_.noalias() = J_.rightCols(n_ - q) * d_.tail(n_ - q);
+  // Dual step, r = R⁻¹ d(0:q)
+  r_.head(q) = d_.head(q);
+  R_.topLeftCorner(q, q).triangularView<Eigen::Upper>().solveInPlace(
+      r_.head(q));
+}
+
+bool DenseActiveSetQpSolver::AddConstraint() {
+  const int q = num_active_;
+  // Givens rotations that zero d(q+1:n), applied to the columns of J
+  for (int j = n_ - 1; j > q; --j) {
+    double cc = d_(j - 1);
+    double ss = d_(j);
+    const double h = std::hypot(cc, ss);
+    if (h == 0) continue;
+    d_(j) = 0;
+    ss /= h;
+    cc /= h;
+    if (cc < 0) {
+      cc = -cc;
+      ss = -ss;
+      d_(j - 1) = -h;
+    } else {
+      d_(j - 1) = h;
+    }
+    const double xny = ss / (1 + cc);
+    for (int k = 0; k < n_; ++k) {
+      const double t1 = J_(k, j - 1);
+      const double t2 = J_(k, j);
+      J_(k, j - 1) = t1 * cc + t2 * ss;
+      J_(k, j) = xny * (t1 + J_(k, j - 1)) - t2;
+    }
+  }
+  // The constraint is linearly dependent on the active ones. The rotations
+  // above only act on the null space part of J, so nothing has to be undone.
+  if (std::abs(d_(q)) <= kEps * R_norm_) {
+    return false;
+  }
+  R_.col(q).head(q + 1) = d_.head(q + 1);
+  R_norm_ = std::max(R_norm_, std::abs(d_(q)));
+  num_active_++;
+  return true;
+}
+
+void DenseActiveSetQpSolver::DeleteConstraint(int constraint) {
+  const int q = num_active_;
+  int slot = -1;
+  for (int j = 0; j < q; ++j) {
+    if (active_[j] == constraint) {
+      slot = j;
+      break;
+    }
+  }
+  DRAKE_DEMAND(slot >= 0);
+  is_active_[constraint] = false;
+
+  // Remove the slot. Slot q holds the constraint that is being added.
+  for (int i = slot; i < q - 1; ++i) {
+    active_[i] = active_[i + 1];
+    u_(i) = u_(i + 1);
+    R_.col(i) = R_.col(i + 1);
+  }
+  active_[q - 1] = active_[q];
+  u_(q - 1) = u_(q);
+  active_[q] = 0;
+  u_(q) = 0;
+  R_.col(q - 1).setZero();
+  num_active_--;
+
+  // Restore the triangularity of R, applying the same rotations to J
+  for (int j = slot; j < num_active_; ++j) {
+    double cc = R_(j, j);
+    double ss = R_(j + 1, j);
+    const double h = std::hypot(cc, ss);
+    if (h == 0) continue;
+    cc /= h;
+    ss /= h;
+    R_(j + 1, j) = 0;
+    if (cc < 0) {
+      R_(j, j) = -h;
+      cc = -cc;
+      ss = -ss;
+    } else {
+      R_(j, j) = h;
+    }
+    const double xny = ss / (1 + cc);
+    for (int k = j + 1; k < num_active_; ++k) {
+      const double t1 = R_(j, k);
+      const double t2 = R_(j + 1, k);
+      R_(j, k) = t1 * cc + t2 * ss;
+      R_(j + 1, k) = xny * (t1 + R_(j, k)) - t2;
+    }
+    for (int k = 0; k < n_; ++k) {
+      const double t1 = J_(k, j);
+      const double t2 = J_(k, j + 1);
+      J_(k, j) = t1 * cc + t2 * ss;
+      J_(k, j + 1) = xny * (J_(k, j) + t1) - t2;
+    }
+  }
+}
+
+SolutionResult DenseActiveSetQpSolver::Solve(
+    const Eigen::SparseMatrix<double>& P, const VectorXd& q,
+    const Eigen::SparseMatrix<double>& A, const VectorXd& l,
+    const VectorXd& u, VectorXd* x, Details* details) {
+  const auto start = std::chrono::steady_clock::now();
+  DRAKE_DEMAND(P.rows() == n_ && P.cols() == n_ && q.size() == n_);
+  DRAKE_DEMAND(A.rows() == m_ && A.cols() == n_);
+  DRAKE_DEMAND(l.size() == m_ && u.size() == m_);
+  details->iterations = 0;
+  details->num_active = 0;
+
+  // Densify the problem data
+  H_.setZero();
+  for (int j = 0; j < n_; ++j) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(P, j); it; ++it) {
+      if (it.row() <= j) {
+        H_(it.row(), j) = it.value();
+        H_(j, it.row()) = it.value();
+      }
+    }
+  }
+  H_.diagonal().array() += regularization_;
+  At_.setZero();
+  for (int j = 0; j < n_; ++j) {
+    for (Eigen::SparseMatrix<double>::InnerIterator it(A, j); it; ++it) {
+      At_(j, it.row()) = it.value();
+    }
+  }
+  lower_ = l;
+  upper_ = u;
+  for (int i = 0; i < m_; ++i) {
+    is_equality_[i] = (l(i) == u(i));
+  }
+
+  auto finish = [&](SolutionResult result) {
+    details->num_active = num_active_;
+    details->run_time = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start)
+                            .count();
+    return result;
+  };
+
+  // Unconstrained minimum. With H = LLᵀ, J = L⁻ᵀ.
+  H_llt_.compute(H_);
+  if (H_llt_.info() != Eigen::Success) {
+    return finish(SolutionResult::kInvalidInput);
+  }
+  J_.setIdentity();
+  H_llt_.matrixU().solveInPlace(J_);
+  x_ = -q;
+  H_llt_.solveInPlace(x_);
+  R_.setZero();
+  u_.setZero();
+  num_active_ = 0;
+  R_norm_ = 1;
+  std::fill(is_active_.begin(), is_active_.end(), false);
+
+  // Equality constraints
+  for (int i = 0; i < m_; ++i) {
+    if (!is_equality_[i]) continue;
+    np_ = At_.col(i);
+    d_.noalias() = J_.transpose() * np_;
+    UpdateStepDirections();
+    // Linearly dependent equality constraints are skipped. (The rotations in
+    // AddConstraint() do not change z and r.)
+    const int slot = num_active_;
+    if (!AddConstraint()) continue;
+    const double t = (lower_(i) - np_.dot(x_)) / z_.dot(np_);
+    x_ += t * z_;
+    u_.head(slot) -= t * r_.head(slot);
+    u_(slot) = t;
+    active_[slot] = -1 - i;
+  }
+
+  // Inequality constraints: add the most violated one until all are satisfied
+  for (;;) {
+    Ax_.noalias() = At_.transpose() * x_;
+    int p = -1;
+    double s_min = -feasibility_tol_;
+    int p_warm = -1;
+    double s_min_warm = -feasibility_tol_;
+    for (int k = 0; k < 2 * m_; ++k) {
+      if (is_active_[k] || !IsInequality(k)) continue;
+      const double s = ConstraintValue(k);
+      if (s < s_min) {
+        s_min = s;
+        p = k;
+      }
+      if (was_active_[k] && s < s_min_warm) {
+        s_min_warm = s;
+        p_warm = k;
+      }
+    }
+    if (p_warm >= 0) {
+      p = p_warm;
+    }
+    if (p < 0) break;
+
+    ConstraintNormal(p, &np_);
+    double s_p = ConstraintValue(p);
+    u_(num_active_) = 0;
+    active_[num_active_] = p;
+    for (;;) {
+      if (++details->iterations > max_iterations_) {
+        return finish(SolutionResult::kIterationLimit);
+      }
+      d_.noalias() = J_.transpose() * np_;
+      UpdateStepDirections();
+
+      // Largest step that keeps the multipliers of the active inequality
+      // constraints nonnegative
+      double t1 = kInf;
+      int blocking = -1;
+      for (int j = 0; j < num_active_; ++j) {
+        if (active_[j] >= 0 && r_(j) > 0 && u_(j) / r_(j) < t1) {
+          t1 = u_(j) / r_(j);
+          blocking = active_[j];
+        }
+      }
+      // Step that satisfies constraint p
+      double t2 = kInf;
+      if (z_.squaredNorm() > kEps) {
+        t2 = -s_p / z_.dot(np_);
+      }
+      const double t = std::min(t1, t2);
+      if (t == kInf) {
+        return finish(SolutionResult::kInfeasibleConstraints);
+      }
+
+      if (t2 == kInf) {
+        // Step in the dual space only
+        u_.head(num_active_) -= t * r_.head(num_active_);
+        u_(num_active_) += t;
+        DeleteConstraint(blocking);
+        continue;
+      }
+
+      x_ += t * z_;
+      u_.head(num_active_) -= t * r_.head(num_active_);
+      u_(num_active_) += t;
+      if (t == t2) {
+        // Full step, p is now satisfied with equality
+        if (AddConstraint()) {
+          is_active_[p] = true;
+        } else {
+          u_(num_active_) = 0;
+        }
+        break;
+      }
+      // Partial step, the blocking constraint leaves the active set
+      DeleteConstraint(blocking);
+      s_p = (p < m_) ? At_.col(p).dot(x_) - lower_(p)
+                     : upper_(p - m_) - At_.col(p - m_).dot(x_);
+    }
+  }
+
+  *x = x_;
+  details->y.resize(m_);
+  details->y.setZero();
+  for (int j = 0; j < num_active_; ++j) {
+    const int k = active_[j];
+    if (k < 0) {
+      details->y(-1 - k) -= u_(j);
+    } else if (k < m_) {
+      details->y(k) -= u_(j);
+    } else {
+      details->y(k - m_) += u_(j);
+    }
+  }
+  was_active_ = is_active_;
+  return finish(SolutionResult::kSolutionFound);
+}
+
+}  // namespace solvers
+}  // namespace dairlib
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include "drake/common/drake_copyable.h"
+#include "drake/solvers/solution_result.h"
+
+namespace dairlib {
+namespace solvers {
+
+/**
+ * Dense dual active-set solver (Goldfarb-Idnani) for small strictly convex
+ * QPs, given in the same standard form as FastOsqpSolver::SolveDirect
+ *   min 0.5 xᵀPx + qᵀx
+ *   s.t. l ≤ Ax ≤ u
+ * Rows with l == u are treated as equality constraints, every finite bound of
+ * the other rows as an inequality constraint.
+ *
+ * All storage is allocated in the constructor for the given problem size, so
+ * Solve() does not allocate (except for Details::y, the first time a Details
+ * object is passed in). Unlike ADMM, the solution is exact (up to round
+ * off) and the work per solve is bounded by the number of active set changes.
+ * The solver is warm started from the active set of the previous solve:
+ * violated constraints that were active in the previous solve are added to
+ * the active set before any other constraint.
+ *
+ * P must be positive definite. A small regularization (see
+ * set_hessian_regularization()) is added to its diagonal so that positive
+ * semidefinite Hessians, e.g. unregularized contact forces, can be used.
+ */
+class DenseActiveSetQpSolver {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(DenseActiveSetQpSolver)
+
+  struct Details {
+    /// Number of active set changes
+    int iterations = 0;
+    /// Number of active constraints (including equalities) at the solution
+    int num_active = 0;
+    /// Wall time of Solve() in seconds
+    double run_time = 0;
+    /// Dual solution in OSQP's sign convention, Px + q + Aᵀy = 0
+    Eigen::VectorXd y;
+  };
+
+  DenseActiveSetQpSolver(int num_vars, int num_constraints);
+
+  /// Solves the QP. P is upper triangular (as for OSQP); only its upper
+  /// triangle is read. `x` is written if a solution is found.
+  drake::solvers::SolutionResult Solve(const Eigen::SparseMatrix<double>& P,
+                                       const Eigen::VectorXd& q,
+                                       const Eigen::SparseMatrix<double>& A,
+                                       const Eigen::VectorXd& l,
+                                       const Eigen::VectorXd& u,
+                                       Eigen::VectorXd* x, Details* details);
+
+  /// Forgets the active set of the previous solve
+  void ResetWarmStart();
+
+  void set_hessian_regularization(double value) { regularization_ = value; }
+  void set_feasibility_tolerance(double value) { feasibility_tol_ = value; }
+  void set_max_iterations(int value) { max_iterations_ = value; }
+
+  int num_vars() const { return n_; }
+  int num_constraints() const { return m_; }
+
+ private:
+  // Inequality constraints are indexed by k in [0, 2m): k < m is the lower
+  // bound of row k, n_kᵀx - l_k ≥ 0 with n_k = A_k, and k ≥ m the upper bound
+  // of row k - m, n_kᵀx + u_k ≥ 0 with n_k = -A_k.
+  // Value of constraint k at the point whose Ax is stored in Ax_
+  double ConstraintValue(int k) const;
+  void ConstraintNormal(int k, Eigen::VectorXd* normal) const;
+  // False for the bounds of equality rows and for infinite bounds
+  bool IsInequality(int k) const;
+
+  // Updates of the factorization of the active set, R (upper triangular) and
+  // J (orthogonal up to the Cholesky factor of P), by Givens rotations
+  bool AddConstraint();
+  void DeleteConstraint(int constraint);
+  // Computes the primal step direction z and the dual step direction r for
+  // the constraint with normal np_ (d_ = Jᵀ np_ must be up to date)
+  void UpdateStepDirections();
+
+  int n_;
+  int m_;
+  double regularization_ = 1e-9;
+  double feasibility_tol_ = 1e-9;
+  int max_iterations_;
+
+  // Problem data
+  Eigen::MatrixXd H_;
+  Eigen::MatrixXd At_;  // Aᵀ, so that the constraint normals are columns
+  Eigen::VectorXd lower_;
+  Eigen::VectorXd upper_;
+  std::vector<bool> is_equality_;
+
+  // Solver state
+  Eigen::LLT<Eigen::MatrixXd> H_llt_;
+  Eigen::MatrixXd J_;
+  Eigen::MatrixXd R_;
+  Eigen::VectorXd d_;
+  Eigen::VectorXd z_;
+  Eigen::VectorXd r_;
+  Eigen::VectorXd np_;
+  Eigen::VectorXd x_;
+  Eigen::VectorXd u_;  // multipliers of the active constraints
+  std::vector<int> active_;  // constraint of each active set slot, -1 - row
+                             // for equalities
+  int num_active_ = 0;
+  double R_norm_ = 1;
+  Eigen::VectorXd Ax_;
+  std::vector<bool> is_active_;
+  std::vector<bool> was_active_;  // warm start
+};
+
+}  // namespace solvers
+}  // namespace dairlib
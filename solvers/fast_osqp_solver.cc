@@ -1,5 +1,6 @@
 #include "fast_osqp_solver.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -264,6 +265,17 @@ void UpdateCSCFromEigenSparse(
   }
 }
 
+// Returns the index into the value array of the compressed column major matrix
+// `mat` that stores entry (row, col). The entry must be part of the sparsity
+// pattern of `mat`.
+c_int FindCscSlot(const Eigen::SparseMatrix<c_float>& mat, int row, int col) {
+  const int* begin = mat.innerIndexPtr() + mat.outerIndexPtr()[col];
+  const int* end = mat.innerIndexPtr() + mat.outerIndexPtr()[col + 1];
+  const int* it = std::lower_bound(begin, end, row);
+  DRAKE_DEMAND(it != end && *it == row);
+  return static_cast<c_int>(it - mat.innerIndexPtr());
+}
+
 template <typename T1, typename T2>
 void SetFastOsqpSolverSetting(
     const std::unordered_map<std::string, T1>& options,
@@ -347,6 +359,32 @@ void SetDualSolution(
                                    constraint.evaluator()->num_constraints()));
   }
 }
+
+void CopyOsqpInfo(const OSQPInfo& info, OsqpSolverDetails* solver_details) {
+  solver_details->iter = info.iter;
+  solver_details->status_val = info.status_val;
+  solver_details->primal_res = info.pri_res;
+  solver_details->dual_res = info.dua_res;
+  solver_details->setup_time = info.setup_time;
+  solver_details->solve_time = info.solve_time;
+  solver_details->polish_time = info.polish_time;
+  solver_details->run_time = info.run_time;
+}
+
+// Same as SetDualSolution, but relies on the constraints being stacked in A in
+// the order in which they are visited, so no constraint_start_row map is
+// needed. `row` is advanced past the visited constraints.
+template <typename C>
+void SetDualSolutionInOrder(const std::vector<Binding<C>>& constraints,
+                            const Eigen::VectorXd& all_dual_solution, int* row,
+                            MathematicalProgramResult* result) {
+  for (const auto& constraint : constraints) {
+    const int num_rows = constraint.evaluator()->num_constraints();
+    result->set_dual_solution(constraint,
+                              -all_dual_solution.segment(*row, num_rows));
+    *row += num_rows;
+  }
+}
 }  // namespace
 
 bool FastOsqpSolver::is_available() { return true; }
@@ -371,14 +409,63 @@ void FastOsqpSolver::InitializeSolver(const MathematicalProgram& prog,
   P_csc_ = EigenSparseToCSC(P_sparse_);
   A_csc_ = EigenSparseToCSC(A_sparse_);
 
+  SetupWorkspace(prog.num_vars(), A_sparse_.rows(), solver_options);
+
+  const auto& options_int = solver_options.GetOptionsInt(OsqpSolver::id());
+  const auto structured_update_option = options_int.find("structured_update");
+  structured_update_ = structured_update_option != options_int.end() &&
+                       structured_update_option->second != 0;
+  if (structured_update_ && !prog.GetVariableScaling().empty()) {
+    drake::log()->warn(
+        "FastOsqpSolver: structured_update is not supported with variable "
+        "scaling, falling back to reparsing the program on every solve.");
+    structured_update_ = false;
+  }
+  if (structured_update_) {
+    RecordStructuredUpdateMap(prog);
+  }
+
+  is_init_ = true;
+}
+
+void FastOsqpSolver::InitializeSolver(const Eigen::SparseMatrix<c_float>& P,
+                                      const Eigen::VectorXd& q,
+                                      const Eigen::SparseMatrix<c_float>& A,
+                                      const Eigen::VectorXd& l,
+                                      const Eigen::VectorXd& u,
+                                      const SolverOptions& solver_options) {
+  DRAKE_DEMAND(P.isCompressed() && A.isCompressed());
+  DRAKE_DEMAND(P.rows() == P.cols() && A.cols() == P.cols());
+  DRAKE_DEMAND(q.size() == P.rows());
+  DRAKE_DEMAND(l.size() == A.rows() && u.size() == A.rows());
+
+  q_.resize(q.size());
+  l_.resize(l.size());
+  u_.resize(u.size());
+  for (int i = 0; i < q.size(); ++i) {
+    q_[i] = q(i);
+  }
+  for (int i = 0; i < l.size(); ++i) {
+    l_[i] = ConvertInfinity(l(i));
+    u_[i] = ConvertInfinity(u(i));
+  }
+  P_csc_ = EigenSparseToCSC(P);
+  A_csc_ = EigenSparseToCSC(A);
+
+  SetupWorkspace(P.rows(), A.rows(), solver_options);
+  is_init_ = true;
+}
+
+void FastOsqpSolver::SetupWorkspace(int num_vars, int num_constraints,
+                                    const SolverOptions& solver_options) {
   // Now pass the constraint and cost to osqp data.
   osqp_data_ = nullptr;
 
   // Populate data.
   osqp_data_ = static_cast<OSQPData*>(c_malloc(sizeof(OSQPData)));
 
-  osqp_data_->n = prog.num_vars();
-  osqp_data_->m = A_sparse_.rows();
+  osqp_data_->n = num_vars;
+  osqp_data_->m = num_constraints;
   osqp_data_->P = P_csc_;
   osqp_data_->q = q_.data();
   osqp_data_->A = A_csc_;
@@ -389,14 +476,19 @@ void FastOsqpSolver::InitializeSolver(const MathematicalProgram& prog,
   osqp_set_default_settings(osqp_settings_);
   SetFastOsqpSolverSettings(solver_options, osqp_settings_);
 
+  const auto& options_int = solver_options.GetOptionsInt(OsqpSolver::id());
+  const auto warm_start_bank_option = options_int.find("warm_start_bank");
+  warm_start_bank_ = warm_start_bank_option != options_int.end() &&
+                     warm_start_bank_option->second != 0;
+  // Stored solutions of a previous problem might have the wrong size
+  warm_start_bank_entries_.clear();
+
   // Setup workspace.
   workspace_ = nullptr;
   const c_int osqp_setup_err =
       osqp_setup(&workspace_, osqp_data_, osqp_settings_);
   DRAKE_DEMAND(osqp_setup_err == 0);
   const c_int osqp_solve_err = osqp_solve(workspace_);
-
-  is_init_ = true;
 }
 
 void FastOsqpSolver::WarmStart(const Eigen::VectorXd& primal,
@@ -413,6 +505,256 @@ void FastOsqpSolver::WarmStart(const Eigen::VectorXd& primal,
   osqp_warm_start(workspace_, x.data(), y.data());
 }
 
+void FastOsqpSolver::GetWarmStart(Eigen::VectorXd* primal,
+                                  Eigen::VectorXd* dual) const {
+  DRAKE_THROW_UNLESS(workspace_ != nullptr);
+  const int n = workspace_->data->n;
+  const int m = workspace_->data->m;
+  if (!warm_start_) {
+    primal->setZero(n);
+    dual->setZero(m);
+    return;
+  }
+  // The iterates are stored scaled, undo osqp_warm_start's scaling
+  *primal = Eigen::Map<Eigen::VectorXd>(workspace_->x, n);
+  *dual = Eigen::Map<Eigen::VectorXd>(workspace_->y, m);
+  if (osqp_settings_->scaling && workspace_->scaling != OSQP_NULL) {
+    primal->array() *=
+        Eigen::Map<Eigen::ArrayXd>(workspace_->scaling->D, n);
+    dual->array() *= Eigen::Map<Eigen::ArrayXd>(workspace_->scaling->E, m) *
+                     workspace_->scaling->cinv;
+  }
+}
+
+void FastOsqpSolver::SetWarmStartKey(int key) const {
+  if (key == warm_start_key_) {
+    return;
+  }
+  warm_start_key_ = key;
+  warm_start_key_switched_ = true;
+  if (!warm_start_bank_ || !warm_start_ || workspace_ == nullptr) {
+    return;
+  }
+  const auto entry = warm_start_bank_entries_.find(key);
+  if (entry != warm_start_bank_entries_.end()) {
+    osqp_warm_start(workspace_, entry->second.x.data(),
+                    entry->second.y.data());
+  }
+}
+
+void FastOsqpSolver::RecordWarmStart(const OSQPInfo& info) const {
+  auto& statistics = warm_start_statistics_[warm_start_key_];
+  statistics.num_solves++;
+  statistics.total_iterations += info.iter;
+  statistics.max_iterations =
+      std::max(statistics.max_iterations, static_cast<int>(info.iter));
+  if (warm_start_key_switched_) {
+    statistics.num_switch_solves++;
+    statistics.switch_iterations += info.iter;
+    warm_start_key_switched_ = false;
+  }
+
+  if (warm_start_bank_ && (info.status_val == OSQP_SOLVED ||
+                           info.status_val == OSQP_SOLVED_INACCURATE)) {
+    auto& entry = warm_start_bank_entries_[warm_start_key_];
+    const OSQPSolution& solution = *workspace_->solution;
+    entry.x.assign(solution.x, solution.x + workspace_->data->n);
+    entry.y.assign(solution.y, solution.y + workspace_->data->m);
+  }
+}
+
+void FastOsqpSolver::RecordStructuredUpdateMap(
+    const MathematicalProgram& prog) {
+  num_quadratic_costs_ = prog.quadratic_costs().size();
+  num_linear_costs_ = prog.linear_costs().size();
+  num_linear_constraints_ = prog.linear_constraints().size();
+  num_linear_equality_constraints_ = prog.linear_equality_constraints().size();
+  num_bounding_box_constraints_ = prog.bounding_box_constraints().size();
+
+  quadratic_cost_vars_.clear();
+  P_slots_.clear();
+  for (const auto& quadratic_cost : prog.quadratic_costs()) {
+    const std::vector<int> x_indices =
+        prog.FindDecisionVariableIndices(quadratic_cost.variables());
+    quadratic_cost_vars_.insert(quadratic_cost_vars_.end(), x_indices.begin(),
+                                x_indices.end());
+    // Same upper triangular traversal as ParseQuadraticCosts
+    const int n = x_indices.size();
+    for (int col = 0; col < n; ++col) {
+      for (int row = 0; row <= col; ++row) {
+        P_slots_.push_back(
+            FindCscSlot(P_sparse_, x_indices[row], x_indices[col]));
+      }
+    }
+  }
+
+  linear_cost_vars_.clear();
+  for (const auto& linear_cost : prog.linear_costs()) {
+    const std::vector<int> x_indices =
+        prog.FindDecisionVariableIndices(linear_cost.variables());
+    linear_cost_vars_.insert(linear_cost_vars_.end(), x_indices.begin(),
+                             x_indices.end());
+  }
+
+  // Linear constraints are stacked in the same order as in
+  // ParseAllLinearConstraints. The dense A of every binding is part of the
+  // sparsity pattern (including explicit zeros), so every entry gets a slot.
+  A_slots_.clear();
+  int num_A_rows = 0;
+  auto record_linear_constraints = [&](const auto& constraints) {
+    for (const auto& constraint : constraints) {
+      const std::vector<int> x_indices =
+          prog.FindDecisionVariableIndices(constraint.variables());
+      const Eigen::MatrixXd& A = constraint.evaluator()->GetDenseA();
+      for (int col = 0; col < A.cols(); ++col) {
+        for (int row = 0; row < A.rows(); ++row) {
+          A_slots_.push_back(
+              FindCscSlot(A_sparse_, num_A_rows + row, x_indices[col]));
+        }
+      }
+      num_A_rows += constraint.evaluator()->num_constraints();
+    }
+  };
+  record_linear_constraints(prog.linear_constraints());
+  record_linear_constraints(prog.linear_equality_constraints());
+  for (const auto& constraint : prog.bounding_box_constraints()) {
+    const std::vector<int> x_indices =
+        prog.FindDecisionVariableIndices(constraint.variables());
+    for (int i = 0; i < static_cast<int>(x_indices.size()); ++i) {
+      A_slots_.push_back(FindCscSlot(A_sparse_, num_A_rows + i, x_indices[i]));
+    }
+    num_A_rows += constraint.evaluator()->num_constraints();
+  }
+}
+
+void FastOsqpSolver::ScatterCoefficients(const MathematicalProgram& prog,
+                                         double* constant_cost_term) const {
+  DRAKE_DEMAND(static_cast<int>(prog.quadratic_costs().size()) ==
+                   num_quadratic_costs_ &&
+               static_cast<int>(prog.linear_costs().size()) ==
+                   num_linear_costs_ &&
+               static_cast<int>(prog.linear_constraints().size()) ==
+                   num_linear_constraints_ &&
+               static_cast<int>(prog.linear_equality_constraints().size()) ==
+                   num_linear_equality_constraints_ &&
+               static_cast<int>(prog.bounding_box_constraints().size()) ==
+                   num_bounding_box_constraints_);
+
+  std::fill(q_.begin(), q_.end(), 0);
+  std::fill(P_csc_->x, P_csc_->x + P_csc_->nzmax, 0);
+  std::fill(A_csc_->x, A_csc_->x + A_csc_->nzmax, 0);
+
+  // Costs. Several bindings may share entries of P and q, so accumulate.
+  const int* var = quadratic_cost_vars_.data();
+  const c_int* P_slot = P_slots_.data();
+  for (const auto& quadratic_cost : prog.quadratic_costs()) {
+    const Eigen::MatrixXd& Q = quadratic_cost.evaluator()->Q();
+    const Eigen::VectorXd& b = quadratic_cost.evaluator()->b();
+    for (int col = 0; col < Q.cols(); ++col) {
+      for (int row = 0; row <= col; ++row) {
+        P_csc_->x[*P_slot++] += Q(row, col);
+      }
+    }
+    for (int i = 0; i < b.size(); ++i) {
+      q_[*var++] += b(i);
+    }
+    *constant_cost_term += quadratic_cost.evaluator()->c();
+  }
+  var = linear_cost_vars_.data();
+  for (const auto& linear_cost : prog.linear_costs()) {
+    const Eigen::VectorXd& a = linear_cost.evaluator()->a();
+    for (int i = 0; i < a.size(); ++i) {
+      q_[*var++] += a(i);
+    }
+    *constant_cost_term += linear_cost.evaluator()->b();
+  }
+
+  // Constraints
+  const c_int* A_slot = A_slots_.data();
+  int row_start = 0;
+  auto scatter_linear_constraints = [&](const auto& constraints) {
+    for (const auto& constraint : constraints) {
+      const Eigen::MatrixXd& A = constraint.evaluator()->GetDenseA();
+      for (int col = 0; col < A.cols(); ++col) {
+        for (int row = 0; row < A.rows(); ++row) {
+          A_csc_->x[*A_slot++] += A(row, col);
+        }
+      }
+      const int num_rows = constraint.evaluator()->num_constraints();
+      for (int i = 0; i < num_rows; ++i) {
+        l_[row_start + i] =
+            ConvertInfinity(constraint.evaluator()->lower_bound()(i));
+        u_[row_start + i] =
+            ConvertInfinity(constraint.evaluator()->upper_bound()(i));
+      }
+      row_start += num_rows;
+    }
+  };
+  scatter_linear_constraints(prog.linear_constraints());
+  scatter_linear_constraints(prog.linear_equality_constraints());
+
+  // Bounding box constraints contribute an identity block to A
+  for (const auto& constraint : prog.bounding_box_constraints()) {
+    const int num_rows = constraint.evaluator()->num_constraints();
+    for (int i = 0; i < num_rows; ++i) {
+      A_csc_->x[*A_slot++] += 1;
+      l_[row_start + i] =
+          ConvertInfinity(constraint.evaluator()->lower_bound()(i));
+      u_[row_start + i] =
+          ConvertInfinity(constraint.evaluator()->upper_bound()(i));
+    }
+    row_start += num_rows;
+  }
+}
+
+SolutionResult FastOsqpSolver::SolveDirect(
+    const Eigen::SparseMatrix<c_float>& P, const Eigen::VectorXd& q,
+    const Eigen::SparseMatrix<c_float>& A, const Eigen::VectorXd& l,
+    const Eigen::VectorXd& u, Eigen::VectorXd* x, Details* details) const {
+  DRAKE_THROW_UNLESS(workspace_ != nullptr);
+  DRAKE_DEMAND(P.nonZeros() == P_csc_->nzmax && A.nonZeros() == A_csc_->nzmax);
+  for (int i = 0; i < q.size(); ++i) {
+    q_[i] = q(i);
+  }
+  for (int i = 0; i < l.size(); ++i) {
+    l_[i] = ConvertInfinity(l(i));
+    u_[i] = ConvertInfinity(u(i));
+  }
+  osqp_update_lin_cost(workspace_, q_.data());
+  osqp_update_bounds(workspace_, l_.data(), u_.data());
+  osqp_update_P_A(workspace_, P.valuePtr(), OSQP_NULL, P.nonZeros(),
+                  A.valuePtr(), OSQP_NULL, A.nonZeros());
+
+  if (osqp_solve(workspace_) != 0) {
+    return SolutionResult::kInvalidInput;
+  }
+  DRAKE_THROW_UNLESS(workspace_->info != nullptr);
+  CopyOsqpInfo(*workspace_->info, details);
+  RecordWarmStart(*workspace_->info);
+
+  switch (workspace_->info->status_val) {
+    case OSQP_SOLVED:
+      this->EnableWarmStart();
+    case OSQP_SOLVED_INACCURATE: {
+      *x = Eigen::Map<Eigen::VectorXd>(workspace_->solution->x,
+                                       workspace_->data->n);
+      details->y = Eigen::Map<Eigen::VectorXd>(workspace_->solution->y,
+                                               workspace_->data->m);
+      return SolutionResult::kSolutionFound;
+    }
+    case OSQP_PRIMAL_INFEASIBLE:
+    case OSQP_PRIMAL_INFEASIBLE_INACCURATE:
+      return SolutionResult::kInfeasibleConstraints;
+    case OSQP_DUAL_INFEASIBLE:
+    case OSQP_DUAL_INFEASIBLE_INACCURATE:
+      return SolutionResult::kDualInfeasible;
+    case OSQP_MAX_ITER_REACHED:
+      return SolutionResult::kIterationLimit;
+    default:
+      return SolutionResult::kUnknownError;
+  }
+}
+
 void FastOsqpSolver::DoSolve(const MathematicalProgram& prog,
                              const Eigen::VectorXd& initial_guess,
                              const SolverOptions& merged_options,
@@ -425,26 +767,31 @@ void FastOsqpSolver::DoSolve(const MathematicalProgram& prog,
   // s.t l ≤ Ax ≤ u
   // OSQP is written in C, so this function will be in C style.
 
-  // clear the vectors for cost and constraint bounds
-  std::fill(q_.begin(), q_.end(), 0);
-  l_.clear();
-  u_.clear();
-
   double constant_cost_term{0};
 
-  ParseQuadraticCosts(prog, P_triplets_, &P_sparse_, &q_, &constant_cost_term);
-  ParseLinearCosts(prog, &q_, &constant_cost_term);
-
   // linear_constraint_start_row[binding] stores the starting row index in A
   // corresponding to the linear constraint `binding`.
   std::unordered_map<Binding<Constraint>, int> constraint_start_row;
 
-  // Parse the linear constraints.
-  ParseAllLinearConstraints(
-      prog, A_triplets_, &A_sparse_, &l_, &u_, &constraint_start_row);
+  if (structured_update_) {
+    ScatterCoefficients(prog, &constant_cost_term);
+  } else {
+    // clear the vectors for cost and constraint bounds
+    std::fill(q_.begin(), q_.end(), 0);
+    l_.clear();
+    u_.clear();
+
+    ParseQuadraticCosts(prog, P_triplets_, &P_sparse_, &q_,
+                        &constant_cost_term);
+    ParseLinearCosts(prog, &q_, &constant_cost_term);
+
+    // Parse the linear constraints.
+    ParseAllLinearConstraints(prog, A_triplets_, &A_sparse_, &l_, &u_,
+                              &constraint_start_row);
 
-  UpdateCSCFromEigenSparse(P_sparse_, P_csc_);
-  UpdateCSCFromEigenSparse(A_sparse_, A_csc_);
+    UpdateCSCFromEigenSparse(P_sparse_, P_csc_);
+    UpdateCSCFromEigenSparse(A_sparse_, A_csc_);
+  }
 
   osqp_update_lin_cost(workspace_, q_.data());
   osqp_update_bounds(workspace_, l_.data(), u_.data());
@@ -467,14 +814,8 @@ void FastOsqpSolver::DoSolve(const MathematicalProgram& prog,
   if (!solution_result) {
     DRAKE_THROW_UNLESS(workspace_->info != nullptr);
 
-    solver_details.iter = workspace_->info->iter;
-    solver_details.status_val = workspace_->info->status_val;
-    solver_details.primal_res = workspace_->info->pri_res;
-    solver_details.dual_res = workspace_->info->dua_res;
-    solver_details.setup_time = workspace_->info->setup_time;
-    solver_details.solve_time = workspace_->info->solve_time;
-    solver_details.polish_time = workspace_->info->polish_time;
-    solver_details.run_time = workspace_->info->run_time;
+    CopyOsqpInfo(*workspace_->info, &solver_details);
+    RecordWarmStart(*workspace_->info);
 
     switch (workspace_->info->status_val) {
       case OSQP_SOLVED:
@@ -500,12 +841,22 @@ void FastOsqpSolver::DoSolve(const MathematicalProgram& prog,
         solver_details.y = Eigen::Map<Eigen::VectorXd>(workspace_->solution->y,
                                                        workspace_->data->m);
         solution_result = SolutionResult::kSolutionFound;
-        SetDualSolution(prog.linear_constraints(), solver_details.y,
-                        constraint_start_row, result);
-        SetDualSolution(prog.linear_equality_constraints(), solver_details.y,
-                        constraint_start_row, result);
-        SetDualSolution(prog.bounding_box_constraints(), solver_details.y,
-                        constraint_start_row, result);
+        if (structured_update_) {
+          int row = 0;
+          SetDualSolutionInOrder(prog.linear_constraints(), solver_details.y,
+                                 &row, result);
+          SetDualSolutionInOrder(prog.linear_equality_constraints(),
+                                 solver_details.y, &row, result);
+          SetDualSolutionInOrder(prog.bounding_box_constraints(),
+                                 solver_details.y, &row, result);
+        } else {
+          SetDualSolution(prog.linear_constraints(), solver_details.y,
+                          constraint_start_row, result);
+          SetDualSolution(prog.linear_equality_constraints(), solver_details.y,
+                          constraint_start_row, result);
+          SetDualSolution(prog.bounding_box_constraints(), solver_details.y,
+                          constraint_start_row, result);
+        }
 
         break;
       }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <map>
+#include <vector>
+
 #include <osqp.h>
 
 #include "drake/common/drake_copyable.h"
@@ -64,6 +67,27 @@ class FastOsqpSolver final : public drake::solvers::SolverBase {
   void InitializeSolver(const drake::solvers::MathematicalProgram&,
                         const drake::solvers::SolverOptions&);
 
+  /// Sets up the solver for a QP given directly in OSQP's standard form
+  ///   min 0.5 xᵀPx + qᵀx
+  ///   s.t. l ≤ Ax ≤ u
+  /// bypassing MathematicalProgram. P must be upper triangular and both P and
+  /// A compressed. Their sparsity patterns are fixed after this call.
+  void InitializeSolver(const Eigen::SparseMatrix<c_float>& P,
+                        const Eigen::VectorXd& q,
+                        const Eigen::SparseMatrix<c_float>& A,
+                        const Eigen::VectorXd& l, const Eigen::VectorXd& u,
+                        const drake::solvers::SolverOptions&);
+
+  /// Solves the QP set up by the matrix form of InitializeSolver with new
+  /// values of P, q, A, l and u. P and A must have the sparsity patterns
+  /// given to InitializeSolver. The primal solution is written to `x` when a
+  /// (possibly inaccurate) solution is found, and the solver statistics and
+  /// dual solution are written to `details`.
+  drake::solvers::SolutionResult SolveDirect(
+      const Eigen::SparseMatrix<c_float>& P, const Eigen::VectorXd& q,
+      const Eigen::SparseMatrix<c_float>& A, const Eigen::VectorXd& l,
+      const Eigen::VectorXd& u, Eigen::VectorXd* x, Details* details) const;
+
   /// Solver will automatically reenable warm starting after a successful solve
   void DisableWarmStart() const {
     osqp_settings_->warm_start = false;
@@ -77,9 +101,44 @@ class FastOsqpSolver final : public drake::solvers::SolverBase {
   }
 
   void WarmStart(const Eigen::VectorXd& primal, const Eigen::VectorXd& dual);
+  /// Writes the (unscaled) primal and dual point the next solve starts from,
+  /// i.e. the values to pass to WarmStart() to reproduce it. Zero when warm
+  /// starting is disabled.
+  void GetWarmStart(Eigen::VectorXd* primal, Eigen::VectorXd* dual) const;
+
+  /// Statistics of the solves done under one warm start key. A solve is a
+  /// switch solve if it is the first one after the key changed.
+  struct WarmStartStatistics {
+    int num_solves = 0;
+    int64_t total_iterations = 0;
+    int max_iterations = 0;
+    int num_switch_solves = 0;
+    int64_t switch_iterations = 0;
+  };
+
+  /// Sets the key (e.g. a contact mode) under which the following solves are
+  /// recorded. When the warm start bank is enabled (integer solver option
+  /// "warm_start_bank"), the primal and dual solution of every successful
+  /// solve is stored under the current key, and changing the key warm starts
+  /// the next solve from the solution last stored under the new key instead
+  /// of the previous solve. Iteration statistics are recorded per key
+  /// whether or not the bank is enabled.
+  void SetWarmStartKey(int key) const;
+
+  bool IsWarmStartBankEnabled() const { return warm_start_bank_; }
+
+  const std::map<int, WarmStartStatistics>& warm_start_statistics() const {
+    return warm_start_statistics_;
+  }
+  void ClearWarmStartStatistics() const { warm_start_statistics_.clear(); }
 
   bool IsInitialized() const { return is_init_; }
 
+  /// True if DoSolve scatters the program coefficients into the sparsity
+  /// pattern recorded by InitializeSolver instead of reparsing the program.
+  /// Enabled with the integer solver option "structured_update".
+  bool IsStructuredUpdateEnabled() const { return structured_update_; }
+
   // A using-declaration adds these methods into our class's Doxygen.
   using SolverBase::Solve;
 
@@ -88,6 +147,24 @@ class FastOsqpSolver final : public drake::solvers::SolverBase {
                const Eigen::VectorXd&, const drake::solvers::SolverOptions&,
                drake::solvers::MathematicalProgramResult*) const final;
 
+  // Allocates the OSQP data and settings for the P_csc_, A_csc_, q_, l_ and
+  // u_ members, and sets up the workspace.
+  void SetupWorkspace(int num_vars, int num_constraints,
+                      const drake::solvers::SolverOptions&);
+
+  // Updates the statistics of the current warm start key and, when the bank
+  // is enabled, stores the solution of a successful solve under that key.
+  void RecordWarmStart(const OSQPInfo& info) const;
+
+  // Records, for every cost and constraint binding in prog, the slots of its
+  // coefficients in P_csc_->x, A_csc_->x, q_, l_ and u_. Must be called after
+  // P_sparse_ and A_sparse_ have been assembled.
+  void RecordStructuredUpdateMap(const drake::solvers::MathematicalProgram&);
+  // Copies the current coefficients of prog into the OSQP data using the map
+  // recorded by RecordStructuredUpdateMap. Does not allocate.
+  void ScatterCoefficients(const drake::solvers::MathematicalProgram&,
+                           double* constant_cost_term) const;
+
   OSQPData* osqp_data_;
   mutable csc* P_csc_ = nullptr;
   mutable csc* A_csc_ = nullptr;
@@ -99,9 +176,34 @@ class FastOsqpSolver final : public drake::solvers::SolverBase {
   mutable std::vector<Eigen::Triplet<c_float>> P_triplets_;
   mutable std::vector<Eigen::Triplet<c_float>> A_triplets_;
 
+  // Structured update map. The slots are stored in the same order in which
+  // the bindings (and the entries of each binding) are visited during the
+  // scatter, so no per-binding lookup is needed.
+  bool structured_update_ = false;
+  int num_quadratic_costs_ = 0;
+  int num_linear_costs_ = 0;
+  int num_linear_constraints_ = 0;
+  int num_linear_equality_constraints_ = 0;
+  int num_bounding_box_constraints_ = 0;
+  std::vector<int> quadratic_cost_vars_;
+  std::vector<int> linear_cost_vars_;
+  std::vector<c_int> P_slots_;
+  std::vector<c_int> A_slots_;
+
   mutable OSQPSettings* osqp_settings_;
   mutable OSQPWorkspace* workspace_;
   mutable bool warm_start_ = true;
+
+  // Warm start bank, see SetWarmStartKey()
+  struct WarmStartEntry {
+    std::vector<c_float> x;
+    std::vector<c_float> y;
+  };
+  bool warm_start_bank_ = false;
+  mutable std::map<int, WarmStartEntry> warm_start_bank_entries_;
+  mutable std::map<int, WarmStartStatistics> warm_start_statistics_;
+  mutable int warm_start_key_ = 0;
+  mutable bool warm_start_key_switched_ = false;
   mutable bool is_init_ = false;
 };
 }  // namespace solvers
@@ -1,6 +1,11 @@
 #include "solvers/nonlinear_constraint.h"
 
+#include <algorithm>
+#include <cmath>
+#include <random>
+
 #include "drake/common/default_scalars.h"
+#include "drake/common/drake_assert.h"
 #include "drake/math/autodiff.h"
 #include "drake/math/autodiff_gradient.h"
 
@@ -13,6 +18,47 @@ using drake::VectorX;
 using Eigen::MatrixXd;
 using Eigen::VectorXd;
 
+namespace {
+
+// Forward differences of evaluate(x, &y) around x, given y0 at x, one
+// variable at a time
+template <typename F>
+void DenseForwardDifferences(const F& evaluate, double eps, VectorXd* x,
+                             const VectorXd& y0, MatrixXd* dy) {
+  VectorXd yi;
+  dy->resize(y0.size(), x->size());
+  for (int i = 0; i < x->size(); i++) {
+    (*x)(i) += eps;
+    evaluate(*x, &yi);
+    (*x)(i) -= eps;
+    dy->col(i) = (yi - y0) / eps;
+  }
+}
+
+// Forward differences perturbing each group of structurally independent
+// variables at once
+template <typename F>
+void ColoredForwardDifferences(
+    const F& evaluate, double eps,
+    const std::vector<std::vector<int>>& colors,
+    const std::vector<std::vector<int>>& column_rows, VectorXd* x,
+    const VectorXd& y0, MatrixXd* dy) {
+  VectorXd yi;
+  dy->setZero(y0.size(), x->size());
+  for (const auto& color : colors) {
+    for (int j : color) (*x)(j) += eps;
+    evaluate(*x, &yi);
+    for (int j : color) {
+      (*x)(j) -= eps;
+      for (int row : column_rows[j]) {
+        (*dy)(row, j) = (yi(row) - y0(row)) / eps;
+      }
+    }
+  }
+}
+
+}  // namespace
+
 template <typename T>
 NonlinearConstraint<T>::NonlinearConstraint(int num_constraints, int num_vars,
                                             const VectorXd& lb,
@@ -27,6 +73,60 @@ void NonlinearConstraint<T>::SetConstraintScaling(
   constraint_scaling_ = map;
 }
 
+template <typename T>
+void NonlinearConstraint<T>::SetJacobianSparsityPattern(
+    const std::vector<std::pair<int, int>>& pattern) {
+  std::vector<std::vector<int>> column_rows(this->num_vars());
+  for (const auto& [row, col] : pattern) {
+    DRAKE_DEMAND(row >= 0 && row < this->num_outputs());
+    DRAKE_DEMAND(col >= 0 && col < this->num_vars());
+    column_rows[col].push_back(row);
+  }
+  UpdateColoring(column_rows);
+  this->SetGradientSparsityPattern(pattern);
+}
+
+template <typename T>
+void NonlinearConstraint<T>::DetectJacobianSparsityPattern() {
+  detect_sparsity_ = true;
+}
+
+template <typename T>
+int NonlinearConstraint<T>::num_gradient_evaluations() const {
+  return column_rows_.empty() ? this->num_vars() : colors_.size();
+}
+
+template <typename T>
+void NonlinearConstraint<T>::UpdateColoring(
+    std::vector<std::vector<int>> column_rows) const {
+  column_rows_ = std::move(column_rows);
+  colors_.clear();
+  // Rows already used by each color
+  std::vector<std::vector<bool>> color_rows;
+  for (int j = 0; j < static_cast<int>(column_rows_.size()); j++) {
+    auto& rows = column_rows_[j];
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    // Independent variables do not need to be perturbed
+    if (rows.empty()) continue;
+    int color = 0;
+    for (; color < static_cast<int>(colors_.size()); color++) {
+      if (std::none_of(rows.begin(), rows.end(),
+                       [&](int row) { return color_rows[color][row]; })) {
+        break;
+      }
+    }
+    if (color == static_cast<int>(colors_.size())) {
+      colors_.emplace_back();
+      color_rows.emplace_back(this->num_outputs(), false);
+    }
+    colors_[color].push_back(j);
+    for (int row : rows) {
+      color_rows[color][row] = true;
+    }
+  }
+}
+
 template <typename T>
 template <typename U>
 void NonlinearConstraint<T>::ScaleConstraint(VectorX<U>* y) const {
@@ -71,17 +171,63 @@ void NonlinearConstraint<double>::DoEval(
     const Eigen::Ref<const AutoDiffVecXd>& x, AutoDiffVecXd* y) const {
   MatrixXd original_grad = drake::math::ExtractGradient(x);
 
-  // forward differencing
   VectorXd x_val = drake::math::ExtractValue(x);
-  VectorXd y0, yi;
+  VectorXd y0;
+  MatrixXd dy;
+  if (EvaluateConstraintWithGradient(x_val, &y0, &dy)) {
+    if (original_grad.isIdentity(1e-16)) {
+      *y = drake::math::InitializeAutoDiff(y0, dy);
+    } else {
+      *y = drake::math::InitializeAutoDiff(y0, dy * original_grad);
+    }
+    this->ScaleConstraint<AutoDiffXd>(y);
+    return;
+  }
+
+  // forward differencing
   EvaluateConstraint(x_val, &y0);
 
-  MatrixXd dy = MatrixXd(y0.size(), x_val.size());
-  for (int i = 0; i < x_val.size(); i++) {
-    x_val(i) += eps_;
-    EvaluateConstraint(x_val, &yi);
-    x_val(i) -= eps_;
-    dy.col(i) = (yi - y0) / eps_;
+  auto evaluate = [this](const VectorXd& x_i, VectorXd* y_i) {
+    EvaluateConstraint(x_i, y_i);
+  };
+  bool dy_done = false;
+  if (detect_sparsity_) {
+    std::call_once(sparsity_detected_, [&]() {
+      DenseForwardDifferences(evaluate, eps_, &x_val, y0, &dy);
+      dy_done = true;
+
+      // Probe again at a random nearby point, so that entries which only
+      // happen to be zero at x (e.g. with zero contact forces) are kept
+      std::mt19937 generator(0);
+      std::uniform_real_distribution<double> distribution(-1, 1);
+      VectorXd x_probe = x_val;
+      for (int i = 0; i < x_probe.size(); i++) {
+        x_probe(i) += 1e-2 * (1 + std::abs(x_probe(i))) *
+                      distribution(generator);
+      }
+      VectorXd y_probe;
+      MatrixXd dy_probe;
+      EvaluateConstraint(x_probe, &y_probe);
+      DenseForwardDifferences(evaluate, eps_, &x_probe, y_probe, &dy_probe);
+
+      std::vector<std::vector<int>> column_rows(x_val.size());
+      for (int j = 0; j < dy.cols(); j++) {
+        for (int i = 0; i < dy.rows(); i++) {
+          if (dy(i, j) != 0 || dy_probe(i, j) != 0) {
+            column_rows[j].push_back(i);
+          }
+        }
+      }
+      UpdateColoring(std::move(column_rows));
+    });
+  }
+  if (!dy_done) {
+    if (column_rows_.empty()) {
+      DenseForwardDifferences(evaluate, eps_, &x_val, y0, &dy);
+    } else {
+      ColoredForwardDifferences(evaluate, eps_, colors_, column_rows_, &x_val,
+                                y0, &dy);
+    }
   }
 
   // Profiling identified dy * original_grad as a significant runtime event,
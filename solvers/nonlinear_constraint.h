@@ -1,7 +1,11 @@
 #pragma once
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "drake/common/symbolic/expression.h"
 #include "drake/solvers/constraint.h"
 
@@ -38,14 +42,61 @@ class NonlinearConstraint : public drake::solvers::Constraint {
 
   void SetConstraintScaling(const std::unordered_map<int, double>& map);
 
+  /// Declares the entries of the Jacobian dy/dx that can be nonzero, as
+  /// (row, column) pairs, and passes the pattern on to the solver.
+  ///
+  /// With a pattern, the numerical gradient of NonlinearConstraint<double>
+  /// perturbs groups of structurally independent variables (columns that do
+  /// not share a nonzero row) together, so it needs one evaluation per group
+  /// instead of one per variable. Variables the constraint does not depend on
+  /// are not perturbed at all.
+  void SetJacobianSparsityPattern(
+      const std::vector<std::pair<int, int>>& pattern);
+
+  /// Instead of declaring the pattern, detect it on the first gradient
+  /// evaluation, by differencing densely at that point and at a randomly
+  /// perturbed one. Entries that are zero at both points are taken to be
+  /// structurally zero, so this is only appropriate for constraints whose
+  /// sparsity comes from their structure (e.g. which joints a contact point
+  /// depends on). Unlike SetJacobianSparsityPattern(), the detected pattern is
+  /// not passed on to the solver.
+  void DetectJacobianSparsityPattern();
+
+  /// Number of constraint evaluations per numerical gradient, excluding the
+  /// nominal one (num_vars() until a pattern is set or detected)
+  int num_gradient_evaluations() const;
+
   virtual void EvaluateConstraint(const Eigen::Ref<const drake::VectorX<T>>& x,
                                   drake::VectorX<T>* y) const = 0;
 
+  /// Optionally evaluates the constraint together with its Jacobian dy/dx.
+  /// Subclasses of NonlinearConstraint<double> that can differentiate
+  /// themselves analytically override this and return true, in which case the
+  /// numerical gradient is skipped. The default returns false.
+  virtual bool EvaluateConstraintWithGradient(
+      const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y,
+      Eigen::MatrixXd* dy) const {
+    return false;
+  }
+
  private:
   template <typename U>
   void ScaleConstraint(drake::VectorX<U>* y) const;
+
+  // Stores the nonzero rows of each column and groups the columns greedily
+  void UpdateColoring(std::vector<std::vector<int>> column_rows) const;
+
   std::unordered_map<int, double> constraint_scaling_;
   double eps_;
+
+  // Jacobian sparsity: the nonzero rows of each column, and the groups
+  // ("colors") of columns that are perturbed together. Empty without a
+  // pattern. Mutable since a detected pattern is set on the first gradient
+  // evaluation (guarded by sparsity_detected_).
+  mutable std::vector<std::vector<int>> column_rows_;
+  mutable std::vector<std::vector<int>> colors_;
+  bool detect_sparsity_ = false;
+  mutable std::once_flag sparsity_detected_;
 };
 
 }  // namespace solvers
@@ -0,0 +1,181 @@
+#include "solvers/qp_snapshot.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+#include "drake/common/drake_assert.h"
+
+using Eigen::SparseMatrix;
+using Eigen::VectorXd;
+
+namespace dairlib {
+namespace solvers {
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'A', 'I', 'R', 'Q', 'P', '0', '1'};
+
+static_assert(sizeof(SparseMatrix<double>::StorageIndex) == sizeof(int32_t),
+              "The log stores the sparse indices as int32");
+
+template <typename T>
+void WriteArray(std::ofstream* file, const T* data, int size) {
+  file->write(reinterpret_cast<const char*>(data), sizeof(T) * size);
+}
+
+template <typename T>
+void WriteValue(std::ofstream* file, T value) {
+  WriteArray(file, &value, 1);
+}
+
+void WriteSparse(std::ofstream* file, const SparseMatrix<double>& matrix) {
+  WriteArray(file, matrix.outerIndexPtr(), matrix.outerSize() + 1);
+  WriteArray(file, matrix.innerIndexPtr(), matrix.nonZeros());
+  WriteArray(file, matrix.valuePtr(), matrix.nonZeros());
+}
+
+template <typename T>
+void ReadArray(std::ifstream* file, T* data, int size) {
+  file->read(reinterpret_cast<char*>(data), sizeof(T) * size);
+  if (!*file) {
+    throw std::runtime_error("QpSnapshotReader: truncated record");
+  }
+}
+
+void ReadSparse(std::ifstream* file, int rows, int cols, int nnz,
+                SparseMatrix<double>* matrix) {
+  matrix->resize(rows, cols);
+  matrix->resizeNonZeros(nnz);
+  ReadArray(file, matrix->outerIndexPtr(), cols + 1);
+  ReadArray(file, matrix->innerIndexPtr(), nnz);
+  ReadArray(file, matrix->valuePtr(), nnz);
+}
+
+}  // namespace
+
+QpSnapshotWriter::QpSnapshotWriter(const std::string& filename, int capacity)
+    : file_(filename, std::ios::binary | std::ios::trunc),
+      slots_(capacity),
+      filled_(capacity),
+      free_(capacity) {
+  if (!file_) {
+    throw std::runtime_error("QpSnapshotWriter: cannot open " + filename);
+  }
+  file_.write(kMagic, sizeof(kMagic));
+  for (int i = 0; i < capacity; ++i) {
+    free_.Push(i);
+  }
+  thread_ = std::thread(&QpSnapshotWriter::Run, this);
+}
+
+QpSnapshotWriter::~QpSnapshotWriter() {
+  stop_ = true;
+  thread_.join();
+  file_.flush();
+}
+
+bool QpSnapshotWriter::Write(double time, int fsm_state,
+                             const SparseMatrix<double>& P, const VectorXd& q,
+                             const SparseMatrix<double>& A, const VectorXd& l,
+                             const VectorXd& u, const VectorXd& x_warm,
+                             const VectorXd& y_warm) {
+  DRAKE_DEMAND(P.isCompressed() && A.isCompressed());
+  int index;
+  if (!free_.Pop(&index)) {
+    num_dropped_++;
+    return false;
+  }
+  QpSnapshot& slot = slots_[index];
+  slot.time = time;
+  slot.fsm_state = fsm_state;
+  slot.P = P;
+  slot.q = q;
+  slot.A = A;
+  slot.l = l;
+  slot.u = u;
+  slot.x_warm = x_warm;
+  slot.y_warm = y_warm;
+  filled_.Push(index);
+  return true;
+}
+
+void QpSnapshotWriter::Run() {
+  for (;;) {
+    // Everything queued before stop_ was set is drained below
+    const bool stop = stop_;
+    int index;
+    while (filled_.Pop(&index)) {
+      WriteRecord(slots_[index]);
+      free_.Push(index);
+      num_written_++;
+    }
+    if (stop) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+void QpSnapshotWriter::WriteRecord(const QpSnapshot& snapshot) {
+  const int32_t sizes[6] = {
+      static_cast<int32_t>(snapshot.P.cols()),
+      static_cast<int32_t>(snapshot.A.rows()),
+      static_cast<int32_t>(snapshot.P.nonZeros()),
+      static_cast<int32_t>(snapshot.A.nonZeros()),
+      static_cast<int32_t>(snapshot.x_warm.size()),
+      static_cast<int32_t>(snapshot.y_warm.size())};
+  WriteValue(&file_, snapshot.time);
+  WriteValue(&file_, static_cast<int32_t>(snapshot.fsm_state));
+  WriteArray(&file_, sizes, 6);
+  WriteSparse(&file_, snapshot.P);
+  WriteArray(&file_, snapshot.q.data(), snapshot.q.size());
+  WriteSparse(&file_, snapshot.A);
+  WriteArray(&file_, snapshot.l.data(), snapshot.l.size());
+  WriteArray(&file_, snapshot.u.data(), snapshot.u.size());
+  WriteArray(&file_, snapshot.x_warm.data(), snapshot.x_warm.size());
+  WriteArray(&file_, snapshot.y_warm.data(), snapshot.y_warm.size());
+}
+
+QpSnapshotReader::QpSnapshotReader(const std::string& filename)
+    : file_(filename, std::ios::binary) {
+  char magic[sizeof(kMagic)];
+  file_.read(magic, sizeof(magic));
+  if (!file_ || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("QpSnapshotReader: " + filename +
+                             " is not a QP snapshot log");
+  }
+}
+
+bool QpSnapshotReader::Read(QpSnapshot* snapshot) {
+  double time;
+  file_.read(reinterpret_cast<char*>(&time), sizeof(time));
+  if (file_.gcount() == 0 && file_.eof()) {
+    return false;
+  }
+  if (!file_) {
+    throw std::runtime_error("QpSnapshotReader: truncated record");
+  }
+  int32_t fsm_state;
+  int32_t sizes[6];
+  ReadArray(&file_, &fsm_state, 1);
+  ReadArray(&file_, sizes, 6);
+  const int n = sizes[0];
+  const int m = sizes[1];
+  snapshot->time = time;
+  snapshot->fsm_state = fsm_state;
+  ReadSparse(&file_, n, n, sizes[2], &snapshot->P);
+  snapshot->q.resize(n);
+  ReadArray(&file_, snapshot->q.data(), n);
+  ReadSparse(&file_, m, n, sizes[3], &snapshot->A);
+  snapshot->l.resize(m);
+  snapshot->u.resize(m);
+  ReadArray(&file_, snapshot->l.data(), m);
+  ReadArray(&file_, snapshot->u.data(), m);
+  snapshot->x_warm.resize(sizes[4]);
+  snapshot->y_warm.resize(sizes[5]);
+  ReadArray(&file_, snapshot->x_warm.data(), sizes[4]);
+  ReadArray(&file_, snapshot->y_warm.data(), sizes[5]);
+  return true;
+}
+
+}  // namespace solvers
+}  // namespace dairlib
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include "common/spsc_ring_buffer.h"
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib {
+namespace solvers {
+
+/// A fully assembled QP in OSQP's standard form
+///   min 0.5 xᵀPx + qᵀx
+///   s.t. l ≤ Ax ≤ u
+/// (P upper triangular, P and A compressed) together with the primal and dual
+/// point the solver was warm started from and the controller state it was
+/// assembled in. The warm start vectors are empty if the solver that was used
+/// has no primal-dual warm start.
+struct QpSnapshot {
+  double time = 0;
+  int fsm_state = 0;
+  Eigen::SparseMatrix<double> P;
+  Eigen::VectorXd q;
+  Eigen::SparseMatrix<double> A;
+  Eigen::VectorXd l;
+  Eigen::VectorXd u;
+  Eigen::VectorXd x_warm;
+  Eigen::VectorXd y_warm;
+};
+
+/// Writes QpSnapshots to a binary log from a background thread.
+///
+/// Write() is meant to be called from a real-time loop: it copies the QP into
+/// one of `capacity` preallocated slots and hands the slot to the writer
+/// thread through a lock-free ring buffer. Once a slot has held a QP of the
+/// same size, the copy does not allocate. If the writer thread falls behind
+/// and no slot is free, the snapshot is dropped (and counted) instead of
+/// blocking the caller.
+///
+/// File format (native endianness): the 8 byte magic "DAIRQP01", followed by
+/// one record per snapshot
+///   double time, int32 fsm_state,
+///   int32 n, m, nnz(P), nnz(A), size(x_warm), size(y_warm),
+///   P: int32 outer[n + 1], int32 inner[nnz(P)], double values[nnz(P)],
+///   double q[n],
+///   A: int32 outer[n + 1], int32 inner[nnz(A)], double values[nnz(A)],
+///   double l[m], double u[m], double x_warm[], double y_warm[]
+/// Infinite bounds are stored as ±inf.
+class QpSnapshotWriter {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(QpSnapshotWriter)
+
+  explicit QpSnapshotWriter(const std::string& filename, int capacity = 256);
+  /// Writes out the pending snapshots and closes the file
+  ~QpSnapshotWriter();
+
+  /// Queues a snapshot. Returns false if it was dropped.
+  bool Write(double time, int fsm_state, const Eigen::SparseMatrix<double>& P,
+             const Eigen::VectorXd& q, const Eigen::SparseMatrix<double>& A,
+             const Eigen::VectorXd& l, const Eigen::VectorXd& u,
+             const Eigen::VectorXd& x_warm, const Eigen::VectorXd& y_warm);
+
+  int64_t num_written() const { return num_written_; }
+  int64_t num_dropped() const { return num_dropped_; }
+
+ private:
+  void Run();
+  void WriteRecord(const QpSnapshot& snapshot);
+
+  std::ofstream file_;
+  std::vector<QpSnapshot> slots_;
+  // Slot indices ready to be written (caller -> writer thread) and free slot
+  // indices (writer thread -> caller)
+  SpscRingBuffer<int> filled_;
+  SpscRingBuffer<int> free_;
+  std::atomic<bool> stop_{false};
+  std::atomic<int64_t> num_written_{0};
+  int64_t num_dropped_ = 0;
+  std::thread thread_;
+};
+
+/// Reads the log written by QpSnapshotWriter
+class QpSnapshotReader {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(QpSnapshotReader)
+
+  /// Throws if the file cannot be opened or is not a snapshot log
+  explicit QpSnapshotReader(const std::string& filename);
+
+  /// Reads the next snapshot. Returns false at the end of the log; throws if
+  /// the last record is truncated.
+  bool Read(QpSnapshot* snapshot);
+
+ private:
+  std::ifstream file_;
+};
+
+}  // namespace solvers
+}  // namespace dairlib
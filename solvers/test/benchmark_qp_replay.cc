@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "common/find_resource.h"
+#include "solvers/dense_active_set_qp_solver.h"
+#include "solvers/fast_osqp_solver.h"
+#include "solvers/qp_snapshot.h"
+#include "solvers/solver_options_io.h"
+
+#include "drake/common/yaml/yaml_io.h"
+#include "drake/solvers/osqp_solver.h"
+
+/// Replays a log of QP snapshots (see solvers::QpSnapshotWriter, e.g. written
+/// by OperationalSpaceControl::SetQpSnapshotLog) through FastOsqpSolver and
+/// DenseActiveSetQpSolver, and reports the distribution of the solve latency
+/// and of the iteration counts, overall and per fsm state, as well as the
+/// slowest snapshots. The QPs are solved in the order they were logged, so
+/// the solvers' own warm starts see the same sequence as on the robot.
+
+DEFINE_string(log, "", "QP snapshot log to replay");
+DEFINE_string(solvers, "osqp,active_set",
+              "Comma separated solvers to benchmark: osqp, active_set");
+DEFINE_string(osqp_options, "solvers/osqp_options_default.yaml",
+              "OSQP options yaml");
+DEFINE_string(warm_start, "logged",
+              "logged: warm start OSQP from the logged point (falls back to "
+              "the previous solve for snapshots without one), previous: warm "
+              "start from the previous replayed solve, cold: no warm start");
+DEFINE_int32(num_passes, 1, "Number of times the log is replayed");
+DEFINE_int32(num_slowest, 5, "Number of slowest snapshots to print");
+
+namespace dairlib {
+namespace solvers {
+namespace {
+
+using drake::solvers::SolutionResult;
+using Eigen::VectorXd;
+
+typedef std::chrono::steady_clock my_clock;
+
+struct Sample {
+  int index;
+  int fsm_state;
+  double time;
+  double latency_us;
+  int iterations;
+};
+
+void PrintDistribution(const std::string& name, std::vector<double> values) {
+  if (values.empty()) return;
+  std::sort(values.begin(), values.end());
+  double mean = 0;
+  for (double v : values) mean += v;
+  mean /= values.size();
+  auto percentile = [&](double p) {
+    return values[static_cast<int>(p * (values.size() - 1))];
+  };
+  std::cout << "    " << name << ": mean " << mean << ", median "
+            << percentile(0.5) << ", p90 " << percentile(0.9) << ", p99 "
+            << percentile(0.99) << ", max " << values.back() << std::endl;
+}
+
+void PrintSummary(const std::string& name, const std::vector<Sample>& samples,
+                  int num_failed) {
+  std::cout << name << ": " << samples.size() << " solves, " << num_failed
+            << " failed" << std::endl;
+  std::map<int, std::vector<const Sample*>> by_fsm_state;
+  for (const auto& sample : samples) {
+    by_fsm_state[sample.fsm_state].push_back(&sample);
+  }
+  auto print_group = [](const std::string& label,
+                        const std::vector<const Sample*>& group) {
+    std::vector<double> latency_us;
+    std::vector<double> iterations;
+    for (const auto* sample : group) {
+      latency_us.push_back(sample->latency_us);
+      iterations.push_back(sample->iterations);
+    }
+    std::cout << "  " << label << " (" << group.size() << " solves)"
+              << std::endl;
+    PrintDistribution("latency [us]", latency_us);
+    PrintDistribution("iterations", iterations);
+  };
+  std::vector<const Sample*> all;
+  for (const auto& sample : samples) all.push_back(&sample);
+  print_group("all", all);
+  for (const auto& [fsm_state, group] : by_fsm_state) {
+    print_group("fsm state " + std::to_string(fsm_state), group);
+  }
+
+  std::sort(all.begin(), all.end(), [](const Sample* a, const Sample* b) {
+    return a->latency_us > b->latency_us;
+  });
+  std::cout << "  slowest:" << std::endl;
+  for (int i = 0; i < std::min<int>(FLAGS_num_slowest, all.size()); ++i) {
+    std::cout << "    snapshot " << all[i]->index << " (t = " << all[i]->time
+              << ", fsm state " << all[i]->fsm_state
+              << "): " << all[i]->latency_us << " us, "
+              << all[i]->iterations << " iterations" << std::endl;
+  }
+}
+
+void ReplayOsqp(const std::vector<QpSnapshot>& snapshots) {
+  auto options = drake::yaml::LoadYamlFile<SolverOptionsFromYaml>(
+                     FindResourceOrThrow(FLAGS_osqp_options))
+                     .GetAsSolverOptions(drake::solvers::OsqpSolver::id());
+  std::unique_ptr<FastOsqpSolver> solver;
+  // Sizes the solver was set up with. The sparsity pattern is fixed once the
+  // solver is set up.
+  std::vector<int> sizes;
+  FastOsqpSolver::Details details;
+  VectorXd x;
+  std::vector<Sample> samples;
+  int num_failed = 0;
+  for (int pass = 0; pass < FLAGS_num_passes; ++pass) {
+    for (int i = 0; i < static_cast<int>(snapshots.size()); ++i) {
+      const QpSnapshot& qp = snapshots[i];
+      const std::vector<int> qp_sizes = {
+          static_cast<int>(qp.q.size()), static_cast<int>(qp.l.size()),
+          static_cast<int>(qp.P.nonZeros()), static_cast<int>(qp.A.nonZeros())};
+      if (solver == nullptr || qp_sizes != sizes) {
+        solver = std::make_unique<FastOsqpSolver>();
+        solver->InitializeSolver(qp.P, qp.q, qp.A, qp.l, qp.u, options);
+        sizes = qp_sizes;
+      }
+      if (FLAGS_warm_start == "cold") {
+        solver->DisableWarmStart();
+      } else if (FLAGS_warm_start == "logged" && qp.x_warm.size() > 0) {
+        solver->WarmStart(qp.x_warm, qp.y_warm);
+      }
+      auto start = my_clock::now();
+      SolutionResult result =
+          solver->SolveDirect(qp.P, qp.q, qp.A, qp.l, qp.u, &x, &details);
+      auto stop = my_clock::now();
+      if (result != SolutionResult::kSolutionFound) num_failed++;
+      samples.push_back(
+          {i, qp.fsm_state, qp.time,
+           std::chrono::duration<double, std::micro>(stop - start).count(),
+           details.iter});
+    }
+  }
+  PrintSummary("osqp", samples, num_failed);
+}
+
+void ReplayActiveSet(const std::vector<QpSnapshot>& snapshots) {
+  std::unique_ptr<DenseActiveSetQpSolver> solver;
+  DenseActiveSetQpSolver::Details details;
+  VectorXd x;
+  std::vector<Sample> samples;
+  int num_failed = 0;
+  for (int pass = 0; pass < FLAGS_num_passes; ++pass) {
+    for (int i = 0; i < static_cast<int>(snapshots.size()); ++i) {
+      const QpSnapshot& qp = snapshots[i];
+      if (solver == nullptr || solver->num_vars() != qp.q.size() ||
+          solver->num_constraints() != qp.l.size()) {
+        solver = std::make_unique<DenseActiveSetQpSolver>(qp.q.size(),
+                                                          qp.l.size());
+      }
+      // The active-set solver is warm started from its previous active set
+      if (FLAGS_warm_start == "cold") {
+        solver->ResetWarmStart();
+      }
+      auto start = my_clock::now();
+      SolutionResult result =
+          solver->Solve(qp.P, qp.q, qp.A, qp.l, qp.u, &x, &details);
+      auto stop = my_clock::now();
+      if (result != SolutionResult::kSolutionFound) num_failed++;
+      samples.push_back(
+          {i, qp.fsm_state, qp.time,
+           std::chrono::duration<double, std::micro>(stop - start).count(),
+           details.iterations});
+    }
+  }
+  PrintSummary("active_set", samples, num_failed);
+}
+
+int DoMain(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  DRAKE_DEMAND(!FLAGS_log.empty());
+  DRAKE_DEMAND(FLAGS_warm_start == "logged" ||
+               FLAGS_warm_start == "previous" || FLAGS_warm_start == "cold");
+
+  std::vector<QpSnapshot> snapshots;
+  QpSnapshotReader reader(FLAGS_log);
+  QpSnapshot snapshot;
+  while (reader.Read(&snapshot)) {
+    snapshots.push_back(snapshot);
+  }
+  std::cout << "Read " << snapshots.size() << " snapshots from " << FLAGS_log
+            << std::endl;
+  if (snapshots.empty()) return 0;
+
+  std::stringstream solvers(FLAGS_solvers);
+  std::string solver;
+  while (std::getline(solvers, solver, ',')) {
+    if (solver == "osqp") {
+      ReplayOsqp(snapshots);
+    } else if (solver == "active_set") {
+      ReplayActiveSet(snapshots);
+    } else {
+      std::cerr << "Unknown solver " << solver << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace dairlib
+
+int main(int argc, char* argv[]) {
+  return dairlib::solvers::DoMain(argc, argv);
+}
@@ -0,0 +1,149 @@
+#include "solvers/constraint_batch.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+
+namespace dairlib {
+namespace solvers {
+namespace {
+
+using drake::AutoDiffVecXd;
+using drake::CompareMatrices;
+using drake::solvers::Binding;
+using drake::solvers::Constraint;
+using drake::solvers::VectorXDecisionVariable;
+using drake::symbolic::Variable;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+/// y = [x0 x1, sin(x2) + x0²] (scaled)
+class TestConstraint : public Constraint {
+ public:
+  explicit TestConstraint(double scale)
+      : Constraint(2, 3, -VectorXd::Ones(2), scale * VectorXd::Ones(2)),
+        scale_(scale) {}
+
+ private:
+  template <typename U>
+  void DoEvalGeneric(const Eigen::Ref<const drake::VectorX<U>>& x,
+                     drake::VectorX<U>* y) const {
+    using std::sin;
+    y->resize(2);
+    (*y)(0) = scale_ * x(0) * x(1);
+    (*y)(1) = scale_ * (sin(x(2)) + x(0) * x(0));
+  }
+
+  void DoEval(const Eigen::Ref<const VectorXd>& x,
+              VectorXd* y) const override {
+    DoEvalGeneric<double>(x, y);
+  }
+
+  void DoEval(const Eigen::Ref<const AutoDiffVecXd>& x,
+              AutoDiffVecXd* y) const override {
+    DoEvalGeneric<drake::AutoDiffXd>(x, y);
+  }
+
+  void DoEval(const Eigen::Ref<const drake::VectorX<Variable>>&,
+              drake::VectorX<drake::symbolic::Expression>*) const override {
+    throw std::logic_error("not supported");
+  }
+
+  double scale_;
+};
+
+class ConstraintBatchTest : public ::testing::Test {
+ protected:
+  ConstraintBatchTest() {
+    for (int i = 0; i < 7; ++i) {
+      vars_.emplace_back("x" + std::to_string(i));
+    }
+    // Consecutive bindings share a variable, and the last one uses a
+    // variable twice
+    for (int k = 0; k < 3; ++k) {
+      VectorXDecisionVariable vars(3);
+      vars << vars_[2 * k], vars_[2 * k + 1], vars_[2 * k + 2];
+      bindings_.emplace_back(std::make_shared<TestConstraint>(k + 1), vars);
+    }
+    VectorXDecisionVariable vars(3);
+    vars << vars_[6], vars_[0], vars_[6];
+    bindings_.emplace_back(std::make_shared<TestConstraint>(0.5), vars);
+  }
+
+  // Value of the bindings' variables, given the batch's variables
+  VectorXd BindingValue(const ConstraintBatch& batch, int k,
+                        const VectorXd& x) {
+    VectorXd x_k(3);
+    for (int j = 0; j < 3; ++j) {
+      const auto& var = bindings_[k].variables()(j);
+      for (int i = 0; i < batch.variables().size(); ++i) {
+        if (batch.variables()(i).get_id() == var.get_id()) x_k(j) = x(i);
+      }
+    }
+    return x_k;
+  }
+
+  std::vector<Variable> vars_;
+  std::vector<Binding<Constraint>> bindings_;
+};
+
+TEST_F(ConstraintBatchTest, MatchesSerialEvaluation) {
+  ConstraintBatch batch(bindings_, 3);
+  EXPECT_EQ(batch.num_vars(), 7);
+  EXPECT_EQ(batch.num_constraints(), 8);
+  EXPECT_EQ(batch.num_bindings(), 4);
+  ASSERT_TRUE(batch.gradient_sparsity_pattern().has_value());
+  // (x6 appears twice in the last binding)
+  EXPECT_EQ(batch.gradient_sparsity_pattern()->size(), 4 * 2 * 3 - 2);
+
+  const VectorXd x = VectorXd::Random(7);
+  VectorXd y;
+  batch.Eval(x, &y);
+  AutoDiffVecXd y_ad;
+  batch.Eval(drake::math::InitializeAutoDiff(x), &y_ad);
+  const MatrixXd dy = drake::math::ExtractGradient(y_ad);
+  // Chain rule through a non-identity input gradient
+  const MatrixXd dx = MatrixXd::Random(7, 2);
+  AutoDiffVecXd y_ad_chain;
+  batch.Eval(drake::math::InitializeAutoDiff(x, dx), &y_ad_chain);
+
+  MatrixXd dy_expected = MatrixXd::Zero(8, 7);
+  for (int k = 0; k < 4; ++k) {
+    const auto& constraint = *bindings_[k].evaluator();
+    const VectorXd x_k = BindingValue(batch, k, x);
+    VectorXd y_k;
+    constraint.Eval(x_k, &y_k);
+    EXPECT_TRUE(CompareMatrices(y.segment(2 * k, 2), y_k, 1e-14));
+    EXPECT_TRUE(CompareMatrices(batch.lower_bound().segment(2 * k, 2),
+                                constraint.lower_bound()));
+    EXPECT_TRUE(CompareMatrices(batch.upper_bound().segment(2 * k, 2),
+                                constraint.upper_bound()));
+
+    AutoDiffVecXd y_k_ad;
+    constraint.Eval(drake::math::InitializeAutoDiff(x_k), &y_k_ad);
+    const MatrixXd dy_k = drake::math::ExtractGradient(y_k_ad);
+    for (int j = 0; j < 3; ++j) {
+      for (int i = 0; i < 7; ++i) {
+        if (batch.variables()(i).get_id() ==
+            bindings_[k].variables()(j).get_id()) {
+          dy_expected.block(2 * k, i, 2, 1) += dy_k.col(j);
+        }
+      }
+    }
+  }
+  EXPECT_TRUE(CompareMatrices(drake::math::ExtractValue(y_ad), y, 1e-14));
+  EXPECT_TRUE(CompareMatrices(dy, dy_expected, 1e-14));
+  EXPECT_TRUE(CompareMatrices(drake::math::ExtractGradient(y_ad_chain),
+                              dy_expected * dx, 1e-12));
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace dairlib
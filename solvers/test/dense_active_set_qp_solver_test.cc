@@ -0,0 +1,138 @@
+#include "solvers/dense_active_set_qp_solver.h"
+
+#include <limits>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "common/allocation_counter.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+
+namespace dairlib {
+namespace solvers {
+namespace {
+
+using drake::CompareMatrices;
+using drake::solvers::SolutionResult;
+using Eigen::MatrixXd;
+using Eigen::SparseMatrix;
+using Eigen::VectorXd;
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// Random feasible, strictly convex QP with a few equality rows, two sided
+// inequality rows and one sided inequality rows, in OSQP's form
+struct RandomQp {
+  RandomQp(int n, int m, int n_eq) {
+    MatrixXd X = MatrixXd::Random(n, n);
+    MatrixXd H = X * X.transpose() + MatrixXd::Identity(n, n);
+    P = MatrixXd(H.triangularView<Eigen::Upper>()).sparseView();
+    q = 10 * VectorXd::Random(n);
+    A = MatrixXd(MatrixXd::Random(m, n)).sparseView();
+    // Feasible by construction
+    VectorXd x_feasible = VectorXd::Random(n);
+    const VectorXd Ax = A * x_feasible;
+    l = Ax - VectorXd::Random(m).cwiseAbs();
+    u = Ax + VectorXd::Random(m).cwiseAbs();
+    l.head(n_eq) = Ax.head(n_eq);
+    u.head(n_eq) = Ax.head(n_eq);
+    for (int i = n_eq; i < m; i += 3) {
+      u(i) = kInf;
+    }
+  }
+  SparseMatrix<double> P;
+  VectorXd q;
+  SparseMatrix<double> A;
+  VectorXd l;
+  VectorXd u;
+};
+
+void CheckKkt(const RandomQp& qp, const VectorXd& x, const VectorXd& y) {
+  const double tol = 1e-8;
+  MatrixXd H = MatrixXd(qp.P).selfadjointView<Eigen::Upper>();
+  VectorXd stationarity = H * x + qp.q + qp.A.transpose() * y;
+  EXPECT_LT(stationarity.lpNorm<Eigen::Infinity>(), 1e-6);
+  VectorXd Ax = qp.A * x;
+  for (int i = 0; i < Ax.size(); ++i) {
+    EXPECT_GE(Ax(i), qp.l(i) - tol);
+    EXPECT_LE(Ax(i), qp.u(i) + tol);
+    // y > 0 only at the upper bound, y < 0 only at the lower bound
+    if (y(i) > tol) EXPECT_NEAR(Ax(i), qp.u(i), 1e-6);
+    if (y(i) < -tol) EXPECT_NEAR(Ax(i), qp.l(i), 1e-6);
+  }
+}
+
+TEST(DenseActiveSetQpSolverTest, RandomProblems) {
+  std::srand(1);
+  const int n = 12;
+  const int m = 20;
+  DenseActiveSetQpSolver solver(n, m);
+  solver.set_hessian_regularization(0);
+  for (int trial = 0; trial < 20; ++trial) {
+    RandomQp qp(n, m, 3);
+    VectorXd x;
+    DenseActiveSetQpSolver::Details details;
+    ASSERT_EQ(solver.Solve(qp.P, qp.q, qp.A, qp.l, qp.u, &x, &details),
+              SolutionResult::kSolutionFound);
+    CheckKkt(qp, x, details.y);
+    EXPECT_GE(details.num_active, 3);
+  }
+}
+
+TEST(DenseActiveSetQpSolverTest, WarmStart) {
+  std::srand(2);
+  const int n = 12;
+  const int m = 20;
+  RandomQp qp(n, m, 2);
+  DenseActiveSetQpSolver solver(n, m);
+  DenseActiveSetQpSolver::Details cold;
+  DenseActiveSetQpSolver::Details warm;
+  VectorXd x_cold;
+  VectorXd x_warm;
+  ASSERT_EQ(solver.Solve(qp.P, qp.q, qp.A, qp.l, qp.u, &x_cold, &cold),
+            SolutionResult::kSolutionFound);
+  // Slightly perturbed problem, as between two controller ticks
+  qp.q += 1e-3 * VectorXd::Random(n);
+  ASSERT_EQ(solver.Solve(qp.P, qp.q, qp.A, qp.l, qp.u, &x_warm, &warm),
+            SolutionResult::kSolutionFound);
+  CheckKkt(qp, x_warm, warm.y);
+  EXPECT_LE(warm.iterations, cold.iterations);
+  EXPECT_TRUE(CompareMatrices(x_cold, x_warm, 1e-1));
+}
+
+TEST(DenseActiveSetQpSolverTest, SteadyStateDoesNotAllocate) {
+  std::srand(3);
+  const int n = 12;
+  const int m = 20;
+  RandomQp qp(n, m, 3);
+  DenseActiveSetQpSolver solver(n, m);
+  DenseActiveSetQpSolver::Details details;
+  VectorXd x = VectorXd::Zero(n);
+  ASSERT_EQ(solver.Solve(qp.P, qp.q, qp.A, qp.l, qp.u, &x, &details),
+            SolutionResult::kSolutionFound);
+  AllocationCounter counter;
+  ASSERT_EQ(solver.Solve(qp.P, qp.q, qp.A, qp.l, qp.u, &x, &details),
+            SolutionResult::kSolutionFound);
+  EXPECT_EQ(counter.count(), 0);
+}
+
+TEST(DenseActiveSetQpSolverTest, Infeasible) {
+  // x >= 1 and x <= 0
+  SparseMatrix<double> P = MatrixXd::Identity(1, 1).sparseView();
+  SparseMatrix<double> A = MatrixXd::Ones(2, 1).sparseView();
+  VectorXd q = VectorXd::Zero(1);
+  VectorXd l(2);
+  VectorXd u(2);
+  l << 1, -kInf;
+  u << kInf, 0;
+  DenseActiveSetQpSolver solver(1, 2);
+  VectorXd x;
+  DenseActiveSetQpSolver::Details details;
+  EXPECT_EQ(solver.Solve(P, q, A, l, u, &x, &details),
+            SolutionResult::kInfeasibleConstraints);
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace dairlib
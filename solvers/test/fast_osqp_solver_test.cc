@@ -0,0 +1,141 @@
+#include <memory>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "solvers/fast_osqp_solver.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/solvers/mathematical_program.h"
+
+namespace dairlib {
+namespace solvers {
+namespace {
+
+using drake::CompareMatrices;
+using drake::solvers::LinearConstraint;
+using drake::solvers::LinearEqualityConstraint;
+using drake::solvers::MathematicalProgram;
+using drake::solvers::MathematicalProgramResult;
+using drake::solvers::OsqpSolver;
+using drake::solvers::QuadraticCost;
+using drake::solvers::SolverOptions;
+using Eigen::Matrix2d;
+using Eigen::MatrixXd;
+using Eigen::Vector2d;
+using Eigen::VectorXd;
+
+// Small QP whose coefficients are updated in place between solves, the same
+// way OperationalSpaceControl updates its program every tick.
+class FastOsqpSolverTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    x_ = prog_.NewContinuousVariables(2, "x");
+    y_ = prog_.NewContinuousVariables(1, "y");
+    cost_x_ = prog_.AddQuadraticCost(Matrix2d::Identity(), Vector2d::Zero(), x_)
+                  .evaluator()
+                  .get();
+    cost_xy_ = prog_.AddQuadraticCost(MatrixXd::Identity(3, 3),
+                                      VectorXd::Zero(3), {x_, y_})
+                   .evaluator()
+                   .get();
+    eq_ = prog_.AddLinearEqualityConstraint(MatrixXd::Zero(1, 3),
+                                            VectorXd::Zero(1), {x_, y_})
+              .evaluator()
+              .get();
+    ineq_ = prog_.AddLinearConstraint(MatrixXd::Ones(1, 2), VectorXd::Zero(1),
+                                      VectorXd::Ones(1), x_)
+                .evaluator()
+                .get();
+    prog_.AddBoundingBoxConstraint(-10, 10, y_);
+  }
+
+  void UpdateCoefficients(double s) {
+    cost_x_->UpdateCoefficients((1 + s) * Matrix2d::Identity(),
+                                Vector2d(-s, 2 * s));
+    MatrixXd Q = MatrixXd::Identity(3, 3);
+    Q(0, 2) = Q(2, 0) = 0.5 * s;
+    cost_xy_->UpdateCoefficients(Q, VectorXd::Constant(3, -1));
+    MatrixXd A(1, 3);
+    A << 1, -s, 1;
+    eq_->UpdateCoefficients(A, VectorXd::Constant(1, s));
+    ineq_->UpdateLowerBound(VectorXd::Constant(1, -s));
+  }
+
+  VectorXd SolveWith(FastOsqpSolver* solver, int structured_update,
+                     int warm_start_bank = 0) {
+    SolverOptions options;
+    options.SetOption(OsqpSolver::id(), "structured_update", structured_update);
+    options.SetOption(OsqpSolver::id(), "warm_start_bank", warm_start_bank);
+    options.SetOption(OsqpSolver::id(), "eps_abs", 1e-9);
+    options.SetOption(OsqpSolver::id(), "eps_rel", 1e-9);
+    options.SetOption(OsqpSolver::id(), "max_iter", 10000);
+    if (!solver->IsInitialized()) {
+      solver->InitializeSolver(prog_, options);
+    }
+    MathematicalProgramResult result = solver->Solve(prog_, {}, options);
+    EXPECT_TRUE(result.is_success());
+    return result.get_x_val();
+  }
+
+  MathematicalProgram prog_;
+  drake::solvers::VectorXDecisionVariable x_;
+  drake::solvers::VectorXDecisionVariable y_;
+  QuadraticCost* cost_x_;
+  QuadraticCost* cost_xy_;
+  LinearEqualityConstraint* eq_;
+  LinearConstraint* ineq_;
+};
+
+TEST_F(FastOsqpSolverTest, StructuredUpdateMatchesReparse) {
+  FastOsqpSolver reparse_solver;
+  FastOsqpSolver structured_solver;
+  UpdateCoefficients(0);
+  SolveWith(&reparse_solver, 0);
+  SolveWith(&structured_solver, 1);
+  EXPECT_FALSE(reparse_solver.IsStructuredUpdateEnabled());
+  EXPECT_TRUE(structured_solver.IsStructuredUpdateEnabled());
+
+  for (double s : {0.1, 0.7, 2.0, 0.3}) {
+    UpdateCoefficients(s);
+    VectorXd x_reparse = SolveWith(&reparse_solver, 0);
+    VectorXd x_structured = SolveWith(&structured_solver, 1);
+    EXPECT_TRUE(CompareMatrices(x_reparse, x_structured, 1e-6));
+  }
+}
+
+TEST_F(FastOsqpSolverTest, WarmStartBank) {
+  FastOsqpSolver solver;
+  FastOsqpSolver bank_solver;
+  // Alternate between two "modes" with different coefficients
+  for (int i = 0; i < 3; ++i) {
+    for (int key : {0, 1}) {
+      UpdateCoefficients(2.0 * key);
+      solver.SetWarmStartKey(key);
+      bank_solver.SetWarmStartKey(key);
+      SolveWith(&solver, 1, 0);
+      SolveWith(&bank_solver, 1, 1);
+    }
+  }
+  EXPECT_FALSE(solver.IsWarmStartBankEnabled());
+  EXPECT_TRUE(bank_solver.IsWarmStartBankEnabled());
+
+  const auto& stats = solver.warm_start_statistics();
+  const auto& bank_stats = bank_solver.warm_start_statistics();
+  ASSERT_EQ(stats.size(), 2);
+  ASSERT_EQ(bank_stats.size(), 2);
+  // The initial key is 0, so the first solve is not a switch
+  EXPECT_EQ(bank_stats.at(0).num_solves, 3);
+  EXPECT_EQ(bank_stats.at(0).num_switch_solves, 2);
+  EXPECT_EQ(bank_stats.at(1).num_solves, 3);
+  EXPECT_EQ(bank_stats.at(1).num_switch_solves, 3);
+  // Restoring the solution of the same problem can only help
+  for (int key : {0, 1}) {
+    EXPECT_LE(bank_stats.at(key).switch_iterations,
+              stats.at(key).switch_iterations);
+  }
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace dairlib
@@ -0,0 +1,116 @@
+#include "solvers/nonlinear_constraint.h"
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+
+namespace dairlib {
+namespace solvers {
+namespace {
+
+using drake::AutoDiffVecXd;
+using drake::CompareMatrices;
+using drake::VectorX;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+/// y0 = x0² + x1, y1 = sin(x1) x2, y2 = x3 x4, y3 = exp(x4); x5 is unused
+class BlockConstraint : public NonlinearConstraint<double> {
+ public:
+  BlockConstraint()
+      : NonlinearConstraint<double>(4, 6, VectorXd::Zero(4), VectorXd::Zero(4),
+                                    "block", 1e-8) {}
+
+  void EvaluateConstraint(const Eigen::Ref<const VectorX<double>>& x,
+                          VectorX<double>* y) const override {
+    num_evaluations_++;
+    y->resize(4);
+    (*y)(0) = x(0) * x(0) + x(1);
+    (*y)(1) = std::sin(x(1)) * x(2);
+    (*y)(2) = x(3) * x(4);
+    (*y)(3) = std::exp(x(4));
+  }
+
+  static MatrixXd Jacobian(const VectorXd& x) {
+    MatrixXd J = MatrixXd::Zero(4, 6);
+    J(0, 0) = 2 * x(0);
+    J(0, 1) = 1;
+    J(1, 1) = std::cos(x(1)) * x(2);
+    J(1, 2) = std::sin(x(1));
+    J(2, 3) = x(4);
+    J(2, 4) = x(3);
+    J(3, 4) = std::exp(x(4));
+    return J;
+  }
+
+  static std::vector<std::pair<int, int>> Pattern() {
+    return {{0, 0}, {0, 1}, {1, 1}, {1, 2}, {2, 3}, {2, 4}, {3, 4}};
+  }
+
+  mutable int num_evaluations_ = 0;
+};
+
+MatrixXd EvalGradient(const BlockConstraint& constraint, const VectorXd& x) {
+  AutoDiffVecXd y;
+  constraint.Eval(drake::math::InitializeAutoDiff(x), &y);
+  return drake::math::ExtractGradient(y);
+}
+
+TEST(NonlinearConstraintTest, DenseFiniteDifferences) {
+  BlockConstraint constraint;
+  VectorXd x(6);
+  x << 0.3, -0.2, 1.1, 0.5, -0.4, 2;
+  EXPECT_EQ(constraint.num_gradient_evaluations(), 6);
+  EXPECT_TRUE(CompareMatrices(EvalGradient(constraint, x),
+                              BlockConstraint::Jacobian(x), 1e-6));
+  EXPECT_EQ(constraint.num_evaluations_, 7);
+}
+
+TEST(NonlinearConstraintTest, DeclaredPattern) {
+  BlockConstraint constraint;
+  constraint.SetJacobianSparsityPattern(BlockConstraint::Pattern());
+  // {x0, x2, x3} and {x1, x4}; x5 is not perturbed
+  EXPECT_EQ(constraint.num_gradient_evaluations(), 2);
+
+  VectorXd x(6);
+  x << 0.3, -0.2, 1.1, 0.5, -0.4, 2;
+  EXPECT_TRUE(CompareMatrices(EvalGradient(constraint, x),
+                              BlockConstraint::Jacobian(x), 1e-6));
+  EXPECT_EQ(constraint.num_evaluations_, 3);
+
+  // Chain rule through a non-identity input gradient
+  const MatrixXd dx = MatrixXd::Random(6, 3);
+  AutoDiffVecXd y;
+  constraint.Eval(drake::math::InitializeAutoDiff(x, dx), &y);
+  EXPECT_TRUE(CompareMatrices(drake::math::ExtractGradient(y),
+                              BlockConstraint::Jacobian(x) * dx, 1e-5));
+}
+
+TEST(NonlinearConstraintTest, DetectedPattern) {
+  BlockConstraint constraint;
+  constraint.DetectJacobianSparsityPattern();
+
+  // y2 = x3 x4 has a zero gradient at the first point, but is still detected
+  VectorXd x(6);
+  x << 0.3, -0.2, 1.1, 0, 0, 2;
+  EXPECT_TRUE(CompareMatrices(EvalGradient(constraint, x),
+                              BlockConstraint::Jacobian(x), 1e-6));
+  EXPECT_EQ(constraint.num_gradient_evaluations(), 2);
+
+  x << -0.7, 0.4, 0.2, 1.5, 0.1, -1;
+  constraint.num_evaluations_ = 0;
+  EXPECT_TRUE(CompareMatrices(EvalGradient(constraint, x),
+                              BlockConstraint::Jacobian(x), 1e-6));
+  EXPECT_EQ(constraint.num_evaluations_, 3);
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace dairlib
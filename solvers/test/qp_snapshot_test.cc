@@ -0,0 +1,86 @@
+#include "solvers/qp_snapshot.h"
+
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+
+namespace dairlib {
+namespace solvers {
+namespace {
+
+using drake::CompareMatrices;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+std::string TempFile() {
+  const char* dir = std::getenv("TEST_TMPDIR");
+  return std::string(dir ? dir : "/tmp") + "/qp_snapshot_test.bin";
+}
+
+QpSnapshot RandomSnapshot(int n, int m, int i) {
+  QpSnapshot snapshot;
+  snapshot.time = 1e-3 * i;
+  snapshot.fsm_state = i % 3;
+  MatrixXd P = MatrixXd::Random(n, n);
+  P = MatrixXd(P.triangularView<Eigen::Upper>());
+  P(0, n - 1) = 0;
+  snapshot.P = P.sparseView();
+  snapshot.q = VectorXd::Random(n);
+  MatrixXd A = MatrixXd::Random(m, n);
+  A(1, 0) = 0;
+  snapshot.A = A.sparseView();
+  snapshot.l = -VectorXd::Ones(m);
+  snapshot.l(0) = -std::numeric_limits<double>::infinity();
+  snapshot.u = VectorXd::Ones(m);
+  // Only some solves have a warm start
+  if (i % 2 == 0) {
+    snapshot.x_warm = VectorXd::Random(n);
+    snapshot.y_warm = VectorXd::Random(m);
+  }
+  return snapshot;
+}
+
+TEST(QpSnapshotTest, WriteAndRead) {
+  const int n = 5;
+  const int m = 4;
+  const int num_snapshots = 10;
+  std::vector<QpSnapshot> snapshots;
+  {
+    QpSnapshotWriter writer(TempFile(), 4);
+    for (int i = 0; i < num_snapshots; ++i) {
+      snapshots.push_back(RandomSnapshot(n, m, i));
+      const QpSnapshot& s = snapshots.back();
+      // Wait for the writer thread instead of dropping snapshots
+      while (!writer.Write(s.time, s.fsm_state, s.P, s.q, s.A, s.l, s.u,
+                           s.x_warm, s.y_warm)) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  QpSnapshotReader reader(TempFile());
+  QpSnapshot snapshot;
+  for (const auto& expected : snapshots) {
+    ASSERT_TRUE(reader.Read(&snapshot));
+    EXPECT_EQ(snapshot.time, expected.time);
+    EXPECT_EQ(snapshot.fsm_state, expected.fsm_state);
+    EXPECT_TRUE(CompareMatrices(MatrixXd(snapshot.P), MatrixXd(expected.P)));
+    EXPECT_EQ(snapshot.P.nonZeros(), expected.P.nonZeros());
+    EXPECT_TRUE(CompareMatrices(MatrixXd(snapshot.A), MatrixXd(expected.A)));
+    EXPECT_TRUE(CompareMatrices(snapshot.q, expected.q));
+    EXPECT_TRUE(CompareMatrices(snapshot.l, expected.l));
+    EXPECT_TRUE(CompareMatrices(snapshot.u, expected.u));
+    EXPECT_TRUE(CompareMatrices(snapshot.x_warm, expected.x_warm));
+    EXPECT_TRUE(CompareMatrices(snapshot.y_warm, expected.y_warm));
+  }
+  EXPECT_FALSE(reader.Read(&snapshot));
+}
+
+}  // namespace
+}  // namespace solvers
+}  // namespace dairlib
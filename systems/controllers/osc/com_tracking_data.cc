@@ -34,7 +34,7 @@ void ComTrackingData::UpdateYdot(const VectorXd& x_w_spr,
 
 void ComTrackingData::UpdateJ(const VectorXd& x_wo_spr,
                               const Context<double>& context_wo_spr) {
-  J_ = MatrixXd::Zero(kSpaceDim, plant_wo_spr_.num_velocities());
+  J_.setZero(kSpaceDim, plant_wo_spr_.num_velocities());
   plant_wo_spr_.CalcJacobianCenterOfMassTranslationalVelocity(
       context_wo_spr, JacobianWrtVariable::kV, world_w_spr_, world_w_spr_, &J_);
 }
@@ -1,5 +1,7 @@
 #include "joint_space_tracking_data.h"
 
+#include <algorithm>
+
 #include "multibody/multibody_utils.h"
 
 using Eigen::MatrixXd;
@@ -83,35 +85,39 @@ void JointSpaceTrackingData::AddStateAndJointsToTrack(
 
 void JointSpaceTrackingData::UpdateY(const VectorXd& x_w_spr,
                                      const Context<double>& context_w_spr) {
-  VectorXd y(GetYDim());
+  y_.resize(GetYDim());
   for (int i = 0; i < GetYDim(); i++) {
-    y(i) = x_w_spr(joint_pos_idx_w_spr_.at(fsm_state_).at(i));
+    y_(i) = x_w_spr(joint_pos_idx_w_spr_.at(fsm_state_).at(i));
   }
-  y_ = y;
 }
 
 void JointSpaceTrackingData::UpdateYdot(const VectorXd& x_w_spr,
                                         const Context<double>& context_w_spr) {
-  VectorXd ydot(GetYdotDim());
+  ydot_.resize(GetYdotDim());
   for (int i = 0; i < GetYdotDim(); i++) {
-    ydot(i) = x_w_spr(plant_w_spr_.num_positions() +
-                      joint_vel_idx_w_spr_.at(fsm_state_).at(i));
+    ydot_(i) = x_w_spr(plant_w_spr_.num_positions() +
+                       joint_vel_idx_w_spr_.at(fsm_state_).at(i));
   }
-  ydot_ = ydot;
 }
 
 void JointSpaceTrackingData::UpdateJ(const VectorXd& x_wo_spr,
                                      const Context<double>& context_wo_spr) {
-  MatrixXd J = MatrixXd::Zero(GetYdotDim(), plant_wo_spr_.num_velocities());
+  J_.setZero(GetYdotDim(), plant_wo_spr_.num_velocities());
   for (int i = 0; i < GetYdotDim(); i++) {
-    J(i, joint_vel_idx_wo_spr_.at(fsm_state_).at(i)) = 1;
+    J_(i, joint_vel_idx_wo_spr_.at(fsm_state_).at(i)) = 1;
   }
-  J_ = J;
 }
 
 void JointSpaceTrackingData::UpdateJdotV(
     const VectorXd& x_wo_spr, const Context<double>& context_wo_spr) {
-  JdotV_ = VectorXd::Zero(GetYdotDim());
+  JdotV_.setZero(GetYdotDim());
+}
+
+std::vector<int> JointSpaceTrackingData::CalcJColumnSupport(
+    int fsm_state) const {
+  std::vector<int> support = joint_vel_idx_wo_spr_.at(fsm_state);
+  std::sort(support.begin(), support.end());
+  return support;
 }
 
 void JointSpaceTrackingData::CheckDerivedOscTrackingData() {
@@ -48,6 +48,7 @@ class JointSpaceTrackingData final : public OptionsTrackingData {
   void UpdateJdotV(const Eigen::VectorXd& x_wo_spr,
                    const drake::systems::Context<double>& context_wo_spr) final;
 
+  std::vector<int> CalcJColumnSupport(int fsm_state) const final;
   void CheckDerivedOscTrackingData() final;
 
   // `joint_pos_idx_wo_spr` is the index of the joint position
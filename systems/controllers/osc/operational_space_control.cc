@@ -1,5 +1,6 @@
 #include "systems/controllers/osc/operational_space_control.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include <drake/multibody/plant/multibody_plant.h>
@@ -7,6 +8,7 @@
 #include "common/eigen_utils.h"
 #include "multibody/multibody_utils.h"
 
+#include "drake/common/drake_throw.h"
 #include "drake/common/text_logging.h"
 
 using std::cout;
@@ -47,7 +49,8 @@ using multibody::SetPositionsIfNew;
 using multibody::SetVelocitiesIfNew;
 using multibody::WorldPointEvaluator;
 
-OperationalSpaceControl::OperationalSpaceControl(
+template <int kNq, int kNv, int kNu, int kNc>
+SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::SizedOperationalSpaceControl(
     const MultibodyPlant<double>& plant_w_spr,
     const MultibodyPlant<double>& plant_wo_spr,
     drake::systems::Context<double>* context_w_spr,
@@ -65,6 +68,10 @@ OperationalSpaceControl::OperationalSpaceControl(
   n_q_ = plant_wo_spr.num_positions();
   n_v_ = plant_wo_spr.num_velocities();
   n_u_ = plant_wo_spr.num_actuators();
+  // The sizes fixed at compile time must match the plant without springs
+  DRAKE_THROW_UNLESS(kNq == Eigen::Dynamic || kNq == n_q_);
+  DRAKE_THROW_UNLESS(kNv == Eigen::Dynamic || kNv == n_v_);
+  DRAKE_THROW_UNLESS(kNu == Eigen::Dynamic || kNu == n_u_);
 
   int n_q_w_spr = plant_w_spr.num_positions();
   int n_v_w_spr = plant_w_spr.num_velocities();
@@ -87,24 +94,28 @@ OperationalSpaceControl::OperationalSpaceControl(
 
     // Discrete update to record the last state event time
     DeclarePerStepDiscreteUpdateEvent(
-        &OperationalSpaceControl::DiscreteVariableUpdate);
+        &SizedOperationalSpaceControl::DiscreteVariableUpdate);
     prev_fsm_state_idx_ = this->DeclareDiscreteState(-0.1 * VectorXd::Ones(1));
     prev_event_time_idx_ = this->DeclareDiscreteState(VectorXd::Zero(1));
   }
 
   osc_output_port_ = this->DeclareVectorOutputPort(
                              "u, t", TimestampedVector<double>(n_u_w_spr),
-                             &OperationalSpaceControl::CalcOptimalInput)
+                             &SizedOperationalSpaceControl::CalcOptimalInput)
                          .get_index();
-  osc_debug_port_ =
-      this->DeclareAbstractOutputPort(
-              "lcmt_osc_debug", &OperationalSpaceControl::AssignOscLcmOutput)
-          .get_index();
+  osc_debug_port_ = this->DeclareAbstractOutputPort(
+                            "lcmt_osc_debug",
+                            &SizedOperationalSpaceControl::AssignOscLcmOutput)
+                        .get_index();
 
   failure_port_ = this->DeclareVectorOutputPort(
                           "failure_signal", TimestampedVector<double>(1),
-                          &OperationalSpaceControl::CheckTracking)
+                          &SizedOperationalSpaceControl::CheckTracking)
                       .get_index();
+  timing_port_ = this->DeclareAbstractOutputPort(
+                         "lcmt_stage_timing",
+                         &SizedOperationalSpaceControl::AssignTimingOutput)
+                     .get_index();
 
   const std::map<string, int>& vel_map_wo_spr =
       multibody::MakeNameToVelocitiesMap(plant_wo_spr);
@@ -161,9 +172,11 @@ OperationalSpaceControl::OperationalSpaceControl(
 }
 
 // Optional features
-void OperationalSpaceControl::SetUpDoubleSupportPhaseBlending(
-    double ds_duration, int left_support_state, int right_support_state,
-    const std::vector<int>& ds_states) {
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::
+    SetUpDoubleSupportPhaseBlending(double ds_duration, int left_support_state,
+                                    int right_support_state,
+                                    const std::vector<int>& ds_states) {
   DRAKE_DEMAND(ds_duration > 0);
   DRAKE_DEMAND(!ds_states.empty());
   ds_duration_ = ds_duration;
@@ -172,8 +185,10 @@ void OperationalSpaceControl::SetUpDoubleSupportPhaseBlending(
   ds_states_ = ds_states;
 }
 
-void OperationalSpaceControl::SetInputCostForJointAndFsmStateWeight(
-    const std::string& joint_u_name, int fsm, double w) {
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::
+    SetInputCostForJointAndFsmStateWeight(const std::string& joint_u_name,
+                                          int fsm, double w) {
   if (W_input_.size() == 0) {
     W_input_ = Eigen::MatrixXd::Zero(n_u_, n_u_);
   }
@@ -182,13 +197,15 @@ void OperationalSpaceControl::SetInputCostForJointAndFsmStateWeight(
 }
 
 // Constraint methods
-void OperationalSpaceControl::AddContactPoint(
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::AddContactPoint(
     const WorldPointEvaluator<double>* evaluator) {
   single_contact_mode_ = true;
   AddStateAndContactPoint(-1, evaluator);
 }
 
-void OperationalSpaceControl::AddStateAndContactPoint(
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::AddStateAndContactPoint(
     int state, const WorldPointEvaluator<double>* evaluator) {
   DRAKE_DEMAND(&evaluator->plant() == &plant_wo_spr_);
 
@@ -212,14 +229,16 @@ void OperationalSpaceControl::AddStateAndContactPoint(
   }
 }
 
-void OperationalSpaceControl::AddKinematicConstraint(
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::AddKinematicConstraint(
     const multibody::KinematicEvaluatorSet<double>* evaluators) {
   DRAKE_DEMAND(&evaluators->plant() == &plant_wo_spr_);
   kinematic_evaluators_ = evaluators;
 }
 
 // Tracking data methods
-void OperationalSpaceControl::AddTrackingData(
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::AddTrackingData(
     std::unique_ptr<OscTrackingData> tracking_data, double t_lb, double t_ub) {
   tracking_data_vec_->push_back(std::move(tracking_data));
   fixed_position_vec_.emplace_back(VectorXd::Zero(0));
@@ -240,7 +259,8 @@ void OperationalSpaceControl::AddTrackingData(
     traj_name_to_port_index_map_[traj_name] = port_index;
   }
 }
-void OperationalSpaceControl::AddConstTrackingData(
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::AddConstTrackingData(
     std::unique_ptr<OscTrackingData> tracking_data, const VectorXd& v,
     double t_lb, double t_ub) {
   tracking_data_vec_->push_back(std::move(tracking_data));
@@ -250,7 +270,8 @@ void OperationalSpaceControl::AddConstTrackingData(
 }
 
 // Osc checkers and constructor
-void OperationalSpaceControl::CheckCostSettings() {
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::CheckCostSettings() {
   if (W_input_.size() != 0) {
     DRAKE_DEMAND((W_input_.rows() == n_u_) && (W_input_.cols() == n_u_));
   }
@@ -263,7 +284,9 @@ void OperationalSpaceControl::CheckCostSettings() {
                  (W_joint_accel_.cols() == n_v_));
   }
 }
-void OperationalSpaceControl::CheckConstraintSettings() {
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::
+    CheckConstraintSettings() {
   if (!all_contacts_.empty()) {
     DRAKE_DEMAND(mu_ != -1);
   }
@@ -272,7 +295,8 @@ void OperationalSpaceControl::CheckConstraintSettings() {
   }
 }
 
-void OperationalSpaceControl::Build() {
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::Build() {
   // Checker
   CheckCostSettings();
   CheckConstraintSettings();
@@ -290,6 +314,7 @@ void OperationalSpaceControl::Build() {
              ? 0
              : kinematic_evaluators_->count_full();
   n_c_ = kSpaceDim * all_contacts_.size();
+  DRAKE_THROW_UNLESS(kNc == Eigen::Dynamic || kNc == n_c_);
   n_c_active_ = 0;
   for (auto evaluator : all_contacts_) {
     n_c_active_ += evaluator->num_active();
@@ -320,6 +345,125 @@ void OperationalSpaceControl::Build() {
   lambda_h_sol_->setZero();
   u_prev_->setZero();
 
+  if (w_joint_limit_ > 0) {
+    K_joint_pos_ = w_joint_limit_ * W_joint_accel_.bottomRightCorner(
+                                        n_revolute_joints_, n_revolute_joints_);
+  }
+
+  // Tracking cost accumulators
+  int max_ydot_dim = 0;
+  for (auto& tracking_data : *tracking_data_vec_) {
+    max_ydot_dim = std::max(max_ydot_dim, tracking_data->GetYdotDim());
+  }
+  tracking_cost_hessian_ = MatrixVV::Zero(n_v_, n_v_);
+  tracking_cost_gradient_ = VectorXd::Zero(n_v_);
+  tracking_WJ_ = MatrixXd::Zero(max_ydot_dim, n_v_);
+  tracking_Wc_ = VectorXd::Zero(max_ydot_dim);
+
+  // Impact-invariant projection, sized for every possible post-impact state
+  for (auto& tracking_data : *tracking_data_vec_) {
+    if (tracking_data->GetImpactInvariantProjection()) {
+      n_ii_ydot_ += tracking_data->GetYdotDim();
+    }
+  }
+  for (const auto& [fsm_state, contact_dim] : active_contact_dim_) {
+    const int n_lambda = contact_dim + n_h_;
+    ImpactInvariantWorkspace& workspace = ii_workspaces_[fsm_state];
+    workspace.J_next = MatrixXd::Zero(n_lambda, n_v_);
+    workspace.M_Jt = MatrixXd::Zero(n_v_, n_lambda);
+    workspace.A = MatrixXd::Zero(n_ii_ydot_, n_lambda);
+    workspace.ydot_err = VectorXd::Zero(n_ii_ydot_);
+    workspace.C = MatrixXd::Zero(n_h_, n_lambda);
+    workspace.d = VectorXd::Zero(n_h_);
+    workspace.A_constrained = MatrixXd::Zero(n_lambda + n_h_, n_lambda + n_h_);
+    workspace.b_constrained = VectorXd::Zero(n_lambda + n_h_);
+    workspace.A_constrained_cod =
+        Eigen::CompleteOrthogonalDecomposition<MatrixXd>(n_lambda + n_h_,
+                                                         n_lambda + n_h_);
+    workspace.lambda_sol = VectorXd::Zero(n_lambda + n_h_);
+  }
+
+  // Per-tick scratch space, so that the steady state tick does not allocate
+  // in the OSC's own code
+  x_w_spr_ = VectorXd::Zero(plant_w_spr_.num_positions() +
+                            plant_w_spr_.num_velocities());
+  x_wo_spr_ = VectorXd::Zero(n_q_ + n_v_);
+  v_proj_ = VectorXd::Zero(n_v_);
+  J_c_ = MatrixCV::Zero(n_c_, n_v_);
+  J_c_active_ = MatrixActiveCV::Zero(n_c_active_, n_v_);
+  JdotV_c_active_ = VectorActiveC::Zero(n_c_active_);
+  w_joint_limit_vec_ = VectorXd::Zero(n_revolute_joints_);
+  joint_limit_violation_ = VectorXd::Zero(n_revolute_joints_);
+  qp_cost_scratch_ = VectorXd::Zero(std::max({n_v_, n_u_, n_c_, n_h_}));
+  qp_cost_du_ = VectorXd::Zero(n_u_);
+  for (const auto& fixed_position : fixed_position_vec_) {
+    if (fixed_position.size() != 0) {
+      fixed_trajectories_.emplace_back(fixed_position);
+    } else {
+      fixed_trajectories_.emplace_back();
+    }
+  }
+
+  // Latency instrumentation
+  std::vector<std::string> stage_names = {
+      "context_update", "dynamics",      "impact_invariant_projection",
+      "jacobians",      "tracking_cost", "qp_assembly",
+      "qp_solve",       "lcm_output"};
+  for (auto& tracking_data : *tracking_data_vec_) {
+    stage_names.push_back("tracking_data/" + tracking_data->GetName());
+  }
+  stage_timer_ = std::make_unique<StageTimer>(stage_names);
+
+  dynamics_cache_ = std::make_unique<SizedOscDynamicsCache<kNv, kNu>>(
+      plant_wo_spr_, context_wo_spr_, all_contacts_, kinematic_evaluators_,
+      tracking_data_vec_->size());
+
+  solver_ = std::make_unique<dairlib::solvers::FastOsqpSolver>();
+
+  // The active-set solver and the snapshot log only read the matrices of the
+  // direct QP
+  DRAKE_DEMAND(qp_solver_ == OscQpSolver::kOsqp ||
+               qp_backend_ != OscQpBackend::kMathematicalProgram);
+  DRAKE_DEMAND(qp_snapshot_log_.empty() ||
+               qp_backend_ != OscQpBackend::kMathematicalProgram);
+  if (qp_backend_ != OscQpBackend::kMathematicalProgram) {
+    // The direct QP does not support the (testing) contact force blending
+    DRAKE_DEMAND(ds_duration_ <= 0);
+    direct_qp_ = std::make_unique<SizedOscDirectQp<kNv, kNu, kNc>>(
+        n_v_, n_u_, n_c_, n_h_, n_c_active_, w_soft_constraint_ > 0,
+        with_input_constraints_, qp_backend_ == OscQpBackend::kReduced);
+    direct_qp_->SetActuationMatrix(dynamics_cache_->B());
+    direct_qp_->SetFrictionCone(mu_);
+    direct_qp_->SetInputLimits(u_min_, u_max_);
+    direct_qp_sol_ = VectorXd::Zero(direct_qp_->num_vars());
+    direct_qp_full_sol_ = VectorXd::Zero(direct_qp_->num_full_vars());
+    if (qp_solver_ == OscQpSolver::kDenseActiveSet) {
+      active_set_solver_ = std::make_unique<solvers::DenseActiveSetQpSolver>(
+          direct_qp_->num_vars(), direct_qp_->A().rows());
+    }
+    if (!qp_snapshot_log_.empty()) {
+      qp_snapshot_writer_ =
+          std::make_unique<solvers::QpSnapshotWriter>(qp_snapshot_log_);
+    }
+    return;
+  }
+
+  ProgramWorkspace& workspace = program_workspace_;
+  workspace.A_dyn = MatrixXd::Zero(n_v_, n_v_ + n_c_ + n_h_ + n_u_);
+  workspace.b_dyn = VectorXd::Zero(n_v_);
+  workspace.b_h = VectorXd::Zero(n_h_);
+  workspace.A_c = MatrixXd::Zero(n_c_active_, n_v_ + n_c_active_);
+  workspace.A_c.rightCols(n_c_active_).setIdentity();
+  workspace.b_c = VectorXd::Zero(n_c_active_);
+  workspace.zeros = VectorXd::Zero(std::max({n_u_, n_c_, n_h_, 5}));
+  workspace.friction_lb_inactive =
+      VectorXd::Constant(5, -std::numeric_limits<double>::infinity());
+  workspace.A_blend = MatrixXd::Zero(1, 2 * n_c_ / kSpaceDim);
+  workspace.W_input = W_input_;
+  workspace.b_input_smoothing = VectorXd::Zero(n_u_);
+  workspace.W_lambda_c = W_lambda_c_reg_;
+  workspace.W_lambda_h = W_lambda_h_reg_;
+
   // Add decision variables
   dv_ = prog_->NewContinuousVariables(n_v_, "dv");
   u_ = prog_->NewContinuousVariables(n_u_, "u");
@@ -438,19 +582,17 @@ void OperationalSpaceControl::Build() {
   }
 
   // 4. Tracking cost
-  for (unsigned int i = 0; i < tracking_data_vec_->size(); i++) {
-    tracking_costs_.push_back(prog_
-                                  ->AddQuadraticCost(MatrixXd::Zero(n_v_, n_v_),
-                                                     VectorXd::Zero(n_v_), dv_)
-                                  .evaluator()
-                                  .get());
+  if (!tracking_data_vec_->empty()) {
+    tracking_cost_ = prog_
+                         ->AddQuadraticCost(MatrixXd::Zero(n_v_, n_v_),
+                                            VectorXd::Zero(n_v_), dv_)
+                         .evaluator()
+                         .get();
   }
 
   // 5. Joint Limit cost
   // TODO(yangwill) discuss best way to implement joint limit cost
   if (w_joint_limit_ > 0) {
-    K_joint_pos_ = w_joint_limit_ * W_joint_accel_.bottomRightCorner(
-                                        n_revolute_joints_, n_revolute_joints_);
     joint_limit_cost_ = prog_
                             ->AddLinearCost(VectorXd::Zero(n_revolute_joints_),
                                             0, dv_.tail(n_revolute_joints_))
@@ -482,25 +624,26 @@ void OperationalSpaceControl::Build() {
     prog_->AddBoundingBoxConstraint(0, 0, epsilon_blend_);
   }
 
-  solver_ = std::make_unique<dairlib::solvers::FastOsqpSolver>();
   prog_->SetSolverOptions(solver_options_);
 }
 
-drake::systems::EventStatus OperationalSpaceControl::DiscreteVariableUpdate(
+template <int kNq, int kNv, int kNu, int kNc>
+drake::systems::EventStatus
+SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::DiscreteVariableUpdate(
     const drake::systems::Context<double>& context,
     drake::systems::DiscreteValues<double>* discrete_state) const {
   const BasicVector<double>* fsm_output =
       (BasicVector<double>*)this->EvalVectorInput(context, fsm_port_);
-  VectorXd fsm_state = fsm_output->get_value();
+  const double fsm_state = fsm_output->get_value()(0);
   const OutputVector<double>* robot_output =
       (OutputVector<double>*)this->EvalVectorInput(context, state_port_);
   double timestamp = robot_output->get_timestamp();
 
   auto prev_fsm_state = discrete_state->get_mutable_vector(prev_fsm_state_idx_)
                             .get_mutable_value();
-  if (fsm_state(0) != prev_fsm_state(0)) {
+  if (fsm_state != prev_fsm_state(0)) {
     prev_distinct_fsm_state_ = prev_fsm_state(0);
-    prev_fsm_state(0) = fsm_state(0);
+    prev_fsm_state(0) = fsm_state;
 
     discrete_state->get_mutable_vector(prev_event_time_idx_).get_mutable_value()
         << timestamp;
@@ -508,18 +651,22 @@ drake::systems::EventStatus OperationalSpaceControl::DiscreteVariableUpdate(
   return drake::systems::EventStatus::Succeeded();
 }
 
-VectorXd OperationalSpaceControl::SolveQp(
+template <int kNq, int kNv, int kNu, int kNc>
+const VectorXd& SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::SolveQp(
     const VectorXd& x_w_spr, const VectorXd& x_wo_spr,
     const drake::systems::Context<double>& context, double t, int fsm_state,
     double t_since_last_state_switch, double alpha, int next_fsm_state) const {
+  stage_timer_->BeginTick();
+
   // Get active contact indices
-  std::set<int> active_contact_set = {};
+  static const std::set<int> kNoContacts;
+  const std::set<int>* active_contacts = &kNoContacts;
   if (single_contact_mode_) {
-    active_contact_set = contact_indices_map_.at(-1);
+    active_contacts = &contact_indices_map_.at(-1);
   } else {
     auto map_iterator = contact_indices_map_.find(fsm_state);
     if (map_iterator != contact_indices_map_.end()) {
-      active_contact_set = map_iterator->second;
+      active_contacts = &map_iterator->second;
     } else {
       static const drake::logging::Warn log_once(const_cast<char*>(
           (std::to_string(fsm_state) +
@@ -528,6 +675,12 @@ VectorXd OperationalSpaceControl::SolveQp(
               .c_str()));
     }
   }
+  const std::set<int>& active_contact_set = *active_contacts;
+  int contact_mode = 0;
+  for (int i : active_contact_set) {
+    contact_mode |= 1 << i;
+  }
+  solver_->SetWarmStartKey(contact_mode);
 
   // Update context
   SetPositionsIfNew<double>(
@@ -541,193 +694,221 @@ VectorXd OperationalSpaceControl::SolveQp(
   SetVelocitiesIfNew<double>(plant_wo_spr_,
                              x_wo_spr.tail(plant_wo_spr_.num_velocities()),
                              context_wo_spr_);
+  dynamics_cache_->Invalidate();
+  stage_timer_->Lap(kContextUpdate);
 
-  // Get M, f_cg, B matrices of the manipulator equation
-  MatrixXd B = plant_wo_spr_.MakeActuationMatrix();
-  MatrixXd M(n_v_, n_v_);
-  plant_wo_spr_.CalcMassMatrix(*context_wo_spr_, &M);
-  VectorXd bias(n_v_);
-  plant_wo_spr_.CalcBiasTerm(*context_wo_spr_, &bias);
-  drake::multibody::MultibodyForces<double> f_app(plant_wo_spr_);
-  plant_wo_spr_.CalcForceElementsContribution(*context_wo_spr_, &f_app);
-  VectorXd grav = plant_wo_spr_.CalcGravityGeneralizedForces(*context_wo_spr_);
-  bias = bias - grav;
-  // TODO (yangwill): Characterize damping in cassie model
-  //  std::cout << f_app.generalized_forces().transpose() << std::endl;
-  //  bias = bias - f_app.generalized_forces();
+  // Get M, f_cg, B matrices of the manipulator equation. These are computed
+  // once per tick and shared with the impact-invariant projection.
+  const MatrixVU& B = dynamics_cache_->B();
+  const MatrixVV& M = dynamics_cache_->M();
+  const VectorV& bias = dynamics_cache_->bias();
+  stage_timer_->Lap(kDynamics);
 
   //  Invariant Impacts
   //  Only update when near an impact
   bool near_impact = alpha != 0;
-  VectorXd v_proj = VectorXd::Zero(n_v_);
+  VectorXd& v_proj = v_proj_;
+  v_proj.setZero();
   if (near_impact) {
     UpdateImpactInvariantProjection(x_w_spr, x_wo_spr, context, t,
                                     t_since_last_state_switch, fsm_state,
-                                    next_fsm_state, M);
-    // Need to call Update before this to get the updated jacobian
-    v_proj = alpha * M_Jt_ * ii_lambda_sol_ + 1e-13 * VectorXd::Ones(n_v_);
+                                    next_fsm_state, alpha, &v_proj);
+    v_proj.array() += 1e-13;
   }
+  stage_timer_->Lap(kImpactInvariantProjection);
 
   // Get J and JdotV for holonomic constraint
-  MatrixXd J_h(n_h_, n_v_);
-  VectorXd JdotV_h(n_h_);
-  if (kinematic_evaluators_ != nullptr) {
-    J_h = kinematic_evaluators_->EvalFullJacobian(*context_wo_spr_);
-    JdotV_h =
-        kinematic_evaluators_->EvalFullJacobianDotTimesV(*context_wo_spr_);
-  }
+  const MatrixHV& J_h = dynamics_cache_->J_h();
+  const VectorXd& JdotV_h = dynamics_cache_->JdotV_h();
 
   // Get J for external forces in equations of motion
-  MatrixXd J_c = MatrixXd::Zero(n_c_, n_v_);
+  MatrixCV& J_c = J_c_;
+  J_c.setZero();
   for (unsigned int i = 0; i < all_contacts_.size(); i++) {
     if (active_contact_set.find(i) != active_contact_set.end()) {
       J_c.block(kSpaceDim * i, 0, kSpaceDim, n_v_) =
-          all_contacts_[i]->EvalFullJacobian(*context_wo_spr_);
+          dynamics_cache_->J_contact(i);
     }
   }
 
   // Get J and JdotV for contact constraint
-  MatrixXd J_c_active = MatrixXd::Zero(n_c_active_, n_v_);
-  VectorXd JdotV_c_active = VectorXd::Zero(n_c_active_);
+  MatrixActiveCV& J_c_active = J_c_active_;
+  VectorActiveC& JdotV_c_active = JdotV_c_active_;
+  J_c_active.setZero();
+  JdotV_c_active.setZero();
   int row_idx = 0;
   for (unsigned int i = 0; i < all_contacts_.size(); i++) {
     auto contact_i = all_contacts_[i];
     if (active_contact_set.find(i) != active_contact_set.end()) {
       // We don't call EvalActiveJacobian() because it'll repeat the computation
       // of the Jacobian. (J_c_active is just a stack of slices of J_c)
+      const Eigen::Vector3d& JdotV_i = dynamics_cache_->JdotV_contact(i);
       for (int j = 0; j < contact_i->num_active(); j++) {
         J_c_active.row(row_idx + j) =
             J_c.row(kSpaceDim * i + contact_i->active_inds().at(j));
+        JdotV_c_active(row_idx + j) = JdotV_i(contact_i->active_inds().at(j));
       }
-      JdotV_c_active.segment(row_idx, contact_i->num_active()) =
-          contact_i->EvalActiveJacobianDotTimesV(*context_wo_spr_);
     }
     row_idx += contact_i->num_active();
   }
+  stage_timer_->Lap(kJacobians);
 
-  // Update constraints
-  // 1. Dynamics constraint
-  ///    M*dv + bias == J_c^T*lambda_c + J_h^T*lambda_h + B*u
-  /// -> M*dv - J_c^T*lambda_c - J_h^T*lambda_h - B*u == - bias
-  /// -> [M, -J_c^T, -J_h^T, -B]*[dv, lambda_c, lambda_h, u]^T = - bias
-  MatrixXd A_dyn = MatrixXd::Zero(n_v_, n_v_ + n_c_ + n_h_ + n_u_);
-  A_dyn.block(0, 0, n_v_, n_v_) = M;
-  A_dyn.block(0, n_v_, n_v_, n_c_) = -J_c.transpose();
-  A_dyn.block(0, n_v_ + n_c_, n_v_, n_h_) = -J_h.transpose();
-  A_dyn.block(0, n_v_ + n_c_ + n_h_, n_v_, n_u_) = -B;
-  dynamics_constraint_->UpdateCoefficients(A_dyn, -bias);
-  // 2. Holonomic constraint
-  ///    JdotV_h + J_h*dv == 0
-  /// -> J_h*dv == -JdotV_h
-  if (n_h_ > 0) {
-    holonomic_constraint_->UpdateCoefficients(J_h, -JdotV_h);
-  }
-  // 3. Contact constraint
-  if (!all_contacts_.empty()) {
-    if (w_soft_constraint_ <= 0) {
-      ///    JdotV_c_active + J_c_active*dv == 0
-      /// -> J_c_active*dv == -JdotV_c_active
-      contact_constraints_->UpdateCoefficients(J_c_active, -JdotV_c_active);
-    } else {
-      // Relaxed version:
-      ///    JdotV_c_active + J_c_active*dv == -epsilon
-      /// -> J_c_active*dv + I*epsilon == -JdotV_c_active
-      /// -> [J_c_active, I]* [dv, epsilon]^T == -JdotV_c_active
-      MatrixXd A_c = MatrixXd::Zero(n_c_active_, n_v_ + n_c_active_);
-      A_c.block(0, 0, n_c_active_, n_v_) = J_c_active;
-      A_c.block(0, n_v_, n_c_active_, n_c_active_) =
-          MatrixXd::Identity(n_c_active_, n_c_active_);
-      contact_constraints_->UpdateCoefficients(A_c, -JdotV_c_active);
+  if (qp_backend_ == OscQpBackend::kReduced) {
+    direct_qp_->SetReducedDynamics(dynamics_cache_->M_llt(), J_c, J_h,
+                                   JdotV_h, bias);
+  } else if (qp_backend_ == OscQpBackend::kDirect) {
+    direct_qp_->SetDynamics(M, J_c, J_h, bias);
+    if (n_h_ > 0) {
+      direct_qp_->SetHolonomicConstraint(J_h, JdotV_h);
     }
   }
-  // 4. Friction constraint (approximated friction cone)
-  /// For i = active contact indices
-  ///     mu_*lambda_c(3*i+2) >= lambda_c(3*i+0)
-  ///    -mu_*lambda_c(3*i+2) <= lambda_c(3*i+0)
-  ///     mu_*lambda_c(3*i+2) >= lambda_c(3*i+1)
-  ///    -mu_*lambda_c(3*i+2) <= lambda_c(3*i+1)
-  ///         lambda_c(3*i+2) >= 0
-  /// ->
-  ///     mu_*lambda_c(3*i+2) - lambda_c(3*i+0) >= 0
-  ///     mu_*lambda_c(3*i+2) + lambda_c(3*i+0) >= 0
-  ///     mu_*lambda_c(3*i+2) - lambda_c(3*i+1) >= 0
-  ///     mu_*lambda_c(3*i+2) + lambda_c(3*i+1) >= 0
-  ///                           lambda_c(3*i+2) >= 0
-  if (!all_contacts_.empty()) {
+  if (qp_backend_ != OscQpBackend::kMathematicalProgram) {
+    if (!all_contacts_.empty()) {
+      direct_qp_->SetContactConstraint(J_c_active, JdotV_c_active);
+    }
     for (unsigned int i = 0; i < all_contacts_.size(); i++) {
-      if (active_contact_set.find(i) != active_contact_set.end()) {
-        friction_constraints_.at(i)->UpdateLowerBound(VectorXd::Zero(5));
+      direct_qp_->SetFrictionConeActive(
+          i, active_contact_set.find(i) != active_contact_set.end());
+    }
+    direct_qp_->ClearCosts();
+  } else {
+    // The coefficients are written into program_workspace_; only the
+    // UpdateCoefficients() calls themselves allocate (inside drake)
+    ProgramWorkspace& workspace = program_workspace_;
+    // Update constraints
+    // 1. Dynamics constraint
+    ///    M*dv + bias == J_c^T*lambda_c + J_h^T*lambda_h + B*u
+    /// -> M*dv - J_c^T*lambda_c - J_h^T*lambda_h - B*u == - bias
+    /// -> [M, -J_c^T, -J_h^T, -B]*[dv, lambda_c, lambda_h, u]^T = - bias
+    MatrixXd& A_dyn = workspace.A_dyn;
+    A_dyn.block(0, 0, n_v_, n_v_) = M;
+    A_dyn.block(0, n_v_, n_v_, n_c_) = -J_c.transpose();
+    A_dyn.block(0, n_v_ + n_c_, n_v_, n_h_) = -J_h.transpose();
+    A_dyn.block(0, n_v_ + n_c_ + n_h_, n_v_, n_u_) = -B;
+    workspace.b_dyn = -bias;
+    dynamics_constraint_->UpdateCoefficients(A_dyn, workspace.b_dyn);
+    // 2. Holonomic constraint
+    ///    JdotV_h + J_h*dv == 0
+    /// -> J_h*dv == -JdotV_h
+    if (n_h_ > 0) {
+      workspace.b_h = -JdotV_h;
+      holonomic_constraint_->UpdateCoefficients(J_h, workspace.b_h);
+    }
+    // 3. Contact constraint
+    if (!all_contacts_.empty()) {
+      workspace.b_c = -JdotV_c_active;
+      if (w_soft_constraint_ <= 0) {
+        ///    JdotV_c_active + J_c_active*dv == 0
+        /// -> J_c_active*dv == -JdotV_c_active
+        contact_constraints_->UpdateCoefficients(J_c_active, workspace.b_c);
       } else {
-        friction_constraints_.at(i)->UpdateLowerBound(
-            VectorXd::Constant(5, -std::numeric_limits<double>::infinity()));
+        // Relaxed version:
+        ///    JdotV_c_active + J_c_active*dv == -epsilon
+        /// -> J_c_active*dv + I*epsilon == -JdotV_c_active
+        /// -> [J_c_active, I]* [dv, epsilon]^T == -JdotV_c_active
+        workspace.A_c.leftCols(n_v_) = J_c_active;
+        contact_constraints_->UpdateCoefficients(workspace.A_c, workspace.b_c);
+      }
+    }
+    // 4. Friction constraint (approximated friction cone)
+    /// For i = active contact indices
+    ///     mu_*lambda_c(3*i+2) >= lambda_c(3*i+0)
+    ///    -mu_*lambda_c(3*i+2) <= lambda_c(3*i+0)
+    ///     mu_*lambda_c(3*i+2) >= lambda_c(3*i+1)
+    ///    -mu_*lambda_c(3*i+2) <= lambda_c(3*i+1)
+    ///         lambda_c(3*i+2) >= 0
+    /// ->
+    ///     mu_*lambda_c(3*i+2) - lambda_c(3*i+0) >= 0
+    ///     mu_*lambda_c(3*i+2) + lambda_c(3*i+0) >= 0
+    ///     mu_*lambda_c(3*i+2) - lambda_c(3*i+1) >= 0
+    ///     mu_*lambda_c(3*i+2) + lambda_c(3*i+1) >= 0
+    ///                           lambda_c(3*i+2) >= 0
+    if (!all_contacts_.empty()) {
+      for (unsigned int i = 0; i < all_contacts_.size(); i++) {
+        if (active_contact_set.find(i) != active_contact_set.end()) {
+          friction_constraints_.at(i)->UpdateLowerBound(
+              workspace.zeros.head(5));
+        } else {
+          friction_constraints_.at(i)->UpdateLowerBound(
+              workspace.friction_lb_inactive);
+        }
       }
     }
   }
 
   // Update costs
   // 4. Tracking cost
+  // All active tracking costs are accumulated in the upper triangle of a
+  // single Hessian (the dv block of the direct QP's Hessian for the direct
+  // backend).
+  MatrixVV* tracking_hessian = (direct_qp_ != nullptr)
+                                   ? &direct_qp_->mutable_H_dv()
+                                   : &tracking_cost_hessian_;
+  Eigen::Ref<VectorXd> tracking_gradient =
+      (direct_qp_ != nullptr)
+          ? direct_qp_->mutable_q().segment(direct_qp_->dv_start(), n_v_)
+          : tracking_cost_gradient_.head(n_v_);
+  double tracking_cost_constant = 0;
+  if (qp_backend_ == OscQpBackend::kMathematicalProgram) {
+    tracking_cost_hessian_.setZero();
+    tracking_cost_gradient_.setZero();
+  }
   for (unsigned int i = 0; i < tracking_data_vec_->size(); i++) {
     auto tracking_data = tracking_data_vec_->at(i).get();
 
     if (tracking_data->IsActive(fsm_state) &&
         t_since_last_state_switch >= t_s_vec_.at(i) &&
         t_since_last_state_switch <= t_e_vec_.at(i)) {
-      // Check whether or not it is a constant trajectory, and update
-      // TrackingData
-      if (fixed_position_vec_.at(i).size() != 0) {
-        // Create constant trajectory and update
-        tracking_data->Update(
-            x_w_spr, *context_w_spr_, x_wo_spr, *context_wo_spr_,
-            PiecewisePolynomial<double>(fixed_position_vec_.at(i)), t,
-            t_since_last_state_switch, fsm_state, v_proj);
-      } else {
-        // Read in traj from input port
-        const string& traj_name = tracking_data->GetName();
-        int port_index = traj_name_to_port_index_map_.at(traj_name);
-        const drake::AbstractValue* input_traj =
-            this->EvalAbstractInput(context, port_index);
-        DRAKE_DEMAND(input_traj != nullptr);
-        const auto& traj =
-            input_traj->get_value<drake::trajectories::Trajectory<double>>();
-        // Update
-        tracking_data->Update(x_w_spr, *context_w_spr_, x_wo_spr,
-                              *context_wo_spr_, traj, t,
-                              t_since_last_state_switch, fsm_state, v_proj);
+      stage_timer_->Lap(kQpAssembly);
+      // The kinematics may already have been updated for the
+      // impact-invariant projection
+      UpdateTrackingDataKinematics(i, x_w_spr, x_wo_spr, context, t,
+                                   t_since_last_state_switch, fsm_state);
+      tracking_data->UpdateCommand(t, t_since_last_state_switch, v_proj);
+      stage_timer_->Lap(kNumFixedStages + i);
+
+      AddTrackingCost(*tracking_data, tracking_hessian, tracking_gradient);
+      const int n_ydot = tracking_data->GetYdotDim();
+      tracking_cost_constant +=
+          (tracking_data->GetJdotTimesV() - tracking_data->GetYddotCommand())
+              .dot(tracking_Wc_.head(n_ydot));
+      stage_timer_->Lap(kTrackingCost);
+    }
+  }
+  if (tracking_cost_ != nullptr) {
+    // QuadraticCost expects the full (symmetric) Hessian
+    for (int j = 0; j < n_v_; ++j) {
+      for (int i = j + 1; i < n_v_; ++i) {
+        tracking_cost_hessian_(i, j) = tracking_cost_hessian_(j, i);
       }
-
-      const VectorXd& ddy_t = tracking_data->GetYddotCommand();
-      const MatrixXd& W = tracking_data->GetWeight();
-      const MatrixXd& J_t = tracking_data->GetJ();
-      const VectorXd& JdotV_t = tracking_data->GetJdotTimesV();
-      const VectorXd constant_term = (JdotV_t - ddy_t);
-
-      tracking_costs_.at(i)->UpdateCoefficients(
-          2 * J_t.transpose() * W * J_t,
-          2 * J_t.transpose() * W * (JdotV_t - ddy_t),
-          constant_term.transpose() * W * constant_term, true);
-    } else {
-      tracking_costs_.at(i)->UpdateCoefficients(MatrixXd::Zero(n_v_, n_v_),
-                                                VectorXd::Zero(n_v_));
     }
+    tracking_cost_->UpdateCoefficients(tracking_cost_hessian_,
+                                       tracking_cost_gradient_,
+                                       tracking_cost_constant, true);
+    stage_timer_->Lap(kTrackingCost);
   }
 
   // Add joint limit constraints
   if (w_joint_limit_ > 0) {
-    VectorXd w_joint_limit =
-        K_joint_pos_ * (x_wo_spr.head(plant_wo_spr_.num_positions())
-                            .tail(n_revolute_joints_) -
-                        q_max_)
-                           .cwiseMax(0) +
-        K_joint_pos_ * (x_wo_spr.head(plant_wo_spr_.num_positions())
-                            .tail(n_revolute_joints_) -
-                        q_min_)
-                           .cwiseMin(0);
-    joint_limit_cost_->UpdateCoefficients(w_joint_limit, 0);
+    VectorXd& w_joint_limit = w_joint_limit_vec_;
+    const auto q_joints =
+        x_wo_spr.head(plant_wo_spr_.num_positions()).tail(n_revolute_joints_);
+    joint_limit_violation_ =
+        (q_joints - q_max_).cwiseMax(0) + (q_joints - q_min_).cwiseMin(0);
+    w_joint_limit.noalias() = K_joint_pos_ * joint_limit_violation_;
+    if (direct_qp_ != nullptr) {
+      direct_qp_->mutable_q().segment(direct_qp_->dv_start() + n_v_ -
+                                          n_revolute_joints_,
+                                      n_revolute_joints_) += w_joint_limit;
+    } else {
+      joint_limit_cost_->UpdateCoefficients(w_joint_limit, 0);
+    }
   }
 
   // (Testing) 6. blend contact forces during double support phase
   if (ds_duration_ > 0) {
-    MatrixXd A = MatrixXd::Zero(1, 2 * n_c_ / kSpaceDim);
+    MatrixXd& A = program_workspace_.A_blend;
+    A.setZero();
     if (std::find(ds_states_.begin(), ds_states_.end(), fsm_state) !=
         ds_states_.end()) {
       double alpha_left = 0;
@@ -752,44 +933,56 @@ VectorXd OperationalSpaceControl::SolveQp(
       A(0, 6) = 1;
       A(0, 7) = 1;
     }
-    blend_constraint_->UpdateCoefficients(A, VectorXd::Zero(1));
+    blend_constraint_->UpdateCoefficients(A, program_workspace_.zeros.head(1));
+  }
+
+  if (direct_qp_ != nullptr) {
+    return SolveDirectQp(t, fsm_state, alpha);
   }
 
+  ProgramWorkspace& workspace = program_workspace_;
   // test joint-level input cost by fsm state
   if (!fsm_to_w_input_map_.empty()) {
-    MatrixXd W = W_input_;
+    MatrixXd& W = workspace.W_input;
+    W = W_input_;
     if (fsm_to_w_input_map_.count(fsm_state)) {
       int j = fsm_to_w_input_map_.at(fsm_state).first;
       double w = fsm_to_w_input_map_.at(fsm_state).second;
       W(j, j) += w;
     }
-    input_cost_->UpdateCoefficients(W, VectorXd::Zero(n_u_));
+    input_cost_->UpdateCoefficients(W, workspace.zeros.head(n_u_));
   }
 
   // (Testing) 7. Cost for staying close to the previous input
   if (W_input_smoothing_.size() > 0 && u_prev_) {
-    input_smoothing_cost_->UpdateCoefficients(
-        W_input_smoothing_, -W_input_smoothing_ * *u_prev_,
-        0.5 * u_prev_->transpose() * W_input_smoothing_ * *u_prev_);
+    VectorXd& b = workspace.b_input_smoothing;
+    b.noalias() = W_input_smoothing_ * *u_prev_;
+    const double c = 0.5 * u_prev_->dot(b);
+    b *= -1;
+    input_smoothing_cost_->UpdateCoefficients(W_input_smoothing_, b, c);
   }
 
   if (W_lambda_c_reg_.size() > 0) {
-    lambda_c_cost_->UpdateCoefficients((1 + alpha) * W_lambda_c_reg_,
-                                       VectorXd::Zero(n_c_));
+    workspace.W_lambda_c = (1 + alpha) * W_lambda_c_reg_;
+    lambda_c_cost_->UpdateCoefficients(workspace.W_lambda_c,
+                                       workspace.zeros.head(n_c_));
   }
 
   if (W_lambda_h_reg_.size() > 0) {
-    lambda_h_cost_->UpdateCoefficients((1 + alpha) * W_lambda_h_reg_,
-                                       VectorXd::Zero(n_h_));
+    workspace.W_lambda_h = (1 + alpha) * W_lambda_h_reg_;
+    lambda_h_cost_->UpdateCoefficients(workspace.W_lambda_h,
+                                       workspace.zeros.head(n_h_));
   }
   if (!solver_->IsInitialized()) {
     solver_->InitializeSolver(*prog_, solver_options_);
   }
+  stage_timer_->Lap(kQpAssembly);
 
   // Solve the QP
   MathematicalProgramResult result;
   result = solver_->Solve(*prog_);
   solve_time_ = result.get_solver_details<OsqpSolver>().run_time;
+  stage_timer_->Lap(kQpSolve);
 
   if (result.is_success()) {
     // Extract solutions
@@ -807,108 +1000,286 @@ VectorXd OperationalSpaceControl::SolveQp(
       tracking_data->StoreYddotCommandSol(*dv_sol_);
     }
   }
+  stage_timer_->Lap(kQpAssembly);
 
   return *u_sol_;
 }
 
-void OperationalSpaceControl::UpdateImpactInvariantProjection(
-    const VectorXd& x_w_spr, const VectorXd& x_wo_spr,
-    const Context<double>& context, double t, double t_since_last_state_switch,
-    int fsm_state, int next_fsm_state, const MatrixXd& M) const {
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::AddTrackingCost(
+    const OscTrackingData& tracking_data, MatrixVV* H,
+    Eigen::Ref<VectorXd> g) const {
+  const MatrixXd& W = tracking_data.GetWeight();
+  const MatrixXd& J = tracking_data.GetJ();
+  const std::vector<int>& support = tracking_data.GetJColumnSupport();
+  const int n_ydot = tracking_data.GetYdotDim();
+  const int n_support = support.size();
+
+  // W*J and W*(JdotV - yddot_cmd), restricted to the nonzero columns of J
+  for (int k = 0; k < n_support; ++k) {
+    tracking_WJ_.col(k).head(n_ydot).noalias() = W * J.col(support[k]);
+  }
+  tracking_Wc_.head(n_ydot).noalias() = W * tracking_data.GetJdotTimesV();
+  tracking_Wc_.head(n_ydot).noalias() -= W * tracking_data.GetYddotCommand();
+
+  // H += 2 J^T W J (upper triangle), g += 2 J^T W (JdotV - yddot_cmd)
+  for (int l = 0; l < n_support; ++l) {
+    const int col = support[l];
+    for (int k = 0; k <= l; ++k) {
+      (*H)(support[k], col) +=
+          2 * J.col(support[k]).dot(tracking_WJ_.col(l).head(n_ydot));
+    }
+    g(col) += 2 * J.col(col).dot(tracking_Wc_.head(n_ydot));
+  }
+}
+
+template <int kNq, int kNv, int kNu, int kNc>
+const VectorXd& SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::SolveDirectQp(
+    double t, int fsm_state, double alpha) const {
+  // The constraints and tracking costs have already been written into
+  // direct_qp_ by SolveQp. Add the regularization costs (same weights as the
+  // program costs in Build(), whose Hessians are scaled by 0.5 in the cost).
+  // Extra weight on one input in some fsm states
+  int w_input_index = -1;
+  double w_input_extra = 0;
+  if (W_input_.size() > 0) {
+    direct_qp_->mutable_H_u() += W_input_;
+    if (fsm_to_w_input_map_.count(fsm_state)) {
+      w_input_index = fsm_to_w_input_map_.at(fsm_state).first;
+      w_input_extra = fsm_to_w_input_map_.at(fsm_state).second;
+      direct_qp_->mutable_H_u()(w_input_index, w_input_index) += w_input_extra;
+    }
+  }
+  if (W_joint_accel_.size() > 0) {
+    direct_qp_->mutable_H_dv() += W_joint_accel_;
+  }
+  if (W_input_smoothing_.size() > 0) {
+    direct_qp_->mutable_H_u() += W_input_smoothing_;
+    direct_qp_->mutable_q().segment(direct_qp_->u_start(), n_u_).noalias() -=
+        W_input_smoothing_ * *u_prev_;
+  }
+  if (W_lambda_c_reg_.size() > 0) {
+    direct_qp_->mutable_H_lambda_c() += (1 + alpha) * W_lambda_c_reg_;
+  }
+  if (W_lambda_h_reg_.size() > 0) {
+    direct_qp_->mutable_H_lambda_h() += (1 + alpha) * W_lambda_h_reg_;
+  }
+  if (w_soft_constraint_ > 0) {
+    direct_qp_->mutable_H_epsilon_diagonal().array() += w_soft_constraint_;
+  }
+  direct_qp_->PackCosts();
+
+  if (active_set_solver_ == nullptr && !solver_->IsInitialized()) {
+    solver_->InitializeSolver(direct_qp_->P(), direct_qp_->q(),
+                              direct_qp_->A(), direct_qp_->l(),
+                              direct_qp_->u(), solver_options_);
+  }
+  if (qp_snapshot_writer_ != nullptr) {
+    if (active_set_solver_ == nullptr) {
+      solver_->GetWarmStart(&qp_snapshot_x_warm_, &qp_snapshot_y_warm_);
+    }
+    qp_snapshot_writer_->Write(t, fsm_state, direct_qp_->P(), direct_qp_->q(),
+                               direct_qp_->A(), direct_qp_->l(),
+                               direct_qp_->u(), qp_snapshot_x_warm_,
+                               qp_snapshot_y_warm_);
+  }
+
+  stage_timer_->Lap(kQpAssembly);
+
+  // Solve the QP
+  SolutionResult solution_result;
+  if (active_set_solver_ != nullptr) {
+    solution_result = active_set_solver_->Solve(
+        direct_qp_->P(), direct_qp_->q(), direct_qp_->A(), direct_qp_->l(),
+        direct_qp_->u(), &direct_qp_sol_, &active_set_details_);
+    solve_time_ = active_set_details_.run_time;
+  } else {
+    solution_result = solver_->SolveDirect(
+        direct_qp_->P(), direct_qp_->q(), direct_qp_->A(), direct_qp_->l(),
+        direct_qp_->u(), &direct_qp_sol_, &osqp_details_);
+    solve_time_ = osqp_details_.run_time;
+  }
+  stage_timer_->Lap(kQpSolve);
+
+  if (solution_result == SolutionResult::kSolutionFound) {
+    // Extract solutions (recovering dv and lambda_h for the reduced QP)
+    direct_qp_->GetFullSolution(direct_qp_sol_, &direct_qp_full_sol_);
+    const VectorXd& sol = direct_qp_full_sol_;
+    *dv_sol_ = sol.segment(direct_qp_->dv_start(), n_v_);
+    *u_sol_ = sol.segment(direct_qp_->u_start(), n_u_);
+    *lambda_c_sol_ = sol.segment(direct_qp_->lambda_c_start(), n_c_);
+    *lambda_h_sol_ = sol.segment(direct_qp_->lambda_h_start(), n_h_);
+    *epsilon_sol_ = sol.segment(direct_qp_->epsilon_start(), n_c_active_);
+  } else {
+    *u_prev_ = 0.99 * *u_sol_ + VectorXd::Random(n_u_);
+  }
+
+  // Regularization costs for the debug output
+  direct_qp_costs_ = DirectQpCosts();
+  // xᵀWx, with Wx written into preallocated scratch space
+  auto quadratic_form = [this](const MatrixXd& W, const VectorXd& x) {
+    auto Wx = qp_cost_scratch_.head(x.size());
+    Wx.noalias() = W * x;
+    return x.dot(Wx);
+  };
+  if (W_input_.size() > 0) {
+    direct_qp_costs_.input = 0.5 * quadratic_form(W_input_, *u_sol_);
+    if (w_input_index >= 0) {
+      direct_qp_costs_.input += 0.5 * w_input_extra *
+                                (*u_sol_)(w_input_index) *
+                                (*u_sol_)(w_input_index);
+    }
+  }
+  if (W_joint_accel_.size() > 0) {
+    direct_qp_costs_.acceleration =
+        0.5 * quadratic_form(W_joint_accel_, *dv_sol_);
+  }
+  if (W_input_smoothing_.size() > 0) {
+    qp_cost_du_ = *u_sol_ - *u_prev_;
+    direct_qp_costs_.input_smoothing =
+        0.5 * quadratic_form(W_input_smoothing_, qp_cost_du_);
+  }
+  if (W_lambda_c_reg_.size() > 0) {
+    direct_qp_costs_.lambda_c =
+        0.5 * (1 + alpha) * quadratic_form(W_lambda_c_reg_, *lambda_c_sol_);
+  }
+  if (W_lambda_h_reg_.size() > 0) {
+    direct_qp_costs_.lambda_h =
+        0.5 * (1 + alpha) * quadratic_form(W_lambda_h_reg_, *lambda_h_sol_);
+  }
+  if (w_soft_constraint_ > 0) {
+    direct_qp_costs_.soft_constraint =
+        0.5 * w_soft_constraint_ * epsilon_sol_->squaredNorm();
+  }
+
+  for (auto& tracking_data : *tracking_data_vec_) {
+    if (tracking_data->IsActive(fsm_state)) {
+      tracking_data->StoreYddotCommandSol(*dv_sol_);
+    }
+  }
+  stage_timer_->Lap(kQpAssembly);
+
+  return *u_sol_;
+}
+
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::
+    UpdateTrackingDataKinematics(int i, const VectorXd& x_w_spr,
+                                 const VectorXd& x_wo_spr,
+                                 const Context<double>& context, double t,
+                                 double t_since_last_state_switch,
+                                 int fsm_state) const {
+  if (dynamics_cache_->tracking_data_valid(i)) {
+    return;
+  }
+  auto tracking_data = tracking_data_vec_->at(i).get();
+  if (fixed_position_vec_.at(i).size() != 0) {
+    // Constant trajectory (built once in Build())
+    tracking_data->UpdateKinematics(
+        x_w_spr, *context_w_spr_, x_wo_spr, *context_wo_spr_,
+        fixed_trajectories_.at(i), t, t_since_last_state_switch, fsm_state);
+  } else {
+    // Read in traj from input port
+    const string& traj_name = tracking_data->GetName();
+    int port_index = traj_name_to_port_index_map_.at(traj_name);
+    const drake::AbstractValue* input_traj =
+        this->EvalAbstractInput(context, port_index);
+    DRAKE_DEMAND(input_traj != nullptr);
+    const auto& traj =
+        input_traj->get_value<drake::trajectories::Trajectory<double>>();
+    tracking_data->UpdateKinematics(x_w_spr, *context_w_spr_, x_wo_spr,
+                                    *context_wo_spr_, traj, t,
+                                    t_since_last_state_switch, fsm_state);
+  }
+  dynamics_cache_->set_tracking_data_valid(i);
+}
+
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::
+    UpdateImpactInvariantProjection(const VectorXd& x_w_spr,
+                                    const VectorXd& x_wo_spr,
+                                    const Context<double>& context, double t,
+                                    double t_since_last_state_switch,
+                                    int fsm_state, int next_fsm_state,
+                                    double alpha, VectorXd* v_proj) const {
   auto map_iterator = contact_indices_map_.find(next_fsm_state);
   if (map_iterator == contact_indices_map_.end()) {
-    ii_lambda_sol_ = VectorXd::Zero(n_c_ + n_h_);
-    M_Jt_ = MatrixXd::Zero(n_v_, n_c_ + n_h_);
     return;
   }
-  std::set<int> next_contact_set = map_iterator->second;
-  int active_constraint_dim = active_contact_dim_.at(next_fsm_state) + n_h_;
-  MatrixXd J_next = MatrixXd::Zero(active_constraint_dim, n_v_);
+  const std::set<int>& next_contact_set = map_iterator->second;
+  ImpactInvariantWorkspace& workspace = ii_workspaces_.at(next_fsm_state);
+  int active_constraint_dim = workspace.J_next.rows();
+  MatrixXd& J_next = workspace.J_next;
   int row_start = 0;
   for (unsigned int i = 0; i < all_contacts_.size(); i++) {
     if (next_contact_set.find(i) != next_contact_set.end()) {
       J_next.block(row_start, 0, kSpaceDim, n_v_) =
-          all_contacts_[i]->EvalFullJacobian(*context_wo_spr_);
+          dynamics_cache_->J_contact(i);
       row_start += kSpaceDim;
     }
   }
   // Holonomic constraints
   if (n_h_ > 0) {
-    J_next.block(row_start, 0, n_h_, n_v_) =
-        kinematic_evaluators_->EvalFullJacobian(*context_wo_spr_);
-  }
-  M_Jt_ = M.llt().solve(J_next.transpose());
-
-  int active_tracking_data_dim = 0;
+    J_next.block(row_start, 0, n_h_, n_v_) = dynamics_cache_->J_h();
+  }
+  MatrixXd& M_Jt = workspace.M_Jt;
+  M_Jt = J_next.transpose();
+  dynamics_cache_->M_llt().solveInPlace(M_Jt);
+
+  // The rows of the inactive tracking data stay zero and do not change A^T A
+  // and A^T ydot_err
+  MatrixXd& A = workspace.A;
+  VectorXd& ydot_err_vec = workspace.ydot_err;
+  A.setZero();
+  ydot_err_vec.setZero();
+  int start_row = 0;
   for (unsigned int i = 0; i < tracking_data_vec_->size(); i++) {
     auto tracking_data = tracking_data_vec_->at(i).get();
-
-    if (tracking_data->IsActive(fsm_state) &&
-        tracking_data->GetImpactInvariantProjection()) {
-      VectorXd v_proj = VectorXd::Zero(n_v_);
-      active_tracking_data_dim += tracking_data->GetYdotDim();
-      if (fixed_position_vec_.at(i).size() != 0) {
-        // Create constant trajectory and update
-        tracking_data->Update(
-            x_w_spr, *context_w_spr_, x_wo_spr, *context_wo_spr_,
-            PiecewisePolynomial<double>(fixed_position_vec_.at(i)), t,
-            t_since_last_state_switch, fsm_state, v_proj);
-      } else {
-        // Read in traj from input port
-        const string& traj_name = tracking_data->GetName();
-        int port_index = traj_name_to_port_index_map_.at(traj_name);
-        const drake::AbstractValue* input_traj =
-            EvalAbstractInput(context, port_index);
-        const auto& traj =
-            input_traj->get_value<drake::trajectories::Trajectory<double>>();
-        tracking_data->Update(x_w_spr, *context_w_spr_, x_wo_spr,
-                              *context_wo_spr_, traj, t,
-                              t_since_last_state_switch, fsm_state, v_proj);
-      }
+    if (!tracking_data->GetImpactInvariantProjection()) {
+      continue;
     }
-  }
-
-  MatrixXd A = MatrixXd::Zero(active_tracking_data_dim, active_constraint_dim);
-  VectorXd ydot_err_vec = VectorXd::Zero(active_tracking_data_dim);
-  int start_row = 0;
-  for (auto& tracking_data : *tracking_data_vec_) {
-    if (tracking_data->IsActive(fsm_state) &&
-        tracking_data->GetImpactInvariantProjection()) {
-      A.block(start_row, 0, tracking_data->GetYdotDim(),
-              active_constraint_dim) = tracking_data->GetJ() * M_Jt_;
-      ydot_err_vec.segment(start_row, tracking_data->GetYdotDim()) =
-          tracking_data->GetErrorYdot();
-      start_row += tracking_data->GetYdotDim();
+    const int n_ydot = tracking_data->GetYdotDim();
+    if (tracking_data->IsActive(fsm_state)) {
+      // The velocity error without the projection (v_proj is still zero)
+      UpdateTrackingDataKinematics(i, x_w_spr, x_wo_spr, context, t,
+                                   t_since_last_state_switch, fsm_state);
+      tracking_data->UpdateCommand(t, t_since_last_state_switch, *v_proj);
+      A.middleRows(start_row, n_ydot).noalias() =
+          tracking_data->GetJ() * M_Jt;
+      ydot_err_vec.segment(start_row, n_ydot) = tracking_data->GetErrorYdot();
     }
+    start_row += n_ydot;
   }
 
   //  int n_holonomic_constraints = n_h_;
-  MatrixXd A_constrained = MatrixXd::Zero(active_constraint_dim + n_h_,
-                                          active_constraint_dim + n_h_);
-  A_constrained.block(0, 0, active_constraint_dim, active_constraint_dim) =
-      A.transpose() * A;
-  VectorXd b_constrained = VectorXd::Zero(active_constraint_dim + n_h_);
-  VectorXd Ab = A.transpose() * ydot_err_vec;
+  MatrixXd& A_constrained = workspace.A_constrained;
+  VectorXd& b_constrained = workspace.b_constrained;
+  A_constrained.setZero();
+  A_constrained.topLeftCorner(active_constraint_dim, active_constraint_dim)
+      .noalias() = A.transpose() * A;
+  b_constrained.head(active_constraint_dim).noalias() =
+      A.transpose() * ydot_err_vec;
   if (n_h_ > 0) {
-    MatrixXd J_h = kinematic_evaluators_->EvalFullJacobian(*context_wo_spr_);
-    MatrixXd C = J_h * M_Jt_;
-    VectorXd d = J_h * x_w_spr.tail(n_v_);
+    const MatrixHV& J_h = dynamics_cache_->J_h();
+    workspace.C.noalias() = J_h * M_Jt;
+    workspace.d.noalias() = J_h * x_w_spr.tail(n_v_);
     A_constrained.block(active_constraint_dim, 0, n_h_, active_constraint_dim) =
-        C;
+        workspace.C;
     A_constrained.block(0, active_constraint_dim, active_constraint_dim, n_h_) =
-        C.transpose();
-    b_constrained << Ab, d;
-  } else {
-    b_constrained << Ab;
+        workspace.C.transpose();
+    b_constrained.tail(n_h_) = workspace.d;
   }
 
-  ii_lambda_sol_ = A_constrained.completeOrthogonalDecomposition()
-                       .solve(b_constrained)
-                       .head(active_constraint_dim);
+  workspace.A_constrained_cod.compute(A_constrained);
+  workspace.lambda_sol = workspace.A_constrained_cod.solve(b_constrained);
+  v_proj->noalias() =
+      alpha * M_Jt * workspace.lambda_sol.head(active_constraint_dim);
 }
 
-void OperationalSpaceControl::AssignOscLcmOutput(
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::AssignOscLcmOutput(
     const Context<double>& context, dairlib::lcmt_osc_output* output) const {
+  StageTimer::ScopedStage timer(stage_timer_.get(), kLcmOutput);
   auto state =
       (OutputVector<double>*)this->EvalVectorInput(context, state_port_);
   double total_cost = 0;
@@ -965,6 +1336,14 @@ void OperationalSpaceControl::AssignOscLcmOutput(
   double lambda_h_cost = (lambda_h_cost_ != nullptr) ? y_lambda_h_cost[0] : 0;
   //  double joint_limit_cost =
   //      (joint_limit_cost_ != nullptr) ? y_joint_limit_cost[0] : 0;
+  if (direct_qp_ != nullptr) {
+    acceleration_cost = direct_qp_costs_.acceleration;
+    input_cost = direct_qp_costs_.input;
+    input_smoothing_cost = direct_qp_costs_.input_smoothing;
+    soft_constraint_cost = direct_qp_costs_.soft_constraint;
+    lambda_c_cost = direct_qp_costs_.lambda_c;
+    lambda_h_cost = direct_qp_costs_.lambda_h;
+  }
 
   total_cost += input_cost + acceleration_cost + soft_constraint_cost +
                 input_smoothing_cost + lambda_h_cost + lambda_c_cost;
@@ -1042,10 +1421,14 @@ void OperationalSpaceControl::AssignOscLcmOutput(
       osc_output.yddot_command_sol =
           CopyVectorXdToStdVector(tracking_data->GetYddotCommandSol());
 
-      VectorXd y_tracking_cost = VectorXd::Zero(1);
-      tracking_costs_[i]->Eval(*dv_sol_, &y_tracking_cost);
-      total_cost += y_tracking_cost[0];
-      output->tracking_costs.push_back(y_tracking_cost[0]);
+      // Same value as the tracking cost in SolveQp:
+      // (J*dv + JdotV - yddot_cmd)^T W (J*dv + JdotV - yddot_cmd)
+      const VectorXd yddot_err = tracking_data->GetYddotCommandSol() -
+                                 tracking_data->GetYddotCommand();
+      double y_tracking_cost =
+          yddot_err.dot(tracking_data->GetWeight() * yddot_err);
+      total_cost += y_tracking_cost;
+      output->tracking_costs.push_back(y_tracking_cost);
       output->tracking_data.push_back(osc_output);
       output->tracking_data_names.push_back(tracking_data->GetName());
     }
@@ -1056,28 +1439,39 @@ void OperationalSpaceControl::AssignOscLcmOutput(
   output->num_regularization_costs = output->regularization_cost_names.size();
 }
 
-void OperationalSpaceControl::CalcOptimalInput(
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::AssignTimingOutput(
+    const Context<double>& context, dairlib::lcmt_stage_timing* output) const {
+  output->utime = context.get_time() * 1e6;
+  stage_timer_->CollectStatistics(output);
+}
+
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::CalcOptimalInput(
     const drake::systems::Context<double>& context,
     systems::TimestampedVector<double>* control) const {
   // Read in current state and time
   auto robot_output =
       (OutputVector<double>*)this->EvalVectorInput(context, state_port_);
 
-  VectorXd q_w_spr = robot_output->GetPositions();
-  VectorXd v_w_spr = robot_output->GetVelocities();
-  VectorXd x_w_spr(plant_w_spr_.num_positions() +
-                   plant_w_spr_.num_velocities());
-  x_w_spr << q_w_spr, v_w_spr;
+  // The state is stored at the front of the OutputVector. Read it through
+  // get_value(), since GetPositions() and GetVelocities() return copies.
+  const int n_q_w_spr = plant_w_spr_.num_positions();
+  const int n_v_w_spr = plant_w_spr_.num_velocities();
+  VectorXd& x_w_spr = x_w_spr_;
+  x_w_spr = robot_output->get_value().head(n_q_w_spr + n_v_w_spr);
 
   double timestamp = robot_output->get_timestamp();
 
   double current_time = timestamp;
 
-  VectorXd x_wo_spr(n_q_ + n_v_);
-  x_wo_spr << map_position_from_spring_to_no_spring_ * q_w_spr,
-      map_velocity_from_spring_to_no_spring_ * v_w_spr;
+  VectorXd& x_wo_spr = x_wo_spr_;
+  x_wo_spr.head(n_q_).noalias() =
+      map_position_from_spring_to_no_spring_ * x_w_spr.head(n_q_w_spr);
+  x_wo_spr.tail(n_v_).noalias() =
+      map_velocity_from_spring_to_no_spring_ * x_w_spr.tail(n_v_w_spr);
 
-  VectorXd u_sol(n_u_);
+  const VectorXd* u_sol;
   if (used_with_finite_state_machine_) {
     // Read in finite state machine
     auto fsm_output = this->EvalVectorInput(context, fsm_port_);
@@ -1086,7 +1480,7 @@ void OperationalSpaceControl::CalcOptimalInput(
       auto clock = this->EvalVectorInput(context, clock_port_);
       clock_time = clock->get_value()(0);
     }
-    VectorXd fsm_state = fsm_output->get_value();
+    const int fsm_state = fsm_output->get_value()(0);
 
     double alpha = 0;
     int next_fsm_state = -1;
@@ -1099,19 +1493,20 @@ void OperationalSpaceControl::CalcOptimalInput(
     // Get discrete states
     const auto prev_event_time =
         context.get_discrete_state(prev_event_time_idx_).get_value();
-    u_sol = SolveQp(x_w_spr, x_wo_spr, context, clock_time, fsm_state(0),
-                    current_time - prev_event_time(0), alpha, next_fsm_state);
+    u_sol = &SolveQp(x_w_spr, x_wo_spr, context, clock_time, fsm_state,
+                     current_time - prev_event_time(0), alpha, next_fsm_state);
   } else {
-    u_sol = SolveQp(x_w_spr, x_wo_spr, context, current_time, -1, current_time,
-                    0, -1);
+    u_sol = &SolveQp(x_w_spr, x_wo_spr, context, current_time, -1,
+                     current_time, 0, -1);
   }
 
   // Assign the control input
-  control->SetDataVector(u_sol);
+  control->SetDataVector(*u_sol);
   control->set_timestamp(robot_output->get_timestamp());
 }
 
-void OperationalSpaceControl::CheckTracking(
+template <int kNq, int kNv, int kNu, int kNc>
+void SizedOperationalSpaceControl<kNq, kNv, kNu, kNc>::CheckTracking(
     const drake::systems::Context<double>& context,
     TimestampedVector<double>* output) const {
   auto robot_output =
@@ -1121,10 +1516,19 @@ void OperationalSpaceControl::CheckTracking(
   VectorXd y_soft_constraint_cost = VectorXd::Zero(1);
   if (soft_constraint_cost_ != nullptr) {
     soft_constraint_cost_->Eval(*epsilon_sol_, &y_soft_constraint_cost);
+  } else if (direct_qp_ != nullptr) {
+    y_soft_constraint_cost[0] = direct_qp_costs_.soft_constraint;
   }
   if (y_soft_constraint_cost[0] > 1e5 || isnan(y_soft_constraint_cost[0])) {
     output->get_mutable_value()(0) = 1.0;
   }
 }
 
+template class SizedOperationalSpaceControl<Eigen::Dynamic, Eigen::Dynamic,
+                                           Eigen::Dynamic, Eigen::Dynamic>;
+template class SizedOperationalSpaceControl<kCassieNq, kCassieNv, kCassieNu,
+                                           kCassieNc>;
+template class SizedOperationalSpaceControl<
+    kCassieFixedSpringsNq, kCassieFixedSpringsNv, kCassieNu, kCassieNc>;
+
 }  // namespace dairlib::systems::controllers
@@ -10,13 +10,19 @@
 #include <drake/multibody/plant/multibody_plant.h>
 
 #include "common/find_resource.h"
+#include "common/stage_timer.h"
 #include "dairlib/lcmt_osc_output.hpp"
 #include "dairlib/lcmt_osc_qp_output.hpp"
 #include "multibody/kinematic/kinematic_evaluator_set.h"
 #include "multibody/kinematic/world_point_evaluator.h"
+#include "solvers/dense_active_set_qp_solver.h"
 #include "solvers/fast_osqp_solver.h"
+#include "solvers/qp_snapshot.h"
 #include "solvers/solver_options_io.h"
 #include "systems/controllers/control_utils.h"
+#include "systems/controllers/osc/osc_direct_qp.h"
+#include "systems/controllers/osc/osc_dynamics_cache.h"
+#include "systems/controllers/osc/osc_sizes.h"
 #include "systems/controllers/osc/osc_tracking_data.h"
 #include "systems/framework/impact_info_vector.h"
 #include "systems/framework/output_vector.h"
@@ -33,6 +39,33 @@
 
 namespace dairlib::systems::controllers {
 
+/// Backend used by `OperationalSpaceControl` to assemble its QP
+///  - kMathematicalProgram: the costs and constraints are bindings of a
+///    drake::solvers::MathematicalProgram. With the "structured_update" OSQP
+///    option (on in the default settings) FastOsqpSolver scatters the updated
+///    coefficients into the sparsity pattern recorded on the first solve
+///    instead of parsing the program again. Every cost and constraint can be
+///    inspected, which is useful for debugging. Updating the bindings and
+///    building the MathematicalProgramResult still allocate inside drake on
+///    every tick.
+///  - kDirect: the QP is written block by block straight into OSQP's matrices
+///    (see OscDirectQp). Does not support the double support contact force
+///    blending.
+///  - kReduced: same as kDirect, but dv and lambda_h are eliminated using the
+///    mass matrix and the holonomic constraints, so OSQP only solves for u,
+///    lambda_c and epsilon. Requires the holonomic constraint Jacobian to
+///    have full row rank.
+enum class OscQpBackend { kMathematicalProgram, kDirect, kReduced };
+
+/// Solver used by `OperationalSpaceControl` for the QP of the kDirect and
+/// kReduced backends
+///  - kOsqp: FastOsqpSolver (ADMM). The solver options set with
+///    SetOsqpSolverOptions() apply.
+///  - kDenseActiveSet: solvers::DenseActiveSetQpSolver, warm started from the
+///    active set of the previous tick. Exact and usually faster for the small
+///    QPs of the OSC, in particular with the kReduced backend.
+enum class OscQpSolver { kOsqp, kDenseActiveSet };
+
 /// `OperationalSpaceControl` takes in desired trajectory in world frame and
 /// outputs torque command of the motors.
 
@@ -95,9 +128,27 @@ namespace dairlib::systems::controllers {
 ///      `OperationalSpaceControl`'s input ports to corresponding output ports
 ///      of the trajectory source.
 
-class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
+/// n_q, n_v, n_u (of the plant without springs) and n_c (kSpaceDim per
+/// contact point) can be fixed at compile time, which makes the dynamics,
+/// the contact Jacobians and the blocks of the kDirect/kReduced QP fixed-size
+/// Eigen matrices. OperationalSpaceControl is the variant with every size
+/// dynamic; the fixed-size variants for Cassie are declared below. The
+/// constructor and Build() throw if the fixed sizes do not match the plant and
+/// the contact points.
+template <int kNq, int kNv, int kNu, int kNc>
+class SizedOperationalSpaceControl
+    : public drake::systems::LeafSystem<double> {
  public:
-  OperationalSpaceControl(
+  using Types = OscTypes<kNv, kNu, kNc>;
+  using VectorV = typename Types::VectorV;
+  using MatrixVV = typename Types::MatrixVV;
+  using MatrixVU = typename Types::MatrixVU;
+  using MatrixCV = typename Types::MatrixCV;
+  using MatrixHV = typename Types::MatrixHV;
+  using MatrixActiveCV = typename Types::MatrixActiveCV;
+  using VectorActiveC = typename Types::VectorActiveC;
+
+  SizedOperationalSpaceControl(
       const drake::multibody::MultibodyPlant<double>& plant_w_spr,
       const drake::multibody::MultibodyPlant<double>& plant_wo_spr,
       drake::systems::Context<double>* context_w_spr,
@@ -128,6 +179,14 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   const drake::systems::OutputPort<double>& get_output_port_failure() const {
     return this->get_output_port(failure_port_);
   }
+  /*!
+   * Output: lcmt_stage_timing message with the latency statistics of each
+   * stage of the controller ticks since the last evaluation of this port.
+   * Meant to be published at a low rate.
+   */
+  const drake::systems::OutputPort<double>& get_output_port_timing() const {
+    return this->get_output_port(timing_port_);
+  }
 
   /*!
    * Input: OutputVector containing the robot state
@@ -248,6 +307,16 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   OscTrackingData* GetTrackingDataByIndex(int index) {
     return tracking_data_vec_->at(index).get();
   }
+  /// OSQP iteration counts per contact mode. The QP solves are keyed by the
+  /// active contact set, encoded as a bitmask of the contact indices (in the
+  /// order the contact points were added), so fsm states with the same
+  /// contacts share a key and flight is key 0. Setting the integer solver
+  /// option "warm_start_bank" also warm starts every mode switch from the
+  /// last solution of the new mode.
+  const std::map<int, solvers::FastOsqpSolver::WarmStartStatistics>&
+  GetWarmStartStatistics() const {
+    return solver_->warm_start_statistics();
+  }
 
   // Optional features
   void SetUpDoubleSupportPhaseBlending(double ds_duration,
@@ -264,6 +333,19 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
             .GetAsSolverOptions(drake::solvers::OsqpSolver::id())
     );
   };
+  /// Selects the QP backend (see OscQpBackend). Must be called before Build()
+  void SetQpBackend(OscQpBackend backend) { qp_backend_ = backend; }
+  /// Selects the QP solver (see OscQpSolver). Must be called before Build().
+  /// kDenseActiveSet requires the kDirect or kReduced backend.
+  void SetQpSolver(OscQpSolver qp_solver) { qp_solver_ = qp_solver; }
+  /// Logs the fully assembled QP of every tick, with the solver's warm start
+  /// and the fsm state, to `filename` (see solvers::QpSnapshotWriter). The
+  /// file is written by a background thread; snapshots are dropped rather
+  /// than delaying the controller. Requires the kDirect or kReduced backend.
+  /// Must be called before Build().
+  void SetQpSnapshotLog(const std::string& filename) {
+    qp_snapshot_log_ = filename;
+  }
   // OSC LeafSystem builder
   void Build();
 
@@ -272,24 +354,43 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   void CheckCostSettings();
   void CheckConstraintSettings();
 
-  // Get solution of OSC
-  Eigen::VectorXd SolveQp(const Eigen::VectorXd& x_w_spr,
-                          const Eigen::VectorXd& x_wo_spr,
-                          const drake::systems::Context<double>& context,
-                          double t, int fsm_state,
-                          double t_since_last_state_switch, double alpha,
-                          int next_fsm_state) const;
+  // Get solution of OSC. Returns a reference to u_sol_.
+  const Eigen::VectorXd& SolveQp(const Eigen::VectorXd& x_w_spr,
+                                 const Eigen::VectorXd& x_wo_spr,
+                                 const drake::systems::Context<double>& context,
+                                 double t, int fsm_state,
+                                 double t_since_last_state_switch,
+                                 double alpha, int next_fsm_state) const;
+  // Adds the regularization costs to direct_qp_ and solves it. Called by
+  // SolveQp after the constraints and tracking costs have been updated.
+  const Eigen::VectorXd& SolveDirectQp(double t, int fsm_state,
+                                       double alpha) const;
+  // Adds the tracking cost
+  //    (J*dv + JdotV - yddot_cmd)^T W (J*dv + JdotV - yddot_cmd)
+  // of an updated tracking data to the upper triangle of `H` and to `g`. Only
+  // the columns of J in the tracking data's column support are visited.
+  void AddTrackingCost(const OscTrackingData& tracking_data,
+                       MatrixVV* H, Eigen::Ref<Eigen::VectorXd> g) const;
 
   // Solves the optimization problem:
   // min_{\lambda} || ydot_{des} - J_{y}(qdot + M^{-1} J_{\lambda}^T \lambda||_2
   // s.t. constraints
   // In the IROS 2021 paper, the problem was unconstrained and could be solved
   // using the closed form least squares solution
+  // Writes the projection alpha * M^{-1} J_{\lambda}^T \lambda into `v_proj`,
+  // which must be zero on entry.
   void UpdateImpactInvariantProjection(
       const Eigen::VectorXd& x_w_spr, const Eigen::VectorXd& x_wo_spr,
       const drake::systems::Context<double>& context, double t,
       double t_since_last_state_switch, int fsm_state, int next_fsm_state,
-      const Eigen::MatrixXd& M) const;
+      double alpha, Eigen::VectorXd* v_proj) const;
+
+  // Calls UpdateKinematics() on tracking data `i` with its desired trajectory,
+  // unless it has already been called this tick (see OscDynamicsCache)
+  void UpdateTrackingDataKinematics(
+      int i, const Eigen::VectorXd& x_w_spr, const Eigen::VectorXd& x_wo_spr,
+      const drake::systems::Context<double>& context, double t,
+      double t_since_last_state_switch, int fsm_state) const;
 
   // Solves the optimization problem:
   // min_{\lambda} || ydot_{des} - J_{y}(qdot + M^{-1} J_{\lambda}^T \lambda||_2
@@ -301,8 +402,8 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   void UpdateImpactInvariantProjectionQP(
       const Eigen::VectorXd& x_w_spr, const Eigen::VectorXd& x_wo_spr,
       const drake::systems::Context<double>& context, double t,
-      double t_since_last_state_switch, int fsm_state, int next_fsm_state,
-      const Eigen::MatrixXd& M) const;
+      double t_since_last_state_switch, int fsm_state,
+      int next_fsm_state) const;
 
   // Discrete update that stores the previous state transition time
   drake::systems::EventStatus DiscreteVariableUpdate(
@@ -311,6 +412,8 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
 
   void AssignOscLcmOutput(const drake::systems::Context<double>& context,
                           dairlib::lcmt_osc_output* output) const;
+  void AssignTimingOutput(const drake::systems::Context<double>& context,
+                          dairlib::lcmt_stage_timing* output) const;
 
   // Output function
   void CalcOptimalInput(const drake::systems::Context<double>& context,
@@ -327,6 +430,7 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   int fsm_port_;
   int impact_info_port_;
   int failure_port_;
+  int timing_port_;
 
   // Discrete update
   int prev_fsm_state_idx_;
@@ -393,6 +497,51 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   // MathematicalProgram
   std::unique_ptr<drake::solvers::MathematicalProgram> prog_;
 
+  // Latency instrumentation. Stages after kNumFixedStages are the
+  // OscTrackingData::Update() calls, in the order of tracking_data_vec_.
+  enum TimingStage {
+    kContextUpdate,
+    kDynamics,
+    kImpactInvariantProjection,
+    kJacobians,
+    kTrackingCost,
+    kQpAssembly,
+    kQpSolve,
+    kLcmOutput,
+    kNumFixedStages
+  };
+  std::unique_ptr<StageTimer> stage_timer_;
+
+  // M, its factorization, bias and constraint Jacobians of the current tick.
+  // Invalidated by SolveQp() after the contexts are updated.
+  std::unique_ptr<SizedOscDynamicsCache<kNv, kNu>> dynamics_cache_;
+
+  // Direct QP backend
+  OscQpBackend qp_backend_ = OscQpBackend::kMathematicalProgram;
+  std::unique_ptr<SizedOscDirectQp<kNv, kNu, kNc>> direct_qp_;
+  mutable Eigen::VectorXd direct_qp_sol_;
+  mutable Eigen::VectorXd direct_qp_full_sol_;
+  OscQpSolver qp_solver_ = OscQpSolver::kOsqp;
+  std::unique_ptr<solvers::DenseActiveSetQpSolver> active_set_solver_;
+  mutable solvers::DenseActiveSetQpSolver::Details active_set_details_;
+  // Kept across ticks so that its dual solution is not reallocated
+  mutable solvers::FastOsqpSolver::Details osqp_details_;
+  std::string qp_snapshot_log_;
+  std::unique_ptr<solvers::QpSnapshotWriter> qp_snapshot_writer_;
+  mutable Eigen::VectorXd qp_snapshot_x_warm_;
+  mutable Eigen::VectorXd qp_snapshot_y_warm_;
+  // Regularization costs of the last direct QP solve, which has no drake cost
+  // objects to evaluate for the debug output
+  struct DirectQpCosts {
+    double input = 0;
+    double acceleration = 0;
+    double soft_constraint = 0;
+    double input_smoothing = 0;
+    double lambda_c = 0;
+    double lambda_h = 0;
+  };
+  mutable DirectQpCosts direct_qp_costs_;
+
   // Decision variables
   drake::solvers::VectorXDecisionVariable dv_;
   drake::solvers::VectorXDecisionVariable u_;
@@ -405,7 +554,25 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   drake::solvers::LinearEqualityConstraint* contact_constraints_;
   std::vector<drake::solvers::LinearConstraint*> friction_constraints_;
 
-  std::vector<drake::solvers::QuadraticCost*> tracking_costs_;
+  // All tracking costs are summed into a single cost on dv
+  drake::solvers::QuadraticCost* tracking_cost_ = nullptr;
+  mutable MatrixVV tracking_cost_hessian_;
+  mutable Eigen::VectorXd tracking_cost_gradient_;
+  // Scratch space for W*J restricted to the column support of J
+  mutable Eigen::MatrixXd tracking_WJ_;
+  mutable Eigen::VectorXd tracking_Wc_;
+
+  // Per-tick scratch space (allocated in Build())
+  mutable Eigen::VectorXd x_w_spr_;
+  mutable Eigen::VectorXd x_wo_spr_;
+  mutable Eigen::VectorXd v_proj_;
+  mutable MatrixCV J_c_;
+  mutable MatrixActiveCV J_c_active_;
+  mutable VectorActiveC JdotV_c_active_;
+  mutable Eigen::VectorXd joint_limit_violation_;
+  mutable Eigen::VectorXd w_joint_limit_vec_;
+  mutable Eigen::VectorXd qp_cost_scratch_;
+  mutable Eigen::VectorXd qp_cost_du_;
   drake::solvers::QuadraticCost* accel_cost_ = nullptr;
   drake::solvers::LinearCost* joint_limit_cost_ = nullptr;
   drake::solvers::QuadraticCost* input_cost_ = nullptr;
@@ -413,6 +580,24 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   drake::solvers::QuadraticCost* lambda_c_cost_ = nullptr;
   drake::solvers::QuadraticCost* lambda_h_cost_ = nullptr;
   drake::solvers::QuadraticCost* soft_constraint_cost_ = nullptr;
+  // Coefficients of the kMathematicalProgram backend's costs and constraints,
+  // written in place every tick (allocated in Build())
+  struct ProgramWorkspace {
+    Eigen::MatrixXd A_dyn;
+    Eigen::VectorXd b_dyn;
+    Eigen::VectorXd b_h;
+    Eigen::MatrixXd A_c;  // [J_c_active, I] of the relaxed contact constraint
+    Eigen::VectorXd b_c;
+    // Long enough for the zero vector of every cost and constraint
+    Eigen::VectorXd zeros;
+    Eigen::VectorXd friction_lb_inactive;
+    Eigen::MatrixXd A_blend;
+    Eigen::MatrixXd W_input;
+    Eigen::VectorXd b_input_smoothing;
+    Eigen::MatrixXd W_lambda_c;
+    Eigen::MatrixXd W_lambda_h;
+  };
+  mutable ProgramWorkspace program_workspace_;
 
   // OSC solution
   std::unique_ptr<Eigen::VectorXd> dv_sol_;
@@ -423,9 +608,27 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   std::unique_ptr<Eigen::VectorXd> u_prev_;
   mutable double solve_time_;
 
-  mutable Eigen::VectorXd ii_lambda_sol_;
-  mutable Eigen::MatrixXd M_Jt_;
   std::map<int, int> active_contact_dim_ = {};
+  // Scratch space of the impact-invariant projection for one post-impact fsm
+  // state, with active_constraint_dim = active_contact_dim_ + n_h_
+  struct ImpactInvariantWorkspace {
+    Eigen::MatrixXd J_next;  // active_constraint_dim x n_v
+    Eigen::MatrixXd M_Jt;    // n_v x active_constraint_dim
+    // One block row per tracking data with the projection enabled (zero when
+    // it is inactive), n_ii_ydot_ x active_constraint_dim
+    Eigen::MatrixXd A;
+    Eigen::VectorXd ydot_err;
+    Eigen::MatrixXd C;  // n_h x active_constraint_dim
+    Eigen::VectorXd d;  // n_h
+    Eigen::MatrixXd A_constrained;
+    Eigen::VectorXd b_constrained;
+    Eigen::CompleteOrthogonalDecomposition<Eigen::MatrixXd> A_constrained_cod;
+    Eigen::VectorXd lambda_sol;
+  };
+  // Keyed by the fsm states of contact_indices_map_ (allocated in Build())
+  mutable std::map<int, ImpactInvariantWorkspace> ii_workspaces_;
+  // Total output dimension of the tracking data with the projection enabled
+  int n_ii_ydot_ = 0;
 
   // OSC cost members
   /// Using u cost would push the robot away from the fixed point, so the user
@@ -461,6 +664,10 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
 
   // Fixed position of constant trajectories
   std::vector<Eigen::VectorXd> fixed_position_vec_;
+  // Constant trajectories for the entries of fixed_position_vec_ that are set,
+  // built once in Build()
+  std::vector<drake::trajectories::PiecewisePolynomial<double>>
+      fixed_trajectories_;
 
   // Set a period during which we apply control (Unit: seconds)
   // Let t be the elapsed time since fsm switched to a new state.
@@ -479,4 +686,16 @@ class OperationalSpaceControl : public drake::systems::LeafSystem<double> {
   drake::solvers::VectorXDecisionVariable epsilon_blend_;
 };
 
+using OperationalSpaceControl =
+    SizedOperationalSpaceControl<Eigen::Dynamic, Eigen::Dynamic,
+                                 Eigen::Dynamic, Eigen::Dynamic>;
+/// Cassie with springs (cassie_v2.urdf) and four contact points
+using CassieOperationalSpaceControl =
+    SizedOperationalSpaceControl<kCassieNq, kCassieNv, kCassieNu, kCassieNc>;
+/// Cassie with fixed springs (cassie_fixed_springs.urdf) and four contact
+/// points
+using CassieFixedSpringsOperationalSpaceControl =
+    SizedOperationalSpaceControl<kCassieFixedSpringsNq, kCassieFixedSpringsNv,
+                                 kCassieNu, kCassieNc>;
+
 }  // namespace dairlib::systems::controllers
@@ -1,7 +1,6 @@
 #include "options_tracking_data.h"
-#include "common/eigen_utils.h"
 
-#include "drake/common/trajectories/piecewise_quaternion.h"
+#include <algorithm>
 
 using Eigen::MatrixXd;
 using Eigen::Quaterniond;
@@ -38,12 +37,19 @@ void OptionsTrackingData::UpdateActual(
   if (with_view_frame_) {
     view_frame_rot_T_ =
         view_frame_->CalcWorldToFrameRotation(plant_w_spr_, context_w_spr);
+    // Rotate through fixed-size copies so that nothing is allocated
     if (!is_rotational_tracking_data_) {
-      y_ = view_frame_rot_T_ * y_;
-      ydot_ = view_frame_rot_T_ * ydot_;
+      const Vector3d y = y_;
+      y_.noalias() = view_frame_rot_T_ * y;
+      const Vector3d ydot = ydot_;
+      ydot_.noalias() = view_frame_rot_T_ * ydot;
     }
-    J_ = view_frame_rot_T_ * J_;
-    JdotV_ = view_frame_rot_T_ * JdotV_;
+    for (int i = 0; i < J_.cols(); i++) {
+      const Vector3d J_i = J_.col(i);
+      J_.col(i).noalias() = view_frame_rot_T_ * J_i;
+    }
+    const Vector3d JdotV = JdotV_;
+    JdotV_.noalias() = view_frame_rot_T_ * JdotV;
   }
 
   UpdateFilters(t);
@@ -59,11 +65,11 @@ void OptionsTrackingData::UpdateFilters(double t) {
       double dt = t - last_timestamp_;
       double alpha = dt / (dt + tau_);
       if (this->is_rotational_tracking_data_) {  // quaternion
-        auto slerp = drake::trajectories::PiecewiseQuaternionSlerp<double>(
-            {0, 1}, {Quaterniond(y_[0], y_[1], y_[2], y_[3]),
-                     Quaterniond(filtered_y_[0], filtered_y_[1], filtered_y_[2],
-                                 filtered_y_[3])});
-        filtered_y_ = slerp.value(1 - alpha);
+        const Quaterniond q_y(y_[0], y_[1], y_[2], y_[3]);
+        const Quaterniond q_filtered(filtered_y_[0], filtered_y_[1],
+                                     filtered_y_[2], filtered_y_[3]);
+        const Quaterniond q = q_y.slerp(1 - alpha, q_filtered);
+        filtered_y_ << q.w(), q.x(), q.y(), q.z();
       } else {
         filtered_y_ = alpha * y_ + (1 - alpha) * filtered_y_;
       }
@@ -90,9 +96,9 @@ void OptionsTrackingData::UpdateYError() { error_y_ = y_des_ - y_; }
 void OptionsTrackingData::UpdateYdotError(const Eigen::VectorXd& v_proj) {
   error_ydot_ = ydot_des_ - ydot_;
   if (impact_invariant_projection_) {
-    error_ydot_ -= GetJ() * v_proj;
+    error_ydot_.noalias() -= GetJ() * v_proj;
   } else if (no_derivative_feedback_ && !v_proj.isZero()) {
-    error_ydot_ = VectorXd::Zero(n_ydot_);
+    error_ydot_.setZero();
   }
 }
 
@@ -103,35 +109,43 @@ void OptionsTrackingData::UpdateYddotDes(double t,
     yddot_des_converted_(idx) = 0;
   }
   if (ff_accel_multiplier_traj_ != nullptr) {
-    yddot_des_converted_ =
-        ff_accel_multiplier_traj_->value(t_since_state_switch) *
-        yddot_des_converted_;
+    gain_multiplier_ = ff_accel_multiplier_traj_->value(t_since_state_switch);
+    yddot_scratch_ = yddot_des_converted_;
+    yddot_des_converted_.noalias() = gain_multiplier_ * yddot_scratch_;
   }
 }
 
 void OptionsTrackingData::UpdateYddotCmd(double t,
                                          double t_since_state_switch) {
   // 4. Update command output (desired output with pd control)
-  MatrixXd p_gain_multiplier =
-      (p_gain_multiplier_traj_ != nullptr)
-          ? p_gain_multiplier_traj_->value(t_since_state_switch)
-          : MatrixXd::Identity(n_ydot_, n_ydot_);
-
-  MatrixXd d_gain_multiplier =
-      (d_gain_multiplier_traj_ != nullptr)
-          ? d_gain_multiplier_traj_->value(t_since_state_switch)
-          : MatrixXd::Identity(n_ydot_, n_ydot_);
-
-  yddot_command_ = yddot_des_converted_ + p_gain_multiplier * K_p_ * error_y_ +
-                   d_gain_multiplier * K_d_ * error_ydot_;
-  yddot_command_ = eigen_clamp(yddot_command_, yddot_cmd_lb_, yddot_cmd_ub_);
+  // The gain multipliers default to identity, in which case they are skipped
+  yddot_command_ = yddot_des_converted_;
+  AddFeedback(K_p_, error_y_, p_gain_multiplier_traj_.get(),
+              t_since_state_switch);
+  AddFeedback(K_d_, error_ydot_, d_gain_multiplier_traj_.get(),
+              t_since_state_switch);
+  yddot_command_ =
+      yddot_command_.cwiseMax(yddot_cmd_lb_).cwiseMin(yddot_cmd_ub_);
   UpdateW(t, t_since_state_switch);
 }
 
+void OptionsTrackingData::AddFeedback(
+    const MatrixXd& K, const VectorXd& error,
+    const drake::trajectories::Trajectory<double>* gain_multiplier_traj,
+    double t_since_state_switch) {
+  yddot_scratch_.noalias() = K * error;
+  if (gain_multiplier_traj != nullptr) {
+    gain_multiplier_ = gain_multiplier_traj->value(t_since_state_switch);
+    yddot_command_.noalias() += gain_multiplier_ * yddot_scratch_;
+  } else {
+    yddot_command_ += yddot_scratch_;
+  }
+}
+
 void OptionsTrackingData::UpdateW(double t, double t_since_state_switch) {
   if (weight_trajectory_ != nullptr) {
     time_varying_weight_ =
-        weight_trajectory_->value(time_through_trajectory_).row(0)[0] * W_;
+        weight_trajectory_->value(time_through_trajectory_)(0, 0) * W_;
   } else {
     time_varying_weight_ = W_;
   }
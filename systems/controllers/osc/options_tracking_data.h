@@ -102,6 +102,11 @@ class OptionsTrackingData : public OscTrackingData {
   void UpdateYddotDes(double t, double t_since_state_switch) override;
   void UpdateYddotCmd(double t, double t_since_state_switch) override;
   void UpdateW(double t, double t_since_state_switch);
+  // Adds gain_multiplier(t_since_state_switch) * K * error to yddot_command_
+  void AddFeedback(
+      const Eigen::MatrixXd& K, const Eigen::VectorXd& error,
+      const drake::trajectories::Trajectory<double>* gain_multiplier_traj,
+      double t_since_state_switch);
 
   void UpdateFilters(double t);
 
@@ -109,6 +114,9 @@ class OptionsTrackingData : public OscTrackingData {
   Eigen::VectorXd filtered_y_;
   Eigen::VectorXd filtered_ydot_;
   Eigen::MatrixXd time_varying_weight_;
+  // Scratch for the gain and feedforward multipliers
+  Eigen::MatrixXd gain_multiplier_;
+  Eigen::VectorXd yddot_scratch_;
   double tau_ = -1;
   std::set<int> low_pass_filter_element_idx_;
   double last_timestamp_ = -1;
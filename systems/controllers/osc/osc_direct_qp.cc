@@ -0,0 +1,422 @@
+#include "systems/controllers/osc/osc_direct_qp.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "drake/common/drake_assert.h"
+
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace dairlib::systems::controllers {
+
+namespace {
+// Number of rows of the linearized friction cone of a single contact point
+constexpr int kFrictionConeRows = 5;
+constexpr int kContactDim = 3;
+}  // namespace
+
+template <int kNv, int kNu, int kNc>
+SizedOscDirectQp<kNv, kNu, kNc>::SizedOscDirectQp(int n_v, int n_u, int n_c,
+                                                 int n_h, int n_c_active,
+                                                 bool soft_contact,
+                                                 bool input_constraints,
+                                                 bool reduced)
+    : n_v_(n_v),
+      n_u_(n_u),
+      n_c_(n_c),
+      n_h_(n_h),
+      n_c_active_(n_c_active),
+      soft_contact_(soft_contact),
+      input_constraints_(input_constraints),
+      reduced_(reduced) {
+  DRAKE_DEMAND(kNv == Eigen::Dynamic || kNv == n_v_);
+  DRAKE_DEMAND(kNu == Eigen::Dynamic || kNu == n_u_);
+  DRAKE_DEMAND(kNc == Eigen::Dynamic || kNc == n_c_);
+  DRAKE_DEMAND(n_c_ % kContactDim == 0);
+  const int n_contacts = n_c_ / kContactDim;
+  n_x_ = n_u_ + n_c_;
+  if (reduced_) {
+    // z = [u, lambda_c, epsilon] and no dynamics or holonomic rows
+    z_u_start_ = 0;
+    z_lambda_c_start_ = n_u_;
+    z_epsilon_start_ = n_x_;
+    num_vars_ = n_x_ + n_c_active_;
+    holonomic_row_ = 0;
+    contact_row_ = 0;
+  } else {
+    z_u_start_ = u_start();
+    z_lambda_c_start_ = lambda_c_start();
+    z_epsilon_start_ = epsilon_start();
+    num_vars_ = num_full_vars();
+    holonomic_row_ = n_v_;
+    contact_row_ = holonomic_row_ + n_h_;
+  }
+  friction_row_ = contact_row_ + n_c_active_;
+  input_row_ = friction_row_ + kFrictionConeRows * n_contacts;
+  num_constraints_ = input_row_ + (input_constraints_ ? n_u_ : 0);
+
+  // Cost Hessian: one block per variable group on the diagonal
+  std::vector<Eigen::Triplet<double>> P_triplets;
+  std::vector<Eigen::Triplet<double>> A_triplets;
+  if (reduced_) {
+    // The projected Hessian couples u and lambda_c
+    P_x_ = MakeBlock(0, 0, n_x_, n_x_, Block::kUpper, &P_triplets);
+    A_contact_dv_ = MakeBlock(contact_row_, 0, n_c_active_, n_x_,
+                              Block::kDense, &A_triplets);
+  } else {
+    P_dv_ = MakeBlock(dv_start(), dv_start(), n_v_, n_v_, Block::kUpper,
+                      &P_triplets);
+    P_u_ = MakeBlock(u_start(), u_start(), n_u_, n_u_, Block::kUpper,
+                     &P_triplets);
+    P_lambda_c_ = MakeBlock(lambda_c_start(), lambda_c_start(), n_c_, n_c_,
+                            Block::kUpper, &P_triplets);
+    P_lambda_h_ = MakeBlock(lambda_h_start(), lambda_h_start(), n_h_, n_h_,
+                            Block::kUpper, &P_triplets);
+
+    // Constraints
+    A_dyn_dv_ =
+        MakeBlock(0, dv_start(), n_v_, n_v_, Block::kDense, &A_triplets);
+    A_dyn_u_ =
+        MakeBlock(0, u_start(), n_v_, n_u_, Block::kDense, &A_triplets);
+    A_dyn_lambda_c_ = MakeBlock(0, lambda_c_start(), n_v_, n_c_,
+                                Block::kDense, &A_triplets);
+    A_dyn_lambda_h_ = MakeBlock(0, lambda_h_start(), n_v_, n_h_,
+                                Block::kDense, &A_triplets);
+    A_holonomic_ = MakeBlock(holonomic_row_, dv_start(), n_h_, n_v_,
+                             Block::kDense, &A_triplets);
+    A_contact_dv_ = MakeBlock(contact_row_, dv_start(), n_c_active_, n_v_,
+                              Block::kDense, &A_triplets);
+  }
+  P_epsilon_ = MakeBlock(z_epsilon_start_, z_epsilon_start_, n_c_active_,
+                         n_c_active_, Block::kDiagonal, &P_triplets);
+  A_contact_epsilon_ = MakeBlock(
+      contact_row_, z_epsilon_start_, soft_contact_ ? n_c_active_ : 0,
+      soft_contact_ ? n_c_active_ : 0, Block::kDiagonal, &A_triplets);
+  for (int i = 0; i < n_contacts; ++i) {
+    A_friction_.push_back(MakeBlock(friction_row_ + kFrictionConeRows * i,
+                                    z_lambda_c_start_ + kContactDim * i,
+                                    kFrictionConeRows, kContactDim,
+                                    Block::kDense, &A_triplets));
+  }
+  A_input_ = MakeBlock(input_row_, z_u_start_, input_constraints_ ? n_u_ : 0,
+                       input_constraints_ ? n_u_ : 0, Block::kDiagonal,
+                       &A_triplets);
+
+  P_.resize(num_vars_, num_vars_);
+  P_.setFromTriplets(P_triplets.begin(), P_triplets.end());
+  P_.makeCompressed();
+  A_.resize(num_constraints_, num_vars_);
+  A_.setFromTriplets(A_triplets.begin(), A_triplets.end());
+  A_.makeCompressed();
+
+  if (reduced_) {
+    for (Block* block : {&P_x_, &P_epsilon_}) {
+      FindBlockSlots(P_, block);
+    }
+    for (Block* block : {&A_contact_dv_, &A_contact_epsilon_, &A_input_}) {
+      FindBlockSlots(A_, block);
+    }
+  } else {
+    for (Block* block :
+         {&P_dv_, &P_u_, &P_lambda_c_, &P_lambda_h_, &P_epsilon_}) {
+      FindBlockSlots(P_, block);
+    }
+    for (Block* block :
+         {&A_dyn_dv_, &A_dyn_u_, &A_dyn_lambda_c_, &A_dyn_lambda_h_,
+          &A_holonomic_, &A_contact_dv_, &A_contact_epsilon_, &A_input_}) {
+      FindBlockSlots(A_, block);
+    }
+  }
+  for (auto& block : A_friction_) {
+    FindBlockSlots(A_, &block);
+  }
+
+  q_ = VectorXd::Zero(num_vars_);
+  l_ = VectorXd::Zero(num_constraints_);
+  u_ = VectorXd::Zero(num_constraints_);
+  H_dv_ = MatrixXd::Zero(n_v_, n_v_);
+  H_u_ = MatrixXd::Zero(n_u_, n_u_);
+  H_lambda_c_ = MatrixXd::Zero(n_c_, n_c_);
+  H_lambda_h_ = MatrixXd::Zero(n_h_, n_h_);
+  H_epsilon_ = VectorXd::Zero(n_c_active_);
+
+  if (reduced_) {
+    q_full_ = VectorXd::Zero(num_full_vars());
+    B_ = MatrixXd::Zero(n_v_, n_u_);
+    Minv_rhs_ = MatrixXd::Zero(n_v_, n_x_ + n_h_ + 1);
+    Lambda_h_ = MatrixXd::Zero(n_h_, n_h_);
+    Lambda_h_llt_ = Eigen::LLT<MatrixXd>(n_h_);
+    G_ = MatrixXd::Zero(n_v_, n_x_);
+    g_ = VectorXd::Zero(n_v_);
+    L_h_ = MatrixXd::Zero(n_h_, n_x_);
+    l_h_ = VectorXd::Zero(n_h_);
+    H_x_ = MatrixXd::Zero(n_x_, n_x_);
+    H_G_ = MatrixXd::Zero(n_v_, n_x_);
+    H_L_ = MatrixXd::Zero(n_h_, n_x_);
+    J_c_G_ = MatrixXd::Zero(n_c_active_, n_x_);
+  }
+
+  // The epsilon relaxation of the contact constraint is constant
+  WriteBlock(A_contact_epsilon_, VectorXd::Ones(A_contact_epsilon_.cols), 1,
+             false, &A_);
+}
+
+template <int kNv, int kNu, int kNc>
+typename SizedOscDirectQp<kNv, kNu, kNc>::Block
+SizedOscDirectQp<kNv, kNu, kNc>::MakeBlock(
+    int row, int col, int rows, int cols, typename Block::Type type,
+    std::vector<Eigen::Triplet<double>>* triplets) {
+  Block block{row, col, rows, cols, type, std::vector<int>(cols)};
+  for (int j = 0; j < cols; ++j) {
+    switch (type) {
+      case Block::kDense:
+        for (int i = 0; i < rows; ++i) {
+          triplets->emplace_back(row + i, col + j, 0);
+        }
+        break;
+      case Block::kUpper:
+        for (int i = 0; i <= j; ++i) {
+          triplets->emplace_back(row + i, col + j, 0);
+        }
+        break;
+      case Block::kDiagonal:
+        triplets->emplace_back(row + j, col + j, 0);
+        break;
+    }
+  }
+  return block;
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::FindBlockSlots(
+    const Eigen::SparseMatrix<double>& mat, Block* block) {
+  for (int j = 0; j < block->cols; ++j) {
+    const int row = (block->type == Block::kDiagonal) ? block->row + j
+                                                      : block->row;
+    const int col = block->col + j;
+    const int* begin = mat.innerIndexPtr() + mat.outerIndexPtr()[col];
+    const int* end = mat.innerIndexPtr() + mat.outerIndexPtr()[col + 1];
+    const int* it = std::lower_bound(begin, end, row);
+    DRAKE_DEMAND(it != end && *it == row);
+    block->col_start[j] = it - mat.innerIndexPtr();
+  }
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::WriteBlock(
+    const Block& block, const Eigen::Ref<const MatrixXd>& value, double scale,
+    bool transpose, Eigen::SparseMatrix<double>* mat) {
+  double* x = mat->valuePtr();
+  for (int j = 0; j < block.cols; ++j) {
+    double* x_j = x + block.col_start[j];
+    switch (block.type) {
+      case Block::kDense:
+        if (transpose) {
+          for (int i = 0; i < block.rows; ++i) {
+            x_j[i] = scale * value(j, i);
+          }
+        } else {
+          for (int i = 0; i < block.rows; ++i) {
+            x_j[i] = scale * value(i, j);
+          }
+        }
+        break;
+      case Block::kUpper:
+        for (int i = 0; i <= j; ++i) {
+          x_j[i] = scale * value(i, j);
+        }
+        break;
+      case Block::kDiagonal:
+        // `value` holds the diagonal as a column vector
+        x_j[0] = scale * value(j, 0);
+        break;
+    }
+  }
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::SetActuationMatrix(const MatrixVU& B) {
+  DRAKE_DEMAND(B.rows() == n_v_ && B.cols() == n_u_);
+  if (reduced_) {
+    B_ = B;
+    return;
+  }
+  WriteBlock(A_dyn_u_, B, -1, false, &A_);
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::SetFrictionCone(double mu) {
+  MatrixXd A(kFrictionConeRows, kContactDim);
+  A << -1, 0, mu, 0, -1, mu, 1, 0, mu, 0, 1, mu, 0, 0, 1;
+  for (unsigned int i = 0; i < A_friction_.size(); ++i) {
+    WriteBlock(A_friction_[i], A, 1, false, &A_);
+    SetFrictionConeActive(i, true);
+    u_.segment(A_friction_[i].row, kFrictionConeRows).setConstant(
+        std::numeric_limits<double>::infinity());
+  }
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::SetInputLimits(const VectorXd& u_min,
+                                                     const VectorXd& u_max) {
+  if (!input_constraints_) return;
+  WriteBlock(A_input_, VectorXd::Ones(n_u_), 1, false, &A_);
+  l_.segment(input_row_, n_u_) = u_min;
+  u_.segment(input_row_, n_u_) = u_max;
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::ClearCosts() {
+  H_dv_.setZero();
+  H_u_.setZero();
+  H_lambda_c_.setZero();
+  H_lambda_h_.setZero();
+  H_epsilon_.setZero();
+  q_.setZero();
+  if (reduced_) {
+    q_full_.setZero();
+  }
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::SetDynamics(const MatrixVV& M,
+                                                  const MatrixCV& J_c,
+                                                  const MatrixHV& J_h,
+                                                  const VectorV& bias) {
+  ///    M*dv + bias == J_c^T*lambda_c + J_h^T*lambda_h + B*u
+  /// -> M*dv - J_c^T*lambda_c - J_h^T*lambda_h - B*u == - bias
+  DRAKE_DEMAND(!reduced_);
+  WriteBlock(A_dyn_dv_, M, 1, false, &A_);
+  WriteBlock(A_dyn_lambda_c_, J_c, -1, true, &A_);
+  WriteBlock(A_dyn_lambda_h_, J_h, -1, true, &A_);
+  l_.head(n_v_) = -bias;
+  u_.head(n_v_) = -bias;
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::SetHolonomicConstraint(
+    const MatrixHV& J_h, const VectorXd& JdotV_h) {
+  DRAKE_DEMAND(!reduced_);
+  WriteBlock(A_holonomic_, J_h, 1, false, &A_);
+  l_.segment(holonomic_row_, n_h_) = -JdotV_h;
+  u_.segment(holonomic_row_, n_h_) = -JdotV_h;
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::SetReducedDynamics(
+    const Eigen::LLT<MatrixVV>& M_llt, const MatrixCV& J_c, const MatrixHV& J_h,
+    const VectorXd& JdotV_h, const VectorV& bias) {
+  DRAKE_DEMAND(reduced_);
+  // M⁻¹ [B, J_cᵀ, J_hᵀ, bias] with a single (multiple right hand side) solve
+  Minv_rhs_.leftCols(n_u_) = B_;
+  Minv_rhs_.middleCols(n_u_, n_c_) = J_c.transpose();
+  Minv_rhs_.middleCols(n_x_, n_h_) = J_h.transpose();
+  Minv_rhs_.template rightCols<1>() = bias;
+  M_llt.solveInPlace(Minv_rhs_);
+  const auto Minv_Jh_T = Minv_rhs_.middleCols(n_x_, n_h_);
+
+  // Without holonomic constraints, dv = M⁻¹ (B*u + J_cᵀ*lambda_c - bias)
+  G_ = Minv_rhs_.leftCols(n_x_);
+  g_ = -Minv_rhs_.template rightCols<1>();
+  if (n_h_ > 0) {
+    // lambda_h = -(J_h M⁻¹ J_hᵀ)⁻¹ (J_h*(G*x + g) + JdotV_h)
+    Lambda_h_.noalias() = J_h * Minv_Jh_T;
+    Lambda_h_llt_.compute(Lambda_h_);
+    L_h_.noalias() = -J_h * G_;
+    l_h_.noalias() = -J_h * g_;
+    l_h_ -= JdotV_h;
+    Lambda_h_llt_.solveInPlace(L_h_);
+    Lambda_h_llt_.solveInPlace(l_h_);
+    G_.noalias() += Minv_Jh_T * L_h_;
+    g_.noalias() += Minv_Jh_T * l_h_;
+  }
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::SetContactConstraint(
+    const MatrixActiveCV& J_c_active, const VectorActiveC& JdotV_c_active) {
+  if (reduced_) {
+    ///    J_c_active*(G*x + g) (+ epsilon) == -JdotV_c_active
+    J_c_G_.noalias() = J_c_active * G_;
+    WriteBlock(A_contact_dv_, J_c_G_, 1, false, &A_);
+    l_.segment(contact_row_, n_c_active_).noalias() = -J_c_active * g_;
+    l_.segment(contact_row_, n_c_active_) -= JdotV_c_active;
+    u_.segment(contact_row_, n_c_active_) =
+        l_.segment(contact_row_, n_c_active_);
+    return;
+  }
+  WriteBlock(A_contact_dv_, J_c_active, 1, false, &A_);
+  l_.segment(contact_row_, n_c_active_) = -JdotV_c_active;
+  u_.segment(contact_row_, n_c_active_) = -JdotV_c_active;
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::SetFrictionConeActive(int i,
+                                                            bool active) {
+  l_.segment(A_friction_.at(i).row, kFrictionConeRows)
+      .setConstant(active ? 0 : -std::numeric_limits<double>::infinity());
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::PackCosts() {
+  if (reduced_) {
+    // With dv = G*x + g and lambda_h = L_h*x + l_h:
+    //   H_x = Gᵀ H_dv G + blkdiag(H_u, H_lambda_c) + L_hᵀ H_lambda_h L_h
+    //   q_x = Gᵀ (H_dv g + q_dv) + [q_u; q_lambda_c]
+    //         + L_hᵀ (H_lambda_h l_h + q_lambda_h)
+    // Only the upper triangles of the Hessian blocks are used.
+    auto q_x = q_.head(n_x_);
+    H_G_.noalias() = H_dv_.template selfadjointView<Eigen::Upper>() * G_;
+    H_x_.noalias() = G_.transpose() * H_G_;
+    H_x_.topLeftCorner(n_u_, n_u_).template triangularView<Eigen::Upper>() +=
+        H_u_;
+    H_x_.bottomRightCorner(n_c_, n_c_)
+        .template triangularView<Eigen::Upper>() += H_lambda_c_;
+    q_x = q_full_.segment(u_start(), n_x_);  // u and lambda_c are adjacent
+    q_x.noalias() += G_.transpose() * q_full_.segment(dv_start(), n_v_);
+    q_x.noalias() += H_G_.transpose() * g_;
+    if (n_h_ > 0) {
+      H_L_.noalias() = H_lambda_h_.selfadjointView<Eigen::Upper>() * L_h_;
+      H_x_.noalias() += L_h_.transpose() * H_L_;
+      q_x.noalias() +=
+          L_h_.transpose() * q_full_.segment(lambda_h_start(), n_h_);
+      q_x.noalias() += H_L_.transpose() * l_h_;
+    }
+    q_.tail(n_c_active_) = q_full_.segment(epsilon_start(), n_c_active_);
+    WriteBlock(P_x_, H_x_, 1, false, &P_);
+    WriteBlock(P_epsilon_, H_epsilon_, 1, false, &P_);
+    return;
+  }
+  WriteBlock(P_dv_, H_dv_, 1, false, &P_);
+  WriteBlock(P_u_, H_u_, 1, false, &P_);
+  WriteBlock(P_lambda_c_, H_lambda_c_, 1, false, &P_);
+  WriteBlock(P_lambda_h_, H_lambda_h_, 1, false, &P_);
+  WriteBlock(P_epsilon_, H_epsilon_, 1, false, &P_);
+}
+
+template <int kNv, int kNu, int kNc>
+void SizedOscDirectQp<kNv, kNu, kNc>::GetFullSolution(
+    const VectorXd& z, VectorXd* full_solution) const {
+  DRAKE_DEMAND(z.size() == num_vars_);
+  if (!reduced_) {
+    *full_solution = z;
+    return;
+  }
+  full_solution->resize(num_full_vars());
+  const auto x = z.head(n_x_);
+  full_solution->segment(dv_start(), n_v_).noalias() = G_ * x;
+  full_solution->segment(dv_start(), n_v_) += g_;
+  full_solution->segment(u_start(), n_x_) = x;
+  full_solution->segment(lambda_h_start(), n_h_).noalias() = L_h_ * x;
+  full_solution->segment(lambda_h_start(), n_h_) += l_h_;
+  full_solution->segment(epsilon_start(), n_c_active_) =
+      z.tail(n_c_active_);
+}
+
+template class SizedOscDirectQp<Eigen::Dynamic, Eigen::Dynamic,
+                                Eigen::Dynamic>;
+template class SizedOscDirectQp<kCassieNv, kCassieNu, kCassieNc>;
+template class SizedOscDirectQp<kCassieFixedSpringsNv, kCassieNu, kCassieNc>;
+
+}  // namespace dairlib::systems::controllers
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include "systems/controllers/osc/osc_sizes.h"
+
+namespace dairlib::systems::controllers {
+
+/// OscDirectQp holds the OSC quadratic program directly in OSQP's standard
+/// form
+///     min 0.5 zᵀPz + qᵀz
+///     s.t. l ≤ Az ≤ u
+/// with z = [dv, u, lambda_c, lambda_h, epsilon], bypassing
+/// drake::solvers::MathematicalProgram.
+///
+/// The sparsity patterns of P (upper triangular) and A are built once in the
+/// constructor from the block structure of the OSC problem. Every dense block
+/// of the pattern occupies a contiguous range of each of its columns in the
+/// compressed column storage, so the setters below copy the blocks straight
+/// into the value arrays without any search or allocation.
+///
+/// Rows of A:
+///   - dynamics, n_v rows: [M, -B, -J_cᵀ, -J_hᵀ, 0] z = -bias
+///   - holonomic, n_h rows: [J_h, 0, 0, 0, 0] z = -JdotV_h
+///   - contact, n_c_active rows: [J_c_active, 0, 0, 0, I] z = -JdotV_c_active
+///     (the identity block on epsilon only exists for soft contacts)
+///   - friction cone, 5 rows per contact point on lambda_c
+///   - input limits, n_u rows (only with input constraints)
+///
+/// In the reduced formulation, dv and lambda_h are eliminated analytically
+/// and OSQP only sees z = [u, lambda_c, epsilon]. With x = [u, lambda_c],
+/// the dynamics and the holonomic constraint
+///     M*dv + bias == B*u + J_cᵀ*lambda_c + J_hᵀ*lambda_h
+///     J_h*dv + JdotV_h == 0
+/// give
+///     lambda_h = -(J_h M⁻¹ J_hᵀ)⁻¹ (J_h M⁻¹ (B*u + J_cᵀ*lambda_c - bias)
+///                                   + JdotV_h) = L_h*x + l_h
+///     dv = M⁻¹ (B*u + J_cᵀ*lambda_c + J_hᵀ*lambda_h - bias) = G*x + g
+/// which requires J_h to have full row rank. The costs are still accumulated
+/// on the full variables and are projected onto x by PackCosts(); the rows of
+/// A are the contact constraints (J_c_active*G on x), the friction cones and
+/// the input limits. The full solution is recovered with GetFullSolution().
+///
+/// n_v, n_u and n_c can be fixed at compile time (see OscTypes), which makes
+/// the dense blocks fixed-size Eigen matrices. OscDirectQp is the variant
+/// with every size dynamic; the fixed-size variants are compiled for Cassie
+/// (see osc_sizes.h).
+template <int kNv, int kNu, int kNc>
+class SizedOscDirectQp {
+ public:
+  using Types = OscTypes<kNv, kNu, kNc>;
+  using VectorV = typename Types::VectorV;
+  using MatrixVV = typename Types::MatrixVV;
+  using MatrixVU = typename Types::MatrixVU;
+  using MatrixUU = typename Types::MatrixUU;
+  using MatrixCC = typename Types::MatrixCC;
+  using MatrixCV = typename Types::MatrixCV;
+  using MatrixHV = typename Types::MatrixHV;
+  using MatrixActiveCV = typename Types::MatrixActiveCV;
+  using VectorActiveC = typename Types::VectorActiveC;
+
+  /// The sizes fixed at compile time must match the arguments.
+  /// @param n_v number of velocities of the plant without springs
+  /// @param n_u number of actuators
+  /// @param n_c dimension of all contact forces (kSpaceDim per contact point)
+  /// @param n_h dimension of the holonomic constraint forces
+  /// @param n_c_active dimension of the active contact constraints (epsilon)
+  /// @param soft_contact whether epsilon relaxes the contact constraints
+  /// @param input_constraints whether to include the input limit rows
+  /// @param reduced whether to eliminate dv and lambda_h (see above)
+  SizedOscDirectQp(int n_v, int n_u, int n_c, int n_h, int n_c_active,
+                   bool soft_contact, bool input_constraints,
+                   bool reduced = false);
+
+  // Offsets of the variable blocks in the full variable vector
+  // [dv, u, lambda_c, lambda_h, epsilon], which is also z unless the QP is
+  // reduced. mutable_q() and GetFullSolution() use this layout.
+  int dv_start() const { return 0; }
+  int u_start() const { return n_v_; }
+  int lambda_c_start() const { return n_v_ + n_u_; }
+  int lambda_h_start() const { return n_v_ + n_u_ + n_c_; }
+  int epsilon_start() const { return n_v_ + n_u_ + n_c_ + n_h_; }
+  int num_full_vars() const { return n_v_ + n_u_ + n_c_ + n_h_ + n_c_active_; }
+  /// Size of z and number of rows of A
+  int num_vars() const { return num_vars_; }
+  int num_constraints() const { return num_constraints_; }
+  bool is_reduced() const { return reduced_; }
+
+  /// Constant parts of the constraints. Call once after construction.
+  void SetActuationMatrix(const MatrixVU& B);
+  void SetFrictionCone(double mu);
+  void SetInputLimits(const Eigen::VectorXd& u_min,
+                      const Eigen::VectorXd& u_max);
+
+  /// Zeroes the cost Hessian blocks and the linear cost term. Costs are then
+  /// accumulated by adding to the mutable Hessian blocks and q.
+  void ClearCosts();
+  MatrixVV& mutable_H_dv() { return H_dv_; }
+  MatrixUU& mutable_H_u() { return H_u_; }
+  MatrixCC& mutable_H_lambda_c() { return H_lambda_c_; }
+  Eigen::MatrixXd& mutable_H_lambda_h() { return H_lambda_h_; }
+  VectorActiveC& mutable_H_epsilon_diagonal() { return H_epsilon_; }
+  /// Linear cost on the full variable vector
+  Eigen::VectorXd& mutable_q() { return reduced_ ? q_full_ : q_; }
+
+  ///    M*dv + bias == J_c^T*lambda_c + J_h^T*lambda_h + B*u
+  /// Not available for the reduced QP.
+  void SetDynamics(const MatrixVV& M, const MatrixCV& J_c, const MatrixHV& J_h,
+                   const VectorV& bias);
+  ///    J_h*dv == -JdotV_h
+  /// Not available for the reduced QP.
+  void SetHolonomicConstraint(const MatrixHV& J_h,
+                              const Eigen::VectorXd& JdotV_h);
+  /// Reduced QP only. Eliminates dv and lambda_h using the factorization of
+  /// M, the dynamics and the holonomic constraint
+  ///    M*dv + bias == J_c^T*lambda_c + J_h^T*lambda_h + B*u
+  ///    J_h*dv == -JdotV_h
+  /// Must be called before SetContactConstraint().
+  void SetReducedDynamics(const Eigen::LLT<MatrixVV>& M_llt,
+                          const MatrixCV& J_c, const MatrixHV& J_h,
+                          const Eigen::VectorXd& JdotV_h, const VectorV& bias);
+  ///    J_c_active*dv (+ epsilon) == -JdotV_c_active
+  void SetContactConstraint(const MatrixActiveCV& J_c_active,
+                            const VectorActiveC& JdotV_c_active);
+  /// Enables (lower bound 0) or disables (lower bound -inf) the friction cone
+  /// of contact point i
+  void SetFrictionConeActive(int i, bool active);
+
+  /// Copies the upper triangles of the cost Hessian blocks into P (after
+  /// projecting them onto [u, lambda_c] for the reduced QP). Call after all
+  /// costs have been accumulated and before solving.
+  void PackCosts();
+
+  /// Maps a solution z of the QP to the full variable vector.
+  void GetFullSolution(const Eigen::VectorXd& z,
+                       Eigen::VectorXd* full_solution) const;
+
+  // Problem data in OSQP form
+  const Eigen::SparseMatrix<double>& P() const { return P_; }
+  const Eigen::SparseMatrix<double>& A() const { return A_; }
+  const Eigen::VectorXd& q() const { return q_; }
+  const Eigen::VectorXd& l() const { return l_; }
+  const Eigen::VectorXd& u() const { return u_; }
+
+ private:
+  // A block of a compressed column major matrix. For kDense blocks every
+  // entry is part of the sparsity pattern; kUpper blocks (diagonal blocks of
+  // P) only store the upper triangle; kDiagonal blocks only the diagonal.
+  // col_start[j] is the index in the value array of the first entry of block
+  // column j.
+  struct Block {
+    enum Type { kDense, kUpper, kDiagonal };
+    int row;
+    int col;
+    int rows;
+    int cols;
+    Type type;
+    std::vector<int> col_start;
+  };
+
+  static Block MakeBlock(int row, int col, int rows, int cols,
+                         typename Block::Type type,
+                         std::vector<Eigen::Triplet<double>>* triplets);
+  static void FindBlockSlots(const Eigen::SparseMatrix<double>& mat,
+                             Block* block);
+  // Copies `scale * value` (or `scale * valueᵀ` if `transpose`) into the
+  // slots of `block`.
+  static void WriteBlock(const Block& block,
+                         const Eigen::Ref<const Eigen::MatrixXd>& value,
+                         double scale, bool transpose,
+                         Eigen::SparseMatrix<double>* mat);
+
+  int n_v_;
+  int n_u_;
+  int n_c_;
+  int n_h_;
+  int n_c_active_;
+  bool soft_contact_;
+  bool input_constraints_;
+  bool reduced_;
+  int num_vars_;
+  int num_constraints_;
+
+  // Row offsets of the constraint groups in A
+  int holonomic_row_;
+  int contact_row_;
+  int friction_row_;
+  int input_row_;
+  // Offsets of the variable blocks in z
+  int z_u_start_;
+  int z_lambda_c_start_;
+  int z_epsilon_start_;
+
+  Eigen::SparseMatrix<double> P_;
+  Eigen::SparseMatrix<double> A_;
+  Eigen::VectorXd q_;
+  Eigen::VectorXd l_;
+  Eigen::VectorXd u_;
+
+  // Dense cost accumulators
+  MatrixVV H_dv_;
+  MatrixUU H_u_;
+  MatrixCC H_lambda_c_;
+  Eigen::MatrixXd H_lambda_h_;
+  VectorActiveC H_epsilon_;
+
+  // Reduced QP. x = [u, lambda_c], dv = G*x + g and lambda_h = L_h*x + l_h.
+  static constexpr int kNx = Types::kNx;
+  using MatrixVX = Eigen::Matrix<double, kNv, kNx>;
+  using MatrixHX = Eigen::Matrix<double, Eigen::Dynamic, kNx>;
+  int n_x_;
+  Eigen::VectorXd q_full_;
+  MatrixVU B_;
+  // M⁻¹ [B, J_cᵀ, J_hᵀ, bias]
+  Eigen::Matrix<double, kNv, Eigen::Dynamic> Minv_rhs_;
+  Eigen::MatrixXd Lambda_h_;  // J_h M⁻¹ J_hᵀ
+  Eigen::LLT<Eigen::MatrixXd> Lambda_h_llt_;
+  MatrixVX G_;
+  VectorV g_;
+  MatrixHX L_h_;
+  Eigen::VectorXd l_h_;
+  // Scratch space of PackCosts()
+  Eigen::Matrix<double, kNx, kNx> H_x_;
+  MatrixVX H_G_;
+  MatrixHX H_L_;
+  Eigen::Matrix<double, Eigen::Dynamic, kNx, 0, kNc, kNx> J_c_G_;
+
+  // Blocks of P. For the reduced QP, P_x_ replaces the dv, u, lambda_c and
+  // lambda_h blocks.
+  Block P_x_;
+  Block P_dv_;
+  Block P_u_;
+  Block P_lambda_c_;
+  Block P_lambda_h_;
+  Block P_epsilon_;
+
+  // Blocks of A
+  Block A_dyn_dv_;
+  Block A_dyn_u_;
+  Block A_dyn_lambda_c_;
+  Block A_dyn_lambda_h_;
+  Block A_holonomic_;
+  Block A_contact_dv_;  // J_c_active*G on x for the reduced QP
+  Block A_contact_epsilon_;
+  std::vector<Block> A_friction_;
+  Block A_input_;
+};
+
+using OscDirectQp =
+    SizedOscDirectQp<Eigen::Dynamic, Eigen::Dynamic, Eigen::Dynamic>;
+
+}  // namespace dairlib::systems::controllers
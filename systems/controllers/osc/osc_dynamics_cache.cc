@@ -0,0 +1,142 @@
+#include "systems/controllers/osc/osc_dynamics_cache.h"
+
+#include <algorithm>
+
+#include "multibody/multibody_utils.h"
+
+using drake::multibody::MultibodyPlant;
+using drake::systems::Context;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+namespace dairlib::systems::controllers {
+
+template <int kNv, int kNu>
+SizedOscDynamicsCache<kNv, kNu>::SizedOscDynamicsCache(
+    const MultibodyPlant<double>& plant, const Context<double>* context,
+    const std::vector<const multibody::WorldPointEvaluator<double>*>& contacts,
+    const multibody::KinematicEvaluatorSet<double>* holonomic_evaluators,
+    int num_tracking_data)
+    : plant_(plant),
+      context_(context),
+      contacts_(contacts),
+      holonomic_evaluators_(holonomic_evaluators) {
+  const int n_v = plant_.num_velocities();
+  DRAKE_DEMAND(kNv == Eigen::Dynamic || kNv == n_v);
+  DRAKE_DEMAND(kNu == Eigen::Dynamic || kNu == plant_.num_actuators());
+  M_.resize(n_v, n_v);
+  M_llt_ = Eigen::LLT<MatrixVV>(n_v);
+  bias_.resize(n_v);
+  tau_g_.resize(n_v);
+  B_ = plant_.MakeActuationMatrix();
+  for (const auto* contact : contacts_) {
+    DRAKE_DEMAND(contact->num_full() == 3);
+    J_contact_.emplace_back(3, n_v);
+    JdotV_contact_.emplace_back();
+  }
+  J_contact_valid_.assign(contacts_.size(), false);
+  JdotV_contact_valid_.assign(contacts_.size(), false);
+  const int n_h =
+      holonomic_evaluators_ ? holonomic_evaluators_->count_full() : 0;
+  J_h_.resize(n_h, n_v);
+  JdotV_h_.resize(n_h);
+  tracking_data_valid_.assign(num_tracking_data, false);
+}
+
+template <int kNv, int kNu>
+void SizedOscDynamicsCache<kNv, kNu>::Invalidate() {
+  M_valid_ = false;
+  M_llt_valid_ = false;
+  bias_valid_ = false;
+  std::fill(J_contact_valid_.begin(), J_contact_valid_.end(), false);
+  std::fill(JdotV_contact_valid_.begin(), JdotV_contact_valid_.end(), false);
+  J_h_valid_ = false;
+  JdotV_h_valid_ = false;
+  std::fill(tracking_data_valid_.begin(), tracking_data_valid_.end(), false);
+}
+
+template <int kNv, int kNu>
+const typename SizedOscDynamicsCache<kNv, kNu>::MatrixVV&
+SizedOscDynamicsCache<kNv, kNu>::M() {
+  if (!M_valid_) {
+    plant_.CalcMassMatrix(*context_, &M_);
+    M_valid_ = true;
+  }
+  return M_;
+}
+
+template <int kNv, int kNu>
+const Eigen::LLT<typename SizedOscDynamicsCache<kNv, kNu>::MatrixVV>&
+SizedOscDynamicsCache<kNv, kNu>::M_llt() {
+  if (!M_llt_valid_) {
+    M_llt_.compute(M());
+    M_llt_valid_ = true;
+  }
+  return M_llt_;
+}
+
+template <int kNv, int kNu>
+const typename SizedOscDynamicsCache<kNv, kNu>::VectorV&
+SizedOscDynamicsCache<kNv, kNu>::bias() {
+  if (!bias_valid_) {
+    plant_.CalcBiasTerm(*context_, &bias_);
+    multibody::CalcGravityGeneralizedForces<double>(plant_, *context_,
+                                                    &tau_g_);
+    bias_ -= tau_g_;
+    // TODO (yangwill): Characterize damping in cassie model
+    bias_valid_ = true;
+  }
+  return bias_;
+}
+
+template <int kNv, int kNu>
+const typename SizedOscDynamicsCache<kNv, kNu>::Matrix3V&
+SizedOscDynamicsCache<kNv, kNu>::J_contact(int i) {
+  if (!J_contact_valid_[i]) {
+    contacts_[i]->EvalFullJacobian(*context_, &J_contact_[i]);
+    J_contact_valid_[i] = true;
+  }
+  return J_contact_[i];
+}
+
+template <int kNv, int kNu>
+const Eigen::Vector3d& SizedOscDynamicsCache<kNv, kNu>::JdotV_contact(int i) {
+  if (!JdotV_contact_valid_[i]) {
+    contacts_[i]->EvalFullJacobianDotTimesV(*context_, &JdotV_contact_[i]);
+    JdotV_contact_valid_[i] = true;
+  }
+  return JdotV_contact_[i];
+}
+
+template <int kNv, int kNu>
+void SizedOscDynamicsCache<kNv, kNu>::EvalHolonomicKinematics() {
+  if (holonomic_evaluators_ != nullptr) {
+    holonomic_evaluators_->EvalFullKinematics(*context_, &h_points_, nullptr,
+                                              &J_h_, &JdotV_h_);
+  }
+  J_h_valid_ = true;
+  JdotV_h_valid_ = true;
+}
+
+template <int kNv, int kNu>
+const typename SizedOscDynamicsCache<kNv, kNu>::MatrixHV&
+SizedOscDynamicsCache<kNv, kNu>::J_h() {
+  if (!J_h_valid_) {
+    EvalHolonomicKinematics();
+  }
+  return J_h_;
+}
+
+template <int kNv, int kNu>
+const VectorXd& SizedOscDynamicsCache<kNv, kNu>::JdotV_h() {
+  if (!JdotV_h_valid_) {
+    EvalHolonomicKinematics();
+  }
+  return JdotV_h_;
+}
+
+template class SizedOscDynamicsCache<Eigen::Dynamic, Eigen::Dynamic>;
+template class SizedOscDynamicsCache<kCassieNv, kCassieNu>;
+template class SizedOscDynamicsCache<kCassieFixedSpringsNv, kCassieNu>;
+
+}  // namespace dairlib::systems::controllers
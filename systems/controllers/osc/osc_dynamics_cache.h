@@ -0,0 +1,120 @@
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Dense>
+#include <drake/multibody/plant/multibody_plant.h>
+
+#include "multibody/kinematic/kinematic_evaluator_set.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "systems/controllers/osc/osc_sizes.h"
+
+#include "drake/common/drake_copyable.h"
+
+namespace dairlib::systems::controllers {
+
+/// Per-tick cache of the rigid body dynamics terms used by
+/// `OperationalSpaceControl`, evaluated at the plant (without springs)
+/// context that the OSC owns:
+///  - the mass matrix M and its Cholesky factorization
+///  - the bias term C(q,v)v - tau_g(q) and the actuation matrix B
+///  - the full Jacobian J and Jdot*v of every contact point
+///  - the Jacobian J_h and Jdot_h*v of the holonomic constraints
+///
+/// It also records which tracking data have been updated (see
+/// OscTrackingData::UpdateKinematics()) this tick, so that the
+/// impact-invariant projection and the QP share one kinematics update per
+/// tracking data.
+///
+/// Each term is computed the first time it is requested after Invalidate()
+/// and then reused by every consumer of the tick (QP assembly, the
+/// impact-invariant projection, ...). All storage is allocated in the
+/// constructor; only the MultibodyPlant queries allocate internally. The
+/// caller is responsible for calling Invalidate() whenever the state in the
+/// context changes.
+///
+/// The terms are fixed-size when n_v and n_u are fixed at compile time (see
+/// OscTypes). OscDynamicsCache is the variant with dynamic sizes.
+template <int kNv, int kNu>
+class SizedOscDynamicsCache {
+ public:
+  DRAKE_NO_COPY_NO_MOVE_NO_ASSIGN(SizedOscDynamicsCache)
+
+  using Types = OscTypes<kNv, kNu, Eigen::Dynamic>;
+  using VectorV = typename Types::VectorV;
+  using MatrixVV = typename Types::MatrixVV;
+  using MatrixVU = typename Types::MatrixVU;
+  using Matrix3V = typename Types::Matrix3V;
+  using MatrixHV = typename Types::MatrixHV;
+
+  /// @param plant the plant without springs
+  /// @param context context of `plant`, which must outlive this object
+  /// @param contacts all contact points of the OSC, indexed as in
+  /// OperationalSpaceControl
+  /// @param holonomic_evaluators holonomic constraints of the OSC (can be
+  /// nullptr)
+  /// @param num_tracking_data number of tracking data of the OSC
+  SizedOscDynamicsCache(
+      const drake::multibody::MultibodyPlant<double>& plant,
+      const drake::systems::Context<double>* context,
+      const std::vector<const multibody::WorldPointEvaluator<double>*>&
+          contacts,
+      const multibody::KinematicEvaluatorSet<double>* holonomic_evaluators,
+      int num_tracking_data);
+
+  /// Marks every cached term as stale
+  void Invalidate();
+
+  const MatrixVV& M();
+  const Eigen::LLT<MatrixVV>& M_llt();
+  const VectorV& bias();
+  const MatrixVU& B() const { return B_; }
+
+  /// Full (3 x n_v) Jacobian of contact `i`
+  const Matrix3V& J_contact(int i);
+  /// Full Jdot*v of contact `i`
+  const Eigen::Vector3d& JdotV_contact(int i);
+
+  const MatrixHV& J_h();
+  const Eigen::VectorXd& JdotV_h();
+
+  int num_contacts() const { return contacts_.size(); }
+
+  /// Whether the kinematics of tracking data `i` have been updated since
+  /// Invalidate()
+  bool tracking_data_valid(int i) const { return tracking_data_valid_[i]; }
+  void set_tracking_data_valid(int i) { tracking_data_valid_[i] = true; }
+
+ private:
+  // Evaluates J_h and Jdot_h*v together, in one pass over the evaluators
+  void EvalHolonomicKinematics();
+
+  const drake::multibody::MultibodyPlant<double>& plant_;
+  const drake::systems::Context<double>* context_;
+  const std::vector<const multibody::WorldPointEvaluator<double>*> contacts_;
+  const multibody::KinematicEvaluatorSet<double>* holonomic_evaluators_;
+
+  MatrixVV M_;
+  Eigen::LLT<MatrixVV> M_llt_;
+  VectorV bias_;
+  VectorV tau_g_;
+  MatrixVU B_;
+  std::vector<Matrix3V> J_contact_;
+  std::vector<Eigen::Vector3d> JdotV_contact_;
+  MatrixHV J_h_;
+  Eigen::VectorXd JdotV_h_;
+  multibody::PointKinematics<double> h_points_;
+
+  bool M_valid_ = false;
+  bool M_llt_valid_ = false;
+  bool bias_valid_ = false;
+  std::vector<bool> J_contact_valid_;
+  std::vector<bool> JdotV_contact_valid_;
+  bool J_h_valid_ = false;
+  bool JdotV_h_valid_ = false;
+  std::vector<bool> tracking_data_valid_;
+};
+
+using OscDynamicsCache = SizedOscDynamicsCache<Eigen::Dynamic, Eigen::Dynamic>;
+
+}  // namespace dairlib::systems::controllers
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Eigen/Dense>
+
+namespace dairlib::systems::controllers {
+
+/// Problem dimensions of Cassie's OSC, for which the fixed-size variants of
+/// OperationalSpaceControl, OscDirectQp and OscDynamicsCache are compiled:
+/// 10 actuators and four contact points (front and rear of each toe).
+constexpr int kCassieNu = 10;
+constexpr int kCassieNc = 12;
+/// Cassie with springs (cassie_v2.urdf)
+constexpr int kCassieNq = 23;
+constexpr int kCassieNv = 22;
+/// Cassie with fixed springs (cassie_fixed_springs.urdf)
+constexpr int kCassieFixedSpringsNq = 19;
+constexpr int kCassieFixedSpringsNv = 18;
+
+/// Eigen types of the per-tick quantities of the OSC for n_v velocities (of
+/// the plant without springs), n_u actuators and n_c contact force
+/// dimensions. Each size is either a compile-time constant or Eigen::Dynamic,
+/// in which case the types are the usual MatrixXd and VectorXd.
+template <int kNv, int kNu, int kNc>
+struct OscTypes {
+  /// a + b, or Eigen::Dynamic if either is dynamic
+  static constexpr int Sum(int a, int b) {
+    return (a == Eigen::Dynamic || b == Eigen::Dynamic) ? Eigen::Dynamic
+                                                        : a + b;
+  }
+  /// Size of x = [u, lambda_c] of the reduced QP
+  static constexpr int kNx = Sum(kNu, kNc);
+
+  using VectorV = Eigen::Matrix<double, kNv, 1>;
+  using VectorU = Eigen::Matrix<double, kNu, 1>;
+  using VectorC = Eigen::Matrix<double, kNc, 1>;
+  using MatrixVV = Eigen::Matrix<double, kNv, kNv>;
+  using MatrixVU = Eigen::Matrix<double, kNv, kNu>;
+  using MatrixUU = Eigen::Matrix<double, kNu, kNu>;
+  using MatrixCC = Eigen::Matrix<double, kNc, kNc>;
+  using MatrixCV = Eigen::Matrix<double, kNc, kNv>;
+  /// Jacobian of a single contact point
+  using Matrix3V = Eigen::Matrix<double, 3, kNv>;
+  /// One row per holonomic constraint, a number only known at runtime
+  using MatrixHV = Eigen::Matrix<double, Eigen::Dynamic, kNv>;
+  /// One row per active contact constraint, at most n_c of them
+  using MatrixActiveCV =
+      Eigen::Matrix<double, Eigen::Dynamic, kNv, 0, kNc, kNv>;
+  using VectorActiveC = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, kNc, 1>;
+};
+
+}  // namespace dairlib::systems::controllers
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <numeric>
 
 #include <drake/multibody/plant/multibody_plant.h>
 
@@ -50,18 +51,35 @@ void OscTrackingData::Update(
     const VectorXd& x_wo_spr, const Context<double>& context_wo_spr,
     const drake::trajectories::Trajectory<double>& traj, double t,
     double t_since_state_switch, const int fsm_state, const VectorXd& v_proj) {
+  UpdateKinematics(x_w_spr, context_w_spr, x_wo_spr, context_wo_spr, traj, t,
+                   t_since_state_switch, fsm_state);
+  UpdateCommand(t, t_since_state_switch, v_proj);
+}
+
+void OscTrackingData::UpdateKinematics(
+    const VectorXd& x_w_spr, const Context<double>& context_w_spr,
+    const VectorXd& x_wo_spr, const Context<double>& context_wo_spr,
+    const drake::trajectories::Trajectory<double>& traj, double t,
+    double t_since_state_switch, const int fsm_state) {
   fsm_state_ = fsm_state;
   // If the set of active states contains -1, the tracking data is always active
   if (active_fsm_states_.count(-1)) {
     fsm_state_ = -1;
   }
   DRAKE_ASSERT(IsActive(fsm_state));
+  if (!J_col_support_.count(fsm_state_)) {
+    J_col_support_[fsm_state_] = CalcJColumnSupport(fsm_state_);
+  }
 
   UpdateActual(x_w_spr, context_w_spr, x_wo_spr, context_wo_spr, t);
   UpdateDesired(traj, t, t_since_state_switch);
   // 3. Update error
   // Careful: must update y and y_des before calling UpdateYError()
   UpdateYError();
+}
+
+void OscTrackingData::UpdateCommand(double t, double t_since_state_switch,
+                                    const VectorXd& v_proj) {
   UpdateYdotError(v_proj);
   UpdateYddotCmd(t, t_since_state_switch);
 }
@@ -111,12 +129,15 @@ void OscTrackingData::UpdateDesired(
 }
 
 void OscTrackingData::UpdateYddotCmd(double t, double t_since_state_switch) {
-  yddot_command_ =
-      yddot_des_converted_ + (K_p_ * (error_y_) + K_d_ * (error_ydot_));
+  yddot_command_ = yddot_des_converted_;
+  yddot_command_.noalias() += K_p_ * error_y_;
+  yddot_command_.noalias() += K_d_ * error_ydot_;
 }
 
 void OscTrackingData::StoreYddotCommandSol(const VectorXd& dv) {
-  yddot_command_sol_ = J_ * dv + JdotV_;
+  yddot_command_sol_.resize(JdotV_.size());
+  yddot_command_sol_.noalias() = J_ * dv;
+  yddot_command_sol_ += JdotV_;
 }
 
 void OscTrackingData::AddFiniteStateToTrack(int state) {
@@ -124,6 +145,12 @@ void OscTrackingData::AddFiniteStateToTrack(int state) {
   active_fsm_states_.insert(state);
 }
 
+std::vector<int> OscTrackingData::CalcJColumnSupport(int fsm_state) const {
+  std::vector<int> support(plant_wo_spr_.num_velocities());
+  std::iota(support.begin(), support.end(), 0);
+  return support;
+}
+
 // Run this function in OSC constructor to make sure that users constructed
 // OscTrackingData correctly.
 void OscTrackingData::CheckOscTrackingData() {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <map>
 #include <string>
 #include <vector>
 
@@ -41,13 +42,29 @@ class OscTrackingData {
   //  - `t`, current time
   //  - `t`, time since the last state switch
   //  - `v_proj`, impact invariant velocity projection
-  virtual void Update(const Eigen::VectorXd& x_w_spr,
-                      const drake::systems::Context<double>& context_w_spr,
-                      const Eigen::VectorXd& x_wo_spr,
-                      const drake::systems::Context<double>& context_wo_spr,
-                      const drake::trajectories::Trajectory<double>& traj,
-                      double t, double t_since_state_switch, int fsm_state,
-                      const Eigen::VectorXd& v_proj);
+  void Update(const Eigen::VectorXd& x_w_spr,
+              const drake::systems::Context<double>& context_w_spr,
+              const Eigen::VectorXd& x_wo_spr,
+              const drake::systems::Context<double>& context_wo_spr,
+              const drake::trajectories::Trajectory<double>& traj, double t,
+              double t_since_state_switch, int fsm_state,
+              const Eigen::VectorXd& v_proj);
+
+  // The two halves of Update(). UpdateKinematics() updates the fsm state, the
+  // actual and desired outputs and the position error. UpdateCommand() updates
+  // the velocity error, which depends on `v_proj`, and the commanded
+  // acceleration. The OSC calls UpdateKinematics() once per tick and
+  // UpdateCommand() once per `v_proj`, since the impact-invariant projection
+  // needs the tracking data before the QP does.
+  virtual void UpdateKinematics(
+      const Eigen::VectorXd& x_w_spr,
+      const drake::systems::Context<double>& context_w_spr,
+      const Eigen::VectorXd& x_wo_spr,
+      const drake::systems::Context<double>& context_wo_spr,
+      const drake::trajectories::Trajectory<double>& traj, double t,
+      double t_since_state_switch, int fsm_state);
+  void UpdateCommand(double t, double t_since_state_switch,
+                     const Eigen::VectorXd& v_proj);
 
   // Add this state to the list of fsm states where this tracking data is active
   void AddFiniteStateToTrack(int state);
@@ -81,7 +98,7 @@ class OscTrackingData {
   const Eigen::VectorXd& GetYDes() const { return y_des_; }
   const Eigen::VectorXd& GetErrorY() const { return error_y_; }
   const Eigen::VectorXd& GetYdot() const { return ydot_; }
-  const Eigen::VectorXd& GetYdotDes() const { return ydot_des_; }
+  virtual const Eigen::VectorXd& GetYdotDes() const { return ydot_des_; }
   const Eigen::VectorXd& GetErrorYdot() const { return error_ydot_; }
   const Eigen::VectorXd& GetYddotDes() const { return yddot_des_; }
   const Eigen::VectorXd& GetYddotCommandSol() const {
@@ -95,6 +112,11 @@ class OscTrackingData {
   const Eigen::VectorXd& GetJdotTimesV() const { return JdotV_; }
   const Eigen::VectorXd& GetYddotCommand() const { return yddot_command_; }
   virtual const Eigen::MatrixXd& GetWeight() const { return W_; }
+  // Indices of the columns of J that can be nonzero in the current fsm state,
+  // in increasing order. Only valid after Update().
+  const std::vector<int>& GetJColumnSupport() const {
+    return J_col_support_.at(fsm_state_);
+  }
 
   // Getters
   const std::string& GetName() const { return name_; };
@@ -117,6 +139,12 @@ class OscTrackingData {
       const Eigen::VectorXd& x_wo_spr,
       const drake::systems::Context<double>& context_wo_spr, double t);
 
+  // Returns the indices of the columns of J (w.r.t. the velocities of
+  // plant_wo_spr) that can be nonzero in `fsm_state`. The default is every
+  // column; derived classes that know their Jacobian's structure override
+  // this so that the OSC can skip the zero columns when building the costs.
+  virtual std::vector<int> CalcJColumnSupport(int fsm_state) const;
+
   // Output dimension
   int n_y_;
   int n_ydot_;
@@ -198,6 +226,10 @@ class OscTrackingData {
   // correctly.
   virtual void CheckDerivedOscTrackingData() = 0;
 
+  // Column support of J per fsm state, filled in the first time each state is
+  // seen in Update()
+  std::map<int, std::vector<int>> J_col_support_;
+
   // Trajectory name
   std::string name_;
 };
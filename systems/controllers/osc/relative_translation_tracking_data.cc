@@ -32,21 +32,23 @@ RelativeTranslationTrackingData::RelativeTranslationTrackingData(
   DRAKE_DEMAND(states1 == states2);
 }
 
-void RelativeTranslationTrackingData::Update(
+void RelativeTranslationTrackingData::UpdateKinematics(
     const VectorXd& x_w_spr, const Context<double>& context_w_spr,
     const VectorXd& x_wo_spr, const Context<double>& context_wo_spr,
     const drake::trajectories::Trajectory<double>& traj, double t,
-    double t_gait_cycle, const int fsm_state, const VectorXd& v_proj) {
-  // Currently there are redundant calculation here. For both to_frame_data_,
-  // and from_frame_data_, we don't nee to run UpdateDesired, UpdateYError,
-  // UpdateYdotError and UpdateYddotCmd inside Update().
+    double t_gait_cycle, const int fsm_state) {
+  // Only the actual outputs of to_frame_data_ and from_frame_data_ are used,
+  // so their UpdateDesired() and UpdateYError() are redundant here.
   // TODO: improve this to make it slightly more efficient.
-  to_frame_data_->Update(x_w_spr, context_w_spr, x_wo_spr, context_wo_spr, traj,
-                         t, t_gait_cycle, fsm_state, v_proj);
-  from_frame_data_->Update(x_w_spr, context_w_spr, x_wo_spr, context_wo_spr,
-                           traj, t, t_gait_cycle, fsm_state, v_proj);
-  OptionsTrackingData::Update(x_w_spr, context_w_spr, x_wo_spr, context_wo_spr,
-                              traj, t, t_gait_cycle, fsm_state, v_proj);
+  to_frame_data_->UpdateKinematics(x_w_spr, context_w_spr, x_wo_spr,
+                                   context_wo_spr, traj, t, t_gait_cycle,
+                                   fsm_state);
+  from_frame_data_->UpdateKinematics(x_w_spr, context_w_spr, x_wo_spr,
+                                     context_wo_spr, traj, t, t_gait_cycle,
+                                     fsm_state);
+  OptionsTrackingData::UpdateKinematics(x_w_spr, context_w_spr, x_wo_spr,
+                                        context_wo_spr, traj, t, t_gait_cycle,
+                                        fsm_state);
 }
 
 void RelativeTranslationTrackingData::UpdateY(
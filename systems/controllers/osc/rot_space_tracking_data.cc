@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include "multibody/multibody_utils.h"
+
 using Eigen::Isometry3d;
 using Eigen::MatrixXd;
 using Eigen::Quaterniond;
@@ -23,7 +25,10 @@ RotTaskSpaceTrackingData::RotTaskSpaceTrackingData(
     const MatrixXd& W, const MultibodyPlant<double>& plant_w_spr,
     const MultibodyPlant<double>& plant_wo_spr)
     : OptionsTrackingData(name, kQuaternionDim, kSpaceDim, K_p, K_d, W,
-                          plant_w_spr, plant_wo_spr) {
+                          plant_w_spr, plant_wo_spr),
+      w_des_(Vector3d::Zero()),
+      J_spatial_w_spr_(6, plant_w_spr.num_velocities()),
+      J_spatial_wo_spr_(6, plant_wo_spr.num_velocities()) {
   is_rotational_tracking_data_ = true;
 }
 
@@ -46,14 +51,14 @@ void RotTaskSpaceTrackingData::AddStateAndFrameToTrack(
 
 void RotTaskSpaceTrackingData::UpdateY(const VectorXd& x_w_spr,
                                        const Context<double>& context_w_spr) {
-  auto transform_mat = plant_w_spr_.CalcRelativeTransform(
-      context_w_spr, plant_w_spr_.world_frame(),
-      *body_frames_w_spr_[fsm_state_]);
+  const drake::math::RigidTransformd transform_mat =
+      plant_w_spr_.CalcRelativeTransform(context_w_spr,
+                                         plant_w_spr_.world_frame(),
+                                         *body_frames_w_spr_[fsm_state_]);
   Quaterniond y_quat(transform_mat.rotation() *
                      frame_poses_[fsm_state_].linear());
-  Eigen::Vector4d y_4d;
-  y_4d << y_quat.w(), y_quat.vec();
-  y_ = y_4d;
+  y_.resize(kQuaternionDim);
+  y_ << y_quat.w(), y_quat.vec();
 }
 
 void RotTaskSpaceTrackingData::UpdateYError() {
@@ -64,48 +69,47 @@ void RotTaskSpaceTrackingData::UpdateYError() {
   Eigen::AngleAxis<double> angle_axis_diff(y_quat_des * y_quat.inverse());
   error_y_ = angle_axis_diff.angle() * angle_axis_diff.axis();
   if (with_view_frame_) {
-    error_y_ = view_frame_rot_T_ * error_y_;
+    const Vector3d error_y = error_y_;
+    error_y_.noalias() = view_frame_rot_T_ * error_y;
   }
 }
 
 void RotTaskSpaceTrackingData::UpdateYdot(
     const VectorXd& x_w_spr, const Context<double>& context_w_spr) {
-  MatrixXd J_spatial(6, plant_w_spr_.num_velocities());
   plant_w_spr_.CalcJacobianSpatialVelocity(
       context_w_spr, JacobianWrtVariable::kV, *body_frames_w_spr_[fsm_state_],
       frame_poses_[fsm_state_].translation(), world_w_spr_, world_w_spr_,
-      &J_spatial);
-  ydot_ = J_spatial.block(0, 0, kSpaceDim, J_spatial.cols()) *
-          x_w_spr.tail(plant_w_spr_.num_velocities());
+      &J_spatial_w_spr_);
+  ydot_.resize(kSpaceDim);
+  ydot_.noalias() = J_spatial_w_spr_.topRows(kSpaceDim) *
+                    x_w_spr.tail(plant_w_spr_.num_velocities());
 }
 
 void RotTaskSpaceTrackingData::UpdateYdotError(const Eigen::VectorXd& v_proj) {
-  // Transform qdot to w
-  Quaterniond y_quat_des(y_des_(0), y_des_(1), y_des_(2), y_des_(3));
-  Quaterniond dy_quat_des(ydot_des_(0), ydot_des_(1), ydot_des_(2),
-                          ydot_des_(3));
-  Vector3d w_des_ = 2 * (dy_quat_des * y_quat_des.conjugate()).vec();
+  // w_des_ is the desired angular velocity (see UpdateYddotDes()).
   // Because we transform the error here rather than in the parent
   // options_tracking_data, and because J_y is already transformed in the view
   // frame, we need to undo the transformation on J_y
-  error_ydot_ =
-      w_des_ - ydot_ - view_frame_rot_T_.transpose() * GetJ() * v_proj;
+  Vector3d J_v_proj;
+  J_v_proj.noalias() = GetJ() * v_proj;
+  const Vector3d error_ydot =
+      w_des_ - ydot_ - view_frame_rot_T_.transpose() * J_v_proj;
+  error_ydot_.resize(kSpaceDim);
   if (with_view_frame_) {
-    error_ydot_ = view_frame_rot_T_ * error_ydot_;
+    error_ydot_.noalias() = view_frame_rot_T_ * error_ydot;
+  } else {
+    error_ydot_ = error_ydot;
   }
-
-  ydot_des_ =
-      w_des_;  // Overwrite 4d quat_dot with 3d omega. Need this for osc logging
 }
 
 void RotTaskSpaceTrackingData::UpdateJ(const VectorXd& x_wo_spr,
                                        const Context<double>& context_wo_spr) {
-  MatrixXd J_spatial(6, plant_wo_spr_.num_velocities());
   plant_wo_spr_.CalcJacobianSpatialVelocity(
-      context_wo_spr, JacobianWrtVariable::kV, *body_frames_wo_spr_[fsm_state_],
+      context_wo_spr, JacobianWrtVariable::kV,
+      *body_frames_wo_spr_[fsm_state_],
       frame_poses_[fsm_state_].translation(), world_wo_spr_, world_wo_spr_,
-      &J_spatial);
-  J_ = J_spatial.block(0, 0, kSpaceDim, J_spatial.cols());
+      &J_spatial_wo_spr_);
+  J_ = J_spatial_wo_spr_.topRows(kSpaceDim);
 }
 
 void RotTaskSpaceTrackingData::UpdateJdotV(
@@ -120,9 +124,15 @@ void RotTaskSpaceTrackingData::UpdateJdotV(
 }
 
 void RotTaskSpaceTrackingData::UpdateYddotDes(double, double) {
+  // Transform qdot to w once here (also needed for osc logging), so that
+  // UpdateYdotError() can run once per v_proj.
+  Quaterniond y_quat_des(y_des_(0), y_des_(1), y_des_(2), y_des_(3));
+  Quaterniond dy_quat_des(ydot_des_(0), ydot_des_(1), ydot_des_(2),
+                          ydot_des_(3));
+  w_des_ = 2 * (dy_quat_des * y_quat_des.conjugate()).vec();
+
   // Convert ddq into angular acceleration
   // See https://physics.stackexchange.com/q/460311
-  Quaterniond y_quat_des(y_des_(0), y_des_(1), y_des_(2), y_des_(3));
   Quaterniond yddot_quat_des(yddot_des_(0), yddot_des_(1), yddot_des_(2),
                              yddot_des_(3));
   yddot_des_converted_ = 2 * (yddot_quat_des * y_quat_des.conjugate()).vec();
@@ -136,6 +146,12 @@ void RotTaskSpaceTrackingData::UpdateYddotDes(double, double) {
   }
 }
 
+std::vector<int> RotTaskSpaceTrackingData::CalcJColumnSupport(
+    int fsm_state) const {
+  return multibody::KinematicPathVelocityIndices(
+      plant_wo_spr_, body_frames_wo_spr_.at(fsm_state)->body());
+}
+
 void RotTaskSpaceTrackingData::CheckDerivedOscTrackingData() {
   if (!body_frames_w_spr_.empty()) {
     body_frames_w_spr_ = body_frames_wo_spr_;
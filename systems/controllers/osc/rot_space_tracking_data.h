@@ -35,6 +35,10 @@ class RotTaskSpaceTrackingData final : public OptionsTrackingData {
       int state, const std::string& body_name,
       const Eigen::Isometry3d& frame_pose = Eigen::Isometry3d::Identity());
 
+  // The desired angular velocity, rather than the derivative of the desired
+  // quaternion
+  const Eigen::VectorXd& GetYdotDes() const final { return w_des_; }
+
  protected:
   std::unordered_map<int, const drake::multibody::BodyFrame<double>*>
       body_frames_w_spr_;
@@ -53,11 +57,18 @@ class RotTaskSpaceTrackingData final : public OptionsTrackingData {
   void UpdateJdotV(const Eigen::VectorXd& x_wo_spr,
                    const drake::systems::Context<double>& context_wo_spr) final;
   void UpdateYddotDes(double t, double t_since_state_switch) override;
+  std::vector<int> CalcJColumnSupport(int fsm_state) const final;
   void CheckDerivedOscTrackingData() final;
 
   // frame_pose_ represents the pose of the frame (w.r.t. the body's frame)
   // which follows the desired rotation.
   std::unordered_map<int, Eigen::Isometry3d> frame_poses_;
+
+  // Desired angular velocity, converted from ydot_des_ in UpdateYddotDes()
+  Eigen::VectorXd w_des_;
+  // Scratch for the spatial velocity Jacobians of both plants
+  Eigen::MatrixXd J_spatial_w_spr_;
+  Eigen::MatrixXd J_spatial_wo_spr_;
 };
 
 }  // namespace controllers
@@ -0,0 +1,256 @@
+#include "systems/controllers/osc/osc_direct_qp.h"
+
+#include <vector>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "common/allocation_counter.h"
+#include "solvers/dense_active_set_qp_solver.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+
+namespace dairlib::systems::controllers {
+namespace {
+
+using drake::CompareMatrices;
+using drake::solvers::SolutionResult;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using solvers::DenseActiveSetQpSolver;
+
+using CassieOscDirectQp =
+    SizedOscDirectQp<kCassieFixedSpringsNv, kCassieNu, kCassieNc>;
+
+// Minimizes the QP of `qp` subject to its equality rows (l == u) only, by
+// solving the KKT system, and returns the full solution.
+template <typename Qp>
+VectorXd SolveEqualityConstrained(const Qp& qp) {
+  const int n = qp.num_vars();
+  MatrixXd P = MatrixXd(qp.P()).selfadjointView<Eigen::Upper>();
+  MatrixXd A = qp.A();
+  std::vector<int> rows;
+  for (int i = 0; i < qp.num_constraints(); ++i) {
+    if (qp.l()(i) == qp.u()(i)) rows.push_back(i);
+  }
+  const int m = rows.size();
+  MatrixXd kkt = MatrixXd::Zero(n + m, n + m);
+  VectorXd rhs = VectorXd::Zero(n + m);
+  kkt.topLeftCorner(n, n) = P;
+  rhs.head(n) = -qp.q();
+  for (int k = 0; k < m; ++k) {
+    kkt.block(n + k, 0, 1, n) = A.row(rows[k]);
+    kkt.block(0, n + k, n, 1) = A.row(rows[k]).transpose();
+    rhs(n + k) = qp.l()(rows[k]);
+  }
+  VectorXd z = kkt.fullPivLu().solve(rhs).head(n);
+  VectorXd full;
+  qp.GetFullSolution(z, &full);
+  return full;
+}
+
+MatrixXd RandomSpd(int n) {
+  MatrixXd X = MatrixXd::Random(n, n);
+  return X * X.transpose() + n * MatrixXd::Identity(n, n);
+}
+
+// Dynamics, constraints and tracking cost of one controller tick, stored in
+// the types that Qp takes them in. The values only depend on `seed`.
+template <typename Qp>
+struct TickData {
+  TickData(int n_v, int n_u, int n_c, int n_h, int n_c_active,
+           unsigned int seed) {
+    std::srand(seed);
+    M = RandomSpd(n_v);
+    M_llt.compute(M);
+    B = MatrixXd::Random(n_v, n_u);
+    J_c = MatrixXd::Random(n_c, n_v);
+    J_h = MatrixXd::Random(n_h, n_v);
+    JdotV_h = VectorXd::Random(n_h);
+    J_c_active = J_c.topRows(n_c_active);
+    JdotV_c_active = VectorXd::Random(n_c_active);
+    bias = VectorXd::Random(n_v);
+    H_dv = RandomSpd(n_v);
+  }
+
+  typename Qp::MatrixVV M;
+  Eigen::LLT<typename Qp::MatrixVV> M_llt;
+  typename Qp::MatrixVU B;
+  typename Qp::MatrixCV J_c;
+  typename Qp::MatrixHV J_h;
+  VectorXd JdotV_h;
+  typename Qp::MatrixActiveCV J_c_active;
+  typename Qp::VectorActiveC JdotV_c_active;
+  typename Qp::VectorV bias;
+  typename Qp::MatrixVV H_dv;
+};
+
+// Writes one controller tick worth of updates into `qp`
+template <typename Qp>
+void Assemble(const TickData<Qp>& data, Qp* qp) {
+  if (qp->is_reduced()) {
+    qp->SetReducedDynamics(data.M_llt, data.J_c, data.J_h, data.JdotV_h,
+                           data.bias);
+  } else {
+    qp->SetDynamics(data.M, data.J_c, data.J_h, data.bias);
+    qp->SetHolonomicConstraint(data.J_h, data.JdotV_h);
+  }
+  qp->SetContactConstraint(data.J_c_active, data.JdotV_c_active);
+  qp->SetFrictionConeActive(0, false);
+  qp->ClearCosts();
+  qp->mutable_H_dv() += data.H_dv;
+  qp->mutable_H_u().diagonal().setConstant(1e-2);
+  qp->mutable_H_lambda_c().diagonal().setConstant(1e-4);
+  qp->mutable_H_lambda_h().diagonal().setConstant(1e-4);
+  qp->mutable_H_epsilon_diagonal().setConstant(10);
+  qp->PackCosts();
+}
+
+// Dimensions of the OSC of Cassie with fixed springs, with the two loop
+// closures and four contact points (two of them without friction along x)
+constexpr int kNh = 2;
+constexpr int kNcActive = 10;
+
+TEST(OscDirectQpTest, ReducedMatchesFull) {
+  const int n_v = 8;
+  const int n_u = 3;
+  const int n_c = 6;
+  const int n_h = 2;
+  const int n_c_active = 4;
+  std::srand(0);
+  const MatrixXd M = RandomSpd(n_v);
+  const MatrixXd B = MatrixXd::Random(n_v, n_u);
+  const MatrixXd J_c = MatrixXd::Random(n_c, n_v);
+  const MatrixXd J_h = MatrixXd::Random(n_h, n_v);
+  const VectorXd JdotV_h = VectorXd::Random(n_h);
+  const MatrixXd J_c_active = J_c.topRows(n_c_active);
+  const VectorXd JdotV_c_active = VectorXd::Random(n_c_active);
+  const VectorXd bias = VectorXd::Random(n_v);
+  // Only the upper triangles of the Hessians are used, so the strictly lower
+  // triangle of H_dv is filled with garbage
+  MatrixXd H_dv = RandomSpd(n_v);
+  H_dv.triangularView<Eigen::StrictlyLower>().setConstant(1e3);
+  const MatrixXd H_u = RandomSpd(n_u);
+  const MatrixXd H_lambda_c = RandomSpd(n_c);
+  const MatrixXd H_lambda_h = RandomSpd(n_h);
+  const VectorXd q =
+      VectorXd::Random(n_v + n_u + n_c + n_h + n_c_active);
+
+  VectorXd solutions[2];
+  for (bool reduced : {false, true}) {
+    OscDirectQp qp(n_v, n_u, n_c, n_h, n_c_active, true, false, reduced);
+    EXPECT_EQ(qp.is_reduced(), reduced);
+    qp.SetActuationMatrix(B);
+    qp.SetFrictionCone(0.6);
+    for (int i = 0; i < n_c / 3; ++i) {
+      qp.SetFrictionConeActive(i, false);
+    }
+    if (reduced) {
+      Eigen::LLT<MatrixXd> M_llt(M);
+      qp.SetReducedDynamics(M_llt, J_c, J_h, JdotV_h, bias);
+    } else {
+      qp.SetDynamics(M, J_c, J_h, bias);
+      qp.SetHolonomicConstraint(J_h, JdotV_h);
+    }
+    qp.SetContactConstraint(J_c_active, JdotV_c_active);
+    qp.ClearCosts();
+    qp.mutable_H_dv() += H_dv;
+    qp.mutable_H_u() += H_u;
+    qp.mutable_H_lambda_c() += H_lambda_c;
+    qp.mutable_H_lambda_h() += H_lambda_h;
+    qp.mutable_H_epsilon_diagonal().setConstant(10);
+    qp.mutable_q() += q;
+    qp.PackCosts();
+    solutions[reduced] = SolveEqualityConstrained(qp);
+  }
+  EXPECT_TRUE(CompareMatrices(solutions[0], solutions[1], 1e-9));
+
+  // The full solution satisfies the eliminated constraints
+  const VectorXd& z = solutions[1];
+  const VectorXd dv = z.head(n_v);
+  const VectorXd u = z.segment(n_v, n_u);
+  const VectorXd lambda_c = z.segment(n_v + n_u, n_c);
+  const VectorXd lambda_h = z.segment(n_v + n_u + n_c, n_h);
+  EXPECT_TRUE(CompareMatrices(
+      M * dv + bias, B * u + J_c.transpose() * lambda_c +
+                         J_h.transpose() * lambda_h, 1e-9));
+  EXPECT_TRUE(CompareMatrices(J_h * dv, -JdotV_h, 1e-9));
+}
+
+TEST(OscDirectQpTest, FixedSizeMatchesDynamic) {
+  const int n_v = kCassieFixedSpringsNv;
+  const int n_u = kCassieNu;
+  const int n_c = kCassieNc;
+  const TickData<OscDirectQp> dynamic_data(n_v, n_u, n_c, kNh, kNcActive, 1);
+  const TickData<CassieOscDirectQp> fixed_data(n_v, n_u, n_c, kNh, kNcActive,
+                                               1);
+  for (bool reduced : {false, true}) {
+    OscDirectQp dynamic_qp(n_v, n_u, n_c, kNh, kNcActive, true, true,
+                           reduced);
+    CassieOscDirectQp fixed_qp(n_v, n_u, n_c, kNh, kNcActive, true, true,
+                               reduced);
+    dynamic_qp.SetActuationMatrix(dynamic_data.B);
+    dynamic_qp.SetFrictionCone(0.6);
+    dynamic_qp.SetInputLimits(-VectorXd::Ones(n_u), VectorXd::Ones(n_u));
+    fixed_qp.SetActuationMatrix(fixed_data.B);
+    fixed_qp.SetFrictionCone(0.6);
+    fixed_qp.SetInputLimits(-VectorXd::Ones(n_u), VectorXd::Ones(n_u));
+    Assemble(dynamic_data, &dynamic_qp);
+    Assemble(fixed_data, &fixed_qp);
+
+    const double tol = 1e-10;
+    EXPECT_TRUE(CompareMatrices(MatrixXd(dynamic_qp.P()),
+                                MatrixXd(fixed_qp.P()), tol));
+    EXPECT_TRUE(CompareMatrices(MatrixXd(dynamic_qp.A()),
+                                MatrixXd(fixed_qp.A()), tol));
+    EXPECT_TRUE(CompareMatrices(dynamic_qp.q(), fixed_qp.q(), tol));
+    EXPECT_TRUE(CompareMatrices(dynamic_qp.l(), fixed_qp.l(), tol));
+    EXPECT_TRUE(CompareMatrices(dynamic_qp.u(), fixed_qp.u(), tol));
+    EXPECT_TRUE(CompareMatrices(SolveEqualityConstrained(dynamic_qp),
+                                SolveEqualityConstrained(fixed_qp), 1e-8));
+  }
+}
+
+// The assembly of the direct and reduced QPs and their solution by the dense
+// active-set solver, i.e. everything between the dynamics terms and the
+// solution of a kDirect or kReduced OSC tick with the kDenseActiveSet
+// solver, do not allocate once sized by a first tick
+template <typename Qp>
+void CheckSteadyStateDoesNotAllocate() {
+  const int n_v = kCassieFixedSpringsNv;
+  const int n_u = kCassieNu;
+  const int n_c = kCassieNc;
+  const TickData<Qp> data(n_v, n_u, n_c, kNh, kNcActive, 2);
+  for (bool reduced : {false, true}) {
+    Qp qp(n_v, n_u, n_c, kNh, kNcActive, true, true, reduced);
+    qp.SetActuationMatrix(data.B);
+    qp.SetFrictionCone(0.6);
+    qp.SetInputLimits(-100 * VectorXd::Ones(n_u), 100 * VectorXd::Ones(n_u));
+    DenseActiveSetQpSolver solver(qp.num_vars(), qp.num_constraints());
+    DenseActiveSetQpSolver::Details details;
+    VectorXd z = VectorXd::Zero(qp.num_vars());
+    VectorXd full = VectorXd::Zero(qp.num_full_vars());
+    auto tick = [&]() {
+      Assemble(data, &qp);
+      const SolutionResult result =
+          solver.Solve(qp.P(), qp.q(), qp.A(), qp.l(), qp.u(), &z, &details);
+      qp.GetFullSolution(z, &full);
+      return result;
+    };
+    ASSERT_EQ(tick(), SolutionResult::kSolutionFound);
+    AllocationCounter counter;
+    ASSERT_EQ(tick(), SolutionResult::kSolutionFound);
+    EXPECT_EQ(counter.count(), 0) << (reduced ? "reduced" : "full");
+  }
+}
+
+TEST(OscDirectQpTest, SteadyStateDoesNotAllocate) {
+  CheckSteadyStateDoesNotAllocate<OscDirectQp>();
+}
+
+TEST(OscDirectQpTest, FixedSizeSteadyStateDoesNotAllocate) {
+  CheckSteadyStateDoesNotAllocate<CassieOscDirectQp>();
+}
+
+}  // namespace
+}  // namespace dairlib::systems::controllers
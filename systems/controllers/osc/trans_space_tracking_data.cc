@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include "multibody/multibody_utils.h"
+
 using Eigen::MatrixXd;
 using Eigen::Vector3d;
 using Eigen::VectorXd;
@@ -20,7 +22,8 @@ TransTaskSpaceTrackingData::TransTaskSpaceTrackingData(
     const MatrixXd& W, const MultibodyPlant<double>& plant_w_spr,
     const MultibodyPlant<double>& plant_wo_spr)
     : OptionsTrackingData(name, kSpaceDim, kSpaceDim, K_p, K_d, W, plant_w_spr,
-                          plant_wo_spr) {}
+                          plant_wo_spr),
+      J_w_spr_(kSpaceDim, plant_w_spr.num_velocities()) {}
 
 void TransTaskSpaceTrackingData::AddPointToTrack(const std::string& body_name,
                                                  const Vector3d& pt_on_body) {
@@ -40,7 +43,7 @@ void TransTaskSpaceTrackingData::AddStateAndPointToTrack(
 
 void TransTaskSpaceTrackingData::UpdateY(const VectorXd& x_w_spr,
                                          const Context<double>& context_w_spr) {
-  y_ = Vector3d::Zero();
+  y_.setZero(kSpaceDim);
   plant_w_spr_.CalcPointsPositions(context_w_spr,
                                    *body_frames_wo_spr_.at(fsm_state_),
                                    pts_on_body_[fsm_state_], world_w_spr_, &y_);
@@ -48,17 +51,17 @@ void TransTaskSpaceTrackingData::UpdateY(const VectorXd& x_w_spr,
 
 void TransTaskSpaceTrackingData::UpdateYdot(
     const VectorXd& x_w_spr, const Context<double>& context_w_spr) {
-  MatrixXd J(kSpaceDim, plant_w_spr_.num_velocities());
   plant_w_spr_.CalcJacobianTranslationalVelocity(
       context_w_spr, JacobianWrtVariable::kV,
       *body_frames_w_spr_.at(fsm_state_), pts_on_body_[fsm_state_],
-      world_w_spr_, world_w_spr_, &J);
-  ydot_ = J * x_w_spr.tail(plant_w_spr_.num_velocities());
+      world_w_spr_, world_w_spr_, &J_w_spr_);
+  ydot_.resize(kSpaceDim);
+  ydot_.noalias() = J_w_spr_ * x_w_spr.tail(plant_w_spr_.num_velocities());
 }
 
 void TransTaskSpaceTrackingData::UpdateJ(
     const VectorXd& x_wo_spr, const Context<double>& context_wo_spr) {
-  J_ = MatrixXd::Zero(kSpaceDim, plant_wo_spr_.num_velocities());
+  J_.setZero(kSpaceDim, plant_wo_spr_.num_velocities());
   plant_wo_spr_.CalcJacobianTranslationalVelocity(
       context_wo_spr, JacobianWrtVariable::kV,
       *body_frames_wo_spr_.at(fsm_state_), pts_on_body_[fsm_state_],
@@ -73,6 +76,12 @@ void TransTaskSpaceTrackingData::UpdateJdotV(
       world_wo_spr_, world_wo_spr_);
 }
 
+std::vector<int> TransTaskSpaceTrackingData::CalcJColumnSupport(
+    int fsm_state) const {
+  return multibody::KinematicPathVelocityIndices(
+      plant_wo_spr_, body_frames_wo_spr_.at(fsm_state)->body());
+}
+
 void TransTaskSpaceTrackingData::CheckDerivedOscTrackingData() {
   if (!body_frames_w_spr_.empty()) {
     body_frames_w_spr_ = body_frames_wo_spr_;
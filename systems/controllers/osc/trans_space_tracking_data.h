@@ -48,10 +48,13 @@ class TransTaskSpaceTrackingData final : public OptionsTrackingData {
   void UpdateJdotV(const Eigen::VectorXd& x_wo_spr,
                    const drake::systems::Context<double>& context_wo_spr) final;
 
+  std::vector<int> CalcJColumnSupport(int fsm_state) const final;
   void CheckDerivedOscTrackingData() final;
 
   // `pt_on_body` is the position w.r.t. the origin of the body
   std::unordered_map<int, Eigen::Vector3d> pts_on_body_;
+  // Scratch for the Jacobian of plant_w_spr_
+  Eigen::MatrixXd J_w_spr_;
 };
 
 }  // namespace controllers
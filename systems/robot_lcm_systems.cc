@@ -1,4 +1,6 @@
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
 
 #include "robot_lcm_systems.h"
 
@@ -26,52 +28,210 @@ using Eigen::VectorXd;
 using std::string;
 using systems::OutputVector;
 
+/*--------------------------------------------------------------------------*/
+// Robot state layouts.
+
+namespace {
+
+// 64-bit FNV-1a hash of the names, each terminated by '\0', followed by
+// '\x1f'
+void AddNamesToHash(const std::vector<std::string>& names, uint64_t* hash) {
+  auto add_byte = [hash](unsigned char c) {
+    *hash ^= c;
+    *hash *= 1099511628211ull;
+  };
+  for (const auto& name : names) {
+    for (char c : name) {
+      add_byte(static_cast<unsigned char>(c));
+    }
+    add_byte('\0');
+  }
+  add_byte('\x1f');
+}
+
+const uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+
+int64_t HashToId(uint64_t hash) {
+  int64_t id;
+  std::memcpy(&id, &hash, sizeof(id));
+  return id;
+}
+
+}  // namespace
+
+int64_t RobotStateLayoutId(const std::vector<std::string>& position_names,
+                           const std::vector<std::string>& velocity_names,
+                           const std::vector<std::string>& effort_names) {
+  uint64_t hash = kFnvOffsetBasis;
+  AddNamesToHash(position_names, &hash);
+  AddNamesToHash(velocity_names, &hash);
+  AddNamesToHash(effort_names, &hash);
+  return HashToId(hash);
+}
+
+lcmt_robot_state_layout MakeRobotStateLayout(
+    const MultibodyPlant<double>& plant) {
+  lcmt_robot_state_layout layout;
+  layout.position_names = multibody::ExtractOrderedNamesFromMap(
+      multibody::MakeNameToPositionsMap(plant));
+  layout.velocity_names = multibody::ExtractOrderedNamesFromMap(
+      multibody::MakeNameToVelocitiesMap(plant));
+  layout.effort_names = multibody::ExtractOrderedNamesFromMap(
+      multibody::MakeNameToActuatorsMap(plant));
+  layout.num_positions = layout.position_names.size();
+  layout.num_velocities = layout.velocity_names.size();
+  layout.num_efforts = layout.effort_names.size();
+  layout.layout_id = RobotStateLayoutId(
+      layout.position_names, layout.velocity_names, layout.effort_names);
+  return layout;
+}
+
+/*--------------------------------------------------------------------------*/
+// methods implementation for NamePermutation.
+
+void NamePermutation::Update(int64_t layout_id,
+                             const std::vector<std::string>& names,
+                             const std::map<std::string, int>& index_map) {
+  if (initialized_ && layout_id == layout_id_) {
+    return;
+  }
+  index_.resize(names.size());
+  identity_ = true;
+  for (size_t i = 0; i < names.size(); i++) {
+    index_[i] = index_map.at(names[i]);
+    identity_ = identity_ && index_[i] == static_cast<int>(i);
+  }
+  layout_id_ = layout_id;
+  initialized_ = true;
+}
+
+void NamePermutation::Scatter(const std::vector<double>& values, int n,
+                              VectorXd* out) const {
+  DRAKE_ASSERT(n <= static_cast<int>(index_.size()));
+  if (identity_) {
+    out->head(n) = Eigen::Map<const VectorXd>(values.data(), n);
+    return;
+  }
+  for (int i = 0; i < n; i++) {
+    (*out)(index_[i]) = values[i];
+  }
+}
+
 /*--------------------------------------------------------------------------*/
 // methods implementation for RobotOutputReceiver.
 
 RobotOutputReceiver::RobotOutputReceiver(
-    const drake::multibody::MultibodyPlant<double>& plant) {
+    const drake::multibody::MultibodyPlant<double>& plant,
+    RobotStateFormat format)
+    : format_(format) {
   num_positions_ = plant.num_positions();
   num_velocities_ = plant.num_velocities();
   num_efforts_ = plant.num_actuators();
   position_index_map_ = multibody::MakeNameToPositionsMap(plant);
   velocity_index_map_ = multibody::MakeNameToVelocitiesMap(plant);
   effort_index_map_ = multibody::MakeNameToActuatorsMap(plant);
-  this->DeclareAbstractInputPort("lcmt_robot_output",
-                                 drake::Value<dairlib::lcmt_robot_output>{});
+  layout_id_ = MakeRobotStateLayout(plant).layout_id;
+  if (format_ == RobotStateFormat::kCompact) {
+    this->DeclareAbstractInputPort(
+        "lcmt_robot_output_compact",
+        drake::Value<dairlib::lcmt_robot_output_compact>{});
+    layout_input_port_ =
+        this->DeclareAbstractInputPort(
+                "lcmt_robot_state_layout",
+                drake::Value<dairlib::lcmt_robot_state_layout>{})
+            .get_index();
+  } else {
+    this->DeclareAbstractInputPort("lcmt_robot_output",
+                                   drake::Value<dairlib::lcmt_robot_output>{});
+  }
   this->DeclareVectorOutputPort(
       "x, u, t",
       OutputVector<double>(plant.num_positions(), plant.num_velocities(),
                            plant.num_actuators()),
       &RobotOutputReceiver::CopyOutput);
+  permutation_cache_entry_ = &this->DeclareCacheEntry(
+      "name_permutation", &RobotOutputReceiver::CalcPermutation,
+      {this->all_input_ports_ticket()});
+}
+
+void RobotOutputReceiver::CalcPermutation(
+    const Context<double>& context, RobotStatePermutation* permutation) const {
+  const drake::AbstractValue* input = this->EvalAbstractInput(context, 0);
+  DRAKE_ASSERT(input != nullptr);
+  if (format_ == RobotStateFormat::kNamed) {
+    const auto& state_msg = input->get_value<dairlib::lcmt_robot_output>();
+    // Hashing the names is much cheaper than looking up every name
+    const int64_t layout_id =
+        RobotStateLayoutId(state_msg.position_names, state_msg.velocity_names,
+                           state_msg.effort_names);
+    permutation->positions.Update(layout_id, state_msg.position_names,
+                                  position_index_map_);
+    permutation->velocities.Update(layout_id, state_msg.velocity_names,
+                                   velocity_index_map_);
+    permutation->efforts.Update(layout_id, state_msg.effort_names,
+                                effort_index_map_);
+    return;
+  }
+
+  // Only evaluated for compact messages with another layout than the plant
+  const auto& state_msg =
+      input->get_value<dairlib::lcmt_robot_output_compact>();
+  const lcmt_robot_state_layout* layout = nullptr;
+  const auto& layout_port = this->get_input_port(layout_input_port_);
+  if (layout_port.HasValue(context)) {
+    layout = &layout_port.Eval<lcmt_robot_state_layout>(context);
+  }
+  if (layout == nullptr || layout->layout_id != state_msg.layout_id) {
+    throw std::runtime_error(
+        "RobotOutputReceiver: received a state with layout id " +
+        std::to_string(state_msg.layout_id) +
+        ", which differs from the plant, without its lcmt_robot_state_layout");
+  }
+  DRAKE_THROW_UNLESS(state_msg.num_positions <= layout->num_positions);
+  DRAKE_THROW_UNLESS(state_msg.num_velocities <= layout->num_velocities);
+  DRAKE_THROW_UNLESS(state_msg.num_efforts <= layout->num_efforts);
+  permutation->positions.Update(state_msg.layout_id, layout->position_names,
+                                position_index_map_);
+  permutation->velocities.Update(state_msg.layout_id, layout->velocity_names,
+                                 velocity_index_map_);
+  permutation->efforts.Update(state_msg.layout_id, layout->effort_names,
+                              effort_index_map_);
 }
 
 void RobotOutputReceiver::CopyOutput(const Context<double>& context,
                                      OutputVector<double>* output) const {
   const drake::AbstractValue* input = this->EvalAbstractInput(context, 0);
   DRAKE_ASSERT(input != nullptr);
-  const auto& state_msg = input->get_value<dairlib::lcmt_robot_output>();
 
   VectorXd positions = VectorXd::Zero(num_positions_);
-  for (int i = 0; i < state_msg.num_positions; i++) {
-    int j = position_index_map_.at(state_msg.position_names[i]);
-    positions(j) = state_msg.position[i];
-  }
   VectorXd velocities = VectorXd::Zero(num_velocities_);
-  for (int i = 0; i < state_msg.num_velocities; i++) {
-    int j = velocity_index_map_.at(state_msg.velocity_names[i]);
-    velocities(j) = state_msg.velocity[i];
-  }
   VectorXd efforts = VectorXd::Zero(num_efforts_);
-  for (int i = 0; i < state_msg.num_efforts; i++) {
-    int j = effort_index_map_.at(state_msg.effort_names[i]);
-    efforts(j) = state_msg.effort[j];
+  const double* imu_accel;
+  int64_t utime;
+  if (format_ == RobotStateFormat::kCompact) {
+    const auto& state_msg =
+        input->get_value<dairlib::lcmt_robot_output_compact>();
+    CopyCompactState(context, state_msg, &positions, &velocities, &efforts);
+    imu_accel = state_msg.imu_accel;
+    utime = state_msg.utime;
+  } else {
+    const auto& state_msg = input->get_value<dairlib::lcmt_robot_output>();
+    const auto& permutation =
+        permutation_cache_entry_->Eval<RobotStatePermutation>(context);
+    permutation.positions.Scatter(state_msg.position, state_msg.num_positions,
+                                  &positions);
+    permutation.velocities.Scatter(state_msg.velocity,
+                                   state_msg.num_velocities, &velocities);
+    permutation.efforts.Scatter(state_msg.effort, state_msg.num_efforts,
+                                &efforts);
+    imu_accel = state_msg.imu_accel;
+    utime = state_msg.utime;
   }
 
   VectorXd imu = VectorXd::Zero(3);
   if (num_positions_ != num_velocities_) {
     for (int i = 0; i < 3; ++i) {
-      imu[i] = state_msg.imu_accel[i];
+      imu[i] = imu_accel[i];
     }
   }
 
@@ -79,48 +239,79 @@ void RobotOutputReceiver::CopyOutput(const Context<double>& context,
   output->SetVelocities(velocities);
   output->SetEfforts(efforts);
   output->SetIMUAccelerations(imu);
-  output->set_timestamp(state_msg.utime * 1.0e-6);
+  output->set_timestamp(utime * 1.0e-6);
 }
 
-void RobotOutputReceiver::InitializeSubscriberPositions(
-    const MultibodyPlant<double>& plant,
-    drake::systems::Context<double> &context) const {
-  auto& state_msg = context.get_mutable_abstract_state<lcmt_robot_output>(0);
-
-  // using the time from the context
-  state_msg.utime = context.get_time() * 1e6;
+void RobotOutputReceiver::CopyCompactState(
+    const Context<double>& context, const lcmt_robot_output_compact& state_msg,
+    VectorXd* positions, VectorXd* velocities, VectorXd* efforts) const {
+  if (state_msg.layout_id == layout_id_) {
+    // Same names in the same order as the plant
+    DRAKE_THROW_UNLESS(state_msg.num_positions == num_positions_);
+    DRAKE_THROW_UNLESS(state_msg.num_velocities == num_velocities_);
+    DRAKE_THROW_UNLESS(state_msg.num_efforts <= num_efforts_);
+    *positions = Eigen::Map<const VectorXd>(state_msg.position.data(),
+                                            num_positions_);
+    *velocities = Eigen::Map<const VectorXd>(state_msg.velocity.data(),
+                                             num_velocities_);
+    efforts->head(state_msg.num_efforts) = Eigen::Map<const VectorXd>(
+        state_msg.effort.data(), state_msg.num_efforts);
+    return;
+  }
+  if (state_msg.num_positions == 0 && state_msg.num_velocities == 0 &&
+      state_msg.num_efforts == 0) {
+    // No message received yet
+    return;
+  }
 
-  std::vector<std::string> ordered_position_names =
-      multibody::ExtractOrderedNamesFromMap(position_index_map_);
-  std::vector<std::string> ordered_velocity_names =
-      multibody::ExtractOrderedNamesFromMap(velocity_index_map_);
-  std::vector<std::string> ordered_effort_names =
-      multibody::ExtractOrderedNamesFromMap(effort_index_map_);
+  const auto& permutation =
+      permutation_cache_entry_->Eval<RobotStatePermutation>(context);
+  permutation.positions.Scatter(state_msg.position, state_msg.num_positions,
+                                positions);
+  permutation.velocities.Scatter(state_msg.velocity, state_msg.num_velocities,
+                                 velocities);
+  permutation.efforts.Scatter(state_msg.effort, state_msg.num_efforts,
+                              efforts);
+}
 
-  state_msg.num_positions = num_positions_;
-  state_msg.num_velocities = num_velocities_;
-  state_msg.position_names.resize(num_positions_);
-  state_msg.velocity_names.resize(num_velocities_);
-  state_msg.position.resize(num_positions_);
-  state_msg.velocity.resize(num_positions_);
+template <typename MessageType>
+void RobotOutputReceiver::InitializeMessagePositions(
+    const MultibodyPlant<double>& plant, double time,
+    MessageType* state_msg) const {
+  // using the time from the context
+  state_msg->utime = time * 1e6;
 
-  for (int i = 0; i < num_positions_; i++) {
-    state_msg.position_names[i] = ordered_position_names[i];
-    state_msg.position[i] = 0;
-  }
+  state_msg->num_positions = num_positions_;
+  state_msg->num_velocities = num_velocities_;
+  state_msg->position.assign(num_positions_, 0.0);
+  state_msg->velocity.assign(num_velocities_, 0.0);
 
   // Set quaternion w = 1, assumes drake quaternion ordering of wxyz
   for (const auto& body_idx : plant.GetFloatingBaseBodies()) {
     const auto& body = plant.get_body(body_idx);
     if (body.has_quaternion_dofs()) {
-      state_msg.position[body.floating_positions_start()] = 1;
+      state_msg->position[body.floating_positions_start()] = 1;
     }
   }
+}
 
-  for (int i = 0; i < num_velocities_; i++) {
-    state_msg.velocity[i] = 0;
-    state_msg.velocity_names[i] = ordered_velocity_names[i];
+void RobotOutputReceiver::InitializeSubscriberPositions(
+    const MultibodyPlant<double>& plant,
+    drake::systems::Context<double> &context) const {
+  if (format_ == RobotStateFormat::kCompact) {
+    auto& state_msg =
+        context.get_mutable_abstract_state<lcmt_robot_output_compact>(0);
+    InitializeMessagePositions(plant, context.get_time(), &state_msg);
+    state_msg.layout_id = layout_id_;
+    return;
   }
+
+  auto& state_msg = context.get_mutable_abstract_state<lcmt_robot_output>(0);
+  InitializeMessagePositions(plant, context.get_time(), &state_msg);
+  state_msg.position_names =
+      multibody::ExtractOrderedNamesFromMap(position_index_map_);
+  state_msg.velocity_names =
+      multibody::ExtractOrderedNamesFromMap(velocity_index_map_);
 }
 
 /*--------------------------------------------------------------------------*/
@@ -128,8 +319,11 @@ void RobotOutputReceiver::InitializeSubscriberPositions(
 
 RobotOutputSender::RobotOutputSender(
     const drake::multibody::MultibodyPlant<double>& plant,
-    const bool publish_efforts, const bool publish_imu)
-    : publish_efforts_(publish_efforts), publish_imu_(publish_imu) {
+    const bool publish_efforts, const bool publish_imu,
+    RobotStateFormat format)
+    : publish_efforts_(publish_efforts),
+      publish_imu_(publish_imu),
+      format_(format) {
   num_positions_ = plant.num_positions();
   num_velocities_ = plant.num_velocities();
   num_efforts_ = plant.num_actuators();
@@ -144,6 +338,7 @@ RobotOutputSender::RobotOutputSender(
       multibody::ExtractOrderedNamesFromMap(velocity_index_map_);
   ordered_effort_names_ =
       multibody::ExtractOrderedNamesFromMap(effort_index_map_);
+  layout_ = MakeRobotStateLayout(plant);
 
   state_input_port_ =
       this->DeclareVectorInputPort(
@@ -160,13 +355,23 @@ RobotOutputSender::RobotOutputSender(
             .get_index();
   }
 
-  this->DeclareAbstractOutputPort("lcmt_robot_output",
-                                  &RobotOutputSender::Output);
+  if (format_ == RobotStateFormat::kCompact) {
+    this->DeclareAbstractOutputPort("lcmt_robot_output_compact",
+                                    &RobotOutputSender::OutputCompact);
+    layout_output_port_ =
+        this->DeclareAbstractOutputPort("lcmt_robot_state_layout", layout_,
+                                        &RobotOutputSender::OutputLayout,
+                                        {this->nothing_ticket()})
+            .get_index();
+  } else {
+    this->DeclareAbstractOutputPort("lcmt_robot_output",
+                                    &RobotOutputSender::Output);
+  }
 }
 
-/// Populate a state message with all states
-void RobotOutputSender::Output(const Context<double>& context,
-                               dairlib::lcmt_robot_output* state_msg) const {
+template <typename MessageType>
+void RobotOutputSender::FillState(const Context<double>& context,
+                                  MessageType* state_msg) const {
   const auto state = this->EvalVectorInput(context, state_input_port_);
 
   // using the time from the context
@@ -174,13 +379,10 @@ void RobotOutputSender::Output(const Context<double>& context,
 
   state_msg->num_positions = num_positions_;
   state_msg->num_velocities = num_velocities_;
-  state_msg->position_names.resize(num_positions_);
-  state_msg->velocity_names.resize(num_velocities_);
   state_msg->position.resize(num_positions_);
   state_msg->velocity.resize(num_velocities_);
 
   for (int i = 0; i < num_positions_; i++) {
-    state_msg->position_names[i] = ordered_position_names_[i];
     if (std::isnan(state->GetAtIndex(i))) {
       state_msg->position[i] = 0;
     } else {
@@ -189,19 +391,16 @@ void RobotOutputSender::Output(const Context<double>& context,
   }
   for (int i = 0; i < num_velocities_; i++) {
     state_msg->velocity[i] = state->GetAtIndex(num_positions_ + i);
-    state_msg->velocity_names[i] = ordered_velocity_names_[i];
   }
 
   if (publish_efforts_) {
     const auto efforts = this->EvalVectorInput(context, effort_input_port_);
 
     state_msg->num_efforts = num_efforts_;
-    state_msg->effort_names.resize(num_efforts_);
     state_msg->effort.resize(num_efforts_);
 
     for (int i = 0; i < num_efforts_; i++) {
       state_msg->effort[i] = efforts->GetAtIndex(i);
-      state_msg->effort_names[i] = ordered_effort_names_[i];
     }
   }
 
@@ -213,6 +412,31 @@ void RobotOutputSender::Output(const Context<double>& context,
   }
 }
 
+/// Populate a state message with all states
+void RobotOutputSender::Output(const Context<double>& context,
+                               dairlib::lcmt_robot_output* state_msg) const {
+  FillState(context, state_msg);
+  state_msg->position_names = ordered_position_names_;
+  state_msg->velocity_names = ordered_velocity_names_;
+  if (publish_efforts_) {
+    state_msg->effort_names = ordered_effort_names_;
+  }
+}
+
+/// Populate a compact state message with all states
+void RobotOutputSender::OutputCompact(
+    const Context<double>& context,
+    dairlib::lcmt_robot_output_compact* state_msg) const {
+  FillState(context, state_msg);
+  state_msg->layout_id = layout_.layout_id;
+}
+
+void RobotOutputSender::OutputLayout(
+    const Context<double>& context,
+    dairlib::lcmt_robot_state_layout* layout) const {
+  *layout = layout_;
+}
+
 /*--------------------------------------------------------------------------*/
 // methods implementation for RobotInputReceiver.
 
@@ -225,6 +449,19 @@ RobotInputReceiver::RobotInputReceiver(
   this->DeclareVectorOutputPort("u, t",
                                 TimestampedVector<double>(num_actuators_),
                                 &RobotInputReceiver::CopyInputOut);
+  permutation_cache_entry_ = &this->DeclareCacheEntry(
+      "name_permutation", &RobotInputReceiver::CalcPermutation,
+      {this->all_input_ports_ticket()});
+}
+
+void RobotInputReceiver::CalcPermutation(const Context<double>& context,
+                                         NamePermutation* permutation) const {
+  const auto& input_msg = this->EvalAbstractInput(context, 0)
+                              ->get_value<dairlib::lcmt_robot_input>();
+  uint64_t hash = kFnvOffsetBasis;
+  AddNamesToHash(input_msg.effort_names, &hash);
+  permutation->Update(HashToId(hash), input_msg.effort_names,
+                      actuator_index_map_);
 }
 
 void RobotInputReceiver::CopyInputOut(const Context<double>& context,
@@ -235,10 +472,8 @@ void RobotInputReceiver::CopyInputOut(const Context<double>& context,
 
   VectorXd input_vector = VectorXd::Zero(num_actuators_);
 
-  for (int i = 0; i < input_msg.num_efforts; i++) {
-    int j = actuator_index_map_.at(input_msg.effort_names[i]);
-    input_vector(j) = input_msg.efforts[i];
-  }
+  permutation_cache_entry_->Eval<NamePermutation>(context).Scatter(
+      input_msg.efforts, input_msg.num_efforts, &input_vector);
   output->SetDataVector(input_vector);
   output->set_timestamp(input_msg.utime * 1.0e-6);
 }
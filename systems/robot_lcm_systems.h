@@ -6,6 +6,8 @@
 
 #include "dairlib/lcmt_robot_input.hpp"
 #include "dairlib/lcmt_robot_output.hpp"
+#include "dairlib/lcmt_robot_output_compact.hpp"
+#include "dairlib/lcmt_robot_state_layout.hpp"
 #include "systems/framework/output_vector.h"
 #include "systems/framework/timestamped_vector.h"
 #include "systems/primitives/subvector_pass_through.h"
@@ -21,13 +23,87 @@ namespace systems {
 /// LCM messages related to a robot. The classes in this file are based on
 /// acrobot_lcm.h
 
+/// Wire formats of the robot state.
+enum class RobotStateFormat {
+  /// lcmt_robot_output, which carries the joint names in every message
+  kNamed,
+  /// lcmt_robot_output_compact, which only carries a layout id. The names
+  /// are published separately in an lcmt_robot_state_layout, which is only
+  /// needed by receivers whose plant orders the states differently.
+  kCompact,
+};
+
+/// Identifies the order of the position, velocity and effort names of a
+/// robot state: a 64-bit FNV-1a hash of the names, each terminated by '\0',
+/// with a '\x1f' after each of the three lists. Any change of a name or of
+/// the order changes the id.
+int64_t RobotStateLayoutId(const std::vector<std::string>& position_names,
+                           const std::vector<std::string>& velocity_names,
+                           const std::vector<std::string>& effort_names);
+
+/// Layout of the states of `plant` in the order of the plant, which is the
+/// order published by RobotOutputSender.
+lcmt_robot_state_layout MakeRobotStateLayout(
+    const drake::multibody::MultibodyPlant<double>& plant);
+
+/// Dense permutation from the order of the names in a message to the order
+/// of a plant. It is recomputed only when the layout id of the messages
+/// changes, so that every other message is a straight copy rather than a name
+/// lookup per element.
+///
+/// The receivers below keep it in a cache entry, which depends on their
+/// input ports. Drake recomputes a cache entry in place, so Update() sees the
+/// permutation of the previous message of the same context.
+class NamePermutation {
+ public:
+  /// Recomputes the permutation from `names` if `layout_id` differs from the
+  /// layout id of the last call.
+  /// @param index_map map from name to index in the plant
+  void Update(int64_t layout_id, const std::vector<std::string>& names,
+              const std::map<std::string, int>& index_map);
+
+  /// Sets (*out)(index[i]) = values[i] for the first n values.
+  void Scatter(const std::vector<double>& values, int n,
+               Eigen::VectorXd* out) const;
+
+ private:
+  bool initialized_ = false;
+  int64_t layout_id_ = 0;
+  bool identity_ = false;
+  std::vector<int> index_;
+};
+
+/// Permutations of the positions, velocities and efforts of a robot state
+/// message
+struct RobotStatePermutation {
+  NamePermutation positions;
+  NamePermutation velocities;
+  NamePermutation efforts;
+};
+
 /// Receives the output of an LcmSubsriberSystem that subsribes to the
 /// Robot output channel with LCM type lcmt_robot_output, and outputs the
 /// robot states as a OutputVector.
+///
+/// The order of the names in the messages is detected from the first message
+/// and cached (see NamePermutation), and only detected again when a hash of
+/// the names changes.
+///
+/// With RobotStateFormat::kCompact, the input is an
+/// lcmt_robot_output_compact instead. Messages whose layout id matches the
+/// layout of `plant` are copied directly. Other messages are mapped by name
+/// through the lcmt_robot_state_layout received on get_input_port_layout(),
+/// which must then be connected and carry the same layout id.
 class RobotOutputReceiver : public drake::systems::LeafSystem<double> {
  public:
   explicit RobotOutputReceiver(
-      const drake::multibody::MultibodyPlant<double>& plant);
+      const drake::multibody::MultibodyPlant<double>& plant,
+      RobotStateFormat format = RobotStateFormat::kNamed);
+
+  const drake::systems::InputPort<double>& get_input_port_layout() const {
+    DRAKE_DEMAND(format_ == RobotStateFormat::kCompact);
+    return this->get_input_port(layout_input_port_);
+  }
 
   /// Convenience function to initialize an lcmt_robot_output subscriber with
   /// positions and velocities which are all zero except for the quaternion
@@ -41,20 +117,46 @@ class RobotOutputReceiver : public drake::systems::LeafSystem<double> {
  private:
   void CopyOutput(const drake::systems::Context<double>& context,
                   OutputVector<double>* output) const;
+  // Permutation of the current message, for messages that are not in the
+  // order of the plant
+  void CalcPermutation(const drake::systems::Context<double>& context,
+                       RobotStatePermutation* permutation) const;
+  // Positions, velocities and efforts of a compact message, in the order of
+  // the plant
+  void CopyCompactState(const drake::systems::Context<double>& context,
+                        const lcmt_robot_output_compact& state_msg,
+                        Eigen::VectorXd* positions,
+                        Eigen::VectorXd* velocities,
+                        Eigen::VectorXd* efforts) const;
+  template <typename MessageType>
+  void InitializeMessagePositions(
+      const drake::multibody::MultibodyPlant<double>& plant, double time,
+      MessageType* state_msg) const;
+
   int num_positions_;
   int num_velocities_;
   int num_efforts_;
   std::map<std::string, int> position_index_map_;
   std::map<std::string, int> velocity_index_map_;
   std::map<std::string, int> effort_index_map_;
+  RobotStateFormat format_;
+  int64_t layout_id_;
+  int layout_input_port_ = -1;
+  const drake::systems::CacheEntry* permutation_cache_entry_;
 };
 
 /// Converts a OutputVector object to LCM type lcmt_robot_output
+///
+/// With RobotStateFormat::kCompact, the output is an
+/// lcmt_robot_output_compact instead, and get_output_port_layout() outputs
+/// the (constant) lcmt_robot_state_layout of the messages, to be published on
+/// a metadata channel.
 class RobotOutputSender : public drake::systems::LeafSystem<double> {
  public:
   explicit RobotOutputSender(
       const drake::multibody::MultibodyPlant<double>& plant,
-      const bool publish_efforts = false, const bool publish_imu = false);
+      const bool publish_efforts = false, const bool publish_imu = false,
+      RobotStateFormat format = RobotStateFormat::kNamed);
 
   const drake::systems::InputPort<double>& get_input_port_state() const {
     return this->get_input_port(state_input_port_);
@@ -69,9 +171,22 @@ class RobotOutputSender : public drake::systems::LeafSystem<double> {
     return this->get_input_port(imu_input_port_);
   }
 
+  const drake::systems::OutputPort<double>& get_output_port_layout() const {
+    DRAKE_DEMAND(format_ == RobotStateFormat::kCompact);
+    return this->get_output_port(layout_output_port_);
+  }
+
  private:
   void Output(const drake::systems::Context<double>& context,
               dairlib::lcmt_robot_output* output) const;
+  void OutputCompact(const drake::systems::Context<double>& context,
+                     dairlib::lcmt_robot_output_compact* output) const;
+  void OutputLayout(const drake::systems::Context<double>& context,
+                    dairlib::lcmt_robot_state_layout* layout) const;
+  // Fills the fields common to both formats
+  template <typename MessageType>
+  void FillState(const drake::systems::Context<double>& context,
+                 MessageType* state_msg) const;
 
   int num_positions_;
   int num_velocities_;
@@ -85,13 +200,18 @@ class RobotOutputSender : public drake::systems::LeafSystem<double> {
   int state_input_port_ = -1;
   int effort_input_port_ = -1;
   int imu_input_port_ = -1;
+  int layout_output_port_ = -1;
   bool publish_efforts_;
   bool publish_imu_;
+  RobotStateFormat format_;
+  lcmt_robot_state_layout layout_;
 };
 
 /// Receives the output of an LcmSubsriberSystem that subsribes to the
 /// robot input channel with LCM type lcmt_robot_input and outputs the
 /// robot inputs as a TimestampedVector.
+///
+/// As in RobotOutputReceiver, the order of the names is cached.
 class RobotInputReceiver : public drake::systems::LeafSystem<double> {
  public:
   explicit RobotInputReceiver(
@@ -100,9 +220,12 @@ class RobotInputReceiver : public drake::systems::LeafSystem<double> {
  private:
   void CopyInputOut(const drake::systems::Context<double>& context,
                     TimestampedVector<double>* output) const;
+  void CalcPermutation(const drake::systems::Context<double>& context,
+                       NamePermutation* permutation) const;
 
   int num_actuators_;
   std::map<std::string, int> actuator_index_map_;
+  const drake::systems::CacheEntry* permutation_cache_entry_;
 };
 
 /// Receives the output of a controller, and outputs it as an LCM
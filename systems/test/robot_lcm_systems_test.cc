@@ -0,0 +1,198 @@
+#include "systems/robot_lcm_systems.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "common/find_resource.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/multibody/parsing/parser.h"
+
+namespace dairlib {
+namespace systems {
+namespace {
+
+using drake::CompareMatrices;
+using drake::multibody::MultibodyPlant;
+using drake::multibody::Parser;
+using Eigen::VectorXd;
+
+class RobotLcmSystemsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    plant_ = std::make_unique<MultibodyPlant<double>>(0.0);
+    Parser parser(plant_.get());
+    parser.AddModelFromFile(
+        FindResourceOrThrow("examples/PlanarWalker/PlanarWalker.urdf"));
+    plant_->WeldFrames(plant_->world_frame(), plant_->GetFrameByName("base"),
+                       drake::math::RigidTransform<double>());
+    plant_->Finalize();
+
+    x_.resize(plant_->num_positions() + plant_->num_velocities());
+    u_.resize(plant_->num_actuators());
+    for (int i = 0; i < x_.size(); i++) x_(i) = 0.1 * (i + 1);
+    for (int i = 0; i < u_.size(); i++) u_(i) = -1.0 * (i + 1);
+  }
+
+  // Receiver output for the state x_ and efforts u_, sent in `format`
+  VectorXd SendAndReceive(RobotStateFormat format) {
+    RobotOutputSender sender(*plant_, true, false, format);
+    auto sender_context = sender.CreateDefaultContext();
+    sender_context->SetTime(1.5);
+    sender.get_input_port_state().FixValue(sender_context.get(), x_);
+    sender.get_input_port_effort().FixValue(sender_context.get(), u_);
+
+    RobotOutputReceiver receiver(*plant_, format);
+    auto receiver_context = receiver.CreateDefaultContext();
+    receiver.get_input_port(0).FixValue(
+        receiver_context.get(),
+        sender.get_output_port(0).EvalAbstract(*sender_context));
+    return receiver.get_output_port(0).Eval(*receiver_context);
+  }
+
+  std::unique_ptr<MultibodyPlant<double>> plant_;
+  VectorXd x_;
+  VectorXd u_;
+};
+
+TEST_F(RobotLcmSystemsTest, CompactMatchesNamed) {
+  const VectorXd named = SendAndReceive(RobotStateFormat::kNamed);
+  const VectorXd compact = SendAndReceive(RobotStateFormat::kCompact);
+  EXPECT_TRUE(CompareMatrices(named, compact));
+
+  const int n_x = x_.size();
+  EXPECT_TRUE(CompareMatrices(named.head(n_x), x_));
+  EXPECT_TRUE(CompareMatrices(named.segment(n_x, u_.size()), u_));
+}
+
+// A compact message with a different order is mapped through its layout
+TEST_F(RobotLcmSystemsTest, CompactWithOtherLayout) {
+  const VectorXd expected = SendAndReceive(RobotStateFormat::kNamed);
+
+  RobotOutputSender sender(*plant_, true, false, RobotStateFormat::kCompact);
+  auto sender_context = sender.CreateDefaultContext();
+  sender_context->SetTime(1.5);
+  sender.get_input_port_state().FixValue(sender_context.get(), x_);
+  sender.get_input_port_effort().FixValue(sender_context.get(), u_);
+  auto message = sender.get_output_port(0).Eval<lcmt_robot_output_compact>(
+      *sender_context);
+  auto layout = sender.get_output_port_layout().Eval<lcmt_robot_state_layout>(
+      *sender_context);
+  EXPECT_EQ(message.layout_id, layout.layout_id);
+
+  // Reverse the order of the positions and efforts
+  std::reverse(message.position.begin(), message.position.end());
+  std::reverse(layout.position_names.begin(), layout.position_names.end());
+  std::reverse(message.effort.begin(), message.effort.end());
+  std::reverse(layout.effort_names.begin(), layout.effort_names.end());
+  layout.layout_id = RobotStateLayoutId(
+      layout.position_names, layout.velocity_names, layout.effort_names);
+  EXPECT_NE(layout.layout_id, message.layout_id);
+  message.layout_id = layout.layout_id;
+
+  RobotOutputReceiver receiver(*plant_, RobotStateFormat::kCompact);
+  auto receiver_context = receiver.CreateDefaultContext();
+  receiver.get_input_port(0).FixValue(receiver_context.get(), message);
+  // Without the layout, the message cannot be interpreted
+  EXPECT_THROW(receiver.get_output_port(0).Eval(*receiver_context),
+               std::runtime_error);
+
+  receiver.get_input_port_layout().FixValue(receiver_context.get(), layout);
+  EXPECT_TRUE(CompareMatrices(receiver.get_output_port(0).Eval(
+                                  *receiver_context),
+                              expected));
+}
+
+// The receivers cache the order of the names, and must detect a change of
+// the order between messages
+TEST_F(RobotLcmSystemsTest, NamedLayoutChange) {
+  const VectorXd expected = SendAndReceive(RobotStateFormat::kNamed);
+
+  RobotOutputSender sender(*plant_, true);
+  auto sender_context = sender.CreateDefaultContext();
+  sender_context->SetTime(1.5);
+  sender.get_input_port_state().FixValue(sender_context.get(), x_);
+  sender.get_input_port_effort().FixValue(sender_context.get(), u_);
+  const auto message =
+      sender.get_output_port(0).Eval<lcmt_robot_output>(*sender_context);
+  auto reversed = message;
+  std::reverse(reversed.position.begin(), reversed.position.end());
+  std::reverse(reversed.position_names.begin(),
+               reversed.position_names.end());
+  std::reverse(reversed.velocity.begin(), reversed.velocity.end());
+  std::reverse(reversed.velocity_names.begin(),
+               reversed.velocity_names.end());
+  std::reverse(reversed.effort.begin(), reversed.effort.end());
+  std::reverse(reversed.effort_names.begin(), reversed.effort_names.end());
+
+  RobotOutputReceiver receiver(*plant_);
+  auto receiver_context = receiver.CreateDefaultContext();
+  for (const auto* msg : {&message, &reversed, &reversed, &message}) {
+    receiver.get_input_port(0).FixValue(receiver_context.get(), *msg);
+    EXPECT_TRUE(CompareMatrices(receiver.get_output_port(0).Eval(
+                                    *receiver_context),
+                                expected));
+  }
+
+  lcmt_robot_input input_msg;
+  input_msg.utime = 1e6;
+  input_msg.num_efforts = u_.size();
+  input_msg.effort_names = message.effort_names;
+  input_msg.efforts = message.effort;
+  auto reversed_input = input_msg;
+  std::reverse(reversed_input.effort_names.begin(),
+               reversed_input.effort_names.end());
+  std::reverse(reversed_input.efforts.begin(), reversed_input.efforts.end());
+
+  RobotInputReceiver input_receiver(*plant_);
+  auto input_context = input_receiver.CreateDefaultContext();
+  for (const auto* msg : {&input_msg, &reversed_input, &input_msg}) {
+    input_receiver.get_input_port(0).FixValue(input_context.get(), *msg);
+    EXPECT_TRUE(CompareMatrices(
+        input_receiver.get_output_port(0).Eval(*input_context).head(u_.size()),
+        u_));
+  }
+}
+
+// The permutations are cached per context, so two contexts receiving
+// messages in different orders do not interfere
+TEST_F(RobotLcmSystemsTest, PermutationPerContext) {
+  const VectorXd expected = SendAndReceive(RobotStateFormat::kNamed);
+
+  RobotOutputSender sender(*plant_, true);
+  auto sender_context = sender.CreateDefaultContext();
+  sender_context->SetTime(1.5);
+  sender.get_input_port_state().FixValue(sender_context.get(), x_);
+  sender.get_input_port_effort().FixValue(sender_context.get(), u_);
+  const auto message =
+      sender.get_output_port(0).Eval<lcmt_robot_output>(*sender_context);
+  auto reversed = message;
+  std::reverse(reversed.position.begin(), reversed.position.end());
+  std::reverse(reversed.position_names.begin(),
+               reversed.position_names.end());
+
+  const RobotOutputReceiver receiver(*plant_);
+  auto context = receiver.CreateDefaultContext();
+  auto reversed_context = receiver.CreateDefaultContext();
+  for (int i = 0; i < 2; i++) {
+    receiver.get_input_port(0).FixValue(context.get(), message);
+    receiver.get_input_port(0).FixValue(reversed_context.get(), reversed);
+    EXPECT_TRUE(CompareMatrices(receiver.get_output_port(0).Eval(*context),
+                                expected));
+    EXPECT_TRUE(CompareMatrices(
+        receiver.get_output_port(0).Eval(*reversed_context), expected));
+  }
+}
+
+}  // namespace
+}  // namespace systems
+}  // namespace dairlib
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,7 +1,11 @@
 #include "systems/trajectory_optimization/dircon/dircon.h"
 
+#include <thread>
+#include <type_traits>
+
 #include "multibody/kinematic/kinematic_constraints.h"
 #include "multibody/multibody_utils.h"
+#include "solvers/constraint_batch.h"
 #include "systems/trajectory_optimization/dircon/dircon_opt_constraints.h"
 
 namespace dairlib {
@@ -10,6 +14,8 @@ namespace trajectory_optimization {
 
 using drake::VectorX;
 using drake::multibody::MultibodyPlant;
+using drake::solvers::Binding;
+using drake::solvers::Constraint;
 using drake::solvers::MathematicalProgramResult;
 using drake::solvers::MatrixXDecisionVariable;
 using drake::solvers::VectorXDecisionVariable;
@@ -48,6 +54,31 @@ Dircon<T>::Dircon(std::unique_ptr<DirconModeSequence<T>> my_sequence,
       mode_sequence_(ext_sequence ? *ext_sequence : *my_sequence_),
       contexts_(num_modes()),
       mode_start_(num_modes()) {
+  // With more than one thread, the dynamics-heavy constraints (collocation,
+  // kinematic and impact) are collected here and added as a single
+  // ConstraintBatch, evaluated in parallel. Each of them then gets contexts
+  // of its own instead of sharing the knot point contexts.
+  int num_threads = mode_sequence_.num_threads();
+  if (num_threads < 1) {
+    num_threads = std::thread::hardware_concurrency();
+  }
+  std::vector<Binding<Constraint>> batch_bindings;
+  auto add_constraint = [&](const std::shared_ptr<Constraint>& constraint,
+                            const drake::solvers::VariableRefList& vars) {
+    if (num_threads > 1) {
+      batch_bindings.emplace_back(constraint, vars);
+    } else {
+      prog().AddConstraint(constraint, vars);
+    }
+  };
+  auto knot_context = [&](int i_mode, int j) {
+    if (num_threads > 1) {
+      owned_contexts_.push_back(plant_.CreateDefaultContext());
+      return owned_contexts_.back().get();
+    }
+    return contexts_[i_mode].at(j).get();
+  };
+
   // Loop over all modes
   for (int i_mode = 0; i_mode < num_modes(); i_mode++) {
     const auto& mode = get_mode(i_mode);
@@ -148,11 +179,28 @@ Dircon<T>::Dircon(std::unique_ptr<DirconModeSequence<T>> my_sequence,
     cache_.push_back(
         std::make_unique<DynamicsCache<T>>(mode.evaluators(), cache_size));
     for (int j = 0; j < mode.num_knotpoints() - 1; j++) {
-      auto constraint = std::make_shared<DirconCollocationConstraint<T>>(
-          plant_, mode.evaluators(), contexts_[i_mode].at(j).get(),
-          contexts_[i_mode].at(j + 1).get(), i_mode, j, cache_[i_mode].get());
+      std::shared_ptr<DirconCollocationConstraint<T>> constraint;
+      if constexpr (std::is_same_v<T, double>) {
+        if (mode.analytic_dynamics_gradients()) {
+          if (!plant_ad_) {
+            plant_ad_ = drake::systems::System<double>::ToAutoDiffXd(plant_);
+          }
+          constraint = std::make_shared<AnalyticDirconCollocationConstraint>(
+              plant_, mode.evaluators(), knot_context(i_mode, j),
+              knot_context(i_mode, j + 1), i_mode, j, cache_[i_mode].get(),
+              plant_ad_.get());
+        }
+      }
+      if (!constraint) {
+        constraint = std::make_shared<DirconCollocationConstraint<T>>(
+            plant_, mode.evaluators(), knot_context(i_mode, j),
+            knot_context(i_mode, j + 1), i_mode, j, cache_[i_mode].get());
+      }
       constraint->SetConstraintScaling(mode.GetDynamicsScale());
-      prog().AddConstraint(
+      if (mode.colored_finite_differences()) {
+        constraint->DetectJacobianSparsityPattern();
+      }
+      add_constraint(
           constraint,
           {timestep(mode_start_[i_mode] + j), state_vars(i_mode, j),
            state_vars(i_mode, j + 1), input_vars(i_mode, j),
@@ -188,13 +236,16 @@ Dircon<T>::Dircon(std::unique_ptr<DirconModeSequence<T>> my_sequence,
 
         auto pos_constraint = std::make_shared<KinematicPositionConstraint<T>>(
             plant_, mode.evaluators(), lb, ub, mode.relative_constraints(),
-            contexts_[i_mode].at(j).get(),
+            knot_context(i_mode, j),
             "kinematic_position[" + std::to_string(i_mode) + "][" +
                 std::to_string(j) + "]");
         pos_constraint->SetConstraintScaling(mode.GetKinPositionScale());
-        prog().AddConstraint(pos_constraint,
-                      {state_vars(i_mode, j).head(plant_.num_positions()),
-                       offset_vars(i_mode)});
+        if (mode.colored_finite_differences()) {
+          pos_constraint->DetectJacobianSparsityPattern();
+        }
+        add_constraint(pos_constraint,
+                       {state_vars(i_mode, j).head(plant_.num_positions()),
+                        offset_vars(i_mode)});
       }
 
       // Velocity constraints if type is not acceleration only. Also skip if
@@ -207,24 +258,30 @@ Dircon<T>::Dircon(std::unique_ptr<DirconModeSequence<T>> my_sequence,
                   plant_, mode.evaluators(),
                   VectorXd::Zero(mode.evaluators().count_active()),
                   VectorXd::Zero(mode.evaluators().count_active()),
-                  contexts_[i_mode].at(j).get(),
+                  knot_context(i_mode, j),
                   "kinematic_velocity[" + std::to_string(i_mode) + "][" +
                       std::to_string(j) + "]");
           vel_constraint->SetConstraintScaling(mode.GetKinVelocityScale());
-          prog().AddConstraint(vel_constraint, state_vars(i_mode, j));
+          if (mode.colored_finite_differences()) {
+            vel_constraint->DetectJacobianSparsityPattern();
+          }
+          add_constraint(vel_constraint, {state_vars(i_mode, j)});
         }
       }
 
       // Acceleration constraints (always)
       auto accel_constraint = std::make_shared<CachedAccelerationConstraint<T>>(
-          plant_, mode.evaluators(), contexts_[i_mode].at(j).get(),
+          plant_, mode.evaluators(), knot_context(i_mode, j),
           "kinematic_acceleration[" + std::to_string(i_mode) + "][" +
               std::to_string(j) + "]",
           cache_[i_mode].get());
       accel_constraint->SetConstraintScaling(mode.GetKinAccelerationScale());
-      prog().AddConstraint(accel_constraint,
-                    {state_vars(i_mode, j), input_vars(i_mode, j),
-                     force_vars(i_mode, j)});
+      if (mode.colored_finite_differences()) {
+        accel_constraint->DetectJacobianSparsityPattern();
+      }
+      add_constraint(accel_constraint,
+                     {state_vars(i_mode, j), input_vars(i_mode, j),
+                      force_vars(i_mode, j)});
     }
 
     //
@@ -239,11 +296,15 @@ Dircon<T>::Dircon(std::unique_ptr<DirconModeSequence<T>> my_sequence,
 
         // Use pre-impact context
         auto impact_constraint = std::make_shared<ImpactConstraint<T>>(
-            plant_, mode.evaluators(), contexts_[i_mode - 1].back().get(),
+            plant_, mode.evaluators(),
+            knot_context(i_mode - 1, contexts_[i_mode - 1].size() - 1),
             "impact[" + std::to_string(i_mode) + "]");
         impact_constraint->SetConstraintScaling(mode.GetImpactScale());
+        if (mode.colored_finite_differences()) {
+          impact_constraint->DetectJacobianSparsityPattern();
+        }
 
-        prog().AddConstraint(
+        add_constraint(
             impact_constraint,
             {state_vars(i_mode - 1, pre_impact_index), impulse_vars(i_mode - 1),
              post_impact_velocity_vars(i_mode - 1)});
@@ -333,6 +394,12 @@ Dircon<T>::Dircon(std::unique_ptr<DirconModeSequence<T>> my_sequence,
       }
     }
   }
+
+  if (!batch_bindings.empty()) {
+    auto batch = std::make_shared<solvers::ConstraintBatch>(
+        batch_bindings, num_threads, "dircon_constraint_batch");
+    prog().AddConstraint(batch, batch->variables());
+  }
 }
 
 ///
@@ -74,6 +74,12 @@ class Dircon
   Eigen::MatrixXd GetForceSamplesByMode(
       const drake::solvers::MathematicalProgramResult& result, int mode) const;
 
+  /// The cache of dynamics evaluations shared by the constraints of a mode,
+  /// e.g. to check its hit rate after solving
+  const DynamicsCache<T>& dynamics_cache(int mode) const {
+    return *cache_.at(mode);
+  }
+
   /// Adds a visualization callback that will visualize knot points
   /// without transparency. Cannot be called twice
   /// @param model_name The path of a URDF/SDF model name for visualization
@@ -233,6 +239,8 @@ class Dircon
   const DirconModeSequence<T>& mode_sequence_;
   std::vector<std::vector<std::unique_ptr<drake::systems::Context<T>>>>
       contexts_;
+  // Per-constraint contexts, when the constraints are evaluated in parallel
+  std::vector<std::unique_ptr<drake::systems::Context<T>>> owned_contexts_;
   std::vector<int> mode_start_;
   void DoAddRunningCost(const drake::symbolic::Expression& e) override;
   std::vector<drake::solvers::VectorXDecisionVariable> force_vars_;
@@ -244,6 +252,10 @@ class Dircon
   std::vector<drake::solvers::VectorXDecisionVariable> quaternion_slack_vars_;
   std::unique_ptr<multibody::MultiposeVisualizer> callback_visualizer_;
   std::vector<std::unique_ptr<DynamicsCache<T>>> cache_;
+  // AutoDiffXd copy of the plant, shared by the analytic collocation
+  // constraints (see DirconMode::SetAnalyticDynamicsGradients)
+  std::unique_ptr<drake::multibody::MultibodyPlant<drake::AutoDiffXd>>
+      plant_ad_;
 
   std::vector<std::pair<drake::VectorX<drake::symbolic::Variable>,
                         drake::VectorX<drake::symbolic::Expression>>>
@@ -0,0 +1,220 @@
+#include "systems/trajectory_optimization/dircon/dircon_continuation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <sstream>
+
+#include "common/thread_pool.h"
+
+#include "drake/common/drake_throw.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+using drake::multibody::MultibodyPlant;
+using drake::solvers::MathematicalProgramResult;
+using drake::solvers::SolverInterface;
+using Eigen::VectorXd;
+
+namespace {
+
+// Distance between two grid points, with each parameter divided by its scale
+double ScaledDistance(const VectorXd& a, const VectorXd& b,
+                      const VectorXd& scale) {
+  return (a - b).cwiseQuotient(scale).norm();
+}
+
+}  // namespace
+
+std::vector<GaitLibraryEntry> SolveDirconContinuation(
+    const MultibodyPlant<double>& plant, const std::vector<VectorXd>& grid,
+    const std::function<std::unique_ptr<Dircon<double>>(const VectorXd&)>&
+        build_problem,
+    const SolverInterface& solver, const DirconContinuationOptions& options) {
+  DRAKE_THROW_UNLESS(solver.available());
+  const int num_points = grid.size();
+  if (num_points == 0) return {};
+  DRAKE_THROW_UNLESS(options.start_index >= 0 &&
+                     options.start_index < num_points);
+  const VectorXd scale = options.parameter_scale.size() > 0
+                             ? options.parameter_scale
+                             : VectorXd::Ones(grid[0].size());
+
+  std::vector<GaitLibraryEntry> entries(num_points);
+  for (int i = 0; i < num_points; i++) {
+    DRAKE_THROW_UNLESS(grid[i].size() == scale.size());
+    entries[i].parameters = grid[i];
+  }
+  // Successful solutions, kept in memory to seed their neighbors
+  std::vector<std::unique_ptr<DirconTrajectory>> solutions(num_points);
+  std::vector<bool> scheduled(num_points, false);
+
+  ThreadPool pool(options.num_threads);
+  std::vector<int> batch = {options.start_index};
+  while (!batch.empty()) {
+    for (int i : batch) {
+      scheduled[i] = true;
+    }
+    pool.ParallelFor(batch.size(), [&](int b) {
+      const int i = batch[b];
+      auto& entry = entries[i];
+      auto trajopt = build_problem(grid[i]);
+      if (entry.seed_index >= 0) {
+        SetInitialGuessFromDirconTrajectory(*solutions[entry.seed_index],
+                                            trajopt.get());
+      }
+      const auto& prog = trajopt->prog();
+
+      MathematicalProgramResult result;
+      auto start = std::chrono::steady_clock::now();
+      solver.Solve(prog, prog.initial_guess(), std::nullopt, &result);
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      entry.solution_result = result.get_solution_result();
+      entry.cost = result.get_optimal_cost();
+      entry.solve_time = elapsed.count();
+      if (!result.is_success()) {
+        return;
+      }
+
+      solutions[i] = std::make_unique<DirconTrajectory>(
+          plant, *trajopt, result, options.name + "_" + std::to_string(i),
+          options.description);
+      if (!options.filepath_prefix.empty()) {
+        entry.filepath = options.filepath_prefix + "_" + std::to_string(i);
+        solutions[i]->WriteToFile(entry.filepath);
+      }
+    });
+
+    // Next batch: the unscheduled points closest to a solved one, each
+    // seeded from its nearest solved point
+    std::vector<std::pair<double, int>> candidates;
+    for (int i = 0; i < num_points; i++) {
+      if (scheduled[i]) continue;
+      double min_distance = std::numeric_limits<double>::infinity();
+      entries[i].seed_index = -1;
+      for (int j = 0; j < num_points; j++) {
+        if (!solutions[j]) continue;
+        const double distance = ScaledDistance(grid[i], grid[j], scale);
+        if (distance < min_distance) {
+          min_distance = distance;
+          entries[i].seed_index = j;
+        }
+      }
+      candidates.emplace_back(min_distance, i);
+    }
+    // Without any solution yet, points are cold started in grid order
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const auto& a, const auto& b) {
+                       return a.first < b.first;
+                     });
+    batch.clear();
+    for (int k = 0; k < std::min<int>(candidates.size(), pool.num_threads());
+         k++) {
+      batch.push_back(candidates[k].second);
+    }
+  }
+
+  if (!options.index_filepath.empty()) {
+    WriteGaitLibraryIndex(options.index_filepath, options.parameter_names,
+                          entries);
+  }
+  return entries;
+}
+
+void SetInitialGuessFromDirconTrajectory(const DirconTrajectory& traj,
+                                         Dircon<double>* trajopt) {
+  auto& prog = trajopt->prog();
+  const VectorXd decision_vars = traj.GetDecisionVariables();
+  if (decision_vars.size() == prog.num_vars()) {
+    prog.SetInitialGuessForAllVariables(decision_vars);
+    return;
+  }
+
+  DRAKE_THROW_UNLESS(traj.GetNumModes() == trajopt->num_modes());
+  trajopt->SetInitialTrajectory(traj.ReconstructInputTrajectory(),
+                                traj.ReconstructStateTrajectory());
+  const auto lambda_traj = traj.ReconstructLambdaTrajectory();
+  const auto lambda_c_traj = traj.ReconstructLambdaCTrajectory();
+  const auto gamma_traj = traj.ReconstructGammaCTrajectory();
+  for (int mode = 0; mode < trajopt->num_modes(); ++mode) {
+    trajopt->SetInitialForceTrajectory(mode, lambda_traj[mode],
+                                       lambda_c_traj[mode], gamma_traj[mode]);
+  }
+}
+
+void WriteGaitLibraryIndex(const std::string& filepath,
+                           const std::vector<std::string>& parameter_names,
+                           const std::vector<GaitLibraryEntry>& entries) {
+  std::ofstream file(filepath);
+  DRAKE_THROW_UNLESS(file.is_open());
+  for (const auto& name : parameter_names) {
+    file << name << ",";
+  }
+  file << "filepath\n";
+  file.precision(17);
+  for (const auto& entry : entries) {
+    if (entry.filepath.empty()) continue;
+    for (int i = 0; i < entry.parameters.size(); i++) {
+      file << entry.parameters(i) << ",";
+    }
+    file << entry.filepath << "\n";
+  }
+}
+
+std::vector<GaitLibraryEntry> LoadGaitLibraryIndex(
+    const std::string& filepath) {
+  std::ifstream file(filepath);
+  DRAKE_THROW_UNLESS(file.is_open());
+  std::vector<GaitLibraryEntry> entries;
+  std::string line;
+  // Header
+  std::getline(file, line);
+  while (std::getline(file, line)) {
+    if (line.empty()) continue;
+    std::vector<std::string> fields;
+    std::stringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+      fields.push_back(field);
+    }
+    GaitLibraryEntry entry;
+    entry.parameters.resize(fields.size() - 1);
+    for (int i = 0; i < entry.parameters.size(); i++) {
+      entry.parameters(i) = std::stod(fields[i]);
+    }
+    entry.filepath = fields.back();
+    entry.solution_result = drake::solvers::SolutionResult::kSolutionFound;
+    entries.push_back(entry);
+  }
+  return entries;
+}
+
+int FindNearestGaitLibraryEntry(const std::vector<GaitLibraryEntry>& entries,
+                                const VectorXd& parameters,
+                                const VectorXd& parameter_scale) {
+  const VectorXd scale = parameter_scale.size() > 0
+                             ? parameter_scale
+                             : VectorXd::Ones(parameters.size());
+  DRAKE_THROW_UNLESS(scale.size() == parameters.size());
+  int nearest = -1;
+  double min_distance = std::numeric_limits<double>::infinity();
+  for (int i = 0; i < static_cast<int>(entries.size()); i++) {
+    DRAKE_THROW_UNLESS(entries[i].parameters.size() == parameters.size());
+    const double distance =
+        ScaledDistance(entries[i].parameters, parameters, scale);
+    if (distance < min_distance) {
+      min_distance = distance;
+      nearest = i;
+    }
+  }
+  return nearest;
+}
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
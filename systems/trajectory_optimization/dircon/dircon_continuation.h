@@ -0,0 +1,117 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lcm/dircon_saved_trajectory.h"
+#include "systems/trajectory_optimization/dircon/dircon.h"
+
+#include "drake/solvers/solution_result.h"
+#include "drake/solvers/solver_interface.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// Options for SolveDirconContinuation()
+struct DirconContinuationOptions {
+  /// Number of grid points solved at the same time. With more than one, the
+  /// points of a batch are all seeded from the solutions of earlier batches,
+  /// so the seeds can be farther away than with 1 (default).
+  int num_threads = 1;
+
+  /// Index of the grid point solved first, from the guess set by
+  /// build_problem
+  int start_index = 0;
+
+  /// Per-parameter scale of the distance between grid points. Defaults to
+  /// ones.
+  Eigen::VectorXd parameter_scale;
+
+  /// Solution i is written to filepath_prefix + "_" + i. If empty, nothing
+  /// is written.
+  std::string filepath_prefix;
+
+  /// If not empty, the library index (see WriteGaitLibraryIndex) is written
+  /// here, with the given parameter names as its header
+  std::string index_filepath;
+  std::vector<std::string> parameter_names;
+
+  /// Name and description of the saved DirconTrajectory objects
+  std::string name = "dircon_trajectory";
+  std::string description;
+};
+
+/// One grid point of a gait library
+struct GaitLibraryEntry {
+  Eigen::VectorXd parameters;
+  /// Path of the saved DirconTrajectory, or empty if it was not solved
+  std::string filepath;
+  /// Grid point whose solution seeded this one, or -1 for a cold start
+  int seed_index = -1;
+  drake::solvers::SolutionResult solution_result =
+      drake::solvers::SolutionResult::kSolutionResultNotSet;
+  double cost = 0;
+  double solve_time = 0;  // [s]
+
+  bool is_success() const {
+    return solution_result == drake::solvers::SolutionResult::kSolutionFound;
+  }
+};
+
+/// Solves a gait library over a grid of parameters (e.g. walking speeds) by
+/// continuation. The start point is solved from the guess set by
+/// build_problem. After that, the unsolved point closest to an already
+/// solved one is solved next, seeded with the solution of that neighbor (see
+/// SetInitialGuessFromDirconTrajectory). Failed solves are never used as
+/// seeds; if no solution is available, the next point starts cold.
+///
+/// build_problem(parameters) returns the problem for a grid point, with its
+/// constraints, costs, solver options and a cold initial guess. With
+/// num_threads > 1 it is called from several threads (see
+/// SolveDirconMultiStart for what that requires).
+///
+/// @return one entry per grid point, in grid order
+std::vector<GaitLibraryEntry> SolveDirconContinuation(
+    const drake::multibody::MultibodyPlant<double>& plant,
+    const std::vector<Eigen::VectorXd>& grid,
+    const std::function<std::unique_ptr<Dircon<double>>(
+        const Eigen::VectorXd&)>& build_problem,
+    const drake::solvers::SolverInterface& solver,
+    const DirconContinuationOptions& options);
+
+/// Sets the initial guess of trajopt from a saved solution. If both have the
+/// same number of decision variables (the same problem at a neighboring
+/// parameter), all of them are copied, including the timesteps and slack
+/// variables. Otherwise the state, input and force trajectories are
+/// resampled, and the timesteps are taken from their breaks.
+///
+/// Only the primal solution is used. Drake's SNOPT and IPOPT interfaces do
+/// not take an initial guess for the constraint multipliers.
+void SetInitialGuessFromDirconTrajectory(const DirconTrajectory& traj,
+                                         Dircon<double>* trajopt);
+
+/// Writes the successful entries as a CSV file, one line per entry:
+/// the parameters followed by the filepath. The first line holds the
+/// parameter names and "filepath".
+void WriteGaitLibraryIndex(const std::string& filepath,
+                           const std::vector<std::string>& parameter_names,
+                           const std::vector<GaitLibraryEntry>& entries);
+
+/// Reads the entries written by WriteGaitLibraryIndex (parameters and
+/// filepath only)
+std::vector<GaitLibraryEntry> LoadGaitLibraryIndex(const std::string& filepath);
+
+/// Index of the entry closest to the given parameters, or -1 if there are
+/// none. Distances are measured like in SolveDirconContinuation, with each
+/// parameter divided by its parameter_scale (ones if empty).
+int FindNearestGaitLibraryEntry(
+    const std::vector<GaitLibraryEntry>& entries,
+    const Eigen::VectorXd& parameters,
+    const Eigen::VectorXd& parameter_scale = Eigen::VectorXd());
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -55,6 +55,31 @@ class DirconMode {
 
   bool IsSkipQuaternionConstraint(int knotpoint_index) const;
 
+  /// Detect the Jacobian sparsity of the dynamics, kinematic and impact
+  /// constraints of this mode, so that their numerical gradients perturb
+  /// structurally independent variables together. See
+  /// NonlinearConstraint::DetectJacobianSparsityPattern(). Only affects
+  /// Dircon<double>.
+  void SetColoredFiniteDifferences(bool colored) {
+    colored_finite_differences_ = colored;
+  };
+
+  bool colored_finite_differences() const {
+    return colored_finite_differences_;
+  };
+
+  /// Use AnalyticDirconCollocationConstraint for the collocation constraints
+  /// of this mode, which computes their gradient from the mass matrix,
+  /// inverse dynamics and constraint Jacobians instead of finite
+  /// differencing. Only affects Dircon<double>.
+  void SetAnalyticDynamicsGradients(bool analytic) {
+    analytic_dynamics_gradients_ = analytic;
+  };
+
+  bool analytic_dynamics_gradients() const {
+    return analytic_dynamics_gradients_;
+  };
+
   /// Count the number of relative constraints
   int num_relative_constraints() const { return relative_constraints_.size(); };
 
@@ -187,6 +212,8 @@ class DirconMode {
   const double force_regularization_;
   std::set<int> relative_constraints_;
   std::set<int> skip_quaternion_;
+  bool colored_finite_differences_ = false;
+  bool analytic_dynamics_gradients_ = false;
 
   // Manually-set constraint types, organized by index. See set_constraint_type.
   std::unordered_map<int, KinematicConstraintType> reduced_constraints_;
@@ -218,9 +245,18 @@ class DirconModeSequence {
 
   const DirconMode<T>& mode(int index) const { return *modes_.at(index); };
 
+  /// Evaluate the collocation, kinematic and impact constraints of all modes
+  /// in parallel on num_threads threads, as a single
+  /// solvers::ConstraintBatch. Values below 1 use all cores. Default 1
+  /// (serial, one binding per constraint).
+  void SetNumThreads(int num_threads) { num_threads_ = num_threads; };
+
+  int num_threads() const { return num_threads_; };
+
  private:
   const drake::multibody::MultibodyPlant<T>& plant_;
   std::vector<DirconMode<T>*> modes_;
+  int num_threads_ = 1;
 };
 
 }  // namespace trajectory_optimization
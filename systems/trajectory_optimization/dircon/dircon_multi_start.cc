@@ -0,0 +1,108 @@
+#include "systems/trajectory_optimization/dircon/dircon_multi_start.h"
+
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <optional>
+#include <random>
+
+#include "common/thread_pool.h"
+#include "lcm/dircon_saved_trajectory.h"
+
+#include "drake/common/drake_throw.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+using drake::multibody::MultibodyPlant;
+using drake::solvers::MathematicalProgram;
+using drake::solvers::MathematicalProgramResult;
+using drake::solvers::SolverInterface;
+using Eigen::VectorXd;
+
+std::vector<DirconMultiStartResult> SolveDirconMultiStart(
+    const MultibodyPlant<double>& plant, int num_problems,
+    const std::function<std::unique_ptr<Dircon<double>>(int)>& build_problem,
+    const SolverInterface& solver, const DirconMultiStartOptions& options) {
+  DRAKE_THROW_UNLESS(solver.available());
+  std::vector<DirconMultiStartResult> results(num_problems);
+
+  // Lowest-cost solution so far, when only that one is saved
+  std::mutex best_mutex;
+  std::unique_ptr<DirconTrajectory> best_traj;
+  int best_index = -1;
+
+  ThreadPool pool(options.num_threads);
+  pool.ParallelFor(num_problems, [&](int i) {
+    auto trajopt = build_problem(i);
+    const auto& prog = trajopt->prog();
+
+    MathematicalProgramResult result;
+    auto start = std::chrono::steady_clock::now();
+    solver.Solve(prog, prog.initial_guess(), std::nullopt, &result);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    auto& outcome = results[i];
+    outcome.index = i;
+    outcome.solution_result = result.get_solution_result();
+    outcome.cost = result.get_optimal_cost();
+    outcome.solve_time = elapsed.count();
+    if (!result.is_success() || options.filepath_prefix.empty()) {
+      return;
+    }
+
+    auto traj = std::make_unique<DirconTrajectory>(
+        plant, *trajopt, result, options.name + "_" + std::to_string(i),
+        options.description);
+    if (options.save_all) {
+      outcome.filepath = options.filepath_prefix + "_" + std::to_string(i);
+      traj->WriteToFile(outcome.filepath);
+    } else {
+      std::lock_guard<std::mutex> lock(best_mutex);
+      if (best_index < 0 || outcome.cost < results[best_index].cost) {
+        best_traj = std::move(traj);
+        best_index = i;
+      }
+    }
+  });
+
+  if (best_traj) {
+    auto& best = results[best_index];
+    best.filepath = options.filepath_prefix + "_" + std::to_string(best_index);
+    best_traj->WriteToFile(best.filepath);
+  }
+  return results;
+}
+
+int FindBestDirconMultiStartResult(
+    const std::vector<DirconMultiStartResult>& results) {
+  int best_index = -1;
+  for (int i = 0; i < static_cast<int>(results.size()); i++) {
+    if (results[i].is_success() &&
+        (best_index < 0 || results[i].cost < results[best_index].cost)) {
+      best_index = i;
+    }
+  }
+  return best_index;
+}
+
+void PerturbInitialGuess(double scale, unsigned int seed,
+                         MathematicalProgram* prog) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> distribution(-scale, scale);
+  VectorXd guess = prog->initial_guess();
+  for (int i = 0; i < guess.size(); i++) {
+    // Variables without a guess are NaN, which the solvers start from zero
+    if (std::isnan(guess(i))) {
+      guess(i) = 0;
+    }
+    guess(i) += distribution(generator);
+  }
+  prog->SetInitialGuessForAllVariables(guess);
+}
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "systems/trajectory_optimization/dircon/dircon.h"
+
+#include "drake/solvers/mathematical_program.h"
+#include "drake/solvers/solution_result.h"
+#include "drake/solvers/solver_interface.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+
+/// Options for SolveDirconMultiStart()
+struct DirconMultiStartOptions {
+  /// Number of problems built and solved at the same time. Values below 1 use
+  /// all cores. The problems themselves should then evaluate their
+  /// constraints serially (DirconModeSequence::SetNumThreads(1)).
+  int num_threads = 0;
+
+  /// Write every successful solution, or only the one with the lowest cost
+  bool save_all = true;
+
+  /// Solution i is written to filepath_prefix + "_" + i. If empty, nothing
+  /// is written.
+  std::string filepath_prefix;
+
+  /// Name and description of the saved DirconTrajectory objects
+  std::string name = "dircon_trajectory";
+  std::string description;
+};
+
+/// Outcome of one of the problems of SolveDirconMultiStart()
+struct DirconMultiStartResult {
+  int index = -1;
+  drake::solvers::SolutionResult solution_result =
+      drake::solvers::SolutionResult::kSolutionResultNotSet;
+  double cost = 0;
+  double solve_time = 0;  // [s]
+  /// Path of the saved DirconTrajectory, or empty if it was not written
+  std::string filepath;
+
+  bool is_success() const {
+    return solution_result == drake::solvers::SolutionResult::kSolutionFound;
+  }
+};
+
+/// Builds and solves num_problems independent Dircon problems in parallel,
+/// e.g. from perturbed initial guesses or over a sweep of gait parameters.
+///
+/// build_problem(i) returns problem i, with its constraints, costs, initial
+/// guess and solver options set. It is called from the worker threads, so it
+/// must only read anything it shares with other problems (the plant, the
+/// KinematicEvaluatorSets and the DirconModeSequence can be shared). At most
+/// num_threads problems are alive at a time, and each is destroyed once its
+/// solution is saved.
+///
+/// The solver must be thread-safe for num_threads > 1. SnoptSolver is;
+/// IpoptSolver with MUMPS is not.
+///
+/// @return the outcome of every problem, ordered by index
+std::vector<DirconMultiStartResult> SolveDirconMultiStart(
+    const drake::multibody::MultibodyPlant<double>& plant, int num_problems,
+    const std::function<std::unique_ptr<Dircon<double>>(int)>& build_problem,
+    const drake::solvers::SolverInterface& solver,
+    const DirconMultiStartOptions& options);
+
+/// Index into `results` of the successful solution with the lowest cost, or
+/// -1 if none succeeded
+int FindBestDirconMultiStartResult(
+    const std::vector<DirconMultiStartResult>& results);
+
+/// Adds uniform noise in [-scale, scale] to the initial guess of every
+/// decision variable of prog (taking variables without a guess as zero), with
+/// a fixed seed so that starts are reproducible
+void PerturbInitialGuess(double scale, unsigned int seed,
+                         drake::solvers::MathematicalProgram* prog);
+
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -1,7 +1,15 @@
 #include "systems/trajectory_optimization/dircon/dircon_opt_constraints.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
 #include "multibody/multibody_utils.h"
 
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+#include "drake/multibody/tree/multibody_forces.h"
+
 namespace dairlib {
 namespace systems {
 namespace trajectory_optimization {
@@ -9,6 +17,8 @@ namespace trajectory_optimization {
 using multibody::KinematicEvaluatorSet;
 using solvers::NonlinearConstraint;
 
+using drake::AutoDiffVecXd;
+using drake::AutoDiffXd;
 using drake::VectorX;
 using drake::multibody::MultibodyPlant;
 using drake::systems::Context;
@@ -55,7 +65,11 @@ DirconCollocationConstraint<T>::DirconCollocationConstraint(
       n_x_(plant.num_positions() + plant.num_velocities()),
       n_u_(plant.num_actuators()),
       n_l_(evaluators.count_full()),
-      cache_(cache) {}
+      cache_(cache),
+      xdot0_(n_x_),
+      xdot1_(n_x_),
+      g_(n_x_),
+      J_col_(evaluators.count_full(), plant.num_velocities()) {}
 
 /// The format of the input to the eval() function is in the order
 ///   - timestep h
@@ -87,45 +101,235 @@ void DirconCollocationConstraint<T>::EvaluateConstraint(
   // Evaluate dynamics at k and k+1
   multibody::SetContext<T>(plant_, x0, u0, context_0_);
   multibody::SetContext<T>(plant_, x1, u1, context_1_);
-  const auto& xdot0 = CalcTimeDerivativesWithForce(context_0_, l0);
-  const auto& xdot1 = CalcTimeDerivativesWithForce(context_1_, l1);
+  CalcTimeDerivativesWithForce(context_0_, l0, 0, &xdot0_);
+  CalcTimeDerivativesWithForce(context_1_, l1, 1, &xdot1_);
 
   // Cubic interpolation to get xcol and xdotcol.
-  const auto& xcol = 0.5 * (x0 + x1) + h / 8 * (xdot0 - xdot1);
-  const auto& xdotcol = -1.5 * (x0 - x1) / h - .25 * (xdot0 + xdot1);
+  const auto& xcol = 0.5 * (x0 + x1) + h / 8 * (xdot0_ - xdot1_);
+  const auto& xdotcol = -1.5 * (x0 - x1) / h - .25 * (xdot0_ + xdot1_);
   const auto& ucol = 0.5 * (u0 + u1);
 
-  drake::MatrixX<T> J(evaluators_.count_full(), plant_.num_velocities());
-
   // Evaluate dynamics at colocation point
   multibody::SetContext<T>(plant_, xcol, ucol, context_col_.get());
-  auto g = CalcTimeDerivativesWithForce(context_col_.get(), lc);
+  CalcTimeDerivativesWithForce(context_col_.get(), lc, 2, &g_);
 
   // Add velocity slack contribution, J^T * gamma
-  evaluators_.EvalFullJacobian(*context_col_, &J);
+  evaluators_.EvalFullKinematics(*context_col_, &points_col_, nullptr, &J_col_,
+                                 nullptr);
   VectorX<T> gamma_in_qdot_space(plant_.num_positions());
-  plant_.MapVelocityToQDot(*context_col_, J.transpose() * gamma,
+  plant_.MapVelocityToQDot(*context_col_, J_col_.transpose() * gamma,
                            &gamma_in_qdot_space);
-  g.head(plant_.num_positions()) += gamma_in_qdot_space;
+  g_.head(plant_.num_positions()) += gamma_in_qdot_space;
 
   // Add quaternion slack contribution, quat * slack
   for (uint i = 0; i < quat_start_indices_.size(); i++) {
-    g.segment(quat_start_indices_.at(i), 4) +=
+    g_.segment(quat_start_indices_.at(i), 4) +=
         xcol.segment(quat_start_indices_.at(i), 4) * quat_slack(i);
   }
 
-  *y = xdotcol - g;
+  *y = xdotcol - g_;
 }
 
 template <typename T>
-drake::VectorX<T> DirconCollocationConstraint<T>::CalcTimeDerivativesWithForce(
+void DirconCollocationConstraint<T>::CalcTimeDerivativesWithForce(
     drake::systems::Context<T>* context,
-    const drake::VectorX<T>& forces) const {
+    const Eigen::Ref<const drake::VectorX<T>>& forces, int point,
+    drake::VectorX<T>* xdot) const {
   if (cache_) {
-    return cache_->CalcTimeDerivativesWithForce(context, forces);
+    // Drake seeds the derivatives of a constraint's decision variables the
+    // same way on every evaluation, so equal values at the same point of the
+    // same constraint have equal derivatives
+    cache_->CalcTimeDerivativesWithForce(
+        context, forces, xdot,
+        reinterpret_cast<uintptr_t>(this) + static_cast<uintptr_t>(point));
   } else {
-    return evaluators_.CalcTimeDerivativesWithForce(context, forces);
+    evaluators_.CalcTimeDerivativesWithForce(context, forces, xdot);
+  }
+}
+
+AnalyticDirconCollocationConstraint::AnalyticDirconCollocationConstraint(
+    const MultibodyPlant<double>& plant,
+    const KinematicEvaluatorSet<double>& evaluators,
+    Context<double>* context_0, Context<double>* context_1, int mode_index,
+    int knot_index, DynamicsCache<double>* cache,
+    const MultibodyPlant<AutoDiffXd>* plant_ad)
+    : DirconCollocationConstraint<double>(plant, evaluators, context_0,
+                                          context_1, mode_index, knot_index,
+                                          cache),
+      owned_plant_ad_(
+          plant_ad ? nullptr
+                   : drake::systems::System<double>::ToAutoDiffXd(plant)),
+      plant_ad_(plant_ad ? *plant_ad : *owned_plant_ad_),
+      context_ad_(plant_ad_.CreateDefaultContext()),
+      B_(plant.MakeActuationMatrix()) {}
+
+/// Same decision variables as DirconCollocationConstraint::EvaluateConstraint
+bool AnalyticDirconCollocationConstraint::EvaluateConstraintWithGradient(
+    const Eigen::Ref<const VectorXd>& x, VectorXd* y, MatrixXd* dy) const {
+  const int n_q = plant_.num_positions();
+  const int n_v = plant_.num_velocities();
+  const int i_x0 = 1;
+  const int i_x1 = i_x0 + n_x_;
+  const int i_u0 = i_x1 + n_x_;
+  const int i_u1 = i_u0 + n_u_;
+  const int i_l0 = i_u1 + n_u_;
+  const int i_l1 = i_l0 + n_l_;
+  const int i_lc = i_l1 + n_l_;
+  const int i_gamma = i_lc + n_l_;
+  const int i_quat_slack = i_gamma + n_l_;
+
+  // Extract decision variables
+  const double h = x(0);
+  const VectorXd x0 = x.segment(i_x0, n_x_);
+  const VectorXd x1 = x.segment(i_x1, n_x_);
+  const VectorXd u0 = x.segment(i_u0, n_u_);
+  const VectorXd u1 = x.segment(i_u1, n_u_);
+  const VectorXd l0 = x.segment(i_l0, n_l_);
+  const VectorXd l1 = x.segment(i_l1, n_l_);
+  const VectorXd lc = x.segment(i_lc, n_l_);
+  const VectorXd gamma = x.segment(i_gamma, n_l_);
+  const VectorXd quat_slack =
+      x.segment(i_quat_slack, quat_start_indices_.size());
+
+  // Dynamics and their Jacobians (A: state, B: input, L: force) at k and k+1
+  VectorXd xdot0, xdot1;
+  MatrixXd A0, A1, B0, B1, L0, L1;
+  CalcTimeDerivativesAndGradient(x0, u0, l0, context_0_, &xdot0, &A0, &B0,
+                                 &L0);
+  CalcTimeDerivativesAndGradient(x1, u1, l1, context_1_, &xdot1, &A1, &B1,
+                                 &L1);
+
+  // Cubic interpolation to get xcol and xdotcol.
+  const VectorXd xcol = 0.5 * (x0 + x1) + h / 8 * (xdot0 - xdot1);
+  const VectorXd xdotcol = -1.5 * (x0 - x1) / h - .25 * (xdot0 + xdot1);
+  const VectorXd ucol = 0.5 * (u0 + u1);
+
+  // Dynamics at the collocation point, g, and G = dg/dxcol
+  VectorXd g;
+  MatrixXd G, Bc, Lc;
+  CalcTimeDerivativesAndGradient(xcol, ucol, lc, context_col_.get(), &g, &G,
+                                 &Bc, &Lc);
+
+  // Velocity slack contribution, N(q) J(q)^T gamma, differentiated w.r.t.
+  // (q, gamma). J^T gamma is seeded with its own derivatives, so that the
+  // product rule through N(q) is applied by AutoDiffXd.
+  MatrixXd J(n_l_, n_v);
+  evaluators_.EvalFullJacobian(*context_col_, &J);
+  MatrixXd dgamma_in_v_space(n_v, n_q + n_l_);
+  dgamma_in_v_space << CalcJacobianTransposeTimesVectorGradient(
+                           context_col_.get(), gamma),
+      J.transpose();
+  AutoDiffVecXd xcol_ad(n_x_);
+  xcol_ad << drake::math::InitializeAutoDiff(xcol.head(n_q), n_q + n_l_, 0),
+      xcol.tail(n_v).cast<AutoDiffXd>();
+  plant_ad_.SetPositionsAndVelocities(context_ad_.get(), xcol_ad);
+  AutoDiffVecXd gamma_in_qdot_space(n_q);
+  plant_ad_.MapVelocityToQDot(
+      *context_ad_,
+      drake::math::InitializeAutoDiff(J.transpose() * gamma,
+                                      dgamma_in_v_space),
+      &gamma_in_qdot_space);
+  const MatrixXd dgamma_in_qdot_space =
+      drake::math::ExtractGradient(gamma_in_qdot_space);
+  g.head(n_q) += drake::math::ExtractValue(gamma_in_qdot_space);
+  G.topLeftCorner(n_q, n_q) += dgamma_in_qdot_space.leftCols(n_q);
+
+  // Quaternion slack contribution, quat * slack
+  for (uint i = 0; i < quat_start_indices_.size(); i++) {
+    const int start = quat_start_indices_.at(i);
+    g.segment(start, 4) += xcol.segment(start, 4) * quat_slack(i);
+    G.block(start, start, 4, 4).diagonal().array() += quat_slack(i);
+  }
+
+  *y = xdotcol - g_;
+
+  // Chain rule through the interpolation. D0 and D1 are dy/dxdot0 and
+  // dy/dxdot1.
+  const MatrixXd I = MatrixXd::Identity(n_x_, n_x_);
+  const MatrixXd D0 = -0.25 * I - h / 8 * G;
+  const MatrixXd D1 = -0.25 * I + h / 8 * G;
+  dy->setZero(n_x_, this->num_vars());
+  dy->col(0) = 1.5 * (x0 - x1) / (h * h) - G * (xdot0 - xdot1) / 8;
+  dy->middleCols(i_x0, n_x_) = -1.5 / h * I - 0.5 * G + D0 * A0;
+  dy->middleCols(i_x1, n_x_) = 1.5 / h * I - 0.5 * G + D1 * A1;
+  dy->middleCols(i_u0, n_u_) = D0 * B0 - 0.5 * Bc;
+  dy->middleCols(i_u1, n_u_) = D1 * B1 - 0.5 * Bc;
+  dy->middleCols(i_l0, n_l_) = D0 * L0;
+  dy->middleCols(i_l1, n_l_) = D1 * L1;
+  dy->middleCols(i_lc, n_l_) = -Lc;
+  dy->block(0, i_gamma, n_q, n_l_) = -dgamma_in_qdot_space.rightCols(n_l_);
+  for (uint i = 0; i < quat_start_indices_.size(); i++) {
+    const int start = quat_start_indices_.at(i);
+    dy->block(start, i_quat_slack + i, 4, 1) = -xcol.segment(start, 4);
+  }
+  return true;
+}
+
+void AnalyticDirconCollocationConstraint::CalcTimeDerivativesAndGradient(
+    const VectorXd& x, const VectorXd& u, const VectorXd& lambda,
+    Context<double>* context, VectorXd* xdot, MatrixXd* dxdot_dx,
+    MatrixXd* dxdot_du, MatrixXd* dxdot_dlambda) const {
+  const int n_q = plant_.num_positions();
+  const int n_v = plant_.num_velocities();
+
+  multibody::SetContext<double>(plant_, x, u, context);
+  // The point only matters for AutoDiffXd
+  CalcTimeDerivativesWithForce(context, lambda, 0, xdot);
+
+  MatrixXd M(n_v, n_v);
+  plant_.CalcMassMatrix(*context, &M);
+  const Eigen::LLT<MatrixXd> M_llt(M);
+  MatrixXd J(n_l_, n_v);
+  evaluators_.EvalFullJacobian(*context, &J);
+
+  // Inverse dynamics, M(q) vdot + C(q, v) - tau_g(q), at the computed vdot.
+  // Derivatives are only taken w.r.t. the local state (q, v).
+  const AutoDiffVecXd x_ad = drake::math::InitializeAutoDiff(x);
+  plant_ad_.SetPositionsAndVelocities(context_ad_.get(), x_ad);
+  drake::multibody::MultibodyForces<AutoDiffXd> forces(plant_ad_);
+  plant_ad_.CalcForceElementsContribution(*context_ad_, &forces);
+  const AutoDiffVecXd inverse_dynamics = plant_ad_.CalcInverseDynamics(
+      *context_ad_, xdot->tail(n_v).cast<AutoDiffXd>(), forces);
+  MatrixXd dinverse_dynamics = drake::math::ExtractGradient(inverse_dynamics);
+  dinverse_dynamics.leftCols(n_q) -=
+      CalcJacobianTransposeTimesVectorGradient(context, lambda);
+
+  // Differentiating inverse_dynamics(q, v, vdot) = B u + J(q)^T lambda
+  dxdot_dx->resize(n_x_, n_x_);
+  dxdot_dx->bottomRows(n_v) = -M_llt.solve(dinverse_dynamics);
+  AutoDiffVecXd qdot(n_q);
+  plant_ad_.MapVelocityToQDot(*context_ad_, x_ad.tail(n_v), &qdot);
+  dxdot_dx->topRows(n_q) = drake::math::ExtractGradient(qdot);
+
+  dxdot_du->setZero(n_x_, n_u_);
+  dxdot_du->bottomRows(n_v) = M_llt.solve(B_);
+  dxdot_dlambda->setZero(n_x_, n_l_);
+  dxdot_dlambda->bottomRows(n_v) = M_llt.solve(J.transpose());
+}
+
+MatrixXd
+AnalyticDirconCollocationConstraint::CalcJacobianTransposeTimesVectorGradient(
+    Context<double>* context, const VectorXd& w) const {
+  const int n_q = plant_.num_positions();
+  const int n_v = plant_.num_velocities();
+  VectorXd q = plant_.GetPositions(*context);
+  MatrixXd J(n_l_, n_v);
+  MatrixXd dJt_w(n_v, n_q);
+  for (int i = 0; i < n_q; i++) {
+    const double q_i = q(i);
+    const double eps = 1e-6 * std::max(1.0, std::abs(q_i));
+    q(i) = q_i + eps;
+    plant_.SetPositions(context, q);
+    evaluators_.EvalFullJacobian(*context, &J);
+    dJt_w.col(i) = J.transpose() * w;
+    q(i) = q_i - eps;
+    plant_.SetPositions(context, q);
+    evaluators_.EvalFullJacobian(*context, &J);
+    dJt_w.col(i) = (dJt_w.col(i) - J.transpose() * w) / (2 * eps);
+    q(i) = q_i;
   }
+  plant_.SetPositions(context, q);
+  return dJt_w;
 }
 
 template <typename T>
@@ -177,7 +381,8 @@ CachedAccelerationConstraint<T>::CachedAccelerationConstraint(
           VectorXd::Zero(evaluators.count_active()), description),
       plant_(plant),
       evaluators_(evaluators),
-      cache_(cache) {
+      cache_(cache),
+      xdot_(plant.num_positions() + plant.num_velocities()) {
   // Create a new context if one was not provided
   if (context == nullptr) {
     owned_context_ = plant_.CreateDefaultContext();
@@ -197,10 +402,11 @@ void CachedAccelerationConstraint<T>::EvaluateConstraint(
   multibody::SetContext<T>(plant_, x, u, context_);
 
   if (cache_) {
-    const auto& xdot = cache_->CalcTimeDerivativesWithForce(context_, lambda);
+    cache_->CalcTimeDerivativesWithForce(context_, lambda, &xdot_,
+                                         reinterpret_cast<uintptr_t>(this));
     const auto& J = evaluators_.EvalActiveJacobian(*context_);
     const auto& Jdotv = evaluators_.EvalActiveJacobianDotTimesV(*context_);
-    *y = J * xdot.tail(plant_.num_velocities()) + Jdotv;
+    *y = J * xdot_.tail(plant_.num_velocities()) + Jdotv;
   } else {
     *y = evaluators_.EvalActiveSecondTimeDerivative(context_, lambda);
   }
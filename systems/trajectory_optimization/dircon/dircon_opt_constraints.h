@@ -49,10 +49,15 @@ class DirconCollocationConstraint : public solvers::NonlinearConstraint<T> {
   void EvaluateConstraint(const Eigen::Ref<const drake::VectorX<T>>& x,
                           drake::VectorX<T>* y) const override;
 
- private:
-  drake::VectorX<T> CalcTimeDerivativesWithForce(
-    drake::systems::Context<T>* context,
-    const drake::VectorX<T>& forces) const;
+ protected:
+  // xdot at `context` and `forces`, through the cache if there is one.
+  // `point` is 0 or 1 for the knot points and 2 for the collocation point;
+  // with the constraint's address, it identifies the AutoDiffXd seeding of
+  // the arguments to the cache.
+  void CalcTimeDerivativesWithForce(
+      drake::systems::Context<T>* context,
+      const Eigen::Ref<const drake::VectorX<T>>& forces, int point,
+      drake::VectorX<T>* xdot) const;
 
   const drake::multibody::MultibodyPlant<T>& plant_;
   const multibody::KinematicEvaluatorSet<T>& evaluators_;
@@ -64,6 +69,67 @@ class DirconCollocationConstraint : public solvers::NonlinearConstraint<T> {
   int n_u_;
   int n_l_;
   DynamicsCache<T>* cache_;
+  // Scratch for xdot at the knot points, the dynamics at the collocation
+  // point and the constraint Jacobian at the collocation point
+  mutable drake::VectorX<T> xdot0_;
+  mutable drake::VectorX<T> xdot1_;
+  mutable drake::VectorX<T> g_;
+  mutable drake::MatrixX<T> J_col_;
+  mutable multibody::PointKinematics<T> points_col_;
+};
+
+/// DirconCollocationConstraint with an analytic gradient, as a faster
+/// alternative to differentiating Dircon<AutoDiffXd> or finite differencing.
+/// Takes the same decision variables and evaluates to the same values.
+///
+/// At each of the two knot points and the collocation point, the Jacobian of
+///   xdot = [N(q) v; M(q)^-1 (B u + J(q)^T lambda - C(q, v) + tau_g(q))]
+/// is computed from M, B and J directly for u and lambda, and by implicitly
+/// differentiating the inverse dynamics for q and v. The inverse dynamics and
+/// N(q) are differentiated with an AutoDiffXd copy of the plant, seeded only
+/// with the local (q, v) derivatives. KinematicEvaluators cannot be converted
+/// to AutoDiffXd, so d/dq (J(q)^T lambda) is the one term that is central
+/// differenced, which only needs kinematics. The cubic interpolation is then
+/// differentiated by the chain rule.
+class AnalyticDirconCollocationConstraint
+    : public DirconCollocationConstraint<double> {
+ public:
+  /// See DirconCollocationConstraint. `plant_ad` is an AutoDiffXd copy of
+  /// `plant`, which can be shared by many constraints. If nullptr, the
+  /// constraint converts and owns one.
+  AnalyticDirconCollocationConstraint(
+      const drake::multibody::MultibodyPlant<double>& plant,
+      const multibody::KinematicEvaluatorSet<double>& evaluators,
+      drake::systems::Context<double>* context_0,
+      drake::systems::Context<double>* context_1,
+      int mode_index, int knot_index,
+      DynamicsCache<double>* cache = nullptr,
+      const drake::multibody::MultibodyPlant<drake::AutoDiffXd>* plant_ad =
+          nullptr);
+
+  bool EvaluateConstraintWithGradient(
+      const Eigen::Ref<const Eigen::VectorXd>& x, Eigen::VectorXd* y,
+      Eigen::MatrixXd* dy) const override;
+
+ private:
+  // xdot(x, u, lambda) and its Jacobians, evaluated with `context`
+  void CalcTimeDerivativesAndGradient(
+      const Eigen::VectorXd& x, const Eigen::VectorXd& u,
+      const Eigen::VectorXd& lambda, drake::systems::Context<double>* context,
+      Eigen::VectorXd* xdot, Eigen::MatrixXd* dxdot_dx,
+      Eigen::MatrixXd* dxdot_du, Eigen::MatrixXd* dxdot_dlambda) const;
+
+  // d/dq (J(q)^T w), by central differences of the Jacobian. Leaves the
+  // positions of `context` unchanged.
+  Eigen::MatrixXd CalcJacobianTransposeTimesVectorGradient(
+      drake::systems::Context<double>* context,
+      const Eigen::VectorXd& w) const;
+
+  std::unique_ptr<drake::multibody::MultibodyPlant<drake::AutoDiffXd>>
+      owned_plant_ad_;
+  const drake::multibody::MultibodyPlant<drake::AutoDiffXd>& plant_ad_;
+  std::unique_ptr<drake::systems::Context<drake::AutoDiffXd>> context_ad_;
+  const Eigen::MatrixXd B_;
 };
 
 /// Implements the impact constraint used by Dircon on mode transitions
@@ -124,6 +190,8 @@ class CachedAccelerationConstraint : public solvers::NonlinearConstraint<T> {
   drake::systems::Context<T>* context_;
   std::unique_ptr<drake::systems::Context<T>> owned_context_;
   DynamicsCache<T>* cache_;
+  // Scratch for xdot
+  mutable drake::VectorX<T> xdot_;
 };
 
 
@@ -1,96 +1,204 @@
 #include "systems/trajectory_optimization/dircon/dynamics_cache.h"
 
-#include "drake/math/autodiff_gradient.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <type_traits>
 
 namespace dairlib {
 namespace systems {
 namespace trajectory_optimization {
 
-using drake::AutoDiffXd;
 using drake::AutoDiffVecXd;
+using drake::AutoDiffXd;
+using drake::VectorX;
+using Eigen::Ref;
+
+namespace {
+
+// Number of slots a key can be stored in, starting at its hash
+constexpr int kProbeWindow = 8;
+
+typedef std::chrono::steady_clock Clock;
+
+double Seconds(Clock::duration duration) {
+  return std::chrono::duration<double>(duration).count();
+}
+
+double ValueOf(double v) { return v; }
+double ValueOf(const AutoDiffXd& v) { return v.value(); }
+
+// splitmix64 finalizer
+uint64_t Mix(uint64_t h) {
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return h;
+}
 
-inline void hash_combine(std::size_t& seed, const double& v) {
-    seed ^= std::hash<double>{}(v) + 0x9e3779b9 + (seed<<6) + (seed>>2);
+// Hash of the values (not the derivatives) of v
+template <typename T>
+void HashValues(const Ref<const VectorX<T>>& v, uint64_t* seed) {
+  for (int i = 0; i < v.size(); i++) {
+    const double value = ValueOf(v(i));
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    *seed = Mix(*seed ^ (bits + 0x9e3779b97f4a7c15ULL));
+  }
 }
 
-inline void hash_combine(std::size_t& seed,
-    const Eigen::Ref<const Eigen::VectorXd>& v) {
+// Compares the segment of a slot's key starting at `start` to v
+template <typename T>
+bool ValuesEqual(const Eigen::VectorXd& key, int start,
+                 const Ref<const VectorX<T>>& v) {
   for (int i = 0; i < v.size(); i++) {
-    hash_combine(seed, v(i)); 
+    if (key(start + i) != ValueOf(v(i))) return false;
   }
+  return true;
 }
 
-inline void hash_combine(std::size_t& seed,
-    const Eigen::Ref<const AutoDiffVecXd>& v) {
+int NumDerivatives(const Ref<const VectorX<double>>&) { return 0; }
+
+int NumDerivatives(const Ref<const AutoDiffVecXd>& v) {
+  int num_derivatives = 0;
   for (int i = 0; i < v.size(); i++) {
-    hash_combine(seed, v(i).value());
-    hash_combine(seed, v(i).derivatives());
+    num_derivatives = std::max<int>(num_derivatives,
+                                    v.data()[i].derivatives().size());
   }
+  return num_derivatives;
+}
+
+// Entries of double are shared by all callers
+template <typename T>
+uint64_t EffectiveSeedId(uint64_t seed_id) {
+  return std::is_same_v<T, double> ? 0 : seed_id;
 }
 
+}  // namespace
+
 template <typename T>
 DynamicsCache<T>::DynamicsCache(
     const multibody::KinematicEvaluatorSet<T>& evaluators, int max_size)
-  : evaluators_(evaluators),
-    max_size_(max_size) {}
+    : evaluators_(evaluators) {
+  // At most half full
+  int capacity = kProbeWindow;
+  while (capacity < 2 * max_size) {
+    capacity *= 2;
+  }
+  slots_.resize(capacity);
+  mask_ = capacity - 1;
+  const auto& plant = evaluators_.plant();
+  const int key_size = plant.num_positions() + plant.num_velocities() +
+                       plant.num_actuators() + evaluators_.count_full();
+  for (auto& slot : slots_) {
+    slot.key.resize(key_size);
+    slot.xdot.resize(plant.num_positions() + plant.num_velocities());
+  }
+}
 
 template <typename T>
-drake::VectorX<T> DynamicsCache<T>::CalcTimeDerivativesWithForce(
-    drake::systems::Context<T>* context,
-    const drake::VectorX<T>& forces) {
-  CacheKey<T> key{evaluators_.plant().GetPositionsAndVelocities(*context), 
-                  evaluators_.plant().get_actuation_input_port().Eval(*context),
-                  forces};
-  auto it = map_.find(key);
-  if (it == map_.end()) {
-    auto xdot = evaluators_.CalcTimeDerivativesWithForce(context, forces);
-    map_[key] = xdot;
-
-    // Add to the queue_
-    if (map_.size() >= max_size_) {
-      map_.erase(queue_.front());
-      queue_.pop_front();
+int DynamicsCache<T>::Find(uint64_t hash, uint64_t seed_id,
+                           int num_derivatives,
+                           const Ref<const VectorX<T>>& state,
+                           const Ref<const VectorX<T>>& input,
+                           const Ref<const VectorX<T>>& forces) const {
+  const int u_start = state.size();
+  const int l_start = u_start + input.size();
+  for (int k = 0; k < kProbeWindow; k++) {
+    const Slot& slot = slots_[(hash + k) & mask_];
+    if (slot.occupied && slot.hash == hash && slot.seed_id == seed_id &&
+        slot.num_derivatives == num_derivatives &&
+        ValuesEqual<T>(slot.key, 0, state) &&
+        ValuesEqual<T>(slot.key, u_start, input) &&
+        ValuesEqual<T>(slot.key, l_start, forces)) {
+      return (hash + k) & mask_;
     }
-    queue_.push_back(key);
-    return xdot;
-  } else {
-    return it->second;
   }
+  return -1;
 }
 
-bool AreVectorsEqual(const Eigen::Ref<const AutoDiffVecXd>& a,
-                     const Eigen::Ref<const AutoDiffVecXd>& b) {
-  if (a.value() != b.value()) {
-    return false;
+template <typename T>
+int DynamicsCache<T>::FindSlotToReplace(uint64_t hash) const {
+  int oldest = -1;
+  for (int k = 0; k < kProbeWindow; k++) {
+    const int i = (hash + k) & mask_;
+    if (!slots_[i].occupied) return i;
+    if (oldest < 0 || slots_[i].stamp < slots_[oldest].stamp) {
+      oldest = i;
+    }
   }
-  const Eigen::MatrixXd& a_gradient = drake::math::ExtractGradient(a);
-  const Eigen::MatrixXd& b_gradient = drake::math::ExtractGradient(b);
-
-  return a_gradient == b_gradient;
+  return oldest;
 }
 
 template <typename T>
-std::size_t CacheHasher<T>::operator()(const CacheKey<T>& key) const {
-  std::size_t seed = 0;
-  hash_combine(seed, key.state);
-  hash_combine(seed, key.input);
-  hash_combine(seed, key.forces);
-  return seed;
+void DynamicsCache<T>::CalcTimeDerivativesWithForce(
+    drake::systems::Context<T>* context, const Ref<const VectorX<T>>& forces,
+    VectorX<T>* xdot, uint64_t seed_id) {
+  const auto lookup_start = Clock::now();
+  const auto& plant = evaluators_.plant();
+  const auto& state = plant.GetPositionsAndVelocities(*context);
+  const auto& input = plant.get_actuation_input_port().Eval(*context);
+  seed_id = EffectiveSeedId<T>(seed_id);
+  const int num_derivatives = std::max(
+      {NumDerivatives(state), NumDerivatives(input), NumDerivatives(forces)});
+  uint64_t hash = Mix(seed_id);
+  HashValues<T>(state, &hash);
+  HashValues<T>(input, &hash);
+  HashValues<T>(forces, &hash);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int i = Find(hash, seed_id, num_derivatives, state, input, forces);
+    if (i >= 0) {
+      *xdot = slots_[i].xdot;
+      statistics_.hits++;
+      statistics_.lookup_time += Seconds(Clock::now() - lookup_start);
+      return;
+    }
+  }
+
+  const auto compute_start = Clock::now();
+  evaluators_.CalcTimeDerivativesWithForce(context, forces, xdot);
+  const auto compute_end = Clock::now();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  statistics_.misses++;
+  statistics_.compute_time += Seconds(compute_end - compute_start);
+  // Another thread may have added the same key in the meantime
+  if (Find(hash, seed_id, num_derivatives, state, input, forces) < 0) {
+    Slot& slot = slots_[FindSlotToReplace(hash)];
+    const int u_start = state.size();
+    const int l_start = u_start + input.size();
+    slot.occupied = true;
+    slot.hash = hash;
+    slot.seed_id = seed_id;
+    slot.num_derivatives = num_derivatives;
+    slot.stamp = num_inserted_++;
+    for (int i = 0; i < state.size(); i++) slot.key(i) = ValueOf(state(i));
+    for (int i = 0; i < input.size(); i++) {
+      slot.key(u_start + i) = ValueOf(input(i));
+    }
+    for (int i = 0; i < forces.size(); i++) {
+      slot.key(l_start + i) = ValueOf(forces(i));
+    }
+    slot.xdot = *xdot;
+  }
+  statistics_.lookup_time += Seconds(Clock::now() - lookup_start) -
+                             Seconds(compute_end - compute_start);
 }
 
-template <>
-bool CacheComparer<double>::operator()(const CacheKey<double>& a,
-    const CacheKey<double>& b) const {
-  return (a.state == b.state) && (a.forces == b.forces) &&
-      (a.input == b.input);
+template <typename T>
+typename DynamicsCache<T>::Statistics DynamicsCache<T>::GetStatistics()
+    const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
 }
 
-template <>
-bool CacheComparer<AutoDiffXd>::operator()(const CacheKey<AutoDiffXd>& a,
-    const CacheKey<AutoDiffXd>& b) const {
-  return AreVectorsEqual(a.state, b.state) &&
-         AreVectorsEqual(a.input, b.input) &&
-        AreVectorsEqual(a.forces, b.forces);
+template <typename T>
+void DynamicsCache<T>::ResetStatistics() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  statistics_ = Statistics();
 }
 
 }  // namespace trajectory_optimization
@@ -1,6 +1,8 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
+#include <mutex>
+#include <vector>
 
 #include "multibody/kinematic/kinematic_evaluator_set.h"
 
@@ -8,44 +10,84 @@ namespace dairlib {
 namespace systems {
 namespace trajectory_optimization {
 
+/// Cache of constrained dynamics evaluations, xdot(x, u, lambda), shared by
+/// the constraints of a mode.
+///
+/// The entries live in a fixed-capacity, open-addressing table that is
+/// allocated up front. Entries are keyed on the values of (x, u, lambda).
+/// For AutoDiffXd, the derivatives are not compared; instead, the caller
+/// passes a seed id that identifies how the derivatives were seeded (e.g. the
+/// constraint and the segment of its decision variables), and entries only
+/// match within the same seed id and number of derivatives. A key is probed
+/// in a short window of slots; when the window is full, its oldest entry is
+/// replaced. For double, hits and inserts (once a slot has been used) do not
+/// allocate.
+///
+/// Safe to use from several threads (each with its own context). The
+/// dynamics are computed outside of the lock.
 template <typename T>
-struct CacheKey {
-  const drake::VectorX<T> state;
-  const drake::VectorX<T> input;
-  const drake::VectorX<T> forces;
-};
-
-// == operation for two CacheKeys
-template <typename T>
-class CacheComparer {
+class DynamicsCache {
  public:
-  bool operator()(const CacheKey<T>& a, const CacheKey<T>& b) const;
-};
+  /// Hit/miss counters and the time spent in lookups vs. in computing the
+  /// dynamics on misses, to check that the cache pays off
+  struct Statistics {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    double lookup_time = 0;   // [s], including hashing and copying
+    double compute_time = 0;  // [s], dynamics evaluations on misses
 
-// Hashes a CacheKey by bit shifting and combining hashes of the double
-// elements
-template <typename T>
-class CacheHasher {
- public:
-  std::size_t operator()(const CacheKey<T>& key) const;
-};
+    double hit_rate() const {
+      return (hits + misses) > 0 ? static_cast<double>(hits) / (hits + misses)
+                                 : 0;
+    }
+  };
 
-template <typename T>
-class DynamicsCache {
- public:
+  /// @param max_size number of entries the cache can hold
   DynamicsCache(const multibody::KinematicEvaluatorSet<T>& constraints,
       int max_size);
 
-  drake::VectorX<T> CalcTimeDerivativesWithForce(
+  /// Computes xdot at the state and input of `context` and the constraint
+  /// forces, or returns the cached value.
+  /// @param seed_id For AutoDiffXd, two calls with the same seed_id and equal
+  /// values must have equal derivatives. Ignored for double, where any
+  /// caller may hit the entry of another.
+  void CalcTimeDerivativesWithForce(
       drake::systems::Context<T>* context,
-      const drake::VectorX<T>& forces);
+      const Eigen::Ref<const drake::VectorX<T>>& forces,
+      drake::VectorX<T>* xdot, uint64_t seed_id = 0);
+
+  Statistics GetStatistics() const;
+  void ResetStatistics();
 
  private:
+  struct Slot {
+    bool occupied = false;
+    uint64_t hash = 0;
+    // AutoDiffXd only: the caller's seed id and number of derivatives
+    uint64_t seed_id = 0;
+    int num_derivatives = 0;
+    // Insertion order, to replace the oldest entry of a full probe window
+    int64_t stamp = 0;
+    // Values of [x; u; lambda]
+    Eigen::VectorXd key;
+    drake::VectorX<T> xdot;
+  };
+
+  // Index of the slot holding the key, or -1
+  int Find(uint64_t hash, uint64_t seed_id, int num_derivatives,
+           const Eigen::Ref<const drake::VectorX<T>>& state,
+           const Eigen::Ref<const drake::VectorX<T>>& input,
+           const Eigen::Ref<const drake::VectorX<T>>& forces) const;
+  // Slot to (over)write for the given hash
+  int FindSlotToReplace(uint64_t hash) const;
+
   const multibody::KinematicEvaluatorSet<T>& evaluators_;
-  size_t max_size_;
-  std::unordered_map<CacheKey<T>, drake::VectorX<T>, CacheHasher<T>,
-      CacheComparer<T>> map_;
-  std::list<CacheKey<T>> queue_;
+  std::vector<Slot> slots_;
+  // slots_.size() - 1, with slots_.size() a power of two
+  uint64_t mask_;
+  int64_t num_inserted_ = 0;
+  Statistics statistics_;
+  mutable std::mutex mutex_;
 };
 
 }  // namespace trajectory_optimization
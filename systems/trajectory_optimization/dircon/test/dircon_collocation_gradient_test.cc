@@ -0,0 +1,219 @@
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "common/find_resource.h"
+#include "multibody/kinematic/distance_evaluator.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "systems/trajectory_optimization/dircon/dircon.h"
+#include "systems/trajectory_optimization/dircon/dircon_opt_constraints.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+#include "drake/multibody/parsing/parser.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::AutoDiffVecXd;
+using drake::AutoDiffXd;
+using drake::CompareMatrices;
+using drake::multibody::MultibodyPlant;
+using drake::multibody::Parser;
+using drake::solvers::Binding;
+using drake::solvers::Constraint;
+using drake::systems::Context;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+
+/// The constrained pendulum of passive_constrained_pendulum_dircon: a floating
+/// acrobot, pinned to the world at its base, with a distance constraint
+/// between the base and the lower link. Built for double and AutoDiffXd.
+template <typename T>
+class ConstrainedPendulum {
+ public:
+  explicit ConstrainedPendulum(const MultibodyPlant<T>& plant)
+      : distance_eval_(plant, Vector3d::Zero(),
+                       plant.GetFrameByName("base_link"), Vector3d(-1, 0, 0),
+                       plant.GetFrameByName("lower_link"), 0.7),
+        pin_eval_(plant, Vector3d::Zero(), plant.GetFrameByName("base_link")),
+        evaluators_(plant),
+        context_0_(plant.CreateDefaultContext()),
+        context_1_(plant.CreateDefaultContext()) {
+    evaluators_.add_evaluator(&distance_eval_);
+    evaluators_.add_evaluator(&pin_eval_);
+  }
+
+  const multibody::KinematicEvaluatorSet<T>& evaluators() const {
+    return evaluators_;
+  }
+  Context<T>* context_0() { return context_0_.get(); }
+  Context<T>* context_1() { return context_1_.get(); }
+
+ private:
+  multibody::DistanceEvaluator<T> distance_eval_;
+  multibody::WorldPointEvaluator<T> pin_eval_;
+  multibody::KinematicEvaluatorSet<T> evaluators_;
+  std::unique_ptr<Context<T>> context_0_;
+  std::unique_ptr<Context<T>> context_1_;
+};
+
+class DirconCollocationGradientTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Parser parser(&plant_);
+    parser.AddModelFromFile(FindResourceOrThrow(
+        "systems/trajectory_optimization/dircon/test/acrobot_floating.urdf"));
+    plant_.Finalize();
+    plant_ad_ = drake::systems::System<double>::ToAutoDiffXd(plant_);
+    pendulum_ = std::make_unique<ConstrainedPendulum<double>>(plant_);
+    pendulum_ad_ = std::make_unique<ConstrainedPendulum<AutoDiffXd>>(*plant_ad_);
+  }
+
+  // A random point with a positive timestep and unit quaternions
+  VectorXd RandomDecisionVariables(int num_vars) const {
+    const int n_q = plant_.num_positions();
+    const int n_x = n_q + plant_.num_velocities();
+    VectorXd vars = VectorXd::Random(num_vars);
+    vars(0) = 0.1;
+    vars.segment(1, 4).normalize();
+    vars.segment(1 + n_x, 4).normalize();
+    return vars;
+  }
+
+  MultibodyPlant<double> plant_{0.0};
+  std::unique_ptr<MultibodyPlant<AutoDiffXd>> plant_ad_;
+  std::unique_ptr<ConstrainedPendulum<double>> pendulum_;
+  std::unique_ptr<ConstrainedPendulum<AutoDiffXd>> pendulum_ad_;
+};
+
+TEST_F(DirconCollocationGradientTest, MatchesAutoDiff) {
+  DirconCollocationConstraint<AutoDiffXd> autodiff_constraint(
+      *plant_ad_, pendulum_ad_->evaluators(), pendulum_ad_->context_0(),
+      pendulum_ad_->context_1(), 0, 0);
+  AnalyticDirconCollocationConstraint analytic_constraint(
+      plant_, pendulum_->evaluators(), pendulum_->context_0(),
+      pendulum_->context_1(), 0, 0, nullptr, plant_ad_.get());
+  ASSERT_EQ(analytic_constraint.num_vars(), autodiff_constraint.num_vars());
+
+  std::srand(0);
+  for (int i = 0; i < 5; i++) {
+    const VectorXd vars =
+        RandomDecisionVariables(analytic_constraint.num_vars());
+    AutoDiffVecXd y_autodiff;
+    AutoDiffVecXd y_analytic;
+    autodiff_constraint.Eval(drake::math::InitializeAutoDiff(vars),
+                             &y_autodiff);
+    analytic_constraint.Eval(drake::math::InitializeAutoDiff(vars),
+                             &y_analytic);
+
+    EXPECT_TRUE(CompareMatrices(drake::math::ExtractValue(y_analytic),
+                                drake::math::ExtractValue(y_autodiff), 1e-10));
+    EXPECT_TRUE(CompareMatrices(drake::math::ExtractGradient(y_analytic),
+                                drake::math::ExtractGradient(y_autodiff),
+                                1e-6));
+  }
+}
+
+TEST_F(DirconCollocationGradientTest, OwnsAutoDiffPlant) {
+  AnalyticDirconCollocationConstraint owning_constraint(
+      plant_, pendulum_->evaluators(), pendulum_->context_0(),
+      pendulum_->context_1(), 0, 0);
+  AnalyticDirconCollocationConstraint sharing_constraint(
+      plant_, pendulum_->evaluators(), pendulum_->context_0(),
+      pendulum_->context_1(), 0, 0, nullptr, plant_ad_.get());
+
+  std::srand(1);
+  const VectorXd vars = RandomDecisionVariables(owning_constraint.num_vars());
+  AutoDiffVecXd y_owning;
+  AutoDiffVecXd y_sharing;
+  owning_constraint.Eval(drake::math::InitializeAutoDiff(vars), &y_owning);
+  sharing_constraint.Eval(drake::math::InitializeAutoDiff(vars), &y_sharing);
+  EXPECT_TRUE(CompareMatrices(drake::math::ExtractGradient(y_owning),
+                              drake::math::ExtractGradient(y_sharing)));
+
+  // The double evaluation is unchanged from DirconCollocationConstraint
+  DirconCollocationConstraint<double> constraint(
+      plant_, pendulum_->evaluators(), pendulum_->context_0(),
+      pendulum_->context_1(), 0, 0);
+  VectorXd y;
+  VectorXd y_analytic;
+  constraint.Eval(vars, &y);
+  owning_constraint.Eval(vars, &y_analytic);
+  EXPECT_TRUE(CompareMatrices(y_analytic, y));
+}
+
+// Dircon<double> with SetAnalyticDynamicsGradients() builds its collocation
+// constraints from AnalyticDirconCollocationConstraint, going through the
+// shared dynamics cache, and its gradients match Dircon<AutoDiffXd>
+TEST_F(DirconCollocationGradientTest, UsedByDircon) {
+  DirconMode<double> mode(pendulum_->evaluators(), 5, 1, 3);
+  mode.SetAnalyticDynamicsGradients(true);
+  DirconModeSequence<double> sequence(plant_);
+  sequence.AddMode(&mode);
+  Dircon<double> trajopt(sequence);
+
+  DirconMode<AutoDiffXd> mode_ad(pendulum_ad_->evaluators(), 5, 1, 3);
+  DirconModeSequence<AutoDiffXd> sequence_ad(*plant_ad_);
+  sequence_ad.AddMode(&mode_ad);
+  Dircon<AutoDiffXd> trajopt_ad(sequence_ad);
+
+  std::vector<Binding<Constraint>> analytic_bindings;
+  for (const auto& binding : trajopt.prog().generic_constraints()) {
+    if (std::dynamic_pointer_cast<DirconCollocationConstraint<double>>(
+            binding.evaluator())) {
+      EXPECT_NE(std::dynamic_pointer_cast<AnalyticDirconCollocationConstraint>(
+                    binding.evaluator()),
+                nullptr);
+      analytic_bindings.push_back(binding);
+    }
+  }
+  std::vector<Binding<Constraint>> autodiff_bindings;
+  for (const auto& binding : trajopt_ad.prog().generic_constraints()) {
+    if (std::dynamic_pointer_cast<DirconCollocationConstraint<AutoDiffXd>>(
+            binding.evaluator())) {
+      autodiff_bindings.push_back(binding);
+    }
+  }
+  ASSERT_EQ(analytic_bindings.size(), mode.num_knotpoints() - 1u);
+  ASSERT_EQ(analytic_bindings.size(), autodiff_bindings.size());
+  ASSERT_EQ(trajopt.prog().num_vars(), trajopt_ad.prog().num_vars());
+
+  // Both programs create their decision variables in the same order
+  std::srand(2);
+  VectorXd x = VectorXd::Random(trajopt.prog().num_vars());
+  for (int j = 0; j < mode.num_knotpoints(); j++) {
+    trajopt.prog().SetDecisionVariableValueInVector(
+        trajopt.state_vars(0, j).head(4),
+        Eigen::Vector4d::Random().normalized(), &x);
+  }
+  trajopt.prog().SetDecisionVariableValueInVector(
+      trajopt.h_vars(), VectorXd::Constant(trajopt.h_vars().size(), 0.1), &x);
+  const AutoDiffVecXd x_ad = drake::math::InitializeAutoDiff(x);
+  // Twice, so that the second pass is served from the cache
+  for (int pass = 0; pass < 2; pass++) {
+    for (size_t i = 0; i < analytic_bindings.size(); i++) {
+      const AutoDiffVecXd y_analytic =
+          trajopt.prog().EvalBinding(analytic_bindings[i], x_ad);
+      const AutoDiffVecXd y_autodiff =
+          trajopt_ad.prog().EvalBinding(autodiff_bindings[i], x_ad);
+      EXPECT_TRUE(CompareMatrices(drake::math::ExtractValue(y_analytic),
+                                  drake::math::ExtractValue(y_autodiff),
+                                  1e-10));
+      EXPECT_TRUE(CompareMatrices(drake::math::ExtractGradient(y_analytic),
+                                  drake::math::ExtractGradient(y_autodiff),
+                                  1e-6));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
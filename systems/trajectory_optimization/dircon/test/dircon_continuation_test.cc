@@ -0,0 +1,237 @@
+#include "systems/trajectory_optimization/dircon/dircon_continuation.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "common/find_resource.h"
+#include "multibody/kinematic/distance_evaluator.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+
+#include "drake/common/never_destroyed.h"
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/multibody/parsing/parser.h"
+#include "drake/solvers/solver_base.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::CompareMatrices;
+using drake::multibody::MultibodyPlant;
+using drake::multibody::Parser;
+using drake::solvers::MathematicalProgram;
+using drake::solvers::MathematicalProgramResult;
+using drake::solvers::SolverId;
+using drake::solvers::SolverOptions;
+using Eigen::Vector2d;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+
+std::string TempFile() {
+  const char* dir = std::getenv("TEST_TMPDIR");
+  return std::string(dir ? dir : "/tmp") + "/gait_library_index.csv";
+}
+
+GaitLibraryEntry Entry(double speed, double stride, const std::string& path) {
+  GaitLibraryEntry entry;
+  entry.parameters = Vector2d(speed, stride);
+  entry.filepath = path;
+  entry.solution_result = drake::solvers::SolutionResult::kSolutionFound;
+  return entry;
+}
+
+TEST(DirconContinuationTest, LibraryIndexRoundTrip) {
+  std::vector<GaitLibraryEntry> entries = {
+      Entry(0.1, 0.2, "walking_0"), Entry(0.5, 0.3, "walking_1"),
+      Entry(1.0 / 3, 0.25, "walking_2")};
+  // Unsolved entries are left out of the index
+  entries.push_back(Entry(1.5, 0.4, ""));
+  entries.back().solution_result =
+      drake::solvers::SolutionResult::kIterationLimit;
+
+  WriteGaitLibraryIndex(TempFile(), {"speed", "stride"}, entries);
+  const auto loaded = LoadGaitLibraryIndex(TempFile());
+  ASSERT_EQ(loaded.size(), 3u);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_TRUE(CompareMatrices(loaded[i].parameters, entries[i].parameters));
+    EXPECT_EQ(loaded[i].filepath, entries[i].filepath);
+  }
+}
+
+TEST(DirconContinuationTest, NearestEntry) {
+  const std::vector<GaitLibraryEntry> entries = {
+      Entry(0.1, 0.2, "walking_0"), Entry(0.5, 0.3, "walking_1"),
+      Entry(0.9, 0.35, "walking_2")};
+  EXPECT_EQ(FindNearestGaitLibraryEntry(entries, Vector2d(0.6, 0.3)), 1);
+  EXPECT_EQ(FindNearestGaitLibraryEntry(entries, Vector2d(2, 0.3)), 2);
+  EXPECT_EQ(FindNearestGaitLibraryEntry({}, Vector2d(2, 0.3)), -1);
+}
+
+TEST(DirconContinuationTest, NearestEntryIsScaled) {
+  const std::vector<GaitLibraryEntry> entries = {
+      Entry(0.1, 0.2, "walking_0"), Entry(0.5, 0.3, "walking_1")};
+  // Unscaled, the speed difference dominates
+  EXPECT_EQ(FindNearestGaitLibraryEntry(entries, Vector2d(0.4, 0.2)), 1);
+  // On a stride scale of 0.01, the stride difference dominates
+  EXPECT_EQ(FindNearestGaitLibraryEntry(entries, Vector2d(0.4, 0.2),
+                                        Vector2d(1, 0.01)),
+            0);
+  EXPECT_EQ(FindNearestGaitLibraryEntry(entries, Vector2d(0.4, 0.2),
+                                        Vector2d::Ones()),
+            1);
+}
+
+/// Returns the initial guess plus one as the solution, and its first entry
+/// as the cost, so that a solution records how many solves seeded it
+class ChainSolver final : public drake::solvers::SolverBase {
+ public:
+  ChainSolver()
+      : SolverBase(&id, &is_available, &is_enabled,
+                   &ProgramAttributesSatisfied) {}
+
+  static SolverId id() {
+    static const drake::never_destroyed<SolverId> singleton{"chain"};
+    return singleton.access();
+  }
+  static bool is_available() { return true; }
+  static bool is_enabled() { return true; }
+  static bool ProgramAttributesSatisfied(const MathematicalProgram&) {
+    return true;
+  }
+
+ private:
+  void DoSolve(const MathematicalProgram&, const VectorXd& initial_guess,
+               const SolverOptions&,
+               MathematicalProgramResult* result) const final {
+    VectorXd x = initial_guess;
+    for (int i = 0; i < x.size(); i++) {
+      x(i) = (std::isnan(x(i)) ? 0 : x(i)) + 1;
+    }
+    result->set_x_val(x);
+    result->set_optimal_cost(x(0));
+    result->set_solution_result(
+        drake::solvers::SolutionResult::kSolutionFound);
+  }
+};
+
+/// The passive constrained pendulum of passive_constrained_pendulum_dircon,
+/// to build the problems of SolveDirconContinuation
+class DirconContinuationSolveTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Parser parser(&plant_);
+    parser.AddModelFromFile(FindResourceOrThrow(
+        "systems/trajectory_optimization/dircon/test/acrobot_floating.urdf"));
+    plant_.Finalize();
+    distance_eval_ = std::make_unique<multibody::DistanceEvaluator<double>>(
+        plant_, Vector3d::Zero(), plant_.GetFrameByName("base_link"),
+        Vector3d(-1, 0, 0), plant_.GetFrameByName("lower_link"), 0.7);
+    pin_eval_ = std::make_unique<multibody::WorldPointEvaluator<double>>(
+        plant_, Vector3d::Zero(), plant_.GetFrameByName("base_link"));
+    evaluators_ =
+        std::make_unique<multibody::KinematicEvaluatorSet<double>>(plant_);
+    evaluators_->add_evaluator(distance_eval_.get());
+    evaluators_->add_evaluator(pin_eval_.get());
+    mode_ = std::make_unique<DirconMode<double>>(*evaluators_, 3, 1, 1);
+    sequence_ = std::make_unique<DirconModeSequence<double>>(plant_);
+    sequence_->AddMode(mode_.get());
+  }
+
+  // Problems are cold started from all zeros, and record the order in which
+  // they are built
+  std::vector<GaitLibraryEntry> Solve(const std::vector<VectorXd>& grid,
+                                      const DirconContinuationOptions& options,
+                                      std::vector<VectorXd>* order) {
+    auto build_problem = [&](const VectorXd& parameters) {
+      order->push_back(parameters);
+      auto trajopt = std::make_unique<Dircon<double>>(*sequence_);
+      trajopt->prog().SetInitialGuessForAllVariables(
+          VectorXd::Zero(trajopt->prog().num_vars()));
+      return trajopt;
+    };
+    return SolveDirconContinuation(plant_, grid, build_problem, ChainSolver(),
+                                   options);
+  }
+
+  MultibodyPlant<double> plant_{0.0};
+  std::unique_ptr<multibody::DistanceEvaluator<double>> distance_eval_;
+  std::unique_ptr<multibody::WorldPointEvaluator<double>> pin_eval_;
+  std::unique_ptr<multibody::KinematicEvaluatorSet<double>> evaluators_;
+  std::unique_ptr<DirconMode<double>> mode_;
+  std::unique_ptr<DirconModeSequence<double>> sequence_;
+};
+
+TEST_F(DirconContinuationSolveTest, SolvesNearestFirst) {
+  const std::vector<VectorXd> grid = {
+      VectorXd::Constant(1, 0.0), VectorXd::Constant(1, 0.3),
+      VectorXd::Constant(1, 0.1), VectorXd::Constant(1, 0.2),
+      VectorXd::Constant(1, 1.0)};
+  DirconContinuationOptions options;
+  std::vector<VectorXd> order;
+  const auto entries = Solve(grid, options, &order);
+
+  // 0.0 (cold), then each point seeded from its solved neighbor
+  const std::vector<int> expected_order = {0, 2, 3, 1, 4};
+  const std::vector<int> expected_seeds = {-1, 3, 0, 2, 1};
+  ASSERT_EQ(order.size(), grid.size());
+  ASSERT_EQ(entries.size(), grid.size());
+  for (int k = 0; k < static_cast<int>(grid.size()); k++) {
+    EXPECT_TRUE(CompareMatrices(order[k], grid[expected_order[k]]));
+    const auto& entry = entries[expected_order[k]];
+    EXPECT_TRUE(CompareMatrices(entry.parameters, grid[expected_order[k]]));
+    EXPECT_EQ(entry.seed_index, expected_seeds[expected_order[k]]);
+    EXPECT_TRUE(entry.is_success());
+    // Each solve adds one to the solution it was seeded with
+    EXPECT_EQ(entry.cost, k + 1);
+  }
+}
+
+TEST_F(DirconContinuationSolveTest, UsesParameterScale) {
+  // From (0, 0), (0.8, 0) is nearer unscaled and (0, 1) on a scale of
+  // (0.1, 1)
+  const std::vector<VectorXd> grid = {Vector2d(0, 0), Vector2d(0, 1),
+                                      Vector2d(0.8, 0)};
+  DirconContinuationOptions options;
+  std::vector<VectorXd> order;
+  Solve(grid, options, &order);
+  ASSERT_EQ(order.size(), 3u);
+  EXPECT_TRUE(CompareMatrices(order[1], grid[2]));
+  EXPECT_TRUE(CompareMatrices(order[2], grid[1]));
+
+  options.parameter_scale = Vector2d(0.1, 1);
+  order.clear();
+  const auto entries = Solve(grid, options, &order);
+  ASSERT_EQ(order.size(), 3u);
+  EXPECT_TRUE(CompareMatrices(order[1], grid[1]));
+  EXPECT_TRUE(CompareMatrices(order[2], grid[2]));
+  EXPECT_EQ(entries[1].seed_index, 0);
+  EXPECT_EQ(entries[2].seed_index, 0);
+}
+
+TEST_F(DirconContinuationSolveTest, StartIndex) {
+  const std::vector<VectorXd> grid = {VectorXd::Constant(1, 0.0),
+                                      VectorXd::Constant(1, 0.5),
+                                      VectorXd::Constant(1, 1.0)};
+  DirconContinuationOptions options;
+  options.start_index = 2;
+  std::vector<VectorXd> order;
+  const auto entries = Solve(grid, options, &order);
+  ASSERT_EQ(order.size(), 3u);
+  EXPECT_TRUE(CompareMatrices(order[0], grid[2]));
+  EXPECT_TRUE(CompareMatrices(order[1], grid[1]));
+  EXPECT_TRUE(CompareMatrices(order[2], grid[0]));
+  EXPECT_EQ(entries[2].seed_index, -1);
+  EXPECT_EQ(entries[1].seed_index, 2);
+  EXPECT_EQ(entries[0].seed_index, 1);
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
@@ -0,0 +1,163 @@
+#include "systems/trajectory_optimization/dircon/dircon_multi_start.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "common/find_resource.h"
+#include "lcm/dircon_saved_trajectory.h"
+#include "multibody/kinematic/distance_evaluator.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "multibody/multibody_utils.h"
+
+#include "drake/multibody/parsing/parser.h"
+#include "drake/solvers/ipopt_solver.h"
+#include "drake/solvers/snopt_solver.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::multibody::MultibodyPlant;
+using drake::multibody::Parser;
+using drake::trajectories::PiecewisePolynomial;
+using Eigen::MatrixXd;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+
+std::string TempPrefix() {
+  const char* dir = std::getenv("TEST_TMPDIR");
+  return std::string(dir ? dir : "/tmp") + "/pendulum";
+}
+
+/// The passive constrained pendulum of passive_constrained_pendulum_dircon
+/// with fewer knot points. Problem i adds a constant cost offsets_[i], so
+/// that the lowest-cost solution is known: the input effort cost is zero at
+/// the passive solution.
+class DirconMultiStartTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Parser parser(&plant_);
+    parser.AddModelFromFile(FindResourceOrThrow(
+        "systems/trajectory_optimization/dircon/test/acrobot_floating.urdf"));
+    plant_.Finalize();
+
+    distance_eval_ = std::make_unique<multibody::DistanceEvaluator<double>>(
+        plant_, Vector3d::Zero(), plant_.GetFrameByName("base_link"),
+        Vector3d(-1, 0, 0), plant_.GetFrameByName("lower_link"), 0.7);
+    pin_eval_ = std::make_unique<multibody::WorldPointEvaluator<double>>(
+        plant_, Vector3d::Zero(), plant_.GetFrameByName("base_link"));
+    evaluators_ =
+        std::make_unique<multibody::KinematicEvaluatorSet<double>>(plant_);
+    evaluators_->add_evaluator(distance_eval_.get());
+    evaluators_->add_evaluator(pin_eval_.get());
+    mode_ = std::make_unique<DirconMode<double>>(*evaluators_, kNumKnotPoints,
+                                                 1, 1);
+    sequence_ = std::make_unique<DirconModeSequence<double>>(plant_);
+    sequence_->AddMode(mode_.get());
+
+    // std::rand is not thread-safe, so the initial guess is made here
+    const int n_x = plant_.num_positions() + plant_.num_velocities();
+    VectorXd times(kNumKnotPoints);
+    MatrixXd states(n_x, kNumKnotPoints);
+    std::srand(0);
+    for (int j = 0; j < kNumKnotPoints; j++) {
+      times(j) = static_cast<double>(j) / (kNumKnotPoints - 1);
+      states.col(j) = .1 * VectorXd::Random(n_x);
+      states.col(j).head(4).normalize();
+    }
+    guess_u_ = PiecewisePolynomial<double>::FirstOrderHold(
+        times, MatrixXd::Zero(1, kNumKnotPoints));
+    guess_x_ = PiecewisePolynomial<double>::FirstOrderHold(times, states);
+  }
+
+  // Only reads the members, so it can be called from the worker threads
+  std::unique_ptr<Dircon<double>> BuildProblem(int i) const {
+    auto trajopt = std::make_unique<Dircon<double>>(*sequence_);
+    auto& prog = trajopt->prog();
+    auto u = trajopt->input();
+    trajopt->AddRunningCost(100 * u.transpose() * u);
+    prog.AddLinearCost(VectorXd::Zero(1), offsets_[i], trajopt->timestep(0));
+
+    const int n_q = plant_.num_positions();
+    auto positions_map = multibody::MakeNameToPositionsMap(plant_);
+    auto velocities_map = multibody::MakeNameToVelocitiesMap(plant_);
+    auto x0 = trajopt->initial_state();
+    prog.AddLinearConstraint(x0(positions_map.at("base_qx")) == .2);
+    prog.AddLinearConstraint(x0(positions_map.at("base_qy")) == .3);
+    prog.AddLinearConstraint(x0(positions_map.at("base_qz")) == -.2);
+    prog.AddLinearConstraint(x0(positions_map.at("base_qw")) >= .1);
+    for (const auto& name : {"base_wx", "base_wy", "base_wz"}) {
+      prog.AddLinearConstraint(x0(n_q + velocities_map.at(name)) == 0);
+    }
+
+    trajopt->SetInitialTrajectory(guess_u_, guess_x_);
+    if (i > 0) {
+      PerturbInitialGuess(0.01, i, &prog);
+    }
+    return trajopt;
+  }
+
+  static constexpr int kNumKnotPoints = 10;
+  const std::vector<double> offsets_ = {3, 1, 2, 4};
+  MultibodyPlant<double> plant_{0.0};
+  std::unique_ptr<multibody::DistanceEvaluator<double>> distance_eval_;
+  std::unique_ptr<multibody::WorldPointEvaluator<double>> pin_eval_;
+  std::unique_ptr<multibody::KinematicEvaluatorSet<double>> evaluators_;
+  std::unique_ptr<DirconMode<double>> mode_;
+  std::unique_ptr<DirconModeSequence<double>> sequence_;
+  PiecewisePolynomial<double> guess_u_;
+  PiecewisePolynomial<double> guess_x_;
+};
+
+TEST_F(DirconMultiStartTest, ReturnsLowestCostSolution) {
+  drake::solvers::SnoptSolver snopt;
+  drake::solvers::IpoptSolver ipopt;
+  if (!snopt.available() && !ipopt.available()) {
+    GTEST_SKIP() << "Neither SNOPT nor IPOPT is available";
+  }
+  DirconMultiStartOptions options;
+  // IpoptSolver (with MUMPS) is not thread-safe
+  options.num_threads = snopt.available() ? 2 : 1;
+  options.save_all = false;
+  options.filepath_prefix = TempPrefix();
+  const drake::solvers::SolverInterface& solver =
+      snopt.available()
+          ? static_cast<const drake::solvers::SolverInterface&>(snopt)
+          : ipopt;
+
+  const int num_problems = offsets_.size();
+  const auto results = SolveDirconMultiStart(
+      plant_, num_problems,
+      [this](int i) { return BuildProblem(i); }, solver, options);
+
+  ASSERT_EQ(static_cast<int>(results.size()), num_problems);
+  for (int i = 0; i < num_problems; i++) {
+    EXPECT_EQ(results[i].index, i);
+    EXPECT_TRUE(results[i].is_success()) << "problem " << i;
+    EXPECT_NEAR(results[i].cost, offsets_[i], 1e-3);
+  }
+
+  // Only the lowest-cost solution is saved, under the index of its start
+  const int best = FindBestDirconMultiStartResult(results);
+  ASSERT_EQ(best, 1);
+  for (int i = 0; i < num_problems; i++) {
+    if (i != best) EXPECT_TRUE(results[i].filepath.empty());
+  }
+  EXPECT_EQ(results[best].filepath, TempPrefix() + "_1");
+  EXPECT_TRUE(std::ifstream(results[best].filepath).good());
+  const DirconTrajectory saved(plant_, results[best].filepath);
+  EXPECT_EQ(saved.GetDecisionVariables().size(),
+            BuildProblem(best)->prog().num_vars());
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
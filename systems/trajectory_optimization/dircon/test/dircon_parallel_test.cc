@@ -0,0 +1,135 @@
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "common/find_resource.h"
+#include "multibody/kinematic/distance_evaluator.h"
+#include "multibody/kinematic/kinematic_constraints.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "solvers/constraint_batch.h"
+#include "systems/trajectory_optimization/dircon/dircon.h"
+#include "systems/trajectory_optimization/dircon/dircon_opt_constraints.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/multibody/parsing/parser.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::CompareMatrices;
+using drake::multibody::MultibodyPlant;
+using drake::multibody::Parser;
+using drake::solvers::Binding;
+using drake::solvers::Constraint;
+using drake::solvers::MathematicalProgram;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+
+// True for the constraints that Dircon evaluates in a ConstraintBatch when
+// it has more than one thread
+bool IsBatched(const Binding<Constraint>& binding) {
+  const auto& c = binding.evaluator();
+  return std::dynamic_pointer_cast<DirconCollocationConstraint<double>>(c) ||
+         std::dynamic_pointer_cast<CachedAccelerationConstraint<double>>(c) ||
+         std::dynamic_pointer_cast<ImpactConstraint<double>>(c) ||
+         std::dynamic_pointer_cast<
+             multibody::KinematicPositionConstraint<double>>(c) ||
+         std::dynamic_pointer_cast<
+             multibody::KinematicVelocityConstraint<double>>(c);
+}
+
+/// The constrained pendulum of passive_constrained_pendulum_dircon, whose
+/// DistanceEvaluator is evaluated by every kinematic and collocation
+/// constraint
+class DirconParallelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Parser parser(&plant_);
+    parser.AddModelFromFile(FindResourceOrThrow(
+        "systems/trajectory_optimization/dircon/test/acrobot_floating.urdf"));
+    plant_.Finalize();
+
+    distance_eval_ = std::make_unique<multibody::DistanceEvaluator<double>>(
+        plant_, Vector3d::Zero(), plant_.GetFrameByName("base_link"),
+        Vector3d(-1, 0, 0), plant_.GetFrameByName("lower_link"), 0.7);
+    pin_eval_ = std::make_unique<multibody::WorldPointEvaluator<double>>(
+        plant_, Vector3d::Zero(), plant_.GetFrameByName("base_link"));
+    evaluators_ =
+        std::make_unique<multibody::KinematicEvaluatorSet<double>>(plant_);
+    evaluators_->add_evaluator(distance_eval_.get());
+    evaluators_->add_evaluator(pin_eval_.get());
+    mode_ = std::make_unique<DirconMode<double>>(*evaluators_, 10, 1, 3);
+  }
+
+  // The sequence must outlive the Dircon
+  std::unique_ptr<Dircon<double>> MakeDircon(int num_threads) {
+    sequences_.push_back(
+        std::make_unique<DirconModeSequence<double>>(plant_));
+    sequences_.back()->AddMode(mode_.get());
+    sequences_.back()->SetNumThreads(num_threads);
+    return std::make_unique<Dircon<double>>(*sequences_.back());
+  }
+
+  MultibodyPlant<double> plant_{0.0};
+  std::unique_ptr<multibody::DistanceEvaluator<double>> distance_eval_;
+  std::unique_ptr<multibody::WorldPointEvaluator<double>> pin_eval_;
+  std::unique_ptr<multibody::KinematicEvaluatorSet<double>> evaluators_;
+  std::unique_ptr<DirconMode<double>> mode_;
+  std::vector<std::unique_ptr<DirconModeSequence<double>>> sequences_;
+};
+
+TEST_F(DirconParallelTest, MatchesSerial) {
+  auto serial = MakeDircon(1);
+  auto threaded = MakeDircon(4);
+  const MathematicalProgram& serial_prog = serial->prog();
+  const MathematicalProgram& threaded_prog = threaded->prog();
+  ASSERT_EQ(serial_prog.num_vars(), threaded_prog.num_vars());
+
+  std::vector<Binding<Constraint>> serial_bindings;
+  for (const auto& binding : serial_prog.generic_constraints()) {
+    if (IsBatched(binding)) serial_bindings.push_back(binding);
+  }
+  std::vector<Binding<Constraint>> batches;
+  for (const auto& binding : threaded_prog.generic_constraints()) {
+    EXPECT_FALSE(IsBatched(binding));
+    if (std::dynamic_pointer_cast<solvers::ConstraintBatch>(
+            binding.evaluator())) {
+      batches.push_back(binding);
+    }
+  }
+  ASSERT_EQ(batches.size(), 1u);
+  ASSERT_GT(serial_bindings.size(), 1u);
+
+  // Both programs create their decision variables in the same order, so a
+  // value vector of one is a value vector of the other. The batch stacks the
+  // outputs of its constraints in the order the serial program adds them.
+  std::srand(0);
+  for (int i = 0; i < 20; i++) {
+    VectorXd x = VectorXd::Random(serial_prog.num_vars());
+    for (int j = 0; j < mode_->num_knotpoints(); j++) {
+      serial_prog.SetDecisionVariableValueInVector(
+          serial->state_vars(0, j).head(4),
+          Eigen::Vector4d::Random().normalized(), &x);
+    }
+
+    VectorXd expected(batches[0].evaluator()->num_outputs());
+    int row = 0;
+    for (const auto& binding : serial_bindings) {
+      const VectorXd y = serial_prog.EvalBinding(binding, x);
+      expected.segment(row, y.size()) = y;
+      row += y.size();
+    }
+    ASSERT_EQ(row, expected.size());
+    EXPECT_TRUE(CompareMatrices(threaded_prog.EvalBinding(batches[0], x),
+                                expected, 1e-12));
+  }
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
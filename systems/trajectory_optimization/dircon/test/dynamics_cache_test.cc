@@ -0,0 +1,250 @@
+#include "systems/trajectory_optimization/dircon/dynamics_cache.h"
+
+#include <memory>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <gtest/gtest.h>
+
+#include "common/find_resource.h"
+#include "multibody/kinematic/world_point_evaluator.h"
+#include "multibody/multibody_utils.h"
+
+#include "drake/common/test_utilities/eigen_matrix_compare.h"
+#include "drake/math/autodiff.h"
+#include "drake/math/autodiff_gradient.h"
+#include "drake/multibody/parsing/parser.h"
+
+namespace dairlib {
+namespace systems {
+namespace trajectory_optimization {
+namespace {
+
+using drake::AutoDiffVecXd;
+using drake::AutoDiffXd;
+using drake::CompareMatrices;
+using drake::VectorX;
+using drake::multibody::MultibodyPlant;
+using drake::multibody::Parser;
+using drake::systems::Context;
+using Eigen::Vector3d;
+using Eigen::VectorXd;
+
+/// The floating acrobot of passive_constrained_pendulum_dircon, pinned to the
+/// world at its base, for double and AutoDiffXd
+template <typename T>
+class PinnedAcrobot {
+ public:
+  explicit PinnedAcrobot(const MultibodyPlant<T>& plant)
+      : plant_(plant),
+        pin_eval_(plant, Vector3d::Zero(), plant.GetFrameByName("base_link")),
+        evaluators_(plant),
+        context_(plant.CreateDefaultContext()) {
+    evaluators_.add_evaluator(&pin_eval_);
+  }
+
+  const multibody::KinematicEvaluatorSet<T>& evaluators() const {
+    return evaluators_;
+  }
+
+  /// Evaluates xdot through `cache` at the [x; u; lambda] stacked in z
+  VectorX<T> Eval(DynamicsCache<T>* cache, const VectorX<T>& z,
+                  uint64_t seed_id = 0) {
+    const int n_x = plant_.num_positions() + plant_.num_velocities();
+    const int n_u = plant_.num_actuators();
+    multibody::SetContext<T>(plant_, z.head(n_x), z.segment(n_x, n_u),
+                             context_.get());
+    VectorX<T> xdot;
+    cache->CalcTimeDerivativesWithForce(
+        context_.get(), z.tail(z.size() - n_x - n_u), &xdot, seed_id);
+    return xdot;
+  }
+
+  /// Evaluates xdot without a cache
+  VectorX<T> EvalUncached(const VectorX<T>& z) {
+    const int n_x = plant_.num_positions() + plant_.num_velocities();
+    const int n_u = plant_.num_actuators();
+    multibody::SetContext<T>(plant_, z.head(n_x), z.segment(n_x, n_u),
+                             context_.get());
+    VectorX<T> xdot;
+    evaluators_.CalcTimeDerivativesWithForce(
+        context_.get(), z.tail(z.size() - n_x - n_u), &xdot);
+    return xdot;
+  }
+
+ private:
+  const MultibodyPlant<T>& plant_;
+  multibody::WorldPointEvaluator<T> pin_eval_;
+  multibody::KinematicEvaluatorSet<T> evaluators_;
+  std::unique_ptr<Context<T>> context_;
+};
+
+class DynamicsCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Parser parser(&plant_);
+    parser.AddModelFromFile(FindResourceOrThrow(
+        "systems/trajectory_optimization/dircon/test/acrobot_floating.urdf"));
+    plant_.Finalize();
+    plant_ad_ = drake::systems::System<double>::ToAutoDiffXd(plant_);
+    acrobot_ = std::make_unique<PinnedAcrobot<double>>(plant_);
+    acrobot_ad_ = std::make_unique<PinnedAcrobot<AutoDiffXd>>(*plant_ad_);
+  }
+
+  // A random [x; u; lambda] with a unit quaternion
+  VectorXd RandomPoint() const {
+    const int n_z = plant_.num_positions() + plant_.num_velocities() +
+                    plant_.num_actuators() +
+                    acrobot_->evaluators().count_full();
+    VectorXd z = VectorXd::Random(n_z);
+    z.head(4).normalize();
+    return z;
+  }
+
+  MultibodyPlant<double> plant_{0.0};
+  std::unique_ptr<MultibodyPlant<AutoDiffXd>> plant_ad_;
+  std::unique_ptr<PinnedAcrobot<double>> acrobot_;
+  std::unique_ptr<PinnedAcrobot<AutoDiffXd>> acrobot_ad_;
+};
+
+// Equal values hit and return the cached xdot; a change in any of x, u or
+// lambda misses
+TEST_F(DynamicsCacheTest, HitsOnEqualValuesAndMissesOnUnequal) {
+  DynamicsCache<double> cache(acrobot_->evaluators(), 16);
+  std::srand(0);
+  const VectorXd z = RandomPoint();
+  const int n_x = plant_.num_positions() + plant_.num_velocities();
+
+  const VectorXd xdot = acrobot_->Eval(&cache, z);
+  EXPECT_TRUE(CompareMatrices(xdot, acrobot_->EvalUncached(z)));
+  EXPECT_EQ(cache.GetStatistics().misses, 1);
+  EXPECT_EQ(cache.GetStatistics().hits, 0);
+
+  EXPECT_TRUE(CompareMatrices(acrobot_->Eval(&cache, z), xdot));
+  EXPECT_EQ(cache.GetStatistics().misses, 1);
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+
+  // One entry of x (a velocity), of u and of lambda
+  for (int i : {n_x - 1, n_x, static_cast<int>(z.size()) - 1}) {
+    VectorXd z_changed = z;
+    z_changed(i) += 1e-12;
+    const VectorXd xdot_changed = acrobot_->Eval(&cache, z_changed);
+    EXPECT_TRUE(CompareMatrices(xdot_changed,
+                                acrobot_->EvalUncached(z_changed)));
+  }
+  EXPECT_EQ(cache.GetStatistics().misses, 4);
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+
+  // The original entry is still there
+  EXPECT_TRUE(CompareMatrices(acrobot_->Eval(&cache, z), xdot));
+  EXPECT_EQ(cache.GetStatistics().misses, 4);
+  EXPECT_EQ(cache.GetStatistics().hits, 2);
+}
+
+// With room for a single entry, the table has as many slots as the probe
+// window (kProbeWindow in dynamics_cache.cc), so every key probes every slot.
+// Once they are all occupied, each insert replaces the oldest entry.
+TEST_F(DynamicsCacheTest, EvictsOldestEntryOfFullWindow) {
+  DynamicsCache<double> cache(acrobot_->evaluators(), 1);
+  const int kProbeWindow = 8;
+  std::srand(1);
+  std::vector<VectorXd> points;
+  for (int i = 0; i < kProbeWindow + 1; i++) {
+    points.push_back(RandomPoint());
+    acrobot_->Eval(&cache, points.back());
+  }
+  EXPECT_EQ(cache.GetStatistics().misses, kProbeWindow + 1);
+
+  // Hits do not change the insertion order
+  for (int i = kProbeWindow; i >= 1; i--) {
+    acrobot_->Eval(&cache, points[i]);
+  }
+  EXPECT_EQ(cache.GetStatistics().hits, kProbeWindow);
+  EXPECT_EQ(cache.GetStatistics().misses, kProbeWindow + 1);
+
+  // The first point was replaced by the last one
+  acrobot_->Eval(&cache, points[0]);
+  EXPECT_EQ(cache.GetStatistics().hits, kProbeWindow);
+  EXPECT_EQ(cache.GetStatistics().misses, kProbeWindow + 2);
+}
+
+// For double, the seed id is ignored and the entries are shared by all
+// callers
+TEST_F(DynamicsCacheTest, DoubleEntriesSharedAcrossSeedIds) {
+  DynamicsCache<double> cache(acrobot_->evaluators(), 16);
+  std::srand(2);
+  const VectorXd z = RandomPoint();
+  const VectorXd xdot = acrobot_->Eval(&cache, z, 1);
+  EXPECT_TRUE(CompareMatrices(acrobot_->Eval(&cache, z, 2), xdot));
+  EXPECT_EQ(cache.GetStatistics().misses, 1);
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+}
+
+// For AutoDiffXd, equal values only hit within the same seed id and number of
+// derivatives, and a hit returns the cached derivatives
+TEST_F(DynamicsCacheTest, AutoDiffEntriesSeparatedBySeedIdAndDerivatives) {
+  DynamicsCache<AutoDiffXd> cache(acrobot_ad_->evaluators(), 16);
+  std::srand(3);
+  const VectorXd z = RandomPoint();
+  const AutoDiffVecXd z_ad = drake::math::InitializeAutoDiff(z);
+
+  const AutoDiffVecXd xdot = acrobot_ad_->Eval(&cache, z_ad, 1);
+  const AutoDiffVecXd xdot_expected = acrobot_ad_->EvalUncached(z_ad);
+  EXPECT_TRUE(CompareMatrices(drake::math::ExtractValue(xdot),
+                              drake::math::ExtractValue(xdot_expected)));
+  EXPECT_TRUE(CompareMatrices(drake::math::ExtractGradient(xdot),
+                              drake::math::ExtractGradient(xdot_expected)));
+  EXPECT_EQ(cache.GetStatistics().misses, 1);
+
+  const AutoDiffVecXd xdot_hit = acrobot_ad_->Eval(&cache, z_ad, 1);
+  EXPECT_TRUE(CompareMatrices(drake::math::ExtractGradient(xdot_hit),
+                              drake::math::ExtractGradient(xdot)));
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+
+  // Another seed id
+  acrobot_ad_->Eval(&cache, z_ad, 2);
+  EXPECT_EQ(cache.GetStatistics().misses, 2);
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+
+  // The same seed id with more derivatives
+  const AutoDiffVecXd z_ad_wide =
+      drake::math::InitializeAutoDiff(z, z.size() + 1);
+  const AutoDiffVecXd xdot_wide = acrobot_ad_->Eval(&cache, z_ad_wide, 1);
+  EXPECT_EQ(xdot_wide(0).derivatives().size(), z.size() + 1);
+  EXPECT_EQ(cache.GetStatistics().misses, 3);
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+}
+
+TEST_F(DynamicsCacheTest, Statistics) {
+  DynamicsCache<double> cache(acrobot_->evaluators(), 16);
+  EXPECT_EQ(cache.GetStatistics().hit_rate(), 0);
+
+  std::srand(4);
+  const VectorXd z_0 = RandomPoint();
+  const VectorXd z_1 = RandomPoint();
+  acrobot_->Eval(&cache, z_0);
+  acrobot_->Eval(&cache, z_0);
+  acrobot_->Eval(&cache, z_0);
+  acrobot_->Eval(&cache, z_1);
+  const auto statistics = cache.GetStatistics();
+  EXPECT_EQ(statistics.hits, 2);
+  EXPECT_EQ(statistics.misses, 2);
+  EXPECT_EQ(statistics.hit_rate(), 0.5);
+  EXPECT_GT(statistics.compute_time, 0);
+  EXPECT_GE(statistics.lookup_time, 0);
+
+  cache.ResetStatistics();
+  EXPECT_EQ(cache.GetStatistics().hits, 0);
+  EXPECT_EQ(cache.GetStatistics().misses, 0);
+  EXPECT_EQ(cache.GetStatistics().compute_time, 0);
+  EXPECT_EQ(cache.GetStatistics().lookup_time, 0);
+
+  // Resetting the counters keeps the entries
+  acrobot_->Eval(&cache, z_1);
+  EXPECT_EQ(cache.GetStatistics().hits, 1);
+}
+
+}  // namespace
+}  // namespace trajectory_optimization
+}  // namespace systems
+}  // namespace dairlib
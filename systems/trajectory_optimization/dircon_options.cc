@@ -157,6 +157,13 @@ DirconKinConstraintType DirconOptions::getEndType() {
 
 double DirconOptions::getForceCost() { return force_cost_; }
 
+void DirconOptions::setColoredFiniteDifferences(bool colored) {
+  colored_finite_differences_ = colored;
+}
+bool DirconOptions::getColoredFiniteDifferences() {
+  return colored_finite_differences_;
+}
+
 int DirconOptions::getNumRelative() {
   return static_cast<int>(std::count(is_constraints_relative_.begin(),
                                      is_constraints_relative_.end(), true));
@@ -52,6 +52,13 @@ class DirconOptions {
   void setForceCost(double force_cost);
   double getForceCost();
 
+  // Setter/getter for detecting the Jacobian sparsity of the dynamic,
+  // kinematic and impact constraints, so that their numerical gradients
+  // perturb structurally independent variables together (see
+  // NonlinearConstraint::DetectJacobianSparsityPattern)
+  void setColoredFiniteDifferences(bool colored);
+  bool getColoredFiniteDifferences();
+
  private:
   // methods for constraint scaling
   static void addConstraintScaling(std::unordered_map<int, double>* list,
@@ -74,6 +81,8 @@ class DirconOptions {
 
   // Force cost
   double force_cost_;
+
+  bool colored_finite_differences_ = false;
 };
 
 }  // namespace trajectory_optimization
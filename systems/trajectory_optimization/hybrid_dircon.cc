@@ -143,6 +143,9 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
         num_states());
     dynamic_constraint->SetConstraintScaling(
         options[i].getDynConstraintScaling());
+    if (options[i].getColoredFiniteDifferences()) {
+      dynamic_constraint->DetectJacobianSparsityPattern();
+    }
     for (int j = 0; j < mode_lengths_[i] - 1; j++) {
       int time_index = mode_start_[i] + j;
       prog().AddConstraint(
@@ -167,6 +170,9 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
         plant_, *constraints_[i], options[i].getConstraintsRelative());
     kinematic_constraint->SetConstraintScaling(
         options[i].getKinConstraintScaling());
+    if (options[i].getColoredFiniteDifferences()) {
+      kinematic_constraint->DetectJacobianSparsityPattern();
+    }
     for (int j = 1; j < mode_lengths_[i] - 1; j++) {
       int time_index = mode_start_[i] + j;
       prog().AddConstraint(
@@ -185,6 +191,9 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
             options[i].getStartType());
     kinematic_constraint_start->SetConstraintScaling(
         options[i].getKinConstraintScalingStart());
+    if (options[i].getColoredFiniteDifferences()) {
+      kinematic_constraint_start->DetectJacobianSparsityPattern();
+    }
     prog().AddConstraint(
         kinematic_constraint_start,
         {state_vars_by_mode(i, 0),
@@ -203,6 +212,9 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
               options[i].getEndType());
       kinematic_constraint_end->SetConstraintScaling(
           options[i].getKinConstraintScalingEnd());
+      if (options[i].getColoredFiniteDifferences()) {
+        kinematic_constraint_end->DetectJacobianSparsityPattern();
+      }
       prog().AddConstraint(
           kinematic_constraint_end,
           {state_vars_by_mode(i, mode_lengths_[i] - 1),
@@ -248,6 +260,9 @@ HybridDircon<T>::HybridDircon(const MultibodyPlant<T>& plant,
             plant_, *constraints_[i]);
         impact_constraint->SetConstraintScaling(
             options[i].getImpConstraintScaling());
+        if (options[i].getColoredFiniteDifferences()) {
+          impact_constraint->DetectJacobianSparsityPattern();
+        }
         prog().AddConstraint(impact_constraint,
                       {state_vars_by_mode(i - 1, mode_lengths_[i - 1] - 1),
                        impulse_vars(i - 1), v_post_impact_vars_by_mode(i - 1)});